@@ -0,0 +1,333 @@
+// This is an open source non-commercial project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+
+#include "AssetPreloader.h"
+
+#include "Constants.h"
+
+#include "SDL_image.h"
+
+#include <algorithm>
+#include <chrono>
+
+using namespace NAS2D;
+
+
+extern const std::string MAP_TERRAIN_EXTENSION;
+extern const std::string MAP_DISPLAY_EXTENSION;
+
+
+/**
+ * Preload manifest: images every game uses that aren't specific to a site.
+ */
+static std::vector<std::string> preloadManifest()
+{
+	std::vector<std::string> names =
+	{
+		"sys/bg1.png",
+		"ui/skin/window_title_left.png",
+		"ui/skin/window_title_middle.png",
+		"ui/skin/window_title_right.png"
+	};
+
+	for (const char* skin : { "ui/skin/button", "ui/skin/button_hover", "ui/skin/button_pressed", "ui/skin/textbox", "ui/skin/window" })
+	{
+		std::vector<std::string> slices = ImageManager::skinNames(skin);
+		names.insert(names.end(), slices.begin(), slices.end());
+	}
+
+	std::vector<std::string> slices = ImageManager::skinNames("ui/skin/textbox", "_highlight");
+	names.insert(names.end(), slices.begin(), slices.end());
+
+	return names;
+}
+
+
+/**
+ * Atlas manifest: small images that are drawn often, usually next to each
+ * other, and are only ever drawn unscaled.
+ *
+ * \note	Skins aren't packed since they're drawn stretched and repeated,
+ *			which needs images of their own.
+ */
+static std::vector<std::string> atlasManifest()
+{
+	return
+	{
+		"ui/icons.png",
+		"ui/structures.png",
+		"ui/robots.png",
+		"ui/factory.png",
+		"ui/skin/checkbox.png",
+		"structures/mine_beacon.png",
+
+		"ui/interface/factory_seed.png",
+		"ui/interface/factory_ag.png",
+		"ui/interface/factory_ug.png",
+		"ui/interface/mine.png",
+		"ui/interface/warehouse.png",
+		"ui/interface/product_robodigger.png",
+		"ui/interface/product_robodozer.png",
+		"ui/interface/product_robominer.png",
+		"ui/interface/product_roboexplorer.png",
+		"ui/interface/product_truck.png",
+		"ui/interface/product_road_materials.png",
+		"ui/interface/product_maintenance_parts.png",
+		"ui/interface/product_clothing.png",
+		"ui/interface/product_medicine.png",
+		"ui/interface/product_none.png",
+
+		"ui/icons/exit.png",
+		"ui/icons/research.png",
+		"ui/icons/production.png",
+		"ui/icons/warehouse.png",
+		"ui/icons/mine.png",
+		"ui/icons/satellite.png",
+		"ui/icons/spaceport.png"
+	};
+}
+
+
+/**
+ * D'tor
+ *
+ * Drops the images still waiting to be decoded and stops the worker thread.
+ */
+AssetPreloader::~AssetPreloader()
+{
+	{
+		std::lock_guard<std::mutex> lock(mLock);
+		mStop = true;
+		mPending.clear();
+	}
+
+	if (mThread.joinable()) { mThread.join(); }
+}
+
+
+/**
+ * Requests images to be decoded.
+ *
+ * Images that are already in the ImageManager or already requested are
+ * skipped.
+ */
+void AssetPreloader::request(const std::vector<std::string>& names)
+{
+	request(names, PLACEMENT_CACHE);
+}
+
+
+/**
+ * Requests the images of the preload and atlas manifests to be decoded.
+ */
+void AssetPreloader::requestManifest()
+{
+	request(preloadManifest(), PLACEMENT_PINNED);
+	request(atlasManifest(), PLACEMENT_ATLAS);
+}
+
+
+/**
+ * Requests the images of a site to be decoded: its satellite and height
+ * views and its tileset.
+ */
+void AssetPreloader::requestSite(const std::string& sitemap, const std::string& tileset)
+{
+	request({ sitemap + MAP_DISPLAY_EXTENSION, sitemap + MAP_TERRAIN_EXTENSION, tileset }, PLACEMENT_CACHE);
+}
+
+
+/**
+ * Uploads decoded images and adds them to the ImageManager. Builds the atlas
+ * once the last requested image is uploaded.
+ *
+ * \param	count	Most images to upload.
+ *
+ * \return	Number of images uploaded.
+ */
+size_t AssetPreloader::upload(size_t count)
+{
+	std::deque<DecodedImage> decoded;
+
+	{
+		std::lock_guard<std::mutex> lock(mLock);
+		while (!mDecoded.empty() && decoded.size() < count)
+		{
+			decoded.push_back(std::move(mDecoded.front()));
+			mDecoded.pop_front();
+		}
+	}
+
+	for (DecodedImage& image : decoded)
+	{
+		++mUploaded;
+		mQueued.erase(image.name);
+
+		// Images that couldn't be decoded are left to be loaded when they're used.
+		if (image.pixels.empty()) { continue; }
+
+		ImageManager& images = Utility<ImageManager>::get();
+		if (image.placement == PLACEMENT_ATLAS)
+		{
+			images.stage(image.name, std::move(image.pixels), image.width, image.height);
+			continue;
+		}
+
+		ImageManager::ImageHandle handle = images.add(image.name, std::move(image.pixels), image.width, image.height);
+		if (image.placement == PLACEMENT_PINNED) { mPinned.push_back(handle); }
+	}
+
+	if (!decoded.empty() && finished()) { Utility<ImageManager>::get().buildAtlas(); }
+
+	return decoded.size();
+}
+
+
+/**
+ * Uploads every requested image, waiting for the worker thread to decode
+ * them if it has to. Draws a loading plaque with a progress bar until
+ * it's done.
+ */
+void AssetPreloader::finish(Image& plaque)
+{
+	Renderer& r = Utility<Renderer>::get();
+
+	while (!finished())
+	{
+		{
+			std::unique_lock<std::mutex> lock(mLock);
+			mDecodedChanged.wait_for(lock, std::chrono::milliseconds(constants::PRELOAD_WAIT), [this] { return !mDecoded.empty(); });
+		}
+
+		upload(mRequested);
+
+		float x = r.center_x() - (plaque.width() / 2);
+		float y = r.center_y() - (plaque.height() / 2);
+		float width = static_cast<float>(plaque.width());
+		float barY = y + plaque.height() + 4;
+
+		r.clearScreen(0, 0, 0);
+		r.drawImage(plaque, x, y);
+		r.drawBoxFilled(x, barY, width, 8, 0, 0, 0, 200);
+		r.drawBoxFilled(x, barY, width * progress(), 8, 0, 185, 0);
+		r.drawBox(x, barY, width, 8, 255, 255, 255);
+		r.update();
+	}
+}
+
+
+/**
+ * Gets how much of what was requested since the preloader was last
+ * finished is uploaded, from 0 to 1.
+ */
+float AssetPreloader::progress() const
+{
+	if (mRequested == 0) { return 1.0f; }
+
+	return static_cast<float>(mUploaded) / mRequested;
+}
+
+
+/**
+ * Queues images to be decoded and starts the worker thread if it isn't
+ * running.
+ */
+void AssetPreloader::request(const std::vector<std::string>& names, Placement placement)
+{
+	if (finished())
+	{
+		mRequested = 0;
+		mUploaded = 0;
+	}
+
+	std::lock_guard<std::mutex> lock(mLock);
+
+	for (const std::string& name : names)
+	{
+		if (mQueued.count(name) > 0 || Utility<ImageManager>::get().contains(name)) { continue; }
+
+		mQueued.insert(name);
+		++mRequested;
+
+		DecodedImage image;
+		image.name = name;
+		image.placement = placement;
+		mPending.push_back(image);
+	}
+
+	if (mBusy || mPending.empty()) { return; }
+
+	// A thread that isn't busy anymore has already let go of the lock.
+	if (mThread.joinable()) { mThread.join(); }
+
+	mBusy = true;
+	mThread = std::thread(&AssetPreloader::run, this);
+}
+
+
+/**
+ * Decodes pending images until there are none left.
+ */
+void AssetPreloader::run()
+{
+	for (;;)
+	{
+		DecodedImage image;
+
+		{
+			std::lock_guard<std::mutex> lock(mLock);
+			if (mStop || mPending.empty())
+			{
+				mBusy = false;
+				return;
+			}
+
+			image = std::move(mPending.front());
+			mPending.pop_front();
+		}
+
+		decode(image);
+
+		{
+			std::lock_guard<std::mutex> lock(mLock);
+			mDecoded.push_back(std::move(image));
+		}
+
+		mDecodedChanged.notify_all();
+	}
+}
+
+
+/**
+ * Reads an image file and decodes it to R, G, B, A bytes.
+ *
+ * \return	False if the file couldn't be read or decoded.
+ */
+bool AssetPreloader::decode(DecodedImage& image)
+{
+	File file = Utility<Filesystem>::get().open(image.name);
+	if (file.empty()) { return false; }
+
+	SDL_Surface* decoded = IMG_Load_RW(SDL_RWFromConstMem(file.raw_bytes(), static_cast<int>(file.size())), 1);
+	if (!decoded) { return false; }
+
+	// Whatever the format of the file, keep the pixels as R, G, B, A bytes.
+	SDL_Surface* surface = SDL_ConvertSurfaceFormat(decoded, SDL_PIXELFORMAT_RGBA32, 0);
+	SDL_FreeSurface(decoded);
+	if (!surface) { return false; }
+
+	image.width = surface->w;
+	image.height = surface->h;
+	image.pixels.resize(static_cast<size_t>(image.width) * image.height * 4);
+
+	SDL_LockSurface(surface);
+	for (int y = 0; y < image.height; ++y)
+	{
+		const uint8_t* row = static_cast<const uint8_t*>(surface->pixels) + static_cast<size_t>(y) * surface->pitch;
+		std::copy(row, row + image.width * 4, image.pixels.begin() + static_cast<size_t>(y) * image.width * 4);
+	}
+	SDL_UnlockSurface(surface);
+
+	SDL_FreeSurface(surface);
+	return true;
+}
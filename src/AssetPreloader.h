@@ -0,0 +1,95 @@
+#pragma once
+
+#include "ImageManager.h"
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+
+/**
+ * \brief	Decodes images ahead of time on a worker thread.
+ *
+ * Images are requested by filename, either one at a time or as the preload
+ * manifest of images every game uses. A worker thread reads and decodes the
+ * requested images into plain pixel buffers. The main thread uploads a few
+ * finished buffers per frame with upload() and adds them to the ImageManager,
+ * so by the time a control asks for an image it's already in the cache.
+ *
+ * Images of the preload manifest are pinned: they stay in the ImageManager
+ * when it evicts images nothing uses. Images of the atlas manifest are staged
+ * into the ImageManager's atlas instead, which is built once everything that
+ * was requested is uploaded.
+ *
+ * \note	Images are only uploaded to the video card on the main thread. The
+ *			worker only reads files and decodes them.
+ */
+class AssetPreloader
+{
+public:
+	AssetPreloader() = default;
+	~AssetPreloader();
+
+	void request(const std::vector<std::string>& names);
+	void requestManifest();
+	void requestSite(const std::string& sitemap, const std::string& tileset);
+
+	size_t upload(size_t count);
+	void finish(NAS2D::Image& plaque);
+
+	bool finished() const { return mUploaded == mRequested; }
+	float progress() const;
+
+private:
+	/**
+	 * Where a decoded image goes once it's uploaded.
+	 */
+	enum Placement
+	{
+		PLACEMENT_CACHE,		/**< ImageManager cache, evicted once it's not used. */
+		PLACEMENT_PINNED,		/**< ImageManager cache, never evicted. */
+		PLACEMENT_ATLAS			/**< ImageManager atlas. */
+	};
+
+	/**
+	 * Pixels of a decoded image.
+	 */
+	struct DecodedImage
+	{
+		std::string				name;
+		int						width = 0;
+		int						height = 0;
+		std::vector<uint8_t>	pixels;								/**< R, G, B, A bytes of every pixel, row by row. Empty if decoding failed. */
+		Placement				placement = PLACEMENT_CACHE;
+	};
+
+private:
+	AssetPreloader(const AssetPreloader&) = delete;
+	AssetPreloader& operator=(const AssetPreloader&) = delete;
+
+	void request(const std::vector<std::string>& names, Placement placement);
+	void run();
+
+	static bool decode(DecodedImage& image);
+
+private:
+	std::thread									mThread;				/**< Worker thread. */
+
+	std::mutex									mLock;					/**< Guards everything below up to the main thread members. */
+	std::condition_variable						mDecodedChanged;		/**< Signaled whenever an image is decoded. */
+	std::deque<DecodedImage>					mPending;				/**< Images to decode, pixels not filled in yet. */
+	std::deque<DecodedImage>					mDecoded;				/**< Decoded images waiting to be uploaded. */
+	bool										mBusy = false;			/**< The worker thread is running. */
+	bool										mStop = false;			/**< The worker thread should stop. */
+
+	// Main thread only.
+	std::set<std::string>						mQueued;				/**< Images requested but not uploaded yet. */
+	std::vector<ImageManager::ImageHandle>		mPinned;				/**< Uploaded images of the preload manifest. */
+	size_t										mRequested = 0;			/**< Images requested since the preloader was last finished. */
+	size_t										mUploaded = 0;			/**< Images of those that are uploaded. */
+};
@@ -0,0 +1,57 @@
+// This is an open source non-commercial project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+
+#include "AttributeSchema.h"
+
+#include <iostream>
+#include <stdexcept>
+
+
+/**
+ * C'tor
+ *
+ * \param	element	Name of the element, used when reporting problems.
+ * \param	entries	Known attributes. Keys don't need to be unique or
+ *					contiguous.
+ *
+ * \throws	std::runtime_error if there are more than 64 entries or a
+ *			name is listed twice.
+ */
+AttributeTable::AttributeTable(const std::string& element, const std::vector<Entry>& entries) :
+	mElement(element),
+	mEntries(entries)
+{
+	if (mEntries.size() > 64)
+	{
+		throw std::runtime_error("AttributeTable: Too many attributes for element '" + mElement + "'.");
+	}
+
+	for (size_t i = 0; i < mEntries.size(); ++i)
+	{
+		if (!mLookup.emplace(mEntries[i].name, i).second)
+		{
+			throw std::runtime_error("AttributeTable: Attribute '" + mEntries[i].name + "' listed twice for element '" + mElement + "'.");
+		}
+
+		if (mEntries[i].required) { mRequired |= uint64_t(1) << i; }
+	}
+}
+
+
+void AttributeTable::reportUnknown(const std::string& name) const
+{
+	if (!mReported.insert(name).second) { return; }
+	std::cout << "Savegame: Unknown attribute '" << name << "' in element '" << mElement << "'." << std::endl;
+}
+
+
+void AttributeTable::reportMissing(uint64_t found) const
+{
+	for (size_t i = 0; i < mEntries.size(); ++i)
+	{
+		if (!mEntries[i].required || (found & (uint64_t(1) << i))) { continue; }
+		if (!mReported.insert(mEntries[i].name).second) { continue; }
+
+		std::cout << "Savegame: Missing attribute '" << mEntries[i].name << "' in element '" << mElement << "'." << std::endl;
+	}
+}
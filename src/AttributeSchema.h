@@ -0,0 +1,139 @@
+#pragma once
+
+#include "NAS2D/NAS2D.h"
+
+#include <cstdint>
+#include <initializer_list>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+
+/**
+ * \brief	Maps the attribute names of a savegame element to integer keys.
+ *
+ * Names are hashed once when the table is built so reading an element
+ * costs a single hash lookup per attribute instead of a chain of string
+ * comparisons. Attributes that aren't in the table and required
+ * attributes that are missing from an element are reported once per
+ * table so malformed or outdated savegames are noticed without flooding
+ * the log.
+ */
+class AttributeTable
+{
+public:
+	struct Entry
+	{
+		Entry(const std::string& _name, int _key, bool _required = false) : name(_name), key(_key), required(_required) {}
+
+		std::string		name;
+		int				key;
+		bool			required;
+	};
+
+public:
+	AttributeTable(const std::string& element, const std::vector<Entry>& entries);
+
+	/**
+	 * Calls \c f(key, attribute) for each known attribute of an element.
+	 *
+	 * \param	element	Element to read. Safe to pass \c nullptr.
+	 */
+	template <typename F>
+	void read(NAS2D::Xml::XmlElement* element, F f) const
+	{
+		if (!element) { return; }
+
+		uint64_t found = 0;
+		for (NAS2D::Xml::XmlAttribute* attribute = element->firstAttribute(); attribute; attribute = attribute->next())
+		{
+			auto it = mLookup.find(attribute->name());
+			if (it == mLookup.end())
+			{
+				reportUnknown(attribute->name());
+				continue;
+			}
+
+			found |= uint64_t(1) << it->second;
+			f(mEntries[it->second].key, attribute);
+		}
+
+		if ((found & mRequired) != mRequired) { reportMissing(found); }
+	}
+
+private:
+	void reportUnknown(const std::string& name) const;
+	void reportMissing(uint64_t found) const;
+
+private:
+	std::string								mElement;			/**< Name of the element described by the table. */
+	std::vector<Entry>						mEntries;			/**< Known attributes. */
+	std::unordered_map<std::string, size_t>	mLookup;			/**< Attribute name to index in mEntries. */
+	uint64_t								mRequired = 0;		/**< Bit mask of required entries. */
+
+	mutable std::unordered_set<std::string>	mReported;			/**< Names that have already been reported. */
+};
+
+
+/**
+ * \brief	Declarative binding of savegame attributes to members of a struct.
+ *
+ * \code
+ * struct TileRecord { int x = 0, y = 0; };
+ * static const AttributeSchema<TileRecord> TILE_SCHEMA("tile", { { "x", &TileRecord::x }, { "y", &TileRecord::y } });
+ *
+ * TileRecord tile;
+ * TILE_SCHEMA.read(element, tile);
+ * \endcode
+ */
+template <typename T>
+class AttributeSchema
+{
+public:
+	struct Binding
+	{
+		/** Known attribute that is read elsewhere or ignored. */
+		Binding(const std::string& _name) : name(_name) {}
+		Binding(const std::string& _name, int T::* member, bool _required = false) : name(_name), intMember(member), required(_required) {}
+		Binding(const std::string& _name, std::string T::* member, bool _required = false) : name(_name), stringMember(member), required(_required) {}
+
+		std::string			name;
+		int T::*			intMember = nullptr;
+		std::string T::*	stringMember = nullptr;
+		bool				required = false;
+	};
+
+public:
+	AttributeSchema(const std::string& element, std::initializer_list<Binding> bindings) :
+		mBindings(bindings),
+		mTable(element, makeEntries(bindings))
+	{}
+
+	/**
+	 * Reads the attributes of an element into \c target. Members whose
+	 * attributes are absent are left untouched.
+	 */
+	void read(NAS2D::Xml::XmlElement* element, T& target) const
+	{
+		mTable.read(element, [this, &target](int key, NAS2D::Xml::XmlAttribute* attribute)
+		{
+			const Binding& binding = mBindings[key];
+			if (binding.intMember) { attribute->queryIntValue(target.*binding.intMember); }
+			else if (binding.stringMember) { target.*binding.stringMember = attribute->value(); }
+		});
+	}
+
+private:
+	static std::vector<AttributeTable::Entry> makeEntries(std::initializer_list<Binding> bindings)
+	{
+		std::vector<AttributeTable::Entry> entries;
+		int key = 0;
+		for (const auto& binding : bindings) { entries.emplace_back(binding.name, key++, binding.required); }
+		return entries;
+	}
+
+private:
+	std::vector<Binding>	mBindings;
+	AttributeTable			mTable;
+};
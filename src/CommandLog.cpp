@@ -0,0 +1,284 @@
+// This is an open source non-commercial project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+
+#include "CommandLog.h"
+
+#include "StructureManager.h"
+
+#include "NAS2D/NAS2D.h"
+
+#include <physfs.h>
+
+#include <cstring>
+#include <iostream>
+#include <stdexcept>
+
+using namespace NAS2D;
+
+
+static const char LOG_MAGIC[8] = { 'O', 'P', 'H', 'D', 'L', 'O', 'G', '1' };
+
+/**
+ * Size of a record on disk: type, depth, x, y and value.
+ */
+static const size_t RECORD_SIZE = 1 + 1 + 2 + 2 + 8;
+
+static const std::string LOG_EXTENSION = ".replay";
+
+
+static std::string physfsError()
+{
+	return PHYSFS_getErrorByCode(PHYSFS_getLastErrorCode());
+}
+
+
+/**
+ * Appends an unsigned integer to a buffer in little endian byte order.
+ */
+static void put(std::vector<char>& buffer, uint64_t value, size_t bytes)
+{
+	for (size_t i = 0; i < bytes; ++i)
+	{
+		buffer.push_back(static_cast<char>((value >> (i * 8)) & 0xff));
+	}
+}
+
+
+static void putString(std::vector<char>& buffer, const std::string& value)
+{
+	put(buffer, value.size(), 2);
+	buffer.insert(buffer.end(), value.begin(), value.end());
+}
+
+
+/**
+ * Reads little endian data from a buffer.
+ */
+class LogReader
+{
+public:
+	LogReader(const std::vector<char>& buffer, const std::string& filename) : mBuffer(buffer), mFilename(filename) {}
+
+	size_t remaining() const { return mBuffer.size() - mPosition; }
+
+	uint64_t get(size_t bytes)
+	{
+		need(bytes);
+
+		uint64_t value = 0;
+		for (size_t i = 0; i < bytes; ++i)
+		{
+			value |= static_cast<uint64_t>(static_cast<unsigned char>(mBuffer[mPosition++])) << (i * 8);
+		}
+
+		return value;
+	}
+
+	std::string getString()
+	{
+		size_t length = static_cast<size_t>(get(2));
+		need(length);
+
+		std::string value(mBuffer.data() + mPosition, length);
+		mPosition += length;
+		return value;
+	}
+
+private:
+	void need(size_t bytes)
+	{
+		if (remaining() < bytes) { throw std::runtime_error("Command log '" + mFilename + "' is truncated."); }
+	}
+
+private:
+	const std::vector<char>&	mBuffer;
+	const std::string&			mFilename;
+	size_t						mPosition = 0;
+};
+
+
+/**
+ * D'tor
+ */
+CommandLog::~CommandLog()
+{
+	stop();
+}
+
+
+/**
+ * Starts a new log, replacing the log that was being written if any.
+ *
+ * \param	filename	File to write the log to. Any existing file is overwritten.
+ * \param	header		Description of the game the log starts from.
+ *
+ * \note	Failing to start a log isn't fatal. The game continues without
+ *			recording.
+ * \note	No log is started while recording is suspended so replaying a
+ *			log never overwrites it.
+ */
+void CommandLog::start(const std::string& filename, const CommandLogHeader& header)
+{
+	stop();
+
+	if (mSuspended) { return; }
+
+	mFile = PHYSFS_openWrite(filename.c_str());
+	if (!mFile)
+	{
+		std::cout << "Unable to open command log '" << filename << "': " << physfsError() << std::endl;
+		return;
+	}
+
+	mFilename = filename;
+
+	mBuffer.insert(mBuffer.end(), LOG_MAGIC, LOG_MAGIC + sizeof(LOG_MAGIC));
+	put(mBuffer, header.seed, 8);
+	putString(mBuffer, header.savegame);
+	putString(mBuffer, header.map);
+	putString(mBuffer, header.tileset);
+	put(mBuffer, static_cast<uint32_t>(header.digDepth), 4);
+	put(mBuffer, static_cast<uint32_t>(header.mineCount), 4);
+
+	flush();
+}
+
+
+/**
+ * Writes any buffered records and closes the log.
+ */
+void CommandLog::stop()
+{
+	if (!mFile) { return; }
+
+	flush();
+	PHYSFS_close(mFile);
+
+	mFile = nullptr;
+	mFilename.clear();
+	mBuffer.clear();
+}
+
+
+/**
+ * Records an action on a tile.
+ */
+void CommandLog::record(CommandType type, int x, int y, int depth, uint64_t value)
+{
+	if (!recording()) { return; }
+
+	put(mBuffer, type, 1);
+	put(mBuffer, static_cast<uint8_t>(depth), 1);
+	put(mBuffer, static_cast<uint16_t>(x), 2);
+	put(mBuffer, static_cast<uint16_t>(y), 2);
+	put(mBuffer, value, 8);
+
+	if (type == COMMAND_END_TURN) { flush(); }
+}
+
+
+/**
+ * Records an action on a structure.
+ */
+void CommandLog::record(CommandType type, Structure* structure, uint64_t value)
+{
+	if (!recording()) { return; }
+
+	Tile* tile = Utility<StructureManager>::get().tileFromStructure(structure);
+	if (!tile) { return; }
+
+	record(type, tile->x(), tile->y(), tile->depth(), value);
+}
+
+
+/**
+ * Writes buffered records to disk.
+ *
+ * \note	Write errors stop the recording instead of interrupting the game.
+ */
+void CommandLog::flush()
+{
+	if (!mFile || mBuffer.empty()) { return; }
+
+	if (PHYSFS_writeBytes(mFile, mBuffer.data(), mBuffer.size()) != static_cast<PHYSFS_sint64>(mBuffer.size()) || !PHYSFS_flush(mFile))
+	{
+		std::cout << "Error writing command log '" << mFilename << "': " << physfsError() << std::endl;
+		PHYSFS_close(mFile);
+		mFile = nullptr;
+	}
+
+	mBuffer.clear();
+}
+
+
+/**
+ * Reads a command log.
+ *
+ * \param	filename	Log to read.
+ * \param	commands	Receives the recorded commands.
+ *
+ * \return	Description of the game the log starts from.
+ *
+ * \throws	std::runtime_error if the file can't be read or isn't a command log.
+ *
+ * \note	A partial record at the end of the file, left by a session that
+ *			ended while writing, is ignored.
+ */
+CommandLogHeader CommandLog::read(const std::string& filename, std::vector<Command>& commands)
+{
+	PHYSFS_File* file = PHYSFS_openRead(filename.c_str());
+	if (!file) { throw std::runtime_error("Unable to open command log '" + filename + "': " + physfsError()); }
+
+	std::vector<char> buffer(static_cast<size_t>(PHYSFS_fileLength(file)));
+	PHYSFS_sint64 count = PHYSFS_readBytes(file, buffer.data(), buffer.size());
+	PHYSFS_close(file);
+
+	if (count != static_cast<PHYSFS_sint64>(buffer.size())) { throw std::runtime_error("Error reading command log '" + filename + "'."); }
+
+	if (buffer.size() < sizeof(LOG_MAGIC) || std::memcmp(buffer.data(), LOG_MAGIC, sizeof(LOG_MAGIC)) != 0)
+	{
+		throw std::runtime_error("'" + filename + "' is not a command log.");
+	}
+
+	std::vector<char> body(buffer.begin() + sizeof(LOG_MAGIC), buffer.end());
+	LogReader reader(body, filename);
+
+	CommandLogHeader header;
+	header.seed = reader.get(8);
+	header.savegame = reader.getString();
+	header.map = reader.getString();
+	header.tileset = reader.getString();
+	header.digDepth = static_cast<int>(reader.get(4));
+	header.mineCount = static_cast<int>(reader.get(4));
+
+	commands.clear();
+	commands.reserve(reader.remaining() / RECORD_SIZE);
+	while (reader.remaining() >= RECORD_SIZE)
+	{
+		Command command;
+		command.type = static_cast<CommandType>(reader.get(1));
+		command.depth = static_cast<int>(reader.get(1));
+		command.x = static_cast<int>(reader.get(2));
+		command.y = static_cast<int>(reader.get(2));
+		command.value = reader.get(8);
+
+		if (command.type >= COMMAND_COUNT) { throw std::runtime_error("Command log '" + filename + "' contains an unknown command."); }
+
+		commands.push_back(command);
+	}
+
+	return header;
+}
+
+
+/**
+ * Gets the name of the command log that belongs to a savegame.
+ */
+std::string CommandLog::logFilename(const std::string& savegame)
+{
+	size_t dot = savegame.rfind('.');
+	size_t slash = savegame.rfind('/');
+	if (dot == std::string::npos || (slash != std::string::npos && dot < slash)) { return savegame + LOG_EXTENSION; }
+
+	return savegame.substr(0, dot) + LOG_EXTENSION;
+}
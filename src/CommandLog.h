@@ -0,0 +1,119 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+struct PHYSFS_File;
+class Structure;
+
+
+/**
+ * Player actions that change the game state.
+ */
+enum CommandType : uint8_t
+{
+	COMMAND_PLACE_STRUCTURE,		/**< Value is the StructureID. */
+	COMMAND_PLACE_TUBE,				/**< Value is the ConnectorDir. */
+	COMMAND_PLACE_ROBOT,			/**< Value is the RobotType. Dozers and miners only. */
+	COMMAND_PLACE_DIGGER,			/**< Value is the DiggerDirection::DiggerSelection. */
+	COMMAND_PRODUCT_TYPE,			/**< Value is the ProductType. */
+	COMMAND_FORCE_IDLE,				/**< Value is 1 to idle the structure, 0 to enable it. */
+	COMMAND_MINE_ORE,				/**< Value is the MineOre index shifted left one bit, or'ed with 1 to enable mining it. */
+	COMMAND_EXTEND_MINE,			/**< Value is unused. */
+	COMMAND_END_TURN,				/**< Value is the state hash after the turn. */
+	COMMAND_QUEUE_ROBOT_JOB,		/**< Value is the RobotType, or'ed with the RobotJob::Priority shifted left eight bits. */
+	COMMAND_QUEUE_ROBOT_AREA,		/**< Bulldoze a rectangle. Value is the opposite corner's x, its y shifted left 16 bits and the RobotJob::Priority shifted left 32 bits. */
+	COMMAND_QUEUE_ROBOT_FILL,		/**< Bulldoze the terrain connected to the tile. Value is the RobotJob::Priority. */
+	COMMAND_QUEUE_PRODUCT,			/**< Value is the ProductType, or'ed with 1 shifted left eight bits for a stock order and the count or stock shifted left 16 bits. */
+	COMMAND_CLEAR_PRODUCTION_QUEUE,	/**< Value is unused. */
+
+	COMMAND_COUNT
+};
+
+
+/**
+ * Packs a production order into the value of a COMMAND_QUEUE_PRODUCT command.
+ */
+inline uint64_t queueProductCommandValue(int product, bool stock, int amount)
+{
+	return static_cast<uint64_t>(product) | (stock ? 1ull << 8 : 0) | (static_cast<uint64_t>(amount) << 16);
+}
+
+
+/**
+ * A recorded player action.
+ *
+ * Actions that target a structure or a tile store its position as the
+ * structure itself may not exist yet when the log is replayed.
+ */
+struct Command
+{
+	CommandType		type = COMMAND_END_TURN;
+	int				x = 0;
+	int				y = 0;
+	int				depth = 0;
+	uint64_t		value = 0;
+};
+
+
+/**
+ * Describes the game a command log starts from.
+ */
+struct CommandLogHeader
+{
+	uint64_t		seed = 0;				/**< RandomService seed at the start of the log. */
+	std::string		savegame;				/**< Savegame the log starts from. Empty for a new game. */
+
+	std::string		map;					/**< Site map of a new game. */
+	std::string		tileset;				/**< Tileset of a new game. */
+	int				digDepth = 0;			/**< Maximum dig depth of a new game. */
+	int				mineCount = 0;			/**< Number of mines of a new game. */
+};
+
+
+/**
+ * \brief	Append-only log of the player actions in a session.
+ *
+ * Every action that changes the game state and every turn advance is
+ * recorded as a small fixed size record. Turn records carry a hash of the
+ * game state so a replay can detect the first turn it diverges on.
+ *
+ * A log is started whenever the game state is fixed to a known point,
+ * i.e. when a new game is started, a game is loaded or a game is saved,
+ * and is written next to the savegame it starts from. Records are
+ * buffered and written to disk at the end of every turn.
+ *
+ * \note	Recording is suspended while a log is replayed.
+ */
+class CommandLog
+{
+public:
+	CommandLog() = default;
+	~CommandLog();
+
+	void start(const std::string& filename, const CommandLogHeader& header);
+	void stop();
+
+	bool recording() const { return mFile != nullptr && !mSuspended; }
+	bool suspended() const { return mSuspended; }
+	void suspend(bool suspended) { mSuspended = suspended; }
+
+	void record(CommandType type, int x, int y, int depth, uint64_t value);
+	void record(CommandType type, Structure* structure, uint64_t value);
+
+	void flush();
+
+	static CommandLogHeader read(const std::string& filename, std::vector<Command>& commands);
+	static std::string logFilename(const std::string& savegame);
+
+private:
+	CommandLog(const CommandLog&) = delete;
+	CommandLog& operator=(const CommandLog&) = delete;
+
+private:
+	PHYSFS_File*		mFile = nullptr;			/**< Log being written. */
+	std::string			mFilename;					/**< Name of the log being written. */
+	std::vector<char>	mBuffer;					/**< Records not yet written to disk. */
+	bool				mSuspended = false;			/**< Recording is suspended. */
+};
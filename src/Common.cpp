@@ -2,12 +2,14 @@
 // PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
 
 #include "Common.h"
+#include "CompressedFile.h"
 #include "Constants.h"
 
 #include "Things/Structures/Structure.h"
 
 #include <NAS2D/NAS2D.h>
 
+#include <algorithm>
 #include <iostream>
 
 #if defined(WINDOWS) || defined(WIN32)
@@ -39,6 +41,10 @@ std::map<Structure::StructureState, Color_4ub> STRUCTURE_TEXT_COLOR_TABLE
 };
 
 
+/** Number of alert messages shown since the game started. */
+static int ALERT_MESSAGE_COUNT = 0;
+
+
 std::map<int, std::string> TILE_INDEX_TRANSLATION =
 {
 	{ 0, constants::TILE_INDEX_TRANSLATION_BULLDOZED },
@@ -295,6 +301,8 @@ void doNonFatalErrorMessage(const std::string& title, const std::string& msg)
  */
 void doAlertMessage(const std::string& title, const std::string& msg)
 {
+	++ALERT_MESSAGE_COUNT;
+
 #if defined(WINDOWS) || defined(WIN32)
 	MessageBoxA(WIN32_getWindowHandle(), msg.c_str(), title.c_str(), MB_OK | /*MB_ICONINFORMATION |*/ MB_TASKMODAL);
 #else
@@ -303,6 +311,18 @@ void doAlertMessage(const std::string& title, const std::string& msg)
 }
 
 
+/**
+ * Gets the number of alert messages shown so far.
+ *
+ * Lets long running operations tell that the player was alerted while
+ * they ran.
+ */
+int alertMessageCount()
+{
+	return ALERT_MESSAGE_COUNT;
+}
+
+
 /**
  * Shows a message dialog box with Yes and No buttons.
  */
@@ -347,10 +367,10 @@ bool doYesNoMessage(const std::string& title, const std::string msg)
  */
 void checkSavegameVersion(const std::string& filename)
 {
-	File xmlFile = Utility<Filesystem>::get().open(filename);
+	std::string xml = readCompressedFile(filename);
 
 	NAS2D::Xml::XmlDocument doc;
-	doc.parse(xmlFile.raw_bytes());
+	doc.parse(xml.c_str());
 	if (doc.error())
 	{
 		throw std::runtime_error("Malformed savegame ('" + filename + "'). Error on Row " + std::to_string(doc.errorRow()) + ", Column " + std::to_string(doc.errorCol()) + ": " + doc.errorDesc());
@@ -398,3 +418,30 @@ void drawBasicProgressBar(int x, int y, int width, int height, float percent, in
 												0, 100, 0);
 	}
 }
+
+
+/**
+ * Draws a series of values as a line graph in a box.
+ *
+ * The graph is scaled so its bottom is zero and its top the largest
+ * value of the series.
+ */
+void drawTrendLine(const std::vector<int>& values, float x, float y, float width, float height, const Color_4ub& color)
+{
+	Renderer& r = Utility<Renderer>::get();
+	r.drawBox(x, y, width, height, 0, 185, 0);
+
+	if (values.size() < 2) { return; }
+
+	const float padding = 3.0f;
+	float top = static_cast<float>(std::max(*std::max_element(values.begin(), values.end()), 1));
+	float stepX = (width - padding * 2.0f) / static_cast<float>(values.size() - 1);
+	float scaleY = (height - padding * 2.0f) / top;
+
+	auto pointY = [&](int value) { return y + height - padding - static_cast<float>(std::max(value, 0)) * scaleY; };
+
+	for (size_t i = 1; i < values.size(); ++i)
+	{
+		r.drawLine(x + padding + stepX * (i - 1), pointY(values[i - 1]), x + padding + stepX * i, pointY(values[i]), color.red(), color.green(), color.blue(), color.alpha());
+	}
+}
@@ -264,6 +264,79 @@ enum ProductType
 };
 
 
+/**
+ * Every product that can be built. Tables indexed by ProductType are checked
+ * against this list at compile time.
+ */
+constexpr std::array<ProductType, 9> PRODUCT_TYPES =
+{{
+	PRODUCT_DIGGER,
+	PRODUCT_DOZER,
+	PRODUCT_MINER,
+	PRODUCT_EXPLORER,
+	PRODUCT_TRUCK,
+
+	PRODUCT_ROAD_MATERIALS,
+	PRODUCT_MAINTENANCE_PARTS,
+
+	PRODUCT_CLOTHING,
+	PRODUCT_MEDICINE
+}};
+
+
+/**
+ * Value a table holds for a product. Used to write product tables in a
+ * readable form that makeProductTable() turns into an array.
+ */
+template <typename T>
+struct ProductEntry
+{
+	ProductType		product;
+	T				value;
+};
+
+
+/**
+ * Checks that a list of entries has exactly one entry for every product in
+ * PRODUCT_TYPES and none for anything else.
+ */
+template <typename T, size_t N>
+constexpr bool coversEveryProduct(const ProductEntry<T> (&entries)[N])
+{
+	if (N != PRODUCT_TYPES.size()) { return false; }
+
+	for (ProductType product : PRODUCT_TYPES)
+	{
+		size_t found = 0;
+		for (const ProductEntry<T>& entry : entries)
+		{
+			if (entry.product == product) { ++found; }
+		}
+
+		if (found != 1) { return false; }
+	}
+
+	return true;
+}
+
+
+/**
+ * Turns a list of entries into an array indexed by ProductType. Products
+ * without an entry get a default constructed value.
+ */
+template <typename T, size_t N>
+constexpr std::array<T, PRODUCT_COUNT> makeProductTable(const ProductEntry<T> (&entries)[N])
+{
+	std::array<T, PRODUCT_COUNT> table{};
+	for (const ProductEntry<T>& entry : entries)
+	{
+		table[entry.product] = entry.value;
+	}
+
+	return table;
+}
+
+
 /**
  * Contains population requirements for a given Structure.
  * 
@@ -294,6 +367,7 @@ bool pointInRect_f(int x, int y, float rectX, float rectY, float rectW, float re
 
 void doNonFatalErrorMessage(const std::string& title, const std::string& msg);
 void doAlertMessage(const std::string& title, const std::string& msg);
+int alertMessageCount();
 bool doYesNoMessage(const std::string& title, const std::string msg);
 
 void checkSavegameVersion(const std::string& filename);
@@ -321,6 +395,11 @@ const std::string& idleReason(IdleReason);
  */
 void drawBasicProgressBar(int x, int y, int width, int height, float percent, int padding = 4);
 
+/**
+ * Line graph of a series of values.
+ */
+void drawTrendLine(const std::vector<int>& values, float x, float y, float width, float height, const NAS2D::Color_4ub& color);
+
 NAS2D::Color_4ub& structureColorFromIndex(size_t);
 NAS2D::Color_4ub& structureTextColorFromIndex(size_t);
 
@@ -0,0 +1,420 @@
+// This is an open source non-commercial project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+
+#include "CompressedFile.h"
+
+#include <physfs.h>
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+
+/**
+ * Size of the buffers used for reading, writing and (de)compressing.
+ */
+static const size_t CHUNK_SIZE = 64 * 1024;
+
+/**
+ * Adding 16 to the window bits makes zlib write and expect a gzip
+ * wrapper instead of a zlib one.
+ */
+static const int GZIP_WINDOW_BITS = 15 + 16;
+
+static const unsigned char GZIP_MAGIC[] = { 0x1f, 0x8b };
+static const unsigned char ZSTD_MAGIC[] = { 0x28, 0xb5, 0x2f, 0xfd };
+
+
+static std::string physfsError()
+{
+	return PHYSFS_getErrorByCode(PHYSFS_getLastErrorCode());
+}
+
+
+/**
+ * Gets a CompressionType from its name as used in the configuration file.
+ *
+ * \return	COMPRESSION_NONE for unrecognized names.
+ */
+CompressionType compressionFromString(const std::string& name)
+{
+	if (name == "gzip") { return COMPRESSION_GZIP; }
+	if (name == "zstd") { return COMPRESSION_ZSTD; }
+	return COMPRESSION_NONE;
+}
+
+
+// ==================================================================================
+// = CompressedFileWriter
+// ==================================================================================
+
+/**
+ * C'tor
+ *
+ * \throws	std::runtime_error if the file can't be opened or the
+ *			compressor can't be set up.
+ */
+CompressedFileWriter::CompressedFileWriter(const std::string& filename, CompressionType compression) :
+	mFilename(filename),
+	mCompression(compression)
+{
+	std::memset(&mZStream, 0, sizeof(mZStream));
+
+	#ifndef OPHD_USE_ZSTD
+	if (mCompression == COMPRESSION_ZSTD) { mCompression = COMPRESSION_GZIP; }
+	#endif
+
+	mFile = PHYSFS_openWrite(filename.c_str());
+	if (!mFile)
+	{
+		throw std::runtime_error("Unable to open '" + filename + "' for writing: " + physfsError());
+	}
+
+	if (mCompression == COMPRESSION_NONE) { return; }
+
+	mOutput.resize(CHUNK_SIZE);
+
+	if (mCompression == COMPRESSION_GZIP)
+	{
+		if (deflateInit2(&mZStream, Z_DEFAULT_COMPRESSION, Z_DEFLATED, GZIP_WINDOW_BITS, 8, Z_DEFAULT_STRATEGY) != Z_OK)
+		{
+			PHYSFS_close(mFile);
+			throw std::runtime_error("Unable to initialize compression for '" + filename + "'.");
+		}
+	}
+	#ifdef OPHD_USE_ZSTD
+	else if (mCompression == COMPRESSION_ZSTD)
+	{
+		mZstdStream = ZSTD_createCStream();
+		if (!mZstdStream || ZSTD_isError(ZSTD_initCStream(mZstdStream, ZSTD_CLEVEL_DEFAULT)))
+		{
+			ZSTD_freeCStream(mZstdStream);
+			PHYSFS_close(mFile);
+			throw std::runtime_error("Unable to initialize compression for '" + filename + "'.");
+		}
+	}
+	#endif
+}
+
+
+/**
+ * D'tor
+ *
+ * \note	Closes the file if close() wasn't called. Errors are ignored
+ *			at this point so an incomplete file may be left behind.
+ */
+CompressedFileWriter::~CompressedFileWriter()
+{
+	if (mCompression == COMPRESSION_GZIP) { deflateEnd(&mZStream); }
+
+	#ifdef OPHD_USE_ZSTD
+	ZSTD_freeCStream(mZstdStream);
+	#endif
+
+	if (mFile) { PHYSFS_close(mFile); }
+}
+
+
+/**
+ * Writes data to the file, compressing it as needed.
+ *
+ * \throws	std::runtime_error on write errors.
+ */
+void CompressedFileWriter::write(const char* data, size_t length)
+{
+	switch (mCompression)
+	{
+	case COMPRESSION_GZIP:
+		deflateChunk(data, length, Z_NO_FLUSH);
+		break;
+	#ifdef OPHD_USE_ZSTD
+	case COMPRESSION_ZSTD:
+		zstdChunk(data, length, ZSTD_e_continue);
+		break;
+	#endif
+	default:
+		writeRaw(data, length);
+		break;
+	}
+}
+
+
+/**
+ * Finishes the compressed stream and closes the file.
+ *
+ * \throws	std::runtime_error on write errors.
+ */
+void CompressedFileWriter::close()
+{
+	if (!mFile) { return; }
+
+	if (mCompression == COMPRESSION_GZIP) { deflateChunk(nullptr, 0, Z_FINISH); }
+
+	#ifdef OPHD_USE_ZSTD
+	if (mCompression == COMPRESSION_ZSTD) { zstdChunk(nullptr, 0, ZSTD_e_end); }
+	#endif
+
+	int result = PHYSFS_close(mFile);
+	mFile = nullptr;
+
+	if (result == 0)
+	{
+		throw std::runtime_error("Unable to finish writing '" + mFilename + "': " + physfsError());
+	}
+}
+
+
+void CompressedFileWriter::writeRaw(const char* data, size_t length)
+{
+	if (PHYSFS_writeBytes(mFile, data, length) != static_cast<PHYSFS_sint64>(length))
+	{
+		throw std::runtime_error("Error writing to '" + mFilename + "': " + physfsError());
+	}
+}
+
+
+void CompressedFileWriter::deflateChunk(const char* data, size_t length, int flush)
+{
+	mZStream.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(data));
+	mZStream.avail_in = static_cast<uInt>(length);
+
+	int result = Z_OK;
+	do
+	{
+		mZStream.next_out = reinterpret_cast<Bytef*>(mOutput.data());
+		mZStream.avail_out = static_cast<uInt>(mOutput.size());
+
+		result = deflate(&mZStream, flush);
+		if (result == Z_STREAM_ERROR)
+		{
+			throw std::runtime_error("Error compressing '" + mFilename + "'.");
+		}
+
+		writeRaw(mOutput.data(), mOutput.size() - mZStream.avail_out);
+	} while (mZStream.avail_out == 0 || (flush == Z_FINISH && result != Z_STREAM_END));
+}
+
+
+#ifdef OPHD_USE_ZSTD
+void CompressedFileWriter::zstdChunk(const char* data, size_t length, ZSTD_EndDirective directive)
+{
+	ZSTD_inBuffer input = { data, length, 0 };
+
+	size_t remaining = 0;
+	do
+	{
+		ZSTD_outBuffer output = { mOutput.data(), mOutput.size(), 0 };
+		remaining = ZSTD_compressStream2(mZstdStream, &output, &input, directive);
+		if (ZSTD_isError(remaining))
+		{
+			throw std::runtime_error("Error compressing '" + mFilename + "': " + ZSTD_getErrorName(remaining));
+		}
+
+		writeRaw(mOutput.data(), output.pos);
+	} while (input.pos < input.size || (directive == ZSTD_e_end && remaining != 0));
+}
+#endif
+
+
+// ==================================================================================
+// = CompressedFileReader
+// ==================================================================================
+
+/**
+ * C'tor
+ *
+ * \throws	std::runtime_error if the file can't be opened, is compressed
+ *			in a format not supported by this build or the decompressor
+ *			can't be set up.
+ */
+CompressedFileReader::CompressedFileReader(const std::string& filename) :
+	mFilename(filename),
+	mInput(CHUNK_SIZE)
+{
+	std::memset(&mZStream, 0, sizeof(mZStream));
+
+	mFile = PHYSFS_openRead(filename.c_str());
+	if (!mFile)
+	{
+		throw std::runtime_error("Unable to open '" + filename + "' for reading: " + physfsError());
+	}
+
+	PHYSFS_sint64 fileLength = PHYSFS_fileLength(mFile);
+	fillInput();
+
+	if (mInputLength >= sizeof(GZIP_MAGIC) && std::memcmp(mInput.data(), GZIP_MAGIC, sizeof(GZIP_MAGIC)) == 0)
+	{
+		mCompression = COMPRESSION_GZIP;
+		if (inflateInit2(&mZStream, GZIP_WINDOW_BITS) != Z_OK)
+		{
+			PHYSFS_close(mFile);
+			throw std::runtime_error("Unable to initialize decompression for '" + filename + "'.");
+		}
+
+		// The last four bytes of a gzip file hold the uncompressed size modulo 2^32.
+		unsigned char trailer[4] = { 0 };
+		if (fileLength > 4 && PHYSFS_seek(mFile, fileLength - 4) && PHYSFS_readBytes(mFile, trailer, 4) == 4)
+		{
+			mSizeHint = trailer[0] | (trailer[1] << 8) | (trailer[2] << 16) | (static_cast<size_t>(trailer[3]) << 24);
+		}
+		PHYSFS_seek(mFile, mInputLength);
+	}
+	else if (mInputLength >= sizeof(ZSTD_MAGIC) && std::memcmp(mInput.data(), ZSTD_MAGIC, sizeof(ZSTD_MAGIC)) == 0)
+	{
+		#ifdef OPHD_USE_ZSTD
+		mCompression = COMPRESSION_ZSTD;
+		mZstdStream = ZSTD_createDStream();
+		if (!mZstdStream || ZSTD_isError(ZSTD_initDStream(mZstdStream)))
+		{
+			ZSTD_freeDStream(mZstdStream);
+			PHYSFS_close(mFile);
+			throw std::runtime_error("Unable to initialize decompression for '" + filename + "'.");
+		}
+
+		unsigned long long contentSize = ZSTD_getFrameContentSize(mInput.data(), mInputLength);
+		if (contentSize != ZSTD_CONTENTSIZE_UNKNOWN && contentSize != ZSTD_CONTENTSIZE_ERROR) { mSizeHint = static_cast<size_t>(contentSize); }
+		#else
+		PHYSFS_close(mFile);
+		throw std::runtime_error("'" + filename + "' is compressed with zstd which is not supported by this build.");
+		#endif
+	}
+	else
+	{
+		mSizeHint = fileLength > 0 ? static_cast<size_t>(fileLength) : 0;
+	}
+}
+
+
+/**
+ * D'tor
+ */
+CompressedFileReader::~CompressedFileReader()
+{
+	if (mCompression == COMPRESSION_GZIP) { inflateEnd(&mZStream); }
+
+	#ifdef OPHD_USE_ZSTD
+	ZSTD_freeDStream(mZstdStream);
+	#endif
+
+	PHYSFS_close(mFile);
+}
+
+
+/**
+ * Reads the next chunk of the file into the input buffer.
+ *
+ * \return	False if there's nothing left to read.
+ */
+bool CompressedFileReader::fillInput()
+{
+	PHYSFS_sint64 count = PHYSFS_readBytes(mFile, mInput.data(), mInput.size());
+	if (count < 0)
+	{
+		throw std::runtime_error("Error reading '" + mFilename + "': " + physfsError());
+	}
+
+	mInputPosition = 0;
+	mInputLength = static_cast<size_t>(count);
+	return mInputLength > 0;
+}
+
+
+/**
+ * Reads up to \c length uncompressed bytes.
+ *
+ * \return	Number of bytes read. Less than \c length only at the end
+ *			of the file.
+ *
+ * \throws	std::runtime_error if the file can't be read or the
+ *			compressed data is corrupt.
+ */
+size_t CompressedFileReader::read(char* data, size_t length)
+{
+	size_t total = 0;
+	while (total < length && !mEndOfStream)
+	{
+		bool inputLeft = mInputPosition < mInputLength || fillInput();
+		if (!inputLeft && mCompression == COMPRESSION_NONE)
+		{
+			mEndOfStream = true;
+			break;
+		}
+
+		size_t before = total;
+
+		if (mCompression == COMPRESSION_NONE)
+		{
+			size_t count = std::min(length - total, mInputLength - mInputPosition);
+			std::memcpy(data + total, mInput.data() + mInputPosition, count);
+			mInputPosition += count;
+			total += count;
+		}
+		else if (mCompression == COMPRESSION_GZIP)
+		{
+			mZStream.next_in = reinterpret_cast<Bytef*>(mInput.data() + mInputPosition);
+			mZStream.avail_in = static_cast<uInt>(mInputLength - mInputPosition);
+			mZStream.next_out = reinterpret_cast<Bytef*>(data + total);
+			mZStream.avail_out = static_cast<uInt>(length - total);
+
+			int result = inflate(&mZStream, Z_NO_FLUSH);
+			if (result != Z_OK && result != Z_STREAM_END && result != Z_BUF_ERROR)
+			{
+				throw std::runtime_error("Corrupt compressed data in '" + mFilename + "'.");
+			}
+
+			mInputPosition = mInputLength - mZStream.avail_in;
+			total = length - mZStream.avail_out;
+			mEndOfStream = (result == Z_STREAM_END);
+		}
+		#ifdef OPHD_USE_ZSTD
+		else if (mCompression == COMPRESSION_ZSTD)
+		{
+			ZSTD_inBuffer input = { mInput.data(), mInputLength, mInputPosition };
+			ZSTD_outBuffer output = { data, length, total };
+
+			size_t result = ZSTD_decompressStream(mZstdStream, &output, &input);
+			if (ZSTD_isError(result))
+			{
+				throw std::runtime_error("Corrupt compressed data in '" + mFilename + "': " + ZSTD_getErrorName(result));
+			}
+
+			mInputPosition = input.pos;
+			total = output.pos;
+			mEndOfStream = (result == 0);
+		}
+		#endif
+
+		// The decoder may still hold output once the file is used up. The data is
+		// only cut short if it stops producing any before the end of the stream.
+		if (!inputLeft && !mEndOfStream && total == before)
+		{
+			throw std::runtime_error("Unexpected end of compressed data in '" + mFilename + "'.");
+		}
+	}
+
+	return total;
+}
+
+
+/**
+ * Reads a whole file, decompressing it as needed.
+ *
+ * The file is decompressed in chunks directly into the returned string
+ * so the compressed file is never held in memory as a whole.
+ */
+std::string readCompressedFile(const std::string& filename)
+{
+	CompressedFileReader reader(filename);
+
+	std::string out;
+	out.reserve(reader.sizeHint());
+
+	std::vector<char> chunk(CHUNK_SIZE);
+	size_t count = 0;
+	while ((count = reader.read(chunk.data(), chunk.size())) > 0)
+	{
+		out.append(chunk.data(), count);
+	}
+
+	return out;
+}
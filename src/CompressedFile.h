@@ -0,0 +1,120 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include <zlib.h>
+
+#ifdef OPHD_USE_ZSTD
+#include <zstd.h>
+#endif
+
+struct PHYSFS_File;
+
+
+/**
+ * Compression applied to files written by CompressedFileWriter.
+ */
+enum CompressionType
+{
+	COMPRESSION_NONE,
+	COMPRESSION_GZIP,
+	COMPRESSION_ZSTD
+};
+
+
+CompressionType compressionFromString(const std::string& name);
+
+
+/**
+ * \brief	Writes a file through PhysFS, optionally compressing it.
+ *
+ * Data is compressed as it's written so only a small fixed size buffer
+ * is needed regardless of the size of the file.
+ *
+ * \note	If zstd support isn't compiled in (OPHD_USE_ZSTD), requesting
+ *			COMPRESSION_ZSTD falls back to COMPRESSION_GZIP.
+ */
+class CompressedFileWriter
+{
+public:
+	CompressedFileWriter(const std::string& filename, CompressionType compression);
+	~CompressedFileWriter();
+
+	void write(const char* data, size_t length);
+	void close();
+
+private:
+	CompressedFileWriter() = delete;
+	CompressedFileWriter(const CompressedFileWriter&) = delete;
+	CompressedFileWriter& operator=(const CompressedFileWriter&) = delete;
+
+private:
+	void writeRaw(const char* data, size_t length);
+	void deflateChunk(const char* data, size_t length, int flush);
+#ifdef OPHD_USE_ZSTD
+	void zstdChunk(const char* data, size_t length, ZSTD_EndDirective directive);
+#endif
+
+private:
+	std::string			mFilename;							/**< Name of the file being written. */
+	PHYSFS_File*		mFile = nullptr;					/**< Output file handle. */
+
+	CompressionType		mCompression = COMPRESSION_NONE;	/**< Compression being applied. */
+	std::vector<char>	mOutput;							/**< Compressed output buffer. */
+
+	z_stream			mZStream;							/**< zlib state. */
+#ifdef OPHD_USE_ZSTD
+	ZSTD_CStream*		mZstdStream = nullptr;				/**< zstd state. */
+#endif
+};
+
+
+/**
+ * \brief	Reads a file through PhysFS, decompressing it if needed.
+ *
+ * The compression used is detected from the file's magic bytes so plain
+ * and compressed files can be read interchangeably. The file is read and
+ * decompressed in fixed size chunks.
+ */
+class CompressedFileReader
+{
+public:
+	CompressedFileReader(const std::string& filename);
+	~CompressedFileReader();
+
+	size_t read(char* data, size_t length);
+
+	CompressionType compression() const { return mCompression; }
+	size_t sizeHint() const { return mSizeHint; }
+
+private:
+	CompressedFileReader() = delete;
+	CompressedFileReader(const CompressedFileReader&) = delete;
+	CompressedFileReader& operator=(const CompressedFileReader&) = delete;
+
+private:
+	bool fillInput();
+
+private:
+	std::string			mFilename;							/**< Name of the file being read. */
+	PHYSFS_File*		mFile = nullptr;					/**< Input file handle. */
+
+	CompressionType		mCompression = COMPRESSION_NONE;	/**< Compression detected in the file. */
+	size_t				mSizeHint = 0;						/**< Expected size of the uncompressed data or 0 if not known. */
+
+	std::vector<char>	mInput;								/**< Buffer of data read from the file. */
+	size_t				mInputPosition = 0;					/**< Read position in mInput. */
+	size_t				mInputLength = 0;					/**< Number of valid bytes in mInput. */
+
+	bool				mEndOfStream = false;				/**< All data has been read. */
+
+	z_stream			mZStream;							/**< zlib state. */
+#ifdef OPHD_USE_ZSTD
+	ZSTD_DStream*		mZstdStream = nullptr;				/**< zstd state. */
+#endif
+};
+
+
+std::string readCompressedFile(const std::string& filename);
@@ -29,6 +29,10 @@ namespace constants
 
 	const int MINER_TASK_TIME = 6;
 
+	const int ROBOT_AREA_ORDER_MAX_TILES = 2500;
+	const int ROBOT_TRAVEL_COST_PER_TURN = 10;
+	const int ROBOT_SHAFT_TRAVEL_COST = 5;
+
 	const int COMMAND_CENTER_POPULATION_CAPACITY = 10;
 	const int MINIMUM_RESIDENCE_OVERCAPACITY_HIT = 1;
 
@@ -36,6 +40,28 @@ namespace constants
 
 	const int DEFAULT_STARTING_MORALE = 600;
 
+	const int AUTOSAVE_INTERVAL = 10;
+	const int AUTOSAVE_SLOT_COUNT = 3;
+
+	const int FAST_FORWARD_TURNS = 10;
+	const int FAST_FORWARD_MAX_TURNS = 100;
+	const unsigned int FAST_FORWARD_REDRAW_INTERVAL = 33;
+
+	const unsigned int TURN_WORKER_WAIT = 16;
+
+	const int FORECAST_TURNS = 20;
+	const int PLANNER_TURNS = 250;
+
+	const unsigned int PRELOAD_UPLOADS_PER_FRAME = 4;
+	const unsigned int PRELOAD_WAIT = 16;
+
+	const int ATLAS_PAGE_SIZE = 2048;
+	const int ATLAS_PADDING = 1;
+
+	const unsigned int TEXT_WIDTH_CACHE_SIZE = 4096;
+
+	const int SAVE_GAME_THUMBNAIL_SIZE = 16;
+
 	const int MINIMUM_WINDOW_WIDTH = 1000;
 	const int MINIMUM_WINDOW_HEIGHT = 700;
 
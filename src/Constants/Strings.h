@@ -45,6 +45,8 @@ namespace constants
 	const std::string SAVE_GAME_PATH = "savegames/";
 	const std::string SAVE_GAME_VERSION = "0.30";
 	const std::string SAVE_GAME_ROOT_NODE = "OutpostHD_SaveGame";
+	const std::string SAVE_GAME_AUTOSAVE = "autosave_";
+	const std::string SAVE_GAME_NEW_GAME_LOG = "new_game.replay";
 
 
 	// =====================================
@@ -257,6 +259,11 @@ namespace constants
 	const std::string ALERT_STRUCTURE_IN_WAY = "A " + ROBODIGGER + " cannot be placed on a Structure.";
 
 	const std::string ALERT_OUT_OF_COMM_RANGE = "The selected tile is out of communications range.";
+	const std::string ALERT_ROBOT_UNREACHABLE = "Robots can't reach the selected tile. It's walled in by impassable terrain or there's no air shaft on its level.";
+	const std::string ALERT_ROBOT_AREA_EMPTY = "Nothing in the selected area can be bulldozed.";
+	const std::string ALERT_ROBOT_AREA_QUEUED_TITLE = "Bulldozing Queued";
+	const std::string ALERT_ROBOT_AREA_QUEUED_MESSAGE = "%i tiles were queued for bulldozing. A single " + ROBODOZER + " needs about %i turns to clear them all.\n\n%i tiles in the area were skipped because they're already bulldozed, occupied, impassable or out of communications range.";
+	const std::string ALERT_ROBOT_JOB_INVALID = "Only bulldozing terrain, mining a marked Mine and digging down can be queued for robots.";
 
 	const std::string ALERT_LANDER_LOCATION = "Lander Location";
 	const std::string ALERT_SEED_TERRAIN = "The " + SEED_LANDER + " cannot be placed on or near Impassable terrain.";
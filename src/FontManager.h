@@ -1,5 +1,6 @@
 #pragma once
 
+#include "Constants.h"
 
 #include <NAS2D/NAS2D.h>
 
@@ -10,6 +11,9 @@
  * point size. Any time a font is requested and is found on disk, it is added to the FontManager's
  * font table.
  * 
+ * FontManager also keeps the widths of strings measured with width() so that text drawn
+ * every frame, like labels that are centered or right aligned, isn't measured every frame.
+ * 
  * The FontManager class is intended to be invoked with the NAS2D::Utility object so as to maintain
  * scope throughout the lifetime of a NAS2D application.
  */
@@ -42,7 +46,7 @@ public:
 	 *			table lookups.
 	 * 
 	 * \warning	The pointer returned by font() is owned by FontManager. Do not dispose of the
-	 *			pointer manually.
+	 *			pointer manually. It stays valid for as long as the FontManager does.
 	 */
 	NAS2D::Font* font(const std::string& name, size_t size)
 	{
@@ -59,10 +63,36 @@ public:
 		}
 	}
 
+	/**
+	 * Gets the width of a string in a font. The string is only measured the first time
+	 * its width is asked for.
+	 * 
+	 * \note	The widths are dropped once constants::TEXT_WIDTH_CACHE_SIZE strings are
+	 *			kept so that text that's only drawn once doesn't pile up.
+	 */
+	int width(const NAS2D::Font* font, const std::string& text)
+	{
+		auto it = mWidthTable.find(WidthId(font, text));
+		if (it != mWidthTable.end())
+		{
+			return it->second;
+		}
+
+		if (mWidthTable.size() >= constants::TEXT_WIDTH_CACHE_SIZE) { mWidthTable.clear(); }
+
+		int width = font->width(text);
+		mWidthTable[WidthId(font, text)] = width;
+		return width;
+	}
+
 private:
 	typedef std::pair<std::string, size_t> FontId;
 	typedef std::map<FontId, NAS2D::Font*> FontTable;
 
+	typedef std::pair<const NAS2D::Font*, std::string> WidthId;
+	typedef std::map<WidthId, int> WidthTable;
+
 private:
 	FontTable	mFontTable;
+	WidthTable	mWidthTable;	/**< Widths of strings by font and string. */
 };
@@ -0,0 +1,172 @@
+// This is an open source non-commercial project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+
+#include "Forecast.h"
+
+#include "Constants.h"
+
+#include <algorithm>
+
+
+/**
+ * D'tor
+ *
+ * Stops the forecast in progress, if any.
+ */
+Forecast::~Forecast()
+{
+	{
+		std::lock_guard<std::mutex> lock(mLock);
+		mPending.reset();
+		++mGeneration;
+	}
+
+	if (mThread.joinable()) { mThread.join(); }
+}
+
+
+/**
+ * Requests a forecast.
+ *
+ * Doesn't do anything if the inputs are the same as those of the last
+ * request.
+ */
+void Forecast::request(const Inputs& inputs)
+{
+	std::lock_guard<std::mutex> lock(mLock);
+
+	if (mLastInputs && sameInputs(*mLastInputs, inputs)) { return; }
+
+	mLastInputs.reset(new Inputs(inputs));
+	mPending.reset(new Inputs(inputs));
+	mPendingGeneration = ++mGeneration;
+
+	if (mBusy) { return; }
+
+	// A thread that isn't busy anymore has already let go of the lock.
+	if (mThread.joinable()) { mThread.join(); }
+
+	mBusy = true;
+	mThread = std::thread(&Forecast::run, this);
+}
+
+
+/**
+ * Gets the last finished forecast.
+ */
+Forecast::Result Forecast::result() const
+{
+	std::lock_guard<std::mutex> lock(mLock);
+	return mResult;
+}
+
+
+/**
+ * Drops the current forecast and stops the one in progress, if any.
+ */
+void Forecast::clear()
+{
+	std::lock_guard<std::mutex> lock(mLock);
+
+	mPending.reset();
+	mLastInputs.reset();
+	mResult = Result();
+	++mGeneration;
+}
+
+
+/**
+ * Runs pending forecasts until there are none left.
+ */
+void Forecast::run()
+{
+	for (;;)
+	{
+		std::unique_ptr<Inputs> inputs;
+		unsigned int generation = 0;
+
+		{
+			std::lock_guard<std::mutex> lock(mLock);
+			if (!mPending)
+			{
+				mBusy = false;
+				return;
+			}
+
+			inputs = std::move(mPending);
+			generation = mPendingGeneration;
+		}
+
+		Result result;
+		if (!simulate(*inputs, generation, result)) { continue; }
+
+		std::lock_guard<std::mutex> lock(mLock);
+		if (generation == mGeneration) { mResult = std::move(result); }
+	}
+}
+
+
+/**
+ * Simulates the coming turns in the same order a turn is processed in:
+ * Agridomes fill their stores before the population eats.
+ *
+ * \return	False if the forecast was outdated before it was done.
+ */
+bool Forecast::simulate(Inputs& inputs, unsigned int generation, Result& result)
+{
+	Population& population = inputs.population;
+	int food = inputs.food;
+
+	result.turn = inputs.turn;
+	result.population.reserve(constants::FORECAST_TURNS + 1);
+	result.food.reserve(constants::FORECAST_TURNS + 1);
+
+	result.population.push_back(population.size());
+	result.food.push_back(food);
+
+	for (int turn = 1; turn <= constants::FORECAST_TURNS; ++turn)
+	{
+		if (generation != mGeneration) { return false; }
+
+		food = std::min(food + inputs.foodProduction, std::max(inputs.foodCapacity, food));
+
+		bool populated = population.size() > 0;
+		int consumed = population.update(inputs.morale, food, inputs.residences, inputs.universities, inputs.nurseries, inputs.hospitals);
+
+		// Population::update() claims more food than there is when people starve.
+		if (populated && (food == 0 || consumed > food) && result.starvationTurn == 0) { result.starvationTurn = turn; }
+
+		food -= std::min(consumed, food);
+
+		result.population.push_back(population.size());
+		result.food.push_back(food);
+	}
+
+	return true;
+}
+
+
+/**
+ * Determines if two sets of inputs would give the same forecast.
+ *
+ * The population only changes between turns so its role sizes are enough
+ * to tell populations of the same turn apart.
+ */
+bool Forecast::sameInputs(const Inputs& a, const Inputs& b)
+{
+	for (int role = Population::ROLE_CHILD; role <= Population::ROLE_RETIRED; ++role)
+	{
+		Population::PersonRole personRole = static_cast<Population::PersonRole>(role);
+		if (a.population.size(personRole) != b.population.size(personRole)) { return false; }
+	}
+
+	return a.turn == b.turn &&
+		a.food == b.food &&
+		a.foodCapacity == b.foodCapacity &&
+		a.foodProduction == b.foodProduction &&
+		a.morale == b.morale &&
+		a.residences == b.residences &&
+		a.universities == b.universities &&
+		a.nurseries == b.nurseries &&
+		a.hospitals == b.hospitals;
+}
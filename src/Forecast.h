@@ -0,0 +1,88 @@
+#pragma once
+
+#include "Population/Population.h"
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+
+/**
+ * \brief	Forecasts the population and food stores of the colony.
+ *
+ * A forecast simulates the coming turns on a copy of the population
+ * assuming nothing else changes: morale and the number of operational
+ * facilities stay the same and every operational Agridome keeps producing.
+ *
+ * Forecasts run on a worker thread. request() never waits for it and
+ * result() only holds a lock long enough to copy the last result so
+ * neither ever blocks a frame. A request with the same inputs as the last
+ * one is ignored. A request made while a forecast is running replaces any
+ * request still waiting and is run next.
+ */
+class Forecast
+{
+public:
+	/**
+	 * State of the colony a forecast starts from.
+	 */
+	struct Inputs
+	{
+		Population	population;
+
+		int			turn = 0;
+		int			food = 0;				/**< Food in storage. */
+		int			foodCapacity = 0;		/**< Food storage capacity. */
+		int			foodProduction = 0;		/**< Food produced per turn. */
+		int			morale = 0;
+		int			residences = 0;
+		int			universities = 0;
+		int			nurseries = 0;
+		int			hospitals = 0;
+	};
+
+	/**
+	 * Population and food in storage at the end of each forecast turn. The
+	 * first entry holds the values the forecast started from.
+	 */
+	struct Result
+	{
+		int					turn = 0;					/**< Turn the forecast started on. 0 if there's no forecast. */
+		int					starvationTurn = 0;			/**< Forecast turn food runs out on. 0 if it doesn't. */
+		std::vector<int>	population;
+		std::vector<int>	food;
+	};
+
+public:
+	Forecast() = default;
+	~Forecast();
+
+	void request(const Inputs& inputs);
+	Result result() const;
+
+	bool busy() const { return mBusy; }
+
+	void clear();
+
+private:
+	Forecast(const Forecast&) = delete;
+	Forecast& operator=(const Forecast&) = delete;
+
+	void run();
+	bool simulate(Inputs& inputs, unsigned int generation, Result& result);
+
+	static bool sameInputs(const Inputs& a, const Inputs& b);
+
+private:
+	std::thread					mThread;				/**< Worker thread. */
+	std::atomic<bool>			mBusy{ false };			/**< A forecast is running. */
+	std::atomic<unsigned int>	mGeneration{ 0 };		/**< Bumped by every request and clear() so outdated forecasts stop early. */
+
+	mutable std::mutex			mLock;					/**< Guards everything below. */
+	std::unique_ptr<Inputs>		mPending;				/**< Inputs of the forecast to run next, if any. */
+	unsigned int				mPendingGeneration = 0;	/**< Generation of the pending inputs. */
+	std::unique_ptr<Inputs>		mLastInputs;			/**< Inputs of the last request. */
+	Result						mResult;				/**< Last finished forecast. */
+};
@@ -0,0 +1,70 @@
+// This is an open source non-commercial project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+
+#include "FormattedText.h"
+
+using namespace NAS2D;
+
+
+/**
+ * Gets the text formatted from one value.
+ */
+const std::string& FormattedText::operator()(int value)
+{
+	if (changed(1, value, 0, 0)) { mText = string_format(mFormat, value); }
+
+	return mText;
+}
+
+
+/**
+ * Gets the text formatted from two values.
+ */
+const std::string& FormattedText::operator()(int first, int second)
+{
+	if (changed(2, first, second, 0)) { mText = string_format(mFormat, first, second); }
+
+	return mText;
+}
+
+
+/**
+ * Gets the text formatted from three values.
+ */
+const std::string& FormattedText::operator()(int first, int second, int third)
+{
+	if (changed(3, first, second, third)) { mText = string_format(mFormat, first, second, third); }
+
+	return mText;
+}
+
+
+/**
+ * Gets the width of the text in a font.
+ */
+int FormattedText::width(const Font& font)
+{
+	if (mFont != &font)
+	{
+		mFont = &font;
+		mWidth = font.width(mText);
+	}
+
+	return mWidth;
+}
+
+
+/**
+ * Determines if the values differ from the ones the text was last formatted
+ * from and takes them if they do.
+ */
+bool FormattedText::changed(size_t count, int first, int second, int third)
+{
+	std::array<int, 3> values = {{ first, second, third }};
+	if (count == mCount && values == mValues) { return false; }
+
+	mValues = values;
+	mCount = count;
+	mFont = nullptr;
+	return true;
+}
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <NAS2D/NAS2D.h>
+
+#include <array>
+#include <string>
+
+
+/**
+ * \brief	Text formatted from a few integers that's only formatted again
+ *			when one of them changes.
+ *
+ * Meant for labels that are drawn every frame but whose values only change
+ * a few times per turn, like the numbers of the resource bar. The width of
+ * the text is kept as well and is only measured again when the text or the
+ * font changes.
+ *
+ * \code
+ * static FormattedText FOOD_TEXT("%i/%i");
+ * r.drawText(*font, FOOD_TEXT(food, capacity), x, y, 255, 255, 255);
+ * \endcode
+ */
+class FormattedText
+{
+public:
+	explicit FormattedText(const std::string& format) : mFormat(format) {}
+
+	const std::string& operator()(int value);
+	const std::string& operator()(int first, int second);
+	const std::string& operator()(int first, int second, int third);
+
+	const std::string& text() const { return mText; }
+	int width(const NAS2D::Font& font);
+
+private:
+	bool changed(size_t count, int first, int second, int third);
+
+private:
+	std::string				mFormat;							/**< printf style format the values are formatted with. */
+	std::string				mText;								/**< Text formatted from mValues. */
+
+	std::array<int, 3>		mValues = {{ 0, 0, 0 }};			/**< Values mText was formatted from. */
+	size_t					mCount = 0;							/**< Number of values mText was formatted from. 0 until it's first formatted. */
+
+	const NAS2D::Font*		mFont = nullptr;					/**< Font mWidth was measured with. */
+	int						mWidth = 0;							/**< Width of mText in mFont. */
+};
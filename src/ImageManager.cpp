@@ -0,0 +1,194 @@
+// This is an open source non-commercial project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+
+#include "ImageManager.h"
+
+#include <array>
+
+using namespace NAS2D;
+
+
+/**
+ * Slices of a skin in the order NAS2D::Renderer::drawImageRect() expects them.
+ */
+static const std::array<std::string, 9> SKIN_SLICES =
+{{
+	"_top_left", "_top_middle", "_top_right",
+	"_middle_left", "_middle_middle", "_middle_right",
+	"_bottom_left", "_bottom_middle", "_bottom_right"
+}};
+
+
+/**
+ * Gets a handle to an image given its filename, loading it if it isn't in the
+ * cache yet.
+ */
+ImageManager::ImageHandle ImageManager::image(const std::string& name)
+{
+	auto it = mImageTable.find(name);
+	if (it != mImageTable.end()) { return it->second; }
+
+	ImageHandle handle = std::make_shared<Image>(name);
+	mImageTable[name] = handle;
+	return handle;
+}
+
+
+/**
+ * Gets a handle to a list of images given the filenames of the images in it.
+ */
+ImageManager::ImageListHandle ImageManager::imageList(const std::vector<std::string>& names)
+{
+	auto it = mImageListTable.find(names);
+	if (it != mImageListTable.end()) { return it->second.list; }
+
+	ImageListEntry entry;
+	entry.list = std::make_shared<ImageList>();
+
+	for (const std::string& name : names)
+	{
+		entry.images.push_back(image(name));
+		entry.list->push_back(*entry.images.back());
+	}
+
+	mImageListTable[names] = entry;
+	return entry.list;
+}
+
+
+/**
+ * Gets a handle to the nine slices of a skin.
+ *
+ * \param	name	Filename of the skin without the slice and the extension,
+ *					e.g. "ui/skin/button".
+ * \param	suffix	Part of the filename that follows the slice, e.g. "_highlight".
+ */
+ImageManager::ImageListHandle ImageManager::skin(const std::string& name, const std::string& suffix)
+{
+	return imageList(skinNames(name, suffix));
+}
+
+
+/**
+ * Gets the region of an image given its filename.
+ *
+ * \return	The part of an atlas page the image was packed into or, if it
+ *			wasn't packed, the whole image loaded as it would be by image().
+ */
+ImageRegion ImageManager::region(const std::string& name)
+{
+	ImageRegion packed = mAtlas.region(name);
+	if (packed) { return packed; }
+
+	ImageHandle handle = image(name);
+	return ImageRegion(handle, 0.0f, 0.0f, static_cast<float>(handle->width()), static_cast<float>(handle->height()));
+}
+
+
+/**
+ * Adds an image that was decoded elsewhere to the cache under the filename
+ * it was decoded from.
+ *
+ * \param	pixels	R, G, B, A bytes of every pixel, row by row.
+ *
+ * \return	Handle to the image. If there already was an image with the same
+ *			filename in the cache, the handle is to that image.
+ */
+ImageManager::ImageHandle ImageManager::add(const std::string& name, std::vector<uint8_t>&& pixels, int width, int height)
+{
+	auto it = mImageTable.find(name);
+	if (it != mImageTable.end()) { return it->second; }
+
+	ImageHandle handle = fromPixels(std::move(pixels), width, height);
+	mImageTable[name] = handle;
+	return handle;
+}
+
+
+/**
+ * Stages an image that was decoded elsewhere to be packed into the atlas by
+ * the next buildAtlas().
+ *
+ * \param	pixels	R, G, B, A bytes of every pixel, row by row.
+ */
+void ImageManager::stage(const std::string& name, std::vector<uint8_t>&& pixels, int width, int height)
+{
+	mAtlas.stage(name, std::move(pixels), width, height);
+}
+
+
+/**
+ * Packs the staged images into atlas pages.
+ *
+ * \return	Number of pages built.
+ */
+size_t ImageManager::buildAtlas()
+{
+	return mAtlas.build();
+}
+
+
+/**
+ * Determines if an image is in the cache or in the atlas.
+ */
+bool ImageManager::contains(const std::string& name) const
+{
+	return mImageTable.find(name) != mImageTable.end() || mAtlas.contains(name);
+}
+
+
+/**
+ * Drops the images and image lists nothing holds a handle to anymore.
+ *
+ * \return	Number of images dropped.
+ */
+size_t ImageManager::evict()
+{
+	for (auto it = mImageListTable.begin(); it != mImageListTable.end();)
+	{
+		if (it->second.list.use_count() == 1) { it = mImageListTable.erase(it); }
+		else { ++it; }
+	}
+
+	size_t evicted = 0;
+	for (auto it = mImageTable.begin(); it != mImageTable.end();)
+	{
+		if (it->second.use_count() == 1)
+		{
+			it = mImageTable.erase(it);
+			++evicted;
+		}
+		else { ++it; }
+	}
+
+	return evicted;
+}
+
+
+/**
+ * Gets the filenames of the nine slices of a skin.
+ *
+ * \see		skin()
+ */
+std::vector<std::string> ImageManager::skinNames(const std::string& name, const std::string& suffix)
+{
+	std::vector<std::string> names;
+	for (const std::string& slice : SKIN_SLICES) { names.push_back(name + slice + suffix + ".png"); }
+
+	return names;
+}
+
+
+/**
+ * Makes an image from decoded pixels.
+ *
+ * \param	pixels	R, G, B, A bytes of every pixel, row by row.
+ *
+ * \note	The pixels are kept as long as the image is since NAS2D::Image may
+ *			read the pixels of an image made from a buffer from that buffer.
+ */
+ImageManager::ImageHandle ImageManager::fromPixels(std::vector<uint8_t>&& pixels, int width, int height)
+{
+	auto buffer = std::make_shared<std::vector<uint8_t>>(std::move(pixels));
+	return ImageHandle(new Image(buffer->data(), 4, width, height), [buffer](Image* image) { delete image; });
+}
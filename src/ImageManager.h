@@ -0,0 +1,85 @@
+#pragma once
+
+#include "TextureAtlas.h"
+
+#include <NAS2D/NAS2D.h>
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+
+/**
+ * A shared image cache for NAS2D::Image objects.
+ *
+ * Images are asked for by filename. The first request for an image loads it, every
+ * request after that gets a handle to the same image so that skins and icon sheets
+ * used by many controls are only decoded and uploaded once. Lists of images, like
+ * the nine slices of a skin, are shared the same way.
+ *
+ * Handles are reference counted. An image stays in the cache as long as anything
+ * holds a handle to it and until evict() is called after the last handle is gone.
+ *
+ * Small images that are drawn often can be staged into a TextureAtlas instead.
+ * region() gets the part of an atlas page such an image was packed into, or the
+ * whole image if it wasn't packed.
+ *
+ * The ImageManager class is intended to be invoked with the NAS2D::Utility object so
+ * as to maintain scope throughout the lifetime of a NAS2D application.
+ *
+ * \note	Images are uploaded to the video card when they're loaded so the cache
+ *			may only be used on the main thread.
+ */
+class ImageManager
+{
+public:
+	typedef std::shared_ptr<NAS2D::Image> ImageHandle;
+	typedef std::shared_ptr<NAS2D::ImageList> ImageListHandle;
+
+public:
+	ImageManager() = default;
+	~ImageManager() = default;
+
+	ImageHandle image(const std::string& name);
+	ImageListHandle imageList(const std::vector<std::string>& names);
+	ImageListHandle skin(const std::string& name, const std::string& suffix = "");
+
+	ImageRegion region(const std::string& name);
+
+	ImageHandle add(const std::string& name, std::vector<uint8_t>&& pixels, int width, int height);
+	void stage(const std::string& name, std::vector<uint8_t>&& pixels, int width, int height);
+	size_t buildAtlas();
+
+	bool contains(const std::string& name) const;
+
+	size_t evict();
+
+	size_t size() const { return mImageTable.size(); }
+
+	static std::vector<std::string> skinNames(const std::string& name, const std::string& suffix = "");
+	static ImageHandle fromPixels(std::vector<uint8_t>&& pixels, int width, int height);
+
+private:
+	ImageManager(const ImageManager&) = delete;
+	ImageManager& operator=(const ImageManager&) = delete;
+
+private:
+	/**
+	 * A shared list of images and the handles of the images in it.
+	 */
+	struct ImageListEntry
+	{
+		ImageListHandle				list;
+		std::vector<ImageHandle>	images;		/**< Keeps the images of the list in the cache while the list is. */
+	};
+
+	typedef std::map<std::string, ImageHandle> ImageTable;
+	typedef std::map<std::vector<std::string>, ImageListEntry> ImageListTable;
+
+private:
+	ImageTable		mImageTable;		/**< Images by filename. */
+	ImageListTable	mImageListTable;	/**< Image lists by the filenames of their images. */
+	TextureAtlas	mAtlas;				/**< Pages of packed images. Never evicted. */
+};
@@ -0,0 +1,59 @@
+// This is an open source non-commercial project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+
+#include "Heightmap.h"
+
+#include <NAS2D/NAS2D.h>
+
+#include "SDL_image.h"
+
+#include <stdexcept>
+
+using namespace NAS2D;
+
+
+/**
+ * Height map value range of a terrain index.
+ */
+const uint8_t TERRAIN_HEIGHT_STEP = 50;
+
+
+/**
+ * C'tor
+ *
+ * Decodes the image and quantizes its red channel in one pass over the
+ * pixel rows. The inner loop only divides bytes by a constant so it's
+ * vectorized by the compiler.
+ */
+Heightmap::Heightmap(const std::string& path)
+{
+	File file = Utility<Filesystem>::get().open(path);
+	if (file.empty()) { throw std::runtime_error("Heightmap: Unable to open '" + path + "'."); }
+
+	SDL_Surface* decoded = IMG_Load_RW(SDL_RWFromConstMem(file.raw_bytes(), static_cast<int>(file.size())), 1);
+	if (!decoded) { throw std::runtime_error("Heightmap: Unable to decode '" + path + "': " + IMG_GetError()); }
+
+	// Whatever the format of the file, read the pixels as R, G, B, A bytes.
+	SDL_Surface* surface = SDL_ConvertSurfaceFormat(decoded, SDL_PIXELFORMAT_RGBA32, 0);
+	SDL_FreeSurface(decoded);
+	if (!surface) { throw std::runtime_error("Heightmap: Unable to convert '" + path + "': " + IMG_GetError()); }
+
+	mWidth = surface->w;
+	mHeight = surface->h;
+	mTerrain.resize(static_cast<size_t>(mWidth) * mHeight);
+
+	SDL_LockSurface(surface);
+	for (int y = 0; y < mHeight; ++y)
+	{
+		const uint8_t* pixels = static_cast<const uint8_t*>(surface->pixels) + static_cast<size_t>(y) * surface->pitch;
+		uint8_t* terrain = mTerrain.data() + static_cast<size_t>(y) * mWidth;
+
+		for (int x = 0; x < mWidth; ++x)
+		{
+			terrain[x] = pixels[x * 4] / TERRAIN_HEIGHT_STEP;
+		}
+	}
+	SDL_UnlockSurface(surface);
+
+	SDL_FreeSurface(surface);
+}
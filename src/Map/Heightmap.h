@@ -0,0 +1,32 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+
+/**
+ * \brief	Terrain of a site read from its height map image.
+ *
+ * The image is decoded once into a plain buffer. Height maps are grey
+ * scale so only the red channel is looked at: its value divided by 50 is
+ * the terrain index of the tile, from TERRAIN_DOZED to TERRAIN_IMPASSABLE.
+ */
+class Heightmap
+{
+public:
+	Heightmap(const std::string& path);
+
+	int width() const { return mWidth; }
+	int height() const { return mHeight; }
+
+	/**
+	 * Terrain indices of a row of the height map.
+	 */
+	const uint8_t* row(int y) const { return mTerrain.data() + static_cast<size_t>(y) * mWidth; }
+
+private:
+	int						mWidth = 0;			/**< Width of the image. */
+	int						mHeight = 0;		/**< Height of the image. */
+	std::vector<uint8_t>	mTerrain;			/**< Terrain index of every pixel, row by row. */
+};
@@ -0,0 +1,331 @@
+// This is an open source non-commercial project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+
+#include "PathFinder.h"
+
+#include "TileMap.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <functional>
+#include <limits>
+
+using namespace NAS2D;
+
+
+const int PathFinder::NO_PATH = -1;
+
+/**
+ * Cached cost of a tile that can't be entered.
+ */
+const uint8_t BLOCKED = 0;
+
+/**
+ * Cost of entering a blocked tile at the end of a path.
+ */
+const int BLOCKED_DESTINATION_COST = TERRAIN_IMPASSABLE;
+
+const int UNREACHED = std::numeric_limits<int>::max();
+
+const size_t MAX_FLOW_FIELDS = 16;
+
+const int NEIGHBOR_OFFSETS[4][2] = { { 0, -1 }, { 0, 1 }, { 1, 0 }, { -1, 0 } };
+
+
+/**
+ * C'tor
+ */
+PathFinder::PathFinder(TileMap& tileMap) : mTileMap(tileMap), mWidth(tileMap.width()), mHeight(tileMap.height())
+{
+	mCosts.resize(static_cast<size_t>(mTileMap.maxDepth() + 1));
+
+	for (int depth = 0; depth <= mTileMap.maxDepth(); ++depth)
+	{
+		auto& costs = mCosts[depth];
+		costs.resize(static_cast<size_t>(mWidth * mHeight));
+
+		for (int y = 0; y < mHeight; ++y)
+		{
+			const Tile* row = mTileMap.row(y, depth);
+			for (int x = 0; x < mWidth; ++x) { costs[index(x, y)] = static_cast<uint8_t>(cost(row[x])); }
+		}
+	}
+}
+
+
+/**
+ * Gets the cost of moving onto a tile.
+ *
+ * \return	Cost of the tile's terrain or 0 if the tile can't be entered.
+ */
+int PathFinder::cost(const Tile& tile)
+{
+	if (!tile.excavated() || tile.index() == TERRAIN_IMPASSABLE) { return BLOCKED; }
+
+	// Bulldozed terrain is as easy to cross as clear terrain.
+	return std::max(tile.index(), static_cast<int>(TERRAIN_CLEAR));
+}
+
+
+/**
+ * Finds the cheapest path between two tiles of a level with A*.
+ *
+ * \param	start	Tile the path starts on.
+ * \param	goal	Tile the path ends on.
+ * \param	depth	Level of the tiles.
+ * \param	path	Optional. Receives the tiles of the path from the start to the goal.
+ *
+ * \return	Cost of the path or NO_PATH if the goal can't be reached.
+ */
+int PathFinder::findPath(const Point_2d& start, const Point_2d& goal, int depth, std::vector<Point_2d>* path)
+{
+	if (path) { path->clear(); }
+
+	if (depth < 0 || depth > mTileMap.maxDepth()) { return NO_PATH; }
+	if (start.x() < 0 || start.x() >= mWidth || start.y() < 0 || start.y() >= mHeight) { return NO_PATH; }
+	if (goal.x() < 0 || goal.x() >= mWidth || goal.y() < 0 || goal.y() >= mHeight) { return NO_PATH; }
+
+	const int startIndex = index(start.x(), start.y());
+	const int goalIndex = index(goal.x(), goal.y());
+
+	std::vector<int> costs(static_cast<size_t>(mWidth * mHeight), UNREACHED);
+	std::vector<int> cameFrom(path ? costs.size() : 0, -1);
+
+	// Every step costs at least 1 so the Manhattan distance never overestimates.
+	auto heuristic = [&goal, this](int tile) { return std::abs(tile % mWidth - goal.x()) + std::abs(tile / mWidth - goal.y()); };
+
+	Frontier open;
+	costs[startIndex] = 0;
+	open.push_back(std::make_pair(heuristic(startIndex), startIndex));
+
+	while (!open.empty())
+	{
+		std::pop_heap(open.begin(), open.end(), std::greater<std::pair<int, int>>());
+		int current = open.back().second;
+		int estimate = open.back().first;
+		open.pop_back();
+
+		if (current == goalIndex) { break; }
+		if (estimate - heuristic(current) > costs[current]) { continue; }
+		if (current != startIndex && mCosts[depth][current] == BLOCKED) { continue; }
+
+		int x = current % mWidth, y = current / mWidth;
+		for (const auto& offset : NEIGHBOR_OFFSETS)
+		{
+			int nx = x + offset[0], ny = y + offset[1];
+			if (nx < 0 || nx >= mWidth || ny < 0 || ny >= mHeight) { continue; }
+
+			int next = index(nx, ny);
+			if (mCosts[depth][next] == BLOCKED && next != goalIndex) { continue; }
+
+			int nextCost = costs[current] + enterCost(depth, next);
+			if (nextCost >= costs[next]) { continue; }
+
+			costs[next] = nextCost;
+			if (path) { cameFrom[next] = current; }
+
+			open.push_back(std::make_pair(nextCost + heuristic(next), next));
+			std::push_heap(open.begin(), open.end(), std::greater<std::pair<int, int>>());
+		}
+	}
+
+	if (costs[goalIndex] == UNREACHED) { return NO_PATH; }
+
+	if (path)
+	{
+		for (int tile = goalIndex; tile != -1; tile = cameFrom[tile]) { path->push_back(Point_2d(tile % mWidth, tile / mWidth)); }
+		std::reverse(path->begin(), path->end());
+	}
+
+	return costs[goalIndex];
+}
+
+
+/**
+ * Gets the cost of travelling from a source to a tile of the same level.
+ *
+ * Uses the flow field of the source, building it if needed.
+ *
+ * \return	Cost of the cheapest path or NO_PATH if the tile can't be reached.
+ */
+int PathFinder::travelCost(const Point_2d& source, const Point_2d& destination, int depth)
+{
+	if (depth < 0 || depth > mTileMap.maxDepth()) { return NO_PATH; }
+	if (source.x() < 0 || source.x() >= mWidth || source.y() < 0 || source.y() >= mHeight) { return NO_PATH; }
+	if (destination.x() < 0 || destination.x() >= mWidth || destination.y() < 0 || destination.y() >= mHeight) { return NO_PATH; }
+
+	int cost = field(source, depth).costs[index(destination.x(), destination.y())];
+	return cost == UNREACHED ? NO_PATH : cost;
+}
+
+
+/**
+ * Updates the cached costs of a level from the map and the flow fields
+ * of the level for the tiles that changed.
+ */
+void PathFinder::sync(int depth)
+{
+	if (depth < 0 || depth > mTileMap.maxDepth()) { return; }
+
+	auto& costs = mCosts[depth];
+
+	std::vector<int> cheaper;
+	bool moreExpensive = false;
+
+	for (int y = 0; y < mHeight; ++y)
+	{
+		const Tile* row = mTileMap.row(y, depth);
+		for (int x = 0; x < mWidth; ++x)
+		{
+			int tile = index(x, y);
+			uint8_t updated = static_cast<uint8_t>(cost(row[x]));
+			if (updated == costs[tile]) { continue; }
+
+			int before = enterCost(depth, tile);
+			costs[tile] = updated;
+
+			if (enterCost(depth, tile) < before) { cheaper.push_back(tile); }
+			else { moreExpensive = true; }
+		}
+	}
+
+	if (cheaper.empty() && !moreExpensive) { return; }
+
+	for (auto& field : mFields)
+	{
+		if (field.depth != depth || field.dirty) { continue; }
+
+		if (moreExpensive) { field.dirty = true; }
+		else { repair(field, cheaper); }
+	}
+}
+
+
+/**
+ * Gets the flow field of a source, building it or rebuilding it if needed.
+ */
+PathFinder::FlowField& PathFinder::field(const Point_2d& source, int depth)
+{
+	++mQueries;
+
+	auto it = std::find_if(mFields.begin(), mFields.end(), [&source, depth](const FlowField& field) { return field.x == source.x() && field.y == source.y() && field.depth == depth; });
+
+	if (it == mFields.end())
+	{
+		if (mFields.size() < MAX_FLOW_FIELDS) { it = mFields.insert(mFields.end(), FlowField()); }
+		else { it = std::min_element(mFields.begin(), mFields.end(), [](const FlowField& a, const FlowField& b) { return a.lastUsed < b.lastUsed; }); }
+
+		it->x = source.x();
+		it->y = source.y();
+		it->depth = depth;
+		it->dirty = true;
+	}
+
+	if (it->dirty) { build(*it); }
+
+	it->lastUsed = mQueries;
+	return *it;
+}
+
+
+/**
+ * Builds a flow field from scratch with Dijkstra's algorithm.
+ */
+void PathFinder::build(FlowField& field)
+{
+	field.costs.assign(static_cast<size_t>(mWidth * mHeight), UNREACHED);
+	field.dirty = false;
+
+	int source = index(field.x, field.y);
+	field.costs[source] = 0;
+
+	Frontier frontier;
+	frontier.push_back(std::make_pair(0, source));
+	spread(field, frontier);
+}
+
+
+/**
+ * Lowers the costs of a flow field after tiles got cheaper to enter.
+ *
+ * Costs only ever go down so only the tiles that can now be reached for
+ * less are visited.
+ */
+void PathFinder::repair(FlowField& field, const std::vector<int>& cheaper)
+{
+	Frontier frontier;
+
+	for (int tile : cheaper)
+	{
+		int x = tile % mWidth, y = tile / mWidth;
+		for (const auto& offset : NEIGHBOR_OFFSETS)
+		{
+			int nx = x + offset[0], ny = y + offset[1];
+			if (nx < 0 || nx >= mWidth || ny < 0 || ny >= mHeight) { continue; }
+
+			int neighbor = index(nx, ny);
+			if (field.costs[neighbor] == UNREACHED) { continue; }
+			if (mCosts[field.depth][neighbor] == BLOCKED && neighbor != index(field.x, field.y)) { continue; }
+
+			field.costs[tile] = std::min(field.costs[tile], field.costs[neighbor] + enterCost(field.depth, tile));
+		}
+
+		if (field.costs[tile] != UNREACHED)
+		{
+			frontier.push_back(std::make_pair(field.costs[tile], tile));
+			std::push_heap(frontier.begin(), frontier.end(), std::greater<std::pair<int, int>>());
+		}
+	}
+
+	spread(field, frontier);
+}
+
+
+/**
+ * Runs Dijkstra's algorithm outward from the tiles in a frontier.
+ *
+ * Blocked tiles get a cost so paths can end on them but paths never go
+ * through them.
+ */
+void PathFinder::spread(FlowField& field, Frontier& frontier)
+{
+	const int source = index(field.x, field.y);
+	const auto& costs = mCosts[field.depth];
+
+	while (!frontier.empty())
+	{
+		std::pop_heap(frontier.begin(), frontier.end(), std::greater<std::pair<int, int>>());
+		int cost = frontier.back().first;
+		int current = frontier.back().second;
+		frontier.pop_back();
+
+		if (cost > field.costs[current]) { continue; }
+		if (costs[current] == BLOCKED && current != source) { continue; }
+
+		int x = current % mWidth, y = current / mWidth;
+		for (const auto& offset : NEIGHBOR_OFFSETS)
+		{
+			int nx = x + offset[0], ny = y + offset[1];
+			if (nx < 0 || nx >= mWidth || ny < 0 || ny >= mHeight) { continue; }
+
+			int next = index(nx, ny);
+			int nextCost = cost + enterCost(field.depth, next);
+			if (nextCost >= field.costs[next]) { continue; }
+
+			field.costs[next] = nextCost;
+			frontier.push_back(std::make_pair(nextCost, next));
+			std::push_heap(frontier.begin(), frontier.end(), std::greater<std::pair<int, int>>());
+		}
+	}
+}
+
+
+/**
+ * Gets the cost of entering a tile. Blocked tiles can only be entered at
+ * the end of a path.
+ */
+int PathFinder::enterCost(int depth, int tile) const
+{
+	uint8_t cost = mCosts[depth][tile];
+	return cost == BLOCKED ? BLOCKED_DESTINATION_COST : cost;
+}
@@ -0,0 +1,84 @@
+#pragma once
+
+#include "NAS2D/NAS2D.h"
+
+#include <cstdint>
+#include <vector>
+
+class Tile;
+class TileMap;
+
+
+/**
+ * \brief	Finds paths for robots over the terrain of a TileMap.
+ *
+ * Moving onto a tile costs more the rougher its terrain is. Impassable
+ * terrain and tiles that haven't been excavated can't be entered. Every
+ * level of the map is pathed on separately.
+ *
+ * The last tile of a path is always reachable so robots can get to
+ * impassable terrain that they're going to work on.
+ *
+ * Single queries are answered with A*. Places that robots often leave
+ * from, like the Command Center and Robot Command Centers, get a flow
+ * field that holds the cost of reaching every tile of its level from
+ * there so a query is a lookup.
+ *
+ * Terrain costs are cached per level. sync() compares the cache to the
+ * map and updates the flow fields of a level for the tiles that changed:
+ * tiles that got cheaper are repaired in place and fields where a tile
+ * got more expensive are rebuilt the next time they're used.
+ */
+class PathFinder
+{
+public:
+	static const int NO_PATH;
+
+public:
+	PathFinder(TileMap& tileMap);
+
+	static int cost(const Tile& tile);
+
+	int findPath(const NAS2D::Point_2d& start, const NAS2D::Point_2d& goal, int depth, std::vector<NAS2D::Point_2d>* path = nullptr);
+	int travelCost(const NAS2D::Point_2d& source, const NAS2D::Point_2d& destination, int depth);
+
+	void sync(int depth);
+
+private:
+	/**
+	 * Cost of reaching every tile of a level from a source.
+	 */
+	struct FlowField
+	{
+		int					x = 0;
+		int					y = 0;
+		int					depth = 0;
+		bool				dirty = false;		/**< A tile got more expensive since the field was built. */
+		uint32_t			lastUsed = 0;		/**< Query counter value of the last time the field was used. */
+		std::vector<int>	costs;				/**< Cost of reaching each tile from the source. */
+	};
+
+	using Frontier = std::vector<std::pair<int, int>>;	/**< Min heap of costs and tile indices. */
+
+private:
+	PathFinder(const PathFinder&) = delete;
+	PathFinder& operator=(const PathFinder&) = delete;
+
+	FlowField& field(const NAS2D::Point_2d& source, int depth);
+	void build(FlowField& field);
+	void repair(FlowField& field, const std::vector<int>& cheaper);
+	void spread(FlowField& field, Frontier& frontier);
+
+	int enterCost(int depth, int tile) const;
+
+	int index(int x, int y) const { return y * mWidth + x; }
+
+private:
+	TileMap&						mTileMap;			/**< Map being pathed over. */
+	int								mWidth = 0;			/**< Width of the map. */
+	int								mHeight = 0;		/**< Height of the map. */
+
+	std::vector<std::vector<uint8_t>>	mCosts;			/**< Cached terrain costs of every level. */
+	std::vector<FlowField>			mFields;			/**< Flow fields, least recently used ones are replaced first. */
+	uint32_t						mQueries = 0;		/**< Number of flow field queries. */
+};
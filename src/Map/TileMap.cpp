@@ -3,11 +3,16 @@
 
 #include "TileMap.h"
 
+#include "Heightmap.h"
+
+#include "../AttributeSchema.h"
 #include "../Constants.h"
+#include "../Random.h"
+#include "../SaveGameSnapshot.h"
+#include "../StateHash.h"
 
 #include <algorithm>
-#include <functional>
-#include <random>
+#include <future>
 
 using namespace NAS2D;
 using namespace NAS2D::Xml;
@@ -33,6 +38,10 @@ const int			TILE_HEIGHT_HALF_ABSOLUTE	= TILE_HEIGHT_ABSOLUTE / 2;
 
 const double		THROB_SPEED					= 250.0f; // Throb speed of mine beacon
 
+const int			MINE_BORDER					= 5;		/**< Mines aren't placed closer than this to the edges of the map. */
+const int			MINE_SPACING				= 10;		/**< Preferred least distance between mines in tiles. */
+const int			MINE_PLACEMENT_ATTEMPTS		= 30;		/**< Candidates drawn per mine before the spacing is relaxed. */
+
 
 // ===============================================================================
 // = LOCAL VARIABLES
@@ -40,19 +49,6 @@ const double		THROB_SPEED					= 250.0f; // Throb speed of mine beacon
 Point_2d			TRANSFORM; /**< Used to adjust mouse and screen spaces based on position of the map field. */
 
 
-// ===============================================================================
-// = RANDOM NUMBER GENERATION
-// ===============================================================================
-std::random_device rd;
-std::mt19937 generator(rd());
-std::uniform_int_distribution<int> map_width(5, MAP_WIDTH - 5);
-std::uniform_int_distribution<int> map_height(5, MAP_HEIGHT - 5);
-std::uniform_int_distribution<int> mine_yield(0, 100);
-
-auto mwidth = std::bind(map_width, std::ref(generator));
-auto mheight = std::bind(map_height, std::ref(generator));
-auto myield = std::bind(mine_yield, std::ref(generator));
-
 
 /**
  * C'tor
@@ -60,15 +56,15 @@ auto myield = std::bind(mine_yield, std::ref(generator));
 TileMap::TileMap(const std::string& map_path, const std::string& tset_path, int _md, int _mc, bool _s) :
 	mWidth(MAP_WIDTH), mHeight(MAP_HEIGHT),	mMaxDepth(_md),
 	mMapPath(map_path), mTsetPath(tset_path),
-	mTileset(tset_path),
-	mMineBeacon("structures/mine_beacon.png")
+	mTileset(Utility<ImageManager>::get().image(tset_path)),
+	mMineBeacon(Utility<ImageManager>::get().region("structures/mine_beacon.png"))
 {
 	std::cout << "Loading '" << map_path << "'... ";
 	buildTerrainMap(map_path);
 	buildMouseMap();
 	initMapDrawParams(Utility<Renderer>::get().width(), Utility<Renderer>::get().height());
 
-	if (_s) { setupMines(_mc); }
+	if (_s) { setupMines(_mc, MINE_SPACING); }
 	std::cout << "finished!" << std::endl;
 }
 
@@ -111,72 +107,196 @@ void TileMap::buildTerrainMap(const std::string& path)
 		throw std::runtime_error("Given map file does not exist.");
 	}
 
-	Image heightmap(path + MAP_TERRAIN_EXTENSION);
+	Heightmap heightmap(path + MAP_TERRAIN_EXTENSION);
+	if (heightmap.width() < width() || heightmap.height() < height())
+	{
+		throw std::runtime_error("Height map is smaller than the map.");
+	}
 
-	mTileMap.resize(mMaxDepth + 1);
-	for(int level = 0; level <= mMaxDepth; level++)
+	/**
+	 * Every level has the terrain of the height map. Levels only touch their
+	 * own tiles so they're built at the same time, one per thread.
+	 */
+	auto buildLevel = [this, &heightmap](int depth)
 	{
-		mTileMap[level].resize(height());
-		for (size_t i = 0; i < mTileMap[level].size(); i++)
+		TileGrid& level = mTileMap[depth];
+		level.resize(height());
+
+		for (int row = 0; row < height(); row++)
 		{
-			mTileMap[level][i].resize(width());
+			level[row].resize(width());
+			const uint8_t* terrain = heightmap.row(row);
+
+			for (int col = 0; col < width(); col++)
+			{
+				Tile& t = level[row][col];
+				t.init(col, row, depth, terrain[col]);
+				if (depth > 0) { t.excavated(false); }
+			}
 		}
-	}
+	};
+
+	mTileMap.resize(mMaxDepth + 1);
+
+	// Futures from std::async wait for their worker when they're destroyed so
+	// every worker is finished before this returns, even if a level throws.
+	// Errors from the workers are rethrown by get().
+	std::vector<std::future<void>> workers;
+	for (int depth = 1; depth <= mMaxDepth; depth++) { workers.push_back(std::async(std::launch::async, buildLevel, depth)); }
+
+	buildLevel(0);
+	for (auto& worker : workers) { worker.get(); }
+}
+
+
+/**
+ * Grid of cells that are too small to hold more than one mine at a given
+ * spacing so checking the spacing of a point only looks at the few cells
+ * around it.
+ */
+class MineGrid
+{
+public:
+	MineGrid(int width, int height, int spacing) :
+		mSpacing(spacing),
+		mCellSize(std::max(static_cast<int>(spacing / 1.41421356), 1)),
+		mReach((spacing + mCellSize - 1) / mCellSize),
+		mColumns(width / mCellSize + 1),
+		mCells(static_cast<size_t>(mColumns * (height / mCellSize + 1)), Point_2d(-1, -1))
+	{}
 
 	/**
-	 * Builds a terrain map based on the pixel color values in
-	 * a maps height map.
-	 * 
-	 * Height maps by default are in grey-scale. This method assumes
-	 * that all channels are the same value so it only looks at the red.
-	 * Color values are divided by 50 to get a height value from 1 - 4.
+	 * Determines if a point is at least the spacing away from every point
+	 * in the grid.
 	 */
-	for(int depth = 0; depth <= mMaxDepth; depth++)
+	bool fits(const Point_2d& pt) const
 	{
-		for(int row = 0; row < height(); row++)
+		int rows = static_cast<int>(mCells.size()) / mColumns;
+		int column = pt.x() / mCellSize, row = pt.y() / mCellSize;
+
+		for (int y = std::max(row - mReach, 0); y <= std::min(row + mReach, rows - 1); ++y)
 		{
-			for(int col = 0; col < width(); col++)
+			for (int x = std::max(column - mReach, 0); x <= std::min(column + mReach, mColumns - 1); ++x)
 			{
-				Color_4ub c = heightmap.pixelColor(col, row);
-				Tile& t = mTileMap[depth][row][col];
-				t.init(col, row, depth, c.red() / 50);
-				if (depth > 0) { t.excavated(false); }
+				const Point_2d& other = mCells[y * mColumns + x];
+				if (other.x() < 0) { continue; }
+
+				int dx = other.x() - pt.x(), dy = other.y() - pt.y();
+				if (dx * dx + dy * dy < mSpacing * mSpacing) { return false; }
 			}
 		}
+
+		return true;
 	}
-}
+
+	void insert(const Point_2d& pt) { mCells[(pt.y() / mCellSize) * mColumns + pt.x() / mCellSize] = pt; }
+
+private:
+	int						mSpacing;		/**< Least distance between points. */
+	int						mCellSize;		/**< Width and height of a cell in tiles. */
+	int						mReach;			/**< Cells in each direction that can hold a point within the spacing. */
+	int						mColumns;		/**< Width of the grid in cells. */
+	std::vector<Point_2d>	mCells;			/**< Point in each cell. Empty cells hold (-1, -1). */
+};
 
 
 /**
  * Creates mining locations around the map area.
+ *
+ * Locations are drawn at random weighted by terrain, rougher terrain is
+ * more likely to hold a mine, and kept at least \c spacing tiles apart.
+ * Every mine gets a fixed number of draws. When they run out the spacing
+ * is halved and placement goes on, so the time taken is bounded by the
+ * number of mines no matter how crowded the map gets. If even adjacent
+ * mines don't fit anymore the remaining mines go to the first free tiles
+ * left.
+ *
+ * Draws come from the "map" stream of the RandomService so a seed always
+ * places the same mines.
  */
-void TileMap::setupMines(int mineCount)
+void TileMap::setupMines(int mineCount, int spacing)
 {
-	int i = 0;
-	while(i < mineCount)
+	Xoshiro256& random = Utility<RandomService>::get().stream("map");
+
+	// Candidate tiles grouped by terrain. A tile's weight is its terrain index.
+	std::array<Point2dList, TERRAIN_IMPASSABLE + 1> candidates;
+	for (int y = MINE_BORDER; y <= height() - MINE_BORDER; ++y)
+	{
+		for (int x = MINE_BORDER; x <= width() - MINE_BORDER; ++x)
+		{
+			candidates[mTileMap[0][y][x].index()].push_back(Point_2d(x, y));
+		}
+	}
+
+	std::array<int, TERRAIN_IMPASSABLE + 1> weights;
+	int totalWeight = 0;
+	for (size_t i = 0; i < candidates.size(); ++i)
+	{
+		weights[i] = static_cast<int>(i);
+		totalWeight += weights[i] * static_cast<int>(candidates[i].size());
+	}
+
+	// Bulldozed terrain only gets mines when there's nothing else.
+	if (totalWeight == 0)
+	{
+		weights[TERRAIN_DOZED] = 1;
+		totalWeight = static_cast<int>(candidates[TERRAIN_DOZED].size());
+	}
+
+	if (totalWeight == 0) { return; }
+
+	// One draw picks a terrain with a chance proportional to its total weight and a tile of that terrain.
+	auto draw = [&]()
+	{
+		int value = random.range(0, totalWeight - 1);
+		for (size_t i = 0; i < candidates.size(); ++i)
+		{
+			int terrainWeight = weights[i] * static_cast<int>(candidates[i].size());
+			if (value < terrainWeight) { return candidates[i][value / weights[i]]; }
+			value -= terrainWeight;
+		}
+
+		return Point_2d(MINE_BORDER, MINE_BORDER);
+	};
+
+	auto place = [&](const Point_2d& pt)
+	{
+		int rate = random.range(0, 99);
+
+		Mine* m = nullptr;
+		if (rate < 60) { m = new Mine(PRODUCTION_RATE_MEDIUM); }
+		else if (rate < 72) { m = new Mine(PRODUCTION_RATE_HIGH); }
+		else { m = new Mine(PRODUCTION_RATE_LOW); }
+
+		mTileMap[0][pt.y()][pt.x()].pushMine(m);
+		mTileMap[0][pt.y()][pt.x()].index(TERRAIN_DOZED);
+
+		mMineLocations.push_back(pt);
+	};
+
+	for (; spacing > 0 && static_cast<int>(mMineLocations.size()) < mineCount; spacing /= 2)
 	{
-		Point_2d pt(mwidth(), mheight());
+		MineGrid grid(width(), height(), spacing);
+		for (const auto& pt : mMineLocations) { grid.insert(pt); }
 
-		
-		if (mTileMap[0][pt.y()][pt.x()].mine()) { continue; } // Ugly
+		for (int attempts = (mineCount - static_cast<int>(mMineLocations.size())) * MINE_PLACEMENT_ATTEMPTS; attempts > 0; --attempts)
+		{
+			Point_2d pt = draw();
+			if (!grid.fits(pt)) { continue; }
+
+			grid.insert(pt);
+			place(pt);
 
-		float probability = 0.05f * mTileMap[0][pt.y()][pt.x()].index();
+			if (static_cast<int>(mMineLocations.size()) == mineCount) { break; }
+		}
+	}
 
-		if(myield() <= (int)(probability * 100))
+	for (int i = static_cast<int>(candidates.size()) - 1; i >= 0; --i)
+	{
+		for (const auto& pt : candidates[i])
 		{
-			Mine* m = nullptr;
-			
-			// Choose a production rate
-			// FIXME: Kind of a naive approach to this... would be nice to weight things better.
-			if (myield() < 60) { m = new Mine(PRODUCTION_RATE_MEDIUM); }
-			else if (myield() < 30) { m = new Mine(PRODUCTION_RATE_HIGH); }
-			else { m = new Mine(PRODUCTION_RATE_LOW); }
-			
-			mTileMap[0][pt.y()][pt.x()].pushMine(m);
-			mTileMap[0][pt.y()][pt.x()].index(TERRAIN_DOZED);
-
-			mMineLocations.push_back(pt);
-			++i;
+			if (static_cast<int>(mMineLocations.size()) == mineCount) { return; }
+			if (!mTileMap[0][pt.y()][pt.x()].mine()) { place(pt); }
 		}
 	}
 }
@@ -270,8 +390,6 @@ bool TileMap::tileHighlightVisible() const
 
 void TileMap::draw()
 {
-	Renderer& r = Utility<Renderer>::get();
-
 	int x = 0, y = 0;
 	Tile* tile = nullptr;
 
@@ -288,39 +406,10 @@ void TileMap::draw()
 
 			if(tile->excavated())
 			{
-				if (row == mMapHighlight.y() && col == mMapHighlight.x())
-				{
-					if (mShowConnections && tile->connected())
-					{
-						r.drawSubImage(mTileset, x, y, tile->index() * TILE_WIDTH, tsetOffset, TILE_WIDTH, TILE_HEIGHT, 71, 224, 146, 255);
-					}
-					else
-					{
-						r.drawSubImage(mTileset, x, y, tile->index() * TILE_WIDTH, tsetOffset, TILE_WIDTH, TILE_HEIGHT, 125, 200, 255, 255);
-					}
-				}
-				else
-				{
-					if (mShowConnections && tile->connected())
-					{
-						r.drawSubImage(mTileset, x, y, tile->index() * TILE_WIDTH, tsetOffset, TILE_WIDTH, TILE_HEIGHT, 0, 255, 0, 255);
-					}
-					else
-					{
-						r.drawSubImage(mTileset, x, y, tile->index() * TILE_WIDTH, tsetOffset, TILE_WIDTH, TILE_HEIGHT);
-					}
-				}
+				drawTerrain(x, y, tile->index(), tsetOffset, tile->connected(), row == mMapHighlight.y() && col == mMapHighlight.x());
 
 				// Draw a beacon on an unoccupied tile with a mine
-				if (tile->mine() != nullptr && !tile->thing())
-				{
-					int glow = 120 + sin(mTimer.tick() / THROB_SPEED) * 57;
-					int loc_x = x + TILE_HALF_WIDTH - 6;
-					int loc_y = y + 15;
-
-					r.drawImage(mMineBeacon, loc_x, loc_y);
-					r.drawSubImage(mMineBeacon, loc_x, loc_y, 0, 0, 10, 5, glow, glow, glow, 255);
-				}
+				if (tile->mine() != nullptr && !tile->thing()) { drawMineBeacon(x, y); }
 
 				// Tell an occupying thing to update itself.
 				if (tile->thing()) { tile->thing()->sprite().update(x, y); }
@@ -332,6 +421,117 @@ void TileMap::draw()
 }
 
 
+/**
+ * Draws the tiles in view from a snapshot instead of from the map.
+ *
+ * The sprites of the snapshot keep animating. Where the view is drawn is
+ * taken from the snapshot so it still lines up after the window is resized.
+ */
+void TileMap::draw(ViewSnapshot& view)
+{
+	int tsetOffset = view.depth > 0 ? TILE_HEIGHT : 0;
+
+	for (int row = 0; row < view.edgeLength; row++)
+	{
+		for (int col = 0; col < view.edgeLength; col++)
+		{
+			int x = view.mapPosition.x() + ((col - row) * TILE_HALF_WIDTH);
+			int y = view.mapPosition.y() + ((col + row) * TILE_HEIGHT_HALF_ABSOLUTE);
+
+			auto& tile = view.tiles[static_cast<size_t>(row * view.edgeLength + col)];
+			if (!tile.excavated) { continue; }
+
+			drawTerrain(x, y, tile.index, tsetOffset, tile.connected, row == mMapHighlight.y() && col == mMapHighlight.x());
+
+			if (tile.mineBeacon) { drawMineBeacon(x, y); }
+			if (tile.occupied) { tile.sprite.update(x, y); }
+		}
+	}
+
+	updateTileHighlight();
+}
+
+
+/**
+ * Copies what's drawn of the tiles in view.
+ */
+void TileMap::snapshot(ViewSnapshot& view)
+{
+	view.depth = mCurrentDepth;
+	view.edgeLength = mEdgeLength;
+	view.mapPosition = mMapPosition;
+
+	view.tiles.clear();
+	view.tiles.resize(static_cast<size_t>(mEdgeLength * mEdgeLength));
+
+	for (int row = 0; row < mEdgeLength; row++)
+	{
+		for (int col = 0; col < mEdgeLength; col++)
+		{
+			Tile& tile = mTileMap[mCurrentDepth][row + mMapViewLocation.y()][col + mMapViewLocation.x()];
+			auto& tileView = view.tiles[static_cast<size_t>(row * mEdgeLength + col)];
+
+			tileView.index = tile.index();
+			tileView.excavated = tile.excavated();
+			tileView.connected = tile.connected();
+			tileView.mineBeacon = tile.mine() != nullptr && !tile.thing();
+			tileView.occupied = tile.thing() != nullptr;
+
+			if (tileView.occupied) { tileView.sprite = tile.thing()->sprite(); }
+		}
+	}
+}
+
+
+/**
+ * Draws the terrain of a tile tinted for the tile highlight and the
+ * connectedness overlay.
+ */
+void TileMap::drawTerrain(int x, int y, int index, int tsetOffset, bool connected, bool highlighted)
+{
+	Renderer& r = Utility<Renderer>::get();
+
+	if (highlighted)
+	{
+		if (mShowConnections && connected)
+		{
+			r.drawSubImage(*mTileset, x, y, index * TILE_WIDTH, tsetOffset, TILE_WIDTH, TILE_HEIGHT, 71, 224, 146, 255);
+		}
+		else
+		{
+			r.drawSubImage(*mTileset, x, y, index * TILE_WIDTH, tsetOffset, TILE_WIDTH, TILE_HEIGHT, 125, 200, 255, 255);
+		}
+	}
+	else
+	{
+		if (mShowConnections && connected)
+		{
+			r.drawSubImage(*mTileset, x, y, index * TILE_WIDTH, tsetOffset, TILE_WIDTH, TILE_HEIGHT, 0, 255, 0, 255);
+		}
+		else
+		{
+			r.drawSubImage(*mTileset, x, y, index * TILE_WIDTH, tsetOffset, TILE_WIDTH, TILE_HEIGHT);
+		}
+	}
+}
+
+
+/**
+ * Draws the throbbing beacon of a mine.
+ */
+void TileMap::drawMineBeacon(int x, int y)
+{
+	Renderer& r = Utility<Renderer>::get();
+
+	int glow = 120 + sin(mTimer.tick() / THROB_SPEED) * 57;
+	int loc_x = x + TILE_HALF_WIDTH - 6;
+	int loc_y = y + 15;
+
+	mMineBeacon.draw(r, loc_x, loc_y);
+	mMineBeacon.drawSub(r, loc_x, loc_y, 0, 0, 10, 5, glow, glow, glow, 255);
+}
+
+
 /**
  * Brute Force but works.
  */
@@ -390,61 +590,49 @@ TileMap::MouseMapRegion TileMap::getMouseMapRegion(int x, int y)
 }
 
 
-static void serializeTile(XmlElement* _ti, int x, int y, int depth, int index)
+static void serializeTile(SaveGameSnapshot& _w, int x, int y, int depth, int index)
 {
-	XmlElement* t = new XmlElement("tile");
-	t->attribute("x", x);
-	t->attribute("y", y);
-	t->attribute("depth", depth);
-	t->attribute("index", index);
-
-	_ti->linkEndChild(t);
+	_w.openElement("tile");
+	_w.attribute("x", x);
+	_w.attribute("y", y);
+	_w.attribute("depth", depth);
+	_w.attribute("index", index);
+	_w.closeElement();
 }
 
 
-void TileMap::serialize(XmlElement* _ti)
+void TileMap::serialize(SaveGameSnapshot& _w)
 {
 	// ==========================================
 	// MAP PROPERTIES
 	// ==========================================
-	XmlElement *properties = new XmlElement("properties");
-	_ti->linkEndChild(properties);
-
-	properties->attribute("sitemap", mMapPath);
-	properties->attribute("tset", mTsetPath);
-	properties->attribute("diggingdepth", mMaxDepth);
-
-	// ==========================================
-	// VIEW PARAMETERS
-	// ==========================================
-	XmlElement *viewparams = new XmlElement("view_parameters");
-	_ti->linkEndChild(viewparams);
-
-	viewparams->attribute("currentdepth", mCurrentDepth);
-	viewparams->attribute("viewlocation_x", mMapViewLocation.x());
-	viewparams->attribute("viewlocation_y", mMapViewLocation.y());
+	_w.openElement("properties");
+	_w.attribute("sitemap", mMapPath);
+	_w.attribute("tset", mTsetPath);
+	_w.attribute("diggingdepth", mMaxDepth);
+	_w.closeElement();
 
 	// ==========================================
 	// MINES
 	// ==========================================
-	XmlElement *mines = new XmlElement("mines");
-	_ti->linkEndChild(mines);
+	_w.openElement("mines");
 
 	for (size_t i = 0; i < mMineLocations.size(); ++i)
 	{
-		XmlElement *mine = new XmlElement("mine");
-		mine->attribute("x", mMineLocations[i].x());
-		mine->attribute("y", mMineLocations[i].y());
-		getTile(mMineLocations[i].x(), mMineLocations[i].y(), LEVEL_SURFACE)->mine()->serialize(mine);
-		mines->linkEndChild(mine);
+		_w.openElement("mine");
+		_w.attribute("x", mMineLocations[i].x());
+		_w.attribute("y", mMineLocations[i].y());
+		getTile(mMineLocations[i].x(), mMineLocations[i].y(), LEVEL_SURFACE)->mine()->serialize(_w);
+		_w.closeElement();
 	}
 
+	_w.closeElement();
+
 
 	// ==========================================
 	// TILES
 	// ==========================================
-	XmlElement *tiles = new XmlElement("tiles");
-	_ti->linkEndChild(tiles);
+	_w.openElement("tiles");
 
 	// We're only writing out tiles that don't have structures or robots in them that are
 	// underground and excavated or surface and bulldozed.
@@ -458,45 +646,110 @@ void TileMap::serialize(XmlElement* _ti)
 				tile = getTile(x, y, depth);
 				if (depth > 0 && tile->excavated() && tile->empty() && tile->mine() == nullptr)
 				{
-					serializeTile(tiles, x, y, depth, tile->index());
+					serializeTile(_w, x, y, depth, tile->index());
 				}
 				else if (tile->index() == 0 && tile->empty() && tile->mine() == nullptr)
 				{
-					serializeTile(tiles, x, y, depth, tile->index());
+					serializeTile(_w, x, y, depth, tile->index());
 				}
 			}
 		}
 	}
+
+	_w.closeElement();
 }
 
 
-void TileMap::deserialize(XmlElement* _ti)
+/**
+ * Writes the level and the location the map is viewed at.
+ *
+ * Kept apart from serialize() as the view isn't part of the state of the
+ * game. Scrolling and changing levels aren't recorded in command logs.
+ */
+void TileMap::serializeView(SaveGameSnapshot& _w)
 {
-	// VIEW PARAMETERS
-	int view_x = 0, view_y = 0, view_depth = 0;
-	XmlElement* view_parameters = _ti->firstChildElement("view_parameters");
-	XmlAttribute* attribute = view_parameters->firstAttribute();
-	while (attribute)
-	{
-		if (attribute->name() == "viewlocation_x")		{ attribute->queryIntValue(view_x); }
-		else if (attribute->name() == "viewlocation_y")	{ attribute->queryIntValue(view_y); }
-		else if (attribute->name() == "currentdepth")	{ attribute->queryIntValue(view_depth); }
-		attribute = attribute->next();
+	_w.openElement("view_parameters");
+	_w.attribute("currentdepth", mCurrentDepth);
+	_w.attribute("viewlocation_x", mMapViewLocation.x());
+	_w.attribute("viewlocation_y", mMapViewLocation.y());
+	_w.closeElement();
+}
+
+
+/**
+ * Adds the mines and the terrain of every tile to a state hash.
+ *
+ * \note	The view isn't added, see serializeView().
+ */
+void TileMap::hash(StateHash& _h)
+{
+	_h.add(static_cast<uint64_t>(mMineLocations.size()));
+	for (const auto& location : mMineLocations)
+	{
+		_h.add(location.x());
+		_h.add(location.y());
+		getTile(location.x(), location.y(), LEVEL_SURFACE)->mine()->hash(_h);
 	}
 
-	mapViewLocation(view_x, view_y);
-	currentDepth(view_depth);
-	for (XmlNode* mine = _ti->firstChildElement("mines")->firstChildElement("mine"); mine; mine = mine->nextSibling())
+	for (const TileGrid& level : mTileMap)
 	{
-		int x = 0, y = 0;
-	
-		attribute = mine->toElement()->firstAttribute();
-		while (attribute)
+		for (const auto& row : level)
 		{
-			if (attribute->name() == "x")		{ attribute->queryIntValue(x); }
-			else if (attribute->name() == "y")	{ attribute->queryIntValue(y); }
-			attribute = attribute->next();
+			for (const Tile& tile : row) { _h.add(tile.index() * 2 + (tile.excavated() ? 1 : 0)); }
 		}
+	}
+}
+
+
+/**
+ * Record types used to read TileMap elements from a savegame.
+ */
+struct ViewRecord { int x = 0, y = 0, depth = 0; };
+struct TileRecord { int x = 0, y = 0, depth = 0, index = 0; };
+
+
+static const AttributeSchema<ViewRecord> VIEW_SCHEMA("view_parameters",
+{
+	{ "viewlocation_x", &ViewRecord::x },
+	{ "viewlocation_y", &ViewRecord::y },
+	{ "currentdepth", &ViewRecord::depth }
+});
+
+
+/** Only the position is read here, everything else is read by Mine::deserialize(). */
+static const AttributeSchema<TileRecord> MINE_POSITION_SCHEMA("mine",
+{
+	{ "x", &TileRecord::x, true },
+	{ "y", &TileRecord::y, true },
+	{ "active" },
+	{ "depth" },
+	{ "yield" },
+	{ "flags" }
+});
+
+
+static const AttributeSchema<TileRecord> TILE_SCHEMA("tile",
+{
+	{ "x", &TileRecord::x, true },
+	{ "y", &TileRecord::y, true },
+	{ "depth", &TileRecord::depth, true },
+	{ "index", &TileRecord::index, true }
+});
+
+
+void TileMap::deserialize(XmlElement* _ti)
+{
+	// VIEW PARAMETERS
+	ViewRecord view;
+	VIEW_SCHEMA.read(_ti->firstChildElement("view_parameters"), view);
+
+	mapViewLocation(view.x, view.y);
+	currentDepth(view.depth);
+	for (XmlNode* mine = _ti->firstChildElement("mines")->firstChildElement("mine"); mine; mine = mine->nextSibling())
+	{
+		TileRecord position;
+		MINE_POSITION_SCHEMA.read(mine->toElement(), position);
+		int x = position.x, y = position.y;
 
 		Mine* m = new Mine();
 		m->deserialize(mine->toElement());
@@ -513,22 +766,12 @@ void TileMap::deserialize(XmlElement* _ti)
 	// TILES AT INDEX 0 WITH NO THING'S
 	for (XmlNode* tile = _ti->firstChildElement("tiles")->firstChildElement("tile"); tile; tile = tile->nextSibling())
 	{
-		int x = 0, y = 0, depth = 0, index = 0;
-
-		attribute = tile->toElement()->firstAttribute();
-		while (attribute)
-		{
-			if (attribute->name() == "x")			{ attribute->queryIntValue(x); }
-			else if (attribute->name() == "y")		{ attribute->queryIntValue(y); }
-			else if (attribute->name() == "depth")	{ attribute->queryIntValue(depth); }
-			else if (attribute->name() == "index")	{ attribute->queryIntValue(index); }
-
-			attribute = attribute->next();
-		}
+		TileRecord record;
+		TILE_SCHEMA.read(tile->toElement(), record);
 
-		mTileMap[depth][y][x].index(static_cast<TerrainType>(index));
+		mTileMap[record.depth][record.y][record.x].index(static_cast<TerrainType>(record.index));
 
-		if (depth > 0) { mTileMap[depth][y][x].excavated(true); }
+		if (record.depth > 0) { mTileMap[record.depth][record.y][record.x].excavated(true); }
 	}
 }
 
@@ -2,8 +2,13 @@
 
 #include "Tile.h"
 
+#include "../ImageManager.h"
+
 #include "../Things/Structures/Structure.h"
 
+class SaveGameSnapshot;
+class StateHash;
+
 using Point2dList = std::vector<NAS2D::Point_2d>;
 
 class TileMap
@@ -21,12 +26,46 @@ public:
 		LEVEL_UG_4
 	};
 
+	/**
+	 * Copy of what's drawn of the tiles in view.
+	 *
+	 * Lets the map be drawn while its tiles and things are being changed
+	 * by the turn processing.
+	 */
+	struct ViewSnapshot
+	{
+		/**
+		 * Drawable state of a tile.
+		 */
+		struct TileView
+		{
+			int				index = 0;
+			bool			excavated = false;
+			bool			connected = false;
+			bool			mineBeacon = false;		/**< Tile has a mine and nothing on it. */
+			bool			occupied = false;		/**< Tile has a thing on it. */
+			NAS2D::Sprite	sprite;					/**< Copy of the sprite of the thing on the tile. */
+		};
+
+		int						depth = 0;			/**< Level that was in view. */
+		int						edgeLength = 0;		/**< Number of tiles along the edges of the view. */
+		NAS2D::Point_2df		mapPosition;		/**< Where the view was drawn on the screen. */
+		std::vector<TileView>	tiles;				/**< Tiles in view, row by row. */
+	};
+
 public:
 	TileMap(const std::string& map_path, const std::string& tset_path, int maxDepth, int mineCount, bool setupMines = true);
 	~TileMap();
 
 	Tile* getTile(int x, int y, int level);
 	Tile* getTile(int x, int y) { return getTile(x, y, mCurrentDepth); }
+
+	/**
+	 * Gets the first tile of a row. The tiles of a row are contiguous.
+	 *
+	 * \note	Unlike getTile() the row and level aren't checked.
+	 */
+	Tile* row(int y, int level) { return mTileMap[level][y].data(); }
 	
 	Tile* getVisibleTile(int x, int y, int level) ;
 	Tile* getVisibleTile(int x, int y) { return getVisibleTile(x, y, mCurrentDepth); }
@@ -63,15 +102,24 @@ public:
 
 	int maxDepth() const { return mMaxDepth; }
 
+	const std::string& mapPath() const { return mMapPath; }
+
 	void injectMouse(int x, int y);
 
 	void initMapDrawParams(int, int);
 	
 	void draw();
+	void draw(ViewSnapshot& view);
 
-	void serialize(NAS2D::Xml::XmlElement* _ti);
+	void snapshot(ViewSnapshot& view);
+	void updateTileHighlight();
+
+	void serialize(SaveGameSnapshot& _w);
+	void serializeView(SaveGameSnapshot& _w);
 	void deserialize(NAS2D::Xml::XmlElement* _ti);
 
+	void hash(StateHash& _h);
+
 protected:
 	/**
 	 * 
@@ -97,9 +145,10 @@ private:
 
 	void buildMouseMap();
 	void buildTerrainMap(const std::string& path);
-	void setupMines(int mineCount);
+	void setupMines(int mineCount, int spacing);
 
-	void updateTileHighlight();
+	void drawTerrain(int x, int y, int index, int tsetOffset, bool connected, bool highlighted);
+	void drawMineBeacon(int x, int y);
 
 	MouseMapRegion getMouseMapRegion(int x, int y);
 
@@ -116,8 +165,8 @@ private:
 
 	TileArray			mTileMap;					/**<  */
 
-	NAS2D::Image		mTileset;					/**<  */
-	NAS2D::Image		mMineBeacon;				/**<  */
+	ImageManager::ImageHandle	mTileset;			/**<  */
+	ImageRegion					mMineBeacon;		/**<  */
 
 	NAS2D::Timer		mTimer;						/**<  */
 
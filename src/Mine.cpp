@@ -3,23 +3,25 @@
 
 #include "Mine.h"
 
+#include "AttributeSchema.h"
+#include "SaveGameSnapshot.h"
+#include "StateHash.h"
+
+#include <algorithm>
 #include <iostream>
 
 using namespace NAS2D::Xml;
 
 
 /**
- * Helper function that gets the total amount of ore 
+ * Ore in a new vein for each production rate.
  */
-static int getOreCount(const Mine::MineVeins& veins, Mine::OreType ore, size_t depth)
-{
-	int _value = 0;
-	for (size_t i = 0; i < depth; ++i)
-	{
-		_value += veins[i][ore];
-	}
-	return _value;
-}
+static const std::array<Mine::MineVein, 3> VEIN_YIELDS =
+{{
+	{ 600, 500, 600, 500 },		// PRODUCTION_RATE_LOW
+	{ 700, 550, 700, 550 },		// PRODUCTION_RATE_MEDIUM
+	{ 850, 600, 850, 600 }		// PRODUCTION_RATE_HIGH
+}};
 
 
 static void setDefaultFlags(std::bitset<6>& flags)
@@ -149,33 +151,46 @@ void Mine::miningRareMinerals(bool _b)
  */
 void Mine::increaseDepth()
 {
-	MineVein vein;
+	addVein(VEIN_YIELDS[productionRate()]);
+}
 
-	switch (productionRate())
+
+/**
+ * Adds a vein below the existing ones.
+ *
+ * \note	Any model of how much ore a level yields only needs to produce
+ *			the vein added here, the totals and cursors follow from it.
+ */
+void Mine::addVein(const MineVein& vein)
+{
+	for (size_t type = 0; type < vein.size(); ++type)
 	{
-	case PRODUCTION_RATE_LOW:
-		vein[ORE_COMMON_METALS] = 600;
-		vein[ORE_COMMON_MINERALS] = 500;
-		vein[ORE_RARE_METALS] = 600;
-		vein[ORE_RARE_MINERALS] = 500;
-		break;
-
-	case PRODUCTION_RATE_MEDIUM:
-		vein[ORE_COMMON_METALS] = 700;
-		vein[ORE_COMMON_MINERALS] = 550;
-		vein[ORE_RARE_METALS] = 700;
-		vein[ORE_RARE_MINERALS] = 550;
-		break;
-
-	case PRODUCTION_RATE_HIGH:
-		vein[ORE_COMMON_METALS] = 850;
-		vein[ORE_COMMON_MINERALS] = 600;
-		vein[ORE_RARE_METALS] = 850;
-		vein[ORE_RARE_MINERALS] = 600;
-		break;
+		// A cursor past the last vein means every vein above is empty.
+		if (mFirstVein[type] == mVeins.size() && vein[type] == 0) { ++mFirstVein[type]; }
+		mOreTotals[type] += vein[type];
 	}
 
 	mVeins.push_back(vein);
+	checkExhausted();
+}
+
+
+/**
+ * Rebuilds the ore totals and vein cursors from the veins.
+ */
+void Mine::updateTotals()
+{
+	mOreTotals.fill(0);
+	mFirstVein.fill(mVeins.size());
+
+	for (size_t i = mVeins.size(); i > 0; --i)
+	{
+		for (size_t type = 0; type < mOreTotals.size(); ++type)
+		{
+			mOreTotals[type] += mVeins[i - 1][type];
+			if (mVeins[i - 1][type] > 0) { mFirstVein[type] = i - 1; }
+		}
+	}
 }
 
 
@@ -194,7 +209,7 @@ int Mine::depth() const
  */
 int Mine::commonMetalsAvailable() const
 {
-	return getOreCount(mVeins, ORE_COMMON_METALS, depth());
+	return mOreTotals[ORE_COMMON_METALS];
 }
 
 
@@ -204,7 +219,7 @@ int Mine::commonMetalsAvailable() const
  */
 int Mine::commonMineralsAvailable() const
 {
-	return getOreCount(mVeins, ORE_COMMON_MINERALS, depth());
+	return mOreTotals[ORE_COMMON_MINERALS];
 }
 
 
@@ -214,7 +229,7 @@ int Mine::commonMineralsAvailable() const
  */
 int Mine::rareMetalsAvailable() const
 {
-	return getOreCount(mVeins, ORE_RARE_METALS, depth());
+	return mOreTotals[ORE_RARE_METALS];
 }
 
 
@@ -224,7 +239,7 @@ int Mine::rareMetalsAvailable() const
  */
 int Mine::rareMineralsAvailable() const
 {
-	return getOreCount(mVeins, ORE_RARE_MINERALS, depth());
+	return mOreTotals[ORE_RARE_MINERALS];
 }
 
 
@@ -240,54 +255,42 @@ bool Mine::exhausted() const
 /**
  * Checks if the mine is exhausted and if it is sets the exhausted flag.
  * 
- * \note	This function is provided so that this computation is only
- *			done once per turn instead of being done every frame. The
- *			issue came up after updating the minimap code to indicate
- *			exhausted mines.
+ * \note	Ore is tracked as it's pulled so this is cheap. pull() and
+ *			increaseDepth() keep the flag up to date on their own.
  */
 void Mine::checkExhausted()
 {
 	if (!active()) { return; }
-	
-	int ore_count = 0;
-	for (auto vein : mVeins)
-	{
-		ore_count += vein[ORE_COMMON_METALS];
-		ore_count += vein[ORE_COMMON_MINERALS];
-		ore_count += vein[ORE_RARE_METALS];
-		ore_count += vein[ORE_RARE_MINERALS];
-	}
 
-	mFlags[5] = (ore_count == 0);
+	mFlags[5] = (mOreTotals[ORE_COMMON_METALS] + mOreTotals[ORE_COMMON_MINERALS] + mOreTotals[ORE_RARE_METALS] + mOreTotals[ORE_RARE_MINERALS] == 0);
 }
 
 
 /**
  * Pulls the specified quantity of Ore from the Mine. If
  * insufficient ore is available, only pulls what's available.
+ *
+ * Starts at the first vein that has any of the ore left.
  */
 int Mine::pull(OreType type, int quantity)
 {
-	int pulled_count = 0, to_pull = quantity;
+	int pulled_count = 0;
+	size_t& first = mFirstVein[type];
 
-	for (size_t i = 0; i < mVeins.size(); ++i)
+	while (pulled_count < quantity && first < mVeins.size())
 	{
-		MineVein& vein = mVeins[i];
+		int& ore = mVeins[first][type];
+		int pulled = std::min(ore, quantity - pulled_count);
 
-		if (vein[type] >= to_pull)
-		{
-			pulled_count = to_pull;
-			vein[type] -= to_pull;
-			break;
-		}
-		else if (vein[type] < to_pull)
-		{
-			pulled_count += vein[type];
-			to_pull = to_pull - vein[type];
-			vein[type] = 0;
-		}
+		ore -= pulled;
+		pulled_count += pulled;
+
+		if (ore == 0) { ++first; }
 	}
 
+	mOreTotals[type] -= pulled_count;
+	if (mOreTotals[type] == 0) { checkExhausted(); }
+
 	return pulled_count;
 }
 
@@ -298,26 +301,42 @@ int Mine::pull(OreType type, int quantity)
 /**
  * Serializes current mine information.
  */
-void Mine::serialize(XmlElement* _ti)
+void Mine::serialize(SaveGameSnapshot& _w)
 {
-	_ti->attribute("depth", depth());
-	_ti->attribute("active", active());
-	_ti->attribute("yield", productionRate());
-	_ti->attribute("flags", mFlags.to_string());
+	_w.attribute("depth", depth());
+	_w.attribute("active", active());
+	_w.attribute("yield", productionRate());
+	_w.attribute("flags", mFlags.to_string());
 
 	for (size_t i = 0; i < mVeins.size(); ++i)
 	{
 		const MineVein& mv = mVeins[i];
 
-		XmlElement* vein = new XmlElement("vein");
+		_w.openElement("vein");
+
+		_w.attribute("id", static_cast<int>(i));
+		_w.attribute("common_metals",	mv[ORE_COMMON_METALS]);
+		_w.attribute("common_minerals",	mv[ORE_COMMON_MINERALS]);
+		_w.attribute("rare_metals",		mv[ORE_RARE_METALS]);
+		_w.attribute("rare_minerals",	mv[ORE_RARE_MINERALS]);
+
+		_w.closeElement();
+	}
+}
+
 
-		vein->attribute("id", static_cast<int>(i));
-		vein->attribute("common_metals",	mv[ORE_COMMON_METALS]);
-		vein->attribute("common_minerals",	mv[ORE_COMMON_MINERALS]);
-		vein->attribute("rare_metals",		mv[ORE_RARE_METALS]);
-		vein->attribute("rare_minerals",	mv[ORE_RARE_MINERALS]);
+/**
+ * Adds the flags, production rate and ore left in every vein to a state hash.
+ */
+void Mine::hash(StateHash& _h) const
+{
+	_h.add(static_cast<uint32_t>(mFlags.to_ulong()));
+	_h.add(static_cast<int>(mProductionRate));
+	_h.add(static_cast<uint64_t>(mVeins.size()));
 
-		_ti->linkEndChild(vein);
+	for (const MineVein& vein : mVeins)
+	{
+		for (int ore : vein) { _h.add(ore); }
 	}
 }
 
@@ -327,37 +346,52 @@ void Mine::serialize(XmlElement* _ti)
  */
 void Mine::deserialize(NAS2D::Xml::XmlElement* _ti)
 {
-	int active = 0, yield = 0, depth = 0;
-	std::string flags;
+	struct MineRecord
+	{
+		int active = 0, yield = 0, depth = 0;
+		std::string flags;
+	};
 
-	XmlAttribute* attribute = _ti->firstAttribute();
-	while (attribute)
+	static const AttributeSchema<MineRecord> MINE_SCHEMA("mine",
 	{
-		if (attribute->name() == "active") { attribute->queryIntValue(active); }
-		else if (attribute->name() == "depth") { attribute->queryIntValue(depth); }
-		else if (attribute->name() == "yield") { attribute->queryIntValue(yield); }
-		else if (attribute->name() == "flags") { mFlags = std::bitset<6>(attribute->value()); }
-		attribute = attribute->next();
-	}
+		{ "active", &MineRecord::active },
+		{ "depth", &MineRecord::depth },
+		{ "yield", &MineRecord::yield },
+		{ "flags", &MineRecord::flags },
+		{ "x" },
+		{ "y" }
+	});
+
+	/** Key used for the vein's id, outside the range of OreType. */
+	const int VEIN_ID = -1;
+
+	static const AttributeTable VEIN_ATTRIBUTES("vein",
+	{
+		{ "common_metals", ORE_COMMON_METALS },
+		{ "common_minerals", ORE_COMMON_MINERALS },
+		{ "rare_metals", ORE_RARE_METALS },
+		{ "rare_minerals", ORE_RARE_MINERALS },
+		{ "id", VEIN_ID, true }
+	});
+
+	MineRecord mine;
+	MINE_SCHEMA.read(_ti, mine);
 
-	this->active(active != 0);
-	mProductionRate = static_cast<MineProductionRate>(yield);
+	if (!mine.flags.empty()) { mFlags = std::bitset<6>(mine.flags); }
+	this->active(mine.active != 0);
+	mProductionRate = static_cast<MineProductionRate>(mine.yield);
 
-	mVeins.resize(depth);
+	mVeins.resize(mine.depth);
 	for (XmlNode* vein = _ti->firstChild(); vein != nullptr; vein = vein->nextSibling())
 	{
-		MineVein _mv;
-		attribute = vein->toElement()->firstAttribute();
+		MineVein _mv = {};
 		int id = 0;
-		while (attribute)
+		VEIN_ATTRIBUTES.read(vein->toElement(), [&_mv, &id](int key, XmlAttribute* attribute)
 		{
-			if (attribute->name() == "common_metals") { attribute->queryIntValue(_mv[ORE_COMMON_METALS]); }
-			else if (attribute->name() == "common_minerals") { attribute->queryIntValue(_mv[ORE_COMMON_MINERALS]); }
-			else if (attribute->name() == "rare_metals") { attribute->queryIntValue(_mv[ORE_RARE_METALS]); }
-			else if (attribute->name() == "rare_minerals") { attribute->queryIntValue(_mv[ORE_RARE_MINERALS]); }
-			else if (attribute->name() == "id") { attribute->queryIntValue(id); }
-			attribute = attribute->next();
-		}
+			attribute->queryIntValue(key == VEIN_ID ? id : _mv[key]);
+		});
 		mVeins[id] = _mv;
 	}
+
+	updateTotals();
 }
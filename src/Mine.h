@@ -7,8 +7,17 @@
 
 #include <bitset>
 
+class SaveGameSnapshot;
+class StateHash;
+
 /**
- * 
+ * \brief	Ore deposit worked by a MineFacility.
+ *
+ * Every level of the mine has a vein of each type of ore. Ore is pulled
+ * from the topmost vein that still has any. The total of each type of ore
+ * and the first vein that still has any are kept up to date as ore is
+ * pulled and levels are added so availability queries and exhaustion
+ * checks don't walk the veins.
  */
 class Mine
 {
@@ -58,15 +67,25 @@ public:
 	int pull(OreType type, int quantity);
 
 public:
-	void serialize(NAS2D::Xml::XmlElement* _ti);
+	void serialize(SaveGameSnapshot& _w);
 	void deserialize(NAS2D::Xml::XmlElement* _ti);
 
+	void hash(StateHash& _h) const;
+
+private:
+	typedef std::array<size_t, 4> VeinCursors;
+
 private:
 	Mine(const Mine&) = delete;
 	Mine& operator=(const Mine&) = delete;
 
+	void addVein(const MineVein& vein);
+	void updateTotals();
+
 private:
 	MineVeins			mVeins;									/**< Ore veins */
+	MineVein			mOreTotals = {};						/**< Ore left in all veins, per type. */
+	VeinCursors			mFirstVein = {};						/**< Index of the first vein with ore left, per type. */
 	MineProductionRate	mProductionRate = PRODUCTION_RATE_LOW;	/**< Mine's production rate. */
 	
 	/**
@@ -3,290 +3,418 @@
 
 #include "Population.h"
 
+#include "../AttributeSchema.h"
+#include "../SaveGameSnapshot.h"
+#include "../StateHash.h"
+
 #include <algorithm>
-#include <functional>
-#include <iostream>
-#include <random>
+#include <cstdlib>
+#include <numeric>
+#include <sstream>
+#include <stdexcept>
 
-#include <NAS2D/NAS2D.h>
+using namespace NAS2D::Xml;
 
 
-const int STUDENT_TO_SCIENTIST_RATE = 35;
+/**
+ * Age in years at which each role starts.
+ */
+const size_t STUDENT_AGE = 12;
+const size_t ADULT_AGE = 22;
+const size_t RETIREMENT_AGE = 65;
 
-const int STUDENT_TO_ADULT_BASE = 190;
-const int ADULT_TO_RETIREE_BASE = 2000;
+/**
+ * Child bearing ages and births per thousand adults and year.
+ */
+const size_t FERTILE_AGE = 18;
+const size_t PEAK_FERTILE_AGE = 25;
+const size_t LATE_FERTILE_AGE = 35;
+const size_t INFERTILE_AGE = 45;
 
+const uint64_t FERTILITY = 40;
+const uint64_t PEAK_FERTILITY = 80;
 
-std::default_random_engine pop_generator;
-std::uniform_int_distribution<int> pop_distribution(0, 100);
+/**
+ * Deaths per hundred thousand people and year. From the age of thirty
+ * mortality doubles every eight years.
+ */
+const uint64_t INFANT_MORTALITY = 600;
+const uint64_t CHILD_MORTALITY = 40;
+const uint64_t BASE_MORTALITY = 15;
+const uint64_t ADULT_MORTALITY = 100;
+const size_t ADULT_MORTALITY_AGE = 30;
+const uint64_t MORTALITY_GROWTH = 71468;		/**< 2^(1/8) in 16 bit fixed point. */
 
-auto random_0_100 = std::bind(pop_distribution, pop_generator);
+/**
+ * Morale modifiers the curves are calibrated for.
+ */
+const uint64_t FAIR_FERTILITY = 60;
+const uint64_t FAIR_MORTALITY = 40;
+
+/**
+ * Effect of facilities in 8 bit fixed point.
+ */
+const uint64_t NURSERY_FERTILITY_BONUS = 26;
+const uint64_t FACILITY_MORTALITY_REDUCTION = 32;
+const int MAX_EFFECTIVE_FACILITIES = 4;
 
 /**
- * Convenience function to cast a MoraleLevel enumerator
- * into an array index.
+ * Students that become scientists when there's a university, in 32 bit
+ * fixed point.
  */
-int moraleIndex(uint32_t morale)
+const uint64_t STUDENT_TO_SCIENTIST_RATE = (uint64_t(35) << 32) / 100;
+
+/**
+ * Fraction of a cohort that moves on to the next one every turn, in 32
+ * bit fixed point. A turn is a month.
+ */
+const uint64_t AGING_RATE = (uint64_t(1) << 32) / 12;
+
+const uint64_t RATE_MAX = UINT32_MAX;
+
+
+/**
+ * Convenience function to cast a morale value into an index of the morale
+ * modifier table, which starts with excellent morale.
+ */
+int moraleIndex(int morale)
 {
-	return NAS2D::clamp(morale, 1, 999) / 200;
+	return (999 - std::clamp(morale, 0, 999)) / 200;
 }
 
 
-
 /**
- * C'tor
+ * Converts a yearly rate with a given denominator to a rate per turn in 32
+ * bit fixed point.
  */
-Population::Population() : mBirthCount(0), mDeathCount(0), mStarveRate(0.5f)
+static uint32_t monthlyRate(uint64_t yearly, uint64_t denominator)
 {
-	init();
+	return static_cast<uint32_t>(std::min((yearly << 32) / (denominator * 12), RATE_MAX));
 }
 
 
 /**
- * D'tor
+ * Births per person and turn of each cohort at fair morale.
  */
-Population::~Population()
+static const Population::Cohorts& baseFertility()
 {
-	clear();
+	static const Population::Cohorts fertility = []()
+	{
+		Population::Cohorts table{};
+		for (size_t age = FERTILE_AGE; age < INFERTILE_AGE; ++age)
+		{
+			bool peak = age >= PEAK_FERTILE_AGE && age < LATE_FERTILE_AGE;
+			table[age] = monthlyRate(peak ? PEAK_FERTILITY : FERTILITY, 1000);
+		}
+		return table;
+	}();
+
+	return fertility;
 }
 
 
-void Population::init()
+/**
+ * Deaths per person and turn of each cohort at fair morale.
+ */
+static const Population::Cohorts& baseMortality()
 {
-	mPopulation.fill(0);
-	mPopulationGrowth.fill(0);
-	mPopulationDeath.fill(0);
+	static const Population::Cohorts mortality = []()
+	{
+		Population::Cohorts table{};
 
-	mModifiers[0] = MoraleModifier(50, 50, 110, 80);	// Excellent
-	mModifiers[1] = MoraleModifier(25, 25, 90, 75);		// Good
-	mModifiers[2] = MoraleModifier(0, 0, 60, 40);		// Fair
-	mModifiers[3] = MoraleModifier(-25, -25, 40, 20);	// Poor
-	mModifiers[4] = MoraleModifier(-50, -50, 20, 10);	// Terrible
+		// Adult mortality in 16 bit fixed point, grown with integers only so
+		// the curve is the same on every platform.
+		uint64_t adult = ADULT_MORTALITY << 16;
+		for (size_t age = ADULT_MORTALITY_AGE; age > 0; --age) { adult = (adult << 16) / MORTALITY_GROWTH; }
+
+		for (size_t age = 0; age < Population::AGE_GROUPS; ++age)
+		{
+			uint64_t yearly = age == 0 ? INFANT_MORTALITY : age < 5 ? CHILD_MORTALITY : BASE_MORTALITY;
+			table[age] = monthlyRate(std::min(std::max(yearly, adult >> 16), uint64_t(100000)), 100000);
+			adult = (adult * MORTALITY_GROWTH) >> 16;
+		}
+		return table;
+	}();
+
+	return mortality;
 }
 
 
 /**
- * Clears entire population and frees all associated resources.
+ * Gets the first cohort and number of cohorts colonists of a role are
+ * added to.
  */
-void Population::clear()
+static std::pair<size_t, size_t> arrivalCohorts(Population::PersonRole role)
 {
-	clearPopulationList(ROLE_CHILD);
-	clearPopulationList(ROLE_STUDENT);
-	clearPopulationList(ROLE_WORKER);
-	clearPopulationList(ROLE_SCIENTIST);
-	clearPopulationList(ROLE_RETIRED);
+	switch (role)
+	{
+	case Population::ROLE_CHILD:
+		return { 0, STUDENT_AGE };
+	case Population::ROLE_STUDENT:
+		return { STUDENT_AGE, ADULT_AGE - STUDENT_AGE };
+	case Population::ROLE_RETIRED:
+		return { RETIREMENT_AGE, 10 };
+	default:
+		return { ADULT_AGE, 20 };
+	}
 }
 
 
 /**
- * Clears a specified segment of the population and frees all resources
- * associated with it.
+ * Sums a range of cohorts.
  */
-void Population::clearPopulationList(PersonRole _role)
+static uint32_t sum(const Population::Cohorts& cohorts, size_t first, size_t last)
 {
-	mPopulation[_role] = 0;
+	return std::accumulate(cohorts.begin() + first, cohorts.begin() + last, uint32_t(0));
 }
 
 
 /**
- * Populates a given population with a specified number of colonists given some base values.
- *
- * \param	role		Segment of the population to populate.
- * \param	count		Base age in months of the population to populated.
+ * Writes cohorts as a space separated list.
  */
-void Population::addPopulation(PersonRole role, uint32_t count)
+static std::string toString(const Population::Cohorts& cohorts)
 {
-	mPopulation[role] += count;
+	std::ostringstream out;
+	for (size_t i = 0; i < cohorts.size(); ++i) { out << (i ? " " : "") << cohorts[i]; }
+	return out.str();
 }
 
 
 /**
- * Gets the size of the entire population.
+ * Reads cohorts from a space separated list.
+ *
+ * \return	False if the list doesn't hold a value for every cohort.
  */
-int Population::size()
+static bool fromString(const std::string& str, Population::Cohorts& cohorts)
 {
-	uint32_t count = 0;
-	for (size_t i = 0; i < mPopulation.size(); ++i)
+	std::istringstream in(str);
+	for (auto& cohort : cohorts)
 	{
-		count += mPopulation[i];
+		if (!(in >> cohort)) { return false; }
 	}
 
-	return count;
+	return true;
 }
 
 
+
 /**
- * Gets the size of a specific segment of the population.
+ * C'tor
  */
-int Population::size(PersonRole _pr)
+Population::Population() : mBirthCount(0), mDeathCount(0), mStarveRate(0.5f)
 {
-	return mPopulation[_pr];
+	init();
 }
 
 
 /**
- * Population check for new children.
- * 
- * \todo	Account for nurseries when implemented.
+ * D'tor
  */
-void Population::spawn_children(int morale, int residences, int nurseries)
+Population::~Population()
 {
-	if (residences < 1 && nurseries < 1) { return; }
+	clear();
+}
 
-	// This should be adjusted to maybe two or three kids per couple to allow for higher growth rates.
-	if (mPopulation[ROLE_SCIENTIST] + mPopulation[ROLE_WORKER] > mPopulation[ROLE_CHILD])
-	{
-		mPopulationGrowth[ROLE_CHILD] += mPopulation[ROLE_SCIENTIST] / 4 + mPopulation[ROLE_WORKER] / 2;
 
-		int divisor = mModifiers[moraleIndex(morale)].fertilityRate;
+void Population::init()
+{
+	clear();
 
-		int newChildren = mPopulationGrowth[ROLE_CHILD] / divisor;
-		mPopulationGrowth[ROLE_CHILD] = mPopulationGrowth[ROLE_CHILD] % divisor;
+	mFertility.fill(0);
+	mMortality.fill(0);
+	mLeaving.fill(0);
 
-		mPopulation[ROLE_CHILD] += newChildren;
-		mBirthCount = newChildren;
-	}
+	mModifiers[0] = MoraleModifier(50, 50, 110, 80);	// Excellent
+	mModifiers[1] = MoraleModifier(25, 25, 90, 75);		// Good
+	mModifiers[2] = MoraleModifier(0, 0, 60, 40);		// Fair
+	mModifiers[3] = MoraleModifier(-25, -25, 40, 20);	// Poor
+	mModifiers[4] = MoraleModifier(-50, -50, 20, 10);	// Terrible
 }
 
 
-void Population::spawn_students()
+/**
+ * Clears entire population.
+ */
+void Population::clear()
 {
-	if (mPopulation[ROLE_CHILD] > 0)
+	for (auto& line : mLines)
 	{
-		mPopulationGrowth[ROLE_STUDENT] += mPopulation[ROLE_CHILD];
-
-		int divisor = mPopulation[ROLE_STUDENT] + mPopulation[ROLE_WORKER] + mPopulation[ROLE_SCIENTIST] + mPopulation[ROLE_CHILD];
-		if (divisor <= STUDENT_TO_ADULT_BASE) { divisor = STUDENT_TO_ADULT_BASE; }
-		divisor = ((divisor / 40) * 3 + 16) * 4;
+		line.people.fill(0);
+		line.aging.fill(0);
+		line.dying.fill(0);
+	}
 
-		int newStudents = mPopulationGrowth[ROLE_STUDENT] / divisor;
-		mPopulationGrowth[ROLE_STUDENT] = mPopulationGrowth[ROLE_STUDENT] % divisor;
+	mBirthCarry = 0;
+	mScientistCarry = 0;
 
-		mPopulation[ROLE_STUDENT] += newStudents;
-		mPopulation[ROLE_CHILD] -= newStudents;
-	}
+	tally();
 }
 
 
-void Population::spawn_adults(int universities)
+/**
+ * Updates the size of each role from the cohorts.
+ */
+void Population::tally()
 {
-	//-- New Adults --//
-	if (mPopulation[ROLE_STUDENT] > 0)
-	{
-		mPopulationGrowth[ROLE_WORKER] += mPopulation[ROLE_STUDENT];
-
-		int divisor = mPopulation[ROLE_STUDENT] + mPopulation[ROLE_WORKER] + mPopulation[ROLE_SCIENTIST] + mPopulation[ROLE_CHILD];
-		if (divisor <= STUDENT_TO_ADULT_BASE) { divisor = STUDENT_TO_ADULT_BASE; }
-
-		divisor = ((divisor / 40) * 3 + 45) * 4;
+	const Cohorts& general = mLines[LINE_GENERAL].people;
+	const Cohorts& scientists = mLines[LINE_SCIENTIST].people;
+
+	mPopulation[ROLE_CHILD] = sum(general, 0, STUDENT_AGE);
+	mPopulation[ROLE_STUDENT] = sum(general, STUDENT_AGE, ADULT_AGE);
+	mPopulation[ROLE_WORKER] = sum(general, ADULT_AGE, RETIREMENT_AGE);
+	mPopulation[ROLE_SCIENTIST] = sum(scientists, 0, RETIREMENT_AGE);
+	mPopulation[ROLE_RETIRED] = sum(general, RETIREMENT_AGE, AGE_GROUPS) + sum(scientists, RETIREMENT_AGE, AGE_GROUPS);
+}
 
-		int newAdult = mPopulationGrowth[ROLE_WORKER] / divisor;
-		mPopulationGrowth[ROLE_WORKER] = mPopulationGrowth[ROLE_WORKER] % divisor;
 
-		// account for universities
-		if (universities > 0 && random_0_100() <= STUDENT_TO_SCIENTIST_RATE)
-		{
-			mPopulation[ROLE_SCIENTIST] += newAdult;
-		}
-		else
-		{
-			mPopulation[ROLE_WORKER] += newAdult;
-		}
+/**
+ * Adds colonists of a given role.
+ *
+ * Colonists are spread evenly over the youngest cohorts of the role.
+ *
+ * \param	role		Segment of the population to populate.
+ * \param	count		Number of colonists to add.
+ */
+void Population::addPopulation(PersonRole role, uint32_t count)
+{
+	Cohorts& people = mLines[role == ROLE_SCIENTIST ? LINE_SCIENTIST : LINE_GENERAL].people;
+	auto cohorts = arrivalCohorts(role);
 
-		mPopulation[ROLE_STUDENT] -= newAdult;
+	for (size_t i = 0; i < cohorts.second; ++i)
+	{
+		people[cohorts.first + i] += count / cohorts.second + (i < count % cohorts.second ? 1 : 0);
 	}
+
+	tally();
 }
 
 
-void Population::spawn_retiree()
+/**
+ * Gets the size of the entire population.
+ */
+int Population::size() const
 {
-	int total_adults = mPopulation[ROLE_WORKER] + mPopulation[ROLE_SCIENTIST];
-	if (total_adults > 0)
+	uint32_t count = 0;
+	for (size_t i = 0; i < mPopulation.size(); ++i)
 	{
-		mPopulationGrowth[ROLE_RETIRED] += total_adults / 10;
-
-		int divisor = total_adults;
-		if (divisor <= ADULT_TO_RETIREE_BASE) { divisor = ADULT_TO_RETIREE_BASE; }
-
-		divisor = ((divisor / 40) * 3 + 40) * 4;
+		count += mPopulation[i];
+	}
 
-		int retiree = mPopulationGrowth[ROLE_RETIRED] / divisor;
-		mPopulationGrowth[ROLE_RETIRED] = mPopulationGrowth[ROLE_RETIRED] % divisor;
+	return count;
+}
 
-		mPopulation[ROLE_RETIRED] += retiree;
 
-		/** Workers retire earlier than scientists. */
-		if (random_0_100() <= 45) { if (mPopulation[ROLE_SCIENTIST] > 0) { mPopulation[ROLE_SCIENTIST] -= retiree; } }
-		else { if (mPopulation[ROLE_WORKER] > 0) { mPopulation[ROLE_WORKER] -= retiree; } }
-	}
+/**
+ * Gets the size of a specific segment of the population.
+ */
+int Population::size(PersonRole _pr) const
+{
+	return mPopulation[_pr];
 }
 
 
-void Population::kill_children(int morale, int nurseries)
+/**
+ * Modulates the fertility and mortality curves by morale, nurseries and
+ * hospitals.
+ *
+ * Nurseries make children more likely and keep them healthy, hospitals
+ * look after everybody else. Only the first few of each make a difference.
+ */
+void Population::updateRates(int morale, int nurseries, int hospitals)
 {
-	if (mPopulation[ROLE_CHILD] > 0)
-	{
-		mPopulationDeath[ROLE_CHILD] = mPopulation[ROLE_CHILD];
+	const MoraleModifier& modifier = mModifiers[moraleIndex(morale)];
 
-		int divisor = mModifiers[moraleIndex(morale)].mortalityRate + (nurseries * 10);
+	nurseries = std::clamp(nurseries, 0, MAX_EFFECTIVE_FACILITIES);
+	hospitals = std::clamp(hospitals, 0, MAX_EFFECTIVE_FACILITIES);
 
-		int deaths = mPopulationDeath[ROLE_CHILD] / divisor;
-		mPopulationDeath[ROLE_CHILD] = mPopulationDeath[ROLE_CHILD] % divisor;
+	// Scales are in 16 bit fixed point.
+	uint64_t fertilityScale = (static_cast<uint64_t>(modifier.fertilityRate) << 8) / FAIR_FERTILITY * ((1 << 8) + nurseries * NURSERY_FERTILITY_BONUS);
+	uint64_t moraleMortality = (FAIR_MORTALITY << 8) / static_cast<uint64_t>(std::max(modifier.mortalityRate, 1));
+	uint64_t childMortality = moraleMortality * ((1 << 8) - nurseries * FACILITY_MORTALITY_REDUCTION);
+	uint64_t adultMortality = moraleMortality * ((1 << 8) - hospitals * FACILITY_MORTALITY_REDUCTION);
 
-		mPopulation[ROLE_CHILD] -= deaths;
-		mDeathCount += deaths;
+	const Cohorts& fertility = baseFertility();
+	const Cohorts& mortality = baseMortality();
 
-		if (mPopulation[ROLE_CHILD] <= 0)
-		{
-			mPopulationDeath[ROLE_CHILD] = 0;
-			mPopulationGrowth[ROLE_STUDENT] = 0;
-		}
+	for (size_t i = 0; i < AGE_GROUPS; ++i)
+	{
+		mFertility[i] = static_cast<uint32_t>(std::min((fertility[i] * fertilityScale) >> 16, RATE_MAX));
 	}
-}
 
+	for (size_t i = 0; i < STUDENT_AGE; ++i)
+	{
+		mMortality[i] = static_cast<uint32_t>(std::min((mortality[i] * childMortality) >> 16, RATE_MAX));
+	}
 
-void Population::kill_students(int morale, int hospitals)
-{
-	if (mPopulation[ROLE_CHILD] > 0)
+	for (size_t i = STUDENT_AGE; i < AGE_GROUPS; ++i)
 	{
-		mPopulationDeath[ROLE_STUDENT] = mPopulation[ROLE_STUDENT];
+		mMortality[i] = static_cast<uint32_t>(std::min((mortality[i] * adultMortality) >> 16, RATE_MAX));
+	}
+}
 
-		int divisor = mModifiers[moraleIndex(morale)].mortalityRate + (hospitals * 65);
 
-		int deaths = mPopulationDeath[ROLE_STUDENT] / divisor;
-		mPopulationDeath[ROLE_STUDENT] = mPopulationDeath[ROLE_CHILD] % divisor;
+/**
+ * Gets the number of children born this turn.
+ *
+ * Scientists are busy and have half as many children as everybody else.
+ * No children are born without a place to raise them.
+ */
+uint32_t Population::births(int residences, int nurseries)
+{
+	if (residences < 1 && nurseries < 1) { return 0; }
 
-		mPopulation[ROLE_STUDENT] -= deaths;
-		mDeathCount += deaths;
+	const Cohorts& general = mLines[LINE_GENERAL].people;
+	const Cohorts& scientists = mLines[LINE_SCIENTIST].people;
 
-		if (mPopulation[ROLE_STUDENT] <= 0)
-		{
-			mPopulationDeath[ROLE_STUDENT] = 0;
-			mPopulationGrowth[ROLE_WORKER] = 0;
-		}
+	uint64_t births = mBirthCarry;
+	for (size_t i = 0; i < AGE_GROUPS; ++i)
+	{
+		births += static_cast<uint64_t>(general[i]) * mFertility[i] + ((static_cast<uint64_t>(scientists[i]) * mFertility[i]) >> 1);
 	}
+
+	mBirthCarry = static_cast<uint32_t>(births);
+	return static_cast<uint32_t>(births >> 32);
 }
 
 
-void Population::kill_adults(Population::PersonRole role, int morale, int hospitals)
+/**
+ * Ages a line of cohorts by a turn.
+ *
+ * Every cohort loses its dead and then a twelfth of its survivors to the
+ * next cohort. Everybody leaving the last cohort dies of old age. The loops
+ * are kept free of branches and dependencies between cohorts so they can
+ * be vectorized.
+ *
+ * \param	line	Line to age.
+ * \param	inflow	Number of people entering the first cohort.
+ *
+ * \return	Number of people that died.
+ *
+ * \note	mLeaving holds the people that left each cohort of the line
+ *			afterwards.
+ */
+uint32_t Population::age(Line& line, uint32_t inflow)
 {
-	// Worker Deaths
-	if (mPopulation[role] > 0)
-	{
-		mPopulationDeath[role] += mPopulation[role];
-		int divisor = mModifiers[moraleIndex(morale)].mortalityRate + 250 + (hospitals * 60);
+	Cohorts& people = line.people;
+	uint32_t deaths = 0;
 
-		int deaths = mPopulationDeath[role] / divisor;
-		mPopulationDeath[role] = mPopulationDeath[role] % divisor;
+	for (size_t i = 0; i < AGE_GROUPS; ++i)
+	{
+		uint64_t dying = static_cast<uint64_t>(people[i]) * mMortality[i] + line.dying[i];
+		line.dying[i] = static_cast<uint32_t>(dying);
+		people[i] -= static_cast<uint32_t>(dying >> 32);
+		deaths += static_cast<uint32_t>(dying >> 32);
+
+		uint64_t aging = static_cast<uint64_t>(people[i]) * AGING_RATE + line.aging[i];
+		line.aging[i] = static_cast<uint32_t>(aging);
+		mLeaving[i] = static_cast<uint32_t>(aging >> 32);
+	}
 
-		mPopulation[role] -= deaths;
-		mDeathCount += deaths;
+	for (size_t i = 0; i < AGE_GROUPS; ++i) { people[i] -= mLeaving[i]; }
+	for (size_t i = 1; i < AGE_GROUPS; ++i) { people[i] += mLeaving[i - 1]; }
+	people[0] += inflow;
 
-		if (mPopulation[role] == 0)
-		{
-			mPopulationDeath[role] = 0;
-		}
-	}
+	return deaths + mLeaving[AGE_GROUPS - 1];
 }
 
 
@@ -294,6 +422,8 @@ void Population::kill_adults(Population::PersonRole role, int morale, int hospit
  * Determine how much food should be consumed and kill off any population that
  * starves.
  *
+ * The starving are taken from every cohort in proportion to its size.
+ *
  * \return	Actual amount of food consumed.
  */
 uint32_t Population::consume_food(uint32_t food)
@@ -301,7 +431,7 @@ uint32_t Population::consume_food(uint32_t food)
 	// If there's no food kill everybody (humans can survive up to 21 days without food, one turn == minimum 28 days)
 	if (food == 0)
 	{
-		mDeathCount = size();
+		mDeathCount += size();
 		clear();
 		return 0;
 	}
@@ -316,30 +446,32 @@ uint32_t Population::consume_food(uint32_t food)
 	uint32_t population_to_kill = static_cast<int>((size() - population_fed) * mStarveRate);
 	if (size() == 1) { population_to_kill = 1; }
 
-	for (uint32_t i = 0; i < population_to_kill; /**/ )
-	{
-		int role_idx = i % 5;
+	uint64_t rate = (static_cast<uint64_t>(population_to_kill) << 32) / static_cast<uint64_t>(size());
+	uint32_t killed = 0;
 
-		int counter = 0;
-		for (;;)
+	for (auto& line : mLines)
+	{
+		for (auto& cohort : line.people)
 		{
-			role_idx = role_idx + counter;
-			if (role_idx > 4) { role_idx = 0; }
-			
-			if (mPopulation[role_idx] > 0)
-			{
-				break;
-			}
-
-			++counter;
-			if (counter > 4) { counter = 0; }
+			uint32_t starved = static_cast<uint32_t>((cohort * rate) >> 32);
+			cohort -= starved;
+			killed += starved;
 		}
+	}
 
-		--mPopulation[role_idx];
-		++i;
+	// Whoever is left to die after rounding is taken from the oldest.
+	for (size_t i = AGE_GROUPS; i > 0 && killed < population_to_kill; --i)
+	{
+		for (auto& line : mLines)
+		{
+			uint32_t starved = std::min(line.people[i - 1], population_to_kill - killed);
+			line.people[i - 1] -= starved;
+			killed += starved;
+		}
 	}
 
-	mDeathCount = population_to_kill;
+	mDeathCount += population_to_kill;
+	tally();
 
 	// actual amount of population fed.
 	return population_fed;
@@ -354,19 +486,113 @@ int Population::update(int morale, int food, int residences, int universities, i
 	mBirthCount = 0;
 	mDeathCount = 0;
 
-	spawn_children(morale, residences, nurseries);
-	spawn_students();
-	spawn_adults(universities);
-	spawn_retiree();
+	updateRates(morale, nurseries, hospitals);
+	mBirthCount = births(residences, nurseries);
+
+	mDeathCount += age(mLines[LINE_SCIENTIST], 0);
+	mDeathCount += age(mLines[LINE_GENERAL], mBirthCount);
 
-	kill_children(morale, nurseries);
-	kill_students(morale, hospitals);
+	// Students that just came of age become scientists if there's a university.
+	uint64_t scientists = static_cast<uint64_t>(mLeaving[ADULT_AGE - 1]) * (universities > 0 ? STUDENT_TO_SCIENTIST_RATE : 0) + mScientistCarry;
+	mScientistCarry = static_cast<uint32_t>(scientists);
 
-	// Workers will die more often than scientists.
-	if (random_0_100() <= 45) { kill_adults(ROLE_SCIENTIST, morale, hospitals); }
-	else { kill_adults(ROLE_WORKER, morale, hospitals); }
+	mLines[LINE_GENERAL].people[ADULT_AGE] -= static_cast<uint32_t>(scientists >> 32);
+	mLines[LINE_SCIENTIST].people[ADULT_AGE] += static_cast<uint32_t>(scientists >> 32);
 
-	kill_adults(ROLE_RETIRED, morale, hospitals);
+	tally();
 
 	return consume_food(food);
 }
+
+
+void Population::serialize(SaveGameSnapshot& _w)
+{
+	_w.openElement("cohorts");
+	_w.attribute("birth_carry", std::to_string(mBirthCarry));
+	_w.attribute("scientist_carry", std::to_string(mScientistCarry));
+
+	for (auto& line : mLines)
+	{
+		_w.openElement("line");
+		_w.attribute("people", toString(line.people));
+		_w.attribute("aging", toString(line.aging));
+		_w.attribute("dying", toString(line.dying));
+		_w.closeElement();
+	}
+
+	_w.closeElement();
+}
+
+
+/**
+ * Reads the cohorts from the population element of a savegame.
+ *
+ * \return	False if the element has no cohorts. Savegames written before
+ *			the population had an age structure only have the size of each
+ *			role and are loaded with addPopulation().
+ */
+bool Population::deserialize(XmlElement* _ti)
+{
+	XmlElement* cohorts = _ti ? _ti->firstChildElement("cohorts") : nullptr;
+	if (!cohorts) { return false; }
+
+	struct CohortsRecord { std::string birth_carry, scientist_carry; };
+	struct LineRecord { std::string people, aging, dying; };
+
+	static const AttributeSchema<CohortsRecord> COHORTS_SCHEMA("cohorts",
+	{
+		{ "birth_carry", &CohortsRecord::birth_carry },
+		{ "scientist_carry", &CohortsRecord::scientist_carry }
+	});
+
+	static const AttributeSchema<LineRecord> LINE_SCHEMA("line",
+	{
+		{ "people", &LineRecord::people, true },
+		{ "aging", &LineRecord::aging, true },
+		{ "dying", &LineRecord::dying, true }
+	});
+
+	clear();
+
+	CohortsRecord record;
+	COHORTS_SCHEMA.read(cohorts, record);
+	mBirthCarry = static_cast<uint32_t>(std::strtoul(record.birth_carry.c_str(), nullptr, 10));
+	mScientistCarry = static_cast<uint32_t>(std::strtoul(record.scientist_carry.c_str(), nullptr, 10));
+
+	XmlNode* node = cohorts->firstChildElement("line");
+	for (auto& line : mLines)
+	{
+		if (!node) { throw std::runtime_error("Population::deserialize(): Savegame is missing cohorts."); }
+
+		LineRecord lineRecord;
+		LINE_SCHEMA.read(node->toElement(), lineRecord);
+
+		if (!fromString(lineRecord.people, line.people) || !fromString(lineRecord.aging, line.aging) || !fromString(lineRecord.dying, line.dying))
+		{
+			throw std::runtime_error("Population::deserialize(): Savegame has malformed cohorts.");
+		}
+
+		node = node->nextSibling();
+	}
+
+	tally();
+	return true;
+}
+
+
+/**
+ * Adds the cohorts and the fractions of people carried over to the next
+ * turn to a state hash.
+ */
+void Population::hash(StateHash& _h) const
+{
+	_h.add(mBirthCarry);
+	_h.add(mScientistCarry);
+
+	for (const Line& line : mLines)
+	{
+		_h.add(line.people.data(), sizeof(line.people));
+		_h.add(line.aging.data(), sizeof(line.aging));
+		_h.add(line.dying.data(), sizeof(line.dying));
+	}
+}
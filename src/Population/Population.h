@@ -2,9 +2,32 @@
 
 #include "Morale.h"
 
-#include <array>
-#include <vector>
+#include "NAS2D/NAS2D.h"
 
+#include <array>
+#include <cstdint>
+
+class SaveGameSnapshot;
+class StateHash;
+
+
+/**
+ * \brief	Age structured population of the colony.
+ *
+ * Colonists are counted in yearly age cohorts. A turn is a month so every
+ * turn a twelfth of each cohort moves on to the next one. Children are
+ * born to adults of child bearing age and everybody has a chance to die
+ * that depends on their age. Both curves are modulated by morale,
+ * nurseries and hospitals.
+ *
+ * Roles follow from age: children become students and students become
+ * workers or, with a university, scientists. Scientists are kept in a
+ * separate line of cohorts so they stay scientists until they retire.
+ *
+ * All rates are 32 bit fixed point fractions. The fractions of a person
+ * that don't add up to a whole one yet are carried over to the next turn
+ * so the update is deterministic and doesn't lose anybody to rounding.
+ */
 class Population
 {
 public:
@@ -21,8 +44,8 @@ public:
 	Population();
 	~Population();
 
-	int size();
-	int size(PersonRole);
+	int size() const;
+	int size(PersonRole) const;
 
 	int birthCount() const { return mBirthCount; }
 	int deathCount() const { return mDeathCount; }
@@ -35,20 +58,46 @@ public:
 
 	void starveRate(float r) { mStarveRate = r; }
 
-protected:
+	void serialize(SaveGameSnapshot& _w);
+	bool deserialize(NAS2D::Xml::XmlElement* _ti);
+
+	void hash(StateHash& _h) const;
+
+public:
+	static const size_t AGE_GROUPS = 120;			/**< Number of yearly age cohorts. */
+
+	typedef std::array<uint32_t, AGE_GROUPS>	Cohorts;
+
+private:
+	/**
+	 * Lines of cohorts.
+	 */
+	enum CohortLine
+	{
+		LINE_GENERAL,		/**< Everybody but scientists. */
+		LINE_SCIENTIST,		/**< Students that became scientists. */
+		LINE_COUNT
+	};
+
+	/**
+	 * People in the cohorts of a line and the fractions of people carried
+	 * over to the next turn.
+	 */
+	struct Line
+	{
+		Cohorts		people;			/**< People in each cohort. */
+		Cohorts		aging;			/**< Fraction of a person about to move on to the next cohort. */
+		Cohorts		dying;			/**< Fraction of a person about to die. */
+	};
 
 private:
 	void init();
-	void clearPopulationList(PersonRole);
+	void tally();
 
-	void spawn_children(int morale, int residences, int nurseries);
-	void spawn_students();
-	void spawn_adults(int universities);
-	void spawn_retiree();
+	void updateRates(int morale, int nurseries, int hospitals);
 
-	void kill_children(int morale, int nurseries);
-	void kill_students(int morale, int hospitals);
-	void kill_adults(Population::PersonRole role, int morale, int hospitals);
+	uint32_t births(int residences, int nurseries);
+	uint32_t age(Line& line, uint32_t inflow);
 
 	uint32_t consume_food(uint32_t _food);
 
@@ -57,14 +106,20 @@ private:
 	typedef std::array<MoraleModifier, 5> MoraleModifiers;
 
 private:
-	uint32_t			mBirthCount;				/**<  */
-	uint32_t			mDeathCount;				/**<  */
+	uint32_t			mBirthCount;				/**< Children born during the last update. */
+	uint32_t			mDeathCount;				/**< People that died during the last update. */
 
 	float				mStarveRate;				/**< Amount of population that dies during food shortages in percent. */
 
-	PopulationTable		mPopulation;				/**< Current population. */
-	PopulationTable		mPopulationGrowth;			/**< Population growth table. */
-	PopulationTable		mPopulationDeath;			/**< Population death table. */
+	Line				mLines[LINE_COUNT];			/**< Cohorts of each line. */
+	PopulationTable		mPopulation;				/**< Size of each role, updated whenever the cohorts change. */
+
+	Cohorts				mFertility;					/**< Births per person and turn of each cohort at the current morale. */
+	Cohorts				mMortality;					/**< Deaths per person and turn of each cohort at the current morale. */
+	Cohorts				mLeaving;					/**< People leaving each cohort during the current update. */
+
+	uint32_t			mBirthCarry;				/**< Fraction of a child about to be born. */
+	uint32_t			mScientistCarry;			/**< Fraction of a student about to become a scientist. */
 
 	MoraleModifiers		mModifiers;					/**< Morale modifier table */
 };
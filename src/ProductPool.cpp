@@ -3,6 +3,10 @@
 
 #include "ProductPool.h"
 
+#include "AttributeSchema.h"
+#include "SaveGameSnapshot.h"
+#include "StateHash.h"
+
 #include <NAS2D/NAS2D.h>
 
 using namespace NAS2D;
@@ -11,7 +15,7 @@ using namespace NAS2D::Xml;
 /**
  * Space required to store a Product.
  */
-std::map<ProductType, int> PRODUCT_STORAGE_VALUE =
+constexpr ProductEntry<int> PRODUCT_STORAGE_VALUES[] =
 {
 	{ PRODUCT_DIGGER, 10 },
 	{ PRODUCT_DOZER, 10 },
@@ -26,11 +30,19 @@ std::map<ProductType, int> PRODUCT_STORAGE_VALUE =
 	{ PRODUCT_MEDICINE, 1 }
 };
 
+static_assert(coversEveryProduct(PRODUCT_STORAGE_VALUES), "PRODUCT_STORAGE_VALUES needs exactly one entry for every product in PRODUCT_TYPES.");
+
+
+/**
+ * Storage space indexed by ProductType.
+ */
+constexpr std::array<int, PRODUCT_COUNT> PRODUCT_STORAGE_VALUE = makeProductTable(PRODUCT_STORAGE_VALUES);
+
 
 /**
  * Gets the amount of storage required for one unit of a Product.
  */
-inline int storageRequiredPerUnit(ProductType type)
+int storageRequiredPerUnit(ProductType type)
 {
 	return PRODUCT_STORAGE_VALUE[type];
 }
@@ -157,17 +169,17 @@ void ProductPool::verifyCount()
 /**
  * 
  */
-void ProductPool::serialize(NAS2D::Xml::XmlElement* _ti)
-{
-	_ti->attribute(constants::SAVE_GAME_PRODUCT_DIGGER,				count(PRODUCT_DIGGER));
-	_ti->attribute(constants::SAVE_GAME_PRODUCT_DOZER,				count(PRODUCT_DOZER));
-	_ti->attribute(constants::SAVE_GAME_PRODUCT_MINER,				count(PRODUCT_MINER));
-	_ti->attribute(constants::SAVE_GAME_PRODUCT_EXPLORER,			count(PRODUCT_EXPLORER));
-	_ti->attribute(constants::SAVE_GAME_PRODUCT_TRUCK,				count(PRODUCT_TRUCK));
-	_ti->attribute(constants::SAVE_GAME_PRODUCT_ROAD_MATERIALS,		count(PRODUCT_ROAD_MATERIALS));
-	_ti->attribute(constants::SAVE_GAME_MAINTENANCE_PARTS,			count(PRODUCT_MAINTENANCE_PARTS));
-	_ti->attribute(constants::SAVE_GAME_PRODUCT_CLOTHING,			count(PRODUCT_CLOTHING));
-	_ti->attribute(constants::SAVE_GAME_PRODUCT_MEDICINE,			count(PRODUCT_MEDICINE));
+void ProductPool::serialize(SaveGameSnapshot& _w)
+{
+	_w.attribute(constants::SAVE_GAME_PRODUCT_DIGGER,				count(PRODUCT_DIGGER));
+	_w.attribute(constants::SAVE_GAME_PRODUCT_DOZER,				count(PRODUCT_DOZER));
+	_w.attribute(constants::SAVE_GAME_PRODUCT_MINER,				count(PRODUCT_MINER));
+	_w.attribute(constants::SAVE_GAME_PRODUCT_EXPLORER,			count(PRODUCT_EXPLORER));
+	_w.attribute(constants::SAVE_GAME_PRODUCT_TRUCK,				count(PRODUCT_TRUCK));
+	_w.attribute(constants::SAVE_GAME_PRODUCT_ROAD_MATERIALS,		count(PRODUCT_ROAD_MATERIALS));
+	_w.attribute(constants::SAVE_GAME_MAINTENANCE_PARTS,			count(PRODUCT_MAINTENANCE_PARTS));
+	_w.attribute(constants::SAVE_GAME_PRODUCT_CLOTHING,			count(PRODUCT_CLOTHING));
+	_w.attribute(constants::SAVE_GAME_PRODUCT_MEDICINE,			count(PRODUCT_MEDICINE));
 }
 
 
@@ -179,20 +191,28 @@ void ProductPool::deserialize(NAS2D::Xml::XmlElement* _ti)
 	/// \todo	This should probably trigger an exception.
 	if (_ti == nullptr) { return; }
 
-	XmlAttribute* attribute = _ti->firstAttribute();
-	while (attribute)
+	static const AttributeTable PRODUCT_ATTRIBUTES("products",
 	{
-		if (attribute->name() == constants::SAVE_GAME_PRODUCT_DIGGER)				{ attribute->queryIntValue(mProducts[PRODUCT_DIGGER]); }
-		else if (attribute->name() == constants::SAVE_GAME_PRODUCT_DOZER)			{ attribute->queryIntValue(mProducts[PRODUCT_DOZER]); }
-		else if (attribute->name() == constants::SAVE_GAME_PRODUCT_MINER)			{ attribute->queryIntValue(mProducts[PRODUCT_MINER]); }
-		else if (attribute->name() == constants::SAVE_GAME_PRODUCT_EXPLORER)		{ attribute->queryIntValue(mProducts[PRODUCT_EXPLORER]); }
-		else if (attribute->name() == constants::SAVE_GAME_PRODUCT_TRUCK)			{ attribute->queryIntValue(mProducts[PRODUCT_TRUCK]); }
-		else if (attribute->name() == constants::SAVE_GAME_PRODUCT_ROAD_MATERIALS)	{ attribute->queryIntValue(mProducts[PRODUCT_ROAD_MATERIALS]); }
-		else if (attribute->name() == constants::SAVE_GAME_MAINTENANCE_PARTS)		{ attribute->queryIntValue(mProducts[PRODUCT_MAINTENANCE_PARTS]); }
-		else if (attribute->name() == constants::SAVE_GAME_PRODUCT_CLOTHING)		{ attribute->queryIntValue(mProducts[PRODUCT_CLOTHING]); }
-		else if (attribute->name() == constants::SAVE_GAME_PRODUCT_MEDICINE)		{ attribute->queryIntValue(mProducts[PRODUCT_MEDICINE]); }
-
-		attribute = attribute->next();
-	}
+		{ constants::SAVE_GAME_PRODUCT_DIGGER, PRODUCT_DIGGER },
+		{ constants::SAVE_GAME_PRODUCT_DOZER, PRODUCT_DOZER },
+		{ constants::SAVE_GAME_PRODUCT_MINER, PRODUCT_MINER },
+		{ constants::SAVE_GAME_PRODUCT_EXPLORER, PRODUCT_EXPLORER },
+		{ constants::SAVE_GAME_PRODUCT_TRUCK, PRODUCT_TRUCK },
+		{ constants::SAVE_GAME_PRODUCT_ROAD_MATERIALS, PRODUCT_ROAD_MATERIALS },
+		{ constants::SAVE_GAME_MAINTENANCE_PARTS, PRODUCT_MAINTENANCE_PARTS },
+		{ constants::SAVE_GAME_PRODUCT_CLOTHING, PRODUCT_CLOTHING },
+		{ constants::SAVE_GAME_PRODUCT_MEDICINE, PRODUCT_MEDICINE }
+	});
+
+	PRODUCT_ATTRIBUTES.read(_ti, [this](int key, XmlAttribute* attribute) { attribute->queryIntValue(mProducts[key]); });
 	mCurrentStorageCount = computeCurrentStorage(mProducts);
 }
+
+
+/**
+ * Adds the count of every product to a state hash.
+ */
+void ProductPool::hash(StateHash& _h) const
+{
+	for (int count : mProducts) { _h.add(count); }
+}
@@ -6,6 +6,9 @@
 
 #include <array>
 
+class SaveGameSnapshot;
+class StateHash;
+
 
 class ProductPool
 {
@@ -32,8 +35,9 @@ public:
 
 	int availableStorage() const;
 
-	void serialize(NAS2D::Xml::XmlElement* _ti);
+	void serialize(SaveGameSnapshot& _w);
 	void deserialize(NAS2D::Xml::XmlElement* _ti);
+	void hash(StateHash& _h) const;
 
 	void verifyCount();
 
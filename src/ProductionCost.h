@@ -1,45 +1,44 @@
 #pragma once
 
+#include <array>
+
 /**
  * \brief	Defines cost in materials per turn.
- * 
+ *
  * Basically just a storage class used to contain resource costs per turn and turn count
  * needed to produce a particular item.
+ *
+ * \note	Costs are kept in the same order as the refined resources of a ResourcePool
+ *			so that the two can be compared and subtracted in a single pass.
  */
 class ProductionCost
 {
 public:
-	ProductionCost() {}
+	typedef std::array<int, 4> ResourceCosts;
+
+public:
+	constexpr ProductionCost() {}
 
-	ProductionCost(int turns, int commonMetals, int commonMinerals, int rareMetals, int rareMinerals) :
+	constexpr ProductionCost(int turns, int commonMetals, int commonMinerals, int rareMetals, int rareMinerals) :
 		mTurnsToBuild(turns),
-		mCommonMetals(commonMetals),
-		mCommonMinerals(commonMinerals),
-		mRareMetals(rareMetals),
-		mRareMinerals(rareMinerals)
+		mResources{ { commonMetals, commonMinerals, rareMetals, rareMinerals } }
 	{}
 
-	~ProductionCost() {}
-
 	void clear()
 	{
 		mTurnsToBuild = 0;
-		mCommonMetals = 0;
-		mCommonMinerals = 0;
-		mRareMetals = 0;
-		mRareMinerals = 0;
+		mResources = {{ 0 }};
 	}
 
-	int turnsToBuild() const { return mTurnsToBuild; }
-	int commonMetals() const { return mCommonMetals; }
-	int commonMinerals() const { return mCommonMinerals; }
-	int rareMetals() const { return mRareMetals; }
-	int rareMinerals() const { return mRareMinerals; }
+	constexpr int turnsToBuild() const { return mTurnsToBuild; }
+	constexpr int commonMetals() const { return mResources[0]; }
+	constexpr int commonMinerals() const { return mResources[1]; }
+	constexpr int rareMetals() const { return mResources[2]; }
+	constexpr int rareMinerals() const { return mResources[3]; }
+
+	constexpr const ResourceCosts& resources() const { return mResources; }
 
 private:
 	int				mTurnsToBuild = 0;
-	int				mCommonMetals = 0;
-	int				mCommonMinerals = 0;
-	int				mRareMetals = 0;
-	int				mRareMinerals = 0;
+	ResourceCosts	mResources = {{ 0 }};		/**< Common metals, common minerals, rare metals, rare minerals. */
 };
@@ -0,0 +1,357 @@
+// This is an open source non-commercial project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+
+#include "ProductionPlanner.h"
+
+#include "AttributeSchema.h"
+#include "Constants.h"
+#include "SaveGameSnapshot.h"
+#include "StructureManager.h"
+
+#include <algorithm>
+#include <deque>
+
+using namespace NAS2D;
+using namespace NAS2D::Xml;
+
+
+/**
+ * A unit of work in the projected timeline of a factory.
+ */
+struct PlannedUnit
+{
+	ProductType		product = PRODUCT_NONE;
+	bool			planned = false;		/**< Unit was assigned by the plan rather than already being worked on. */
+};
+
+
+/**
+ * Projected timeline of a factory.
+ */
+struct FactoryTimeline
+{
+	Factory*					factory = nullptr;
+	std::deque<PlannedUnit>		units;
+	int							progress = 0;		/**< Turns spent on the first unit. */
+	int							freeTurn = 0;		/**< Turns until every unit in the timeline is built. */
+};
+
+
+/**
+ * Gets the number of turns it takes to build a unit of a product.
+ *
+ * \note	A factory completes a product on the turn after it has worked on it
+ *			for ProductionCost::turnsToBuild() turns and it pays the production
+ *			cost on that turn as well.
+ */
+static int unitTurns(ProductType product)
+{
+	return productCost(product).turnsToBuild() + 1;
+}
+
+
+/**
+ * Determines if a factory works on its production in the coming turns.
+ */
+static bool factoryWorking(const Factory* factory)
+{
+	return (factory->operational() || factory->isIdle()) && !factory->forceIdle();
+}
+
+
+/**
+ * Sets the colony the next plan is made for.
+ *
+ * \param	stock		Products in warehouses and robots in the robot pool.
+ * \param	resources	Refined resources in storage.
+ * \param	income		Refined resources brought into storage per turn.
+ */
+void ProductionPlanner::colony(const ProductPool::ProductTypeCount& stock, const Resources& resources, const Resources& income)
+{
+	mStock = stock;
+	mResources = resources;
+	mIncome = income;
+}
+
+
+/**
+ * Solves the plan again if any of its inputs changed since it was last
+ * solved.
+ */
+const ProductionPlanner::Plan& ProductionPlanner::update()
+{
+	std::vector<int> key;
+	inputKey(key);
+
+	if (key != mKey)
+	{
+		mKey.swap(key);
+		solve();
+	}
+
+	return mPlan;
+}
+
+
+/**
+ * Drops the targets and the last plan.
+ */
+void ProductionPlanner::clear()
+{
+	mTargets.fill(0);
+	mStock.fill(0);
+	mResources.fill(0);
+	mIncome.fill(0);
+
+	mKey.clear();
+	mPlan = Plan();
+}
+
+
+/**
+ * Writes the targets to a savegame.
+ */
+void ProductionPlanner::serialize(SaveGameSnapshot& _w)
+{
+	_w.openElement("production_targets");
+	_w.attribute(constants::SAVE_GAME_PRODUCT_DIGGER,				mTargets[PRODUCT_DIGGER]);
+	_w.attribute(constants::SAVE_GAME_PRODUCT_DOZER,				mTargets[PRODUCT_DOZER]);
+	_w.attribute(constants::SAVE_GAME_PRODUCT_MINER,				mTargets[PRODUCT_MINER]);
+	_w.attribute(constants::SAVE_GAME_PRODUCT_EXPLORER,			mTargets[PRODUCT_EXPLORER]);
+	_w.attribute(constants::SAVE_GAME_PRODUCT_TRUCK,				mTargets[PRODUCT_TRUCK]);
+	_w.attribute(constants::SAVE_GAME_PRODUCT_ROAD_MATERIALS,		mTargets[PRODUCT_ROAD_MATERIALS]);
+	_w.attribute(constants::SAVE_GAME_MAINTENANCE_PARTS,			mTargets[PRODUCT_MAINTENANCE_PARTS]);
+	_w.attribute(constants::SAVE_GAME_PRODUCT_CLOTHING,			mTargets[PRODUCT_CLOTHING]);
+	_w.attribute(constants::SAVE_GAME_PRODUCT_MEDICINE,			mTargets[PRODUCT_MEDICINE]);
+	_w.closeElement();
+}
+
+
+/**
+ * Reads the targets from a savegame.
+ *
+ * \note	Savegames written before targets were saved have no targets
+ *			element. The targets are left as they are in that case.
+ */
+void ProductionPlanner::deserialize(XmlElement* _ti)
+{
+	static const AttributeTable TARGET_ATTRIBUTES("production_targets",
+	{
+		{ constants::SAVE_GAME_PRODUCT_DIGGER, PRODUCT_DIGGER },
+		{ constants::SAVE_GAME_PRODUCT_DOZER, PRODUCT_DOZER },
+		{ constants::SAVE_GAME_PRODUCT_MINER, PRODUCT_MINER },
+		{ constants::SAVE_GAME_PRODUCT_EXPLORER, PRODUCT_EXPLORER },
+		{ constants::SAVE_GAME_PRODUCT_TRUCK, PRODUCT_TRUCK },
+		{ constants::SAVE_GAME_PRODUCT_ROAD_MATERIALS, PRODUCT_ROAD_MATERIALS },
+		{ constants::SAVE_GAME_MAINTENANCE_PARTS, PRODUCT_MAINTENANCE_PARTS },
+		{ constants::SAVE_GAME_PRODUCT_CLOTHING, PRODUCT_CLOTHING },
+		{ constants::SAVE_GAME_PRODUCT_MEDICINE, PRODUCT_MEDICINE }
+	});
+
+	TARGET_ATTRIBUTES.read(_ti, [this](int key, XmlAttribute* attribute) { attribute->queryIntValue(mTargets[key]); });
+}
+
+
+/**
+ * Gets everything a plan depends on as a list of values that can be compared.
+ */
+void ProductionPlanner::inputKey(std::vector<int>& key) const
+{
+	key.insert(key.end(), mTargets.begin(), mTargets.end());
+	key.insert(key.end(), mStock.begin(), mStock.end());
+	key.insert(key.end(), mResources.begin(), mResources.end());
+	key.insert(key.end(), mIncome.begin(), mIncome.end());
+
+	for (auto structure : Utility<StructureManager>::get().structureList(Structure::CLASS_FACTORY))
+	{
+		Factory* factory = static_cast<Factory*>(structure);
+
+		key.push_back(static_cast<int>(factory->state()));
+		key.push_back(factory->forceIdle());
+		key.push_back(factory->productType());
+		key.push_back(factory->productWaiting());
+		key.push_back(factory->productionTurnsCompleted());
+		key.push_back(factory->queued());
+
+		for (const Factory::ProductionOrder& order : factory->productionQueue())
+		{
+			key.push_back(order.product);
+			key.push_back(order.count);
+			key.push_back(order.stock);
+		}
+
+		key.push_back(PRODUCT_NONE);
+	}
+}
+
+
+/**
+ * Solves the plan.
+ */
+void ProductionPlanner::solve()
+{
+	mPlan = Plan();
+	mPlan.stock = mStock;
+
+	std::vector<FactoryTimeline> timelines;
+
+	// Work already in the factories counts towards the stock and keeps them busy.
+	for (auto structure : Utility<StructureManager>::get().structureList(Structure::CLASS_FACTORY))
+	{
+		Factory* factory = static_cast<Factory*>(structure);
+
+		if (factory->productWaiting() != PRODUCT_NONE) { ++mPlan.stock[factory->productWaiting()]; }
+
+		FactoryTimeline timeline;
+		timeline.factory = factory;
+
+		if (factory->productType() != PRODUCT_NONE)
+		{
+			timeline.units.push_back({ factory->productType(), false });
+			timeline.progress = factory->productionTurnsCompleted();
+		}
+
+		if (factory->queued())
+		{
+			for (const Factory::ProductionOrder& order : factory->productionQueue())
+			{
+				for (int i = 0; i < order.count && order.stock == 0; ++i) { timeline.units.push_back({ order.product, false }); }
+			}
+		}
+
+		// Work in a factory that's stopped won't be finished so it's planned again.
+		if (!factoryWorking(factory)) { continue; }
+
+		for (const PlannedUnit& unit : timeline.units) { ++mPlan.stock[unit.product]; }
+		for (const PlannedUnit& unit : timeline.units) { timeline.freeTurn += unitTurns(unit.product); }
+		timeline.freeTurn -= timeline.progress;
+
+		timelines.push_back(timeline);
+	}
+
+	for (ProductType product : PRODUCT_TYPES)
+	{
+		mPlan.shortfall[product] = std::max(mTargets[product] - mPlan.stock[product], 0);
+
+		const Resources& costs = productCost(product).resources();
+		for (size_t i = 0; i < costs.size(); ++i)
+		{
+			mPlan.bill[i] += costs[i] * unitTurns(product) * mPlan.shortfall[product];
+		}
+	}
+
+	// Products fewer factories can build are handed out first so they aren't
+	// crowded out by products any factory can build.
+	std::array<int, PRODUCT_COUNT> capable = {{ 0 }};
+	for (const FactoryTimeline& timeline : timelines)
+	{
+		for (ProductType product : timeline.factory->productList()) { ++capable[product]; }
+	}
+
+	std::vector<ProductType> products(PRODUCT_TYPES.begin(), PRODUCT_TYPES.end());
+	std::stable_sort(products.begin(), products.end(), [&capable](ProductType a, ProductType b) { return capable[a] < capable[b]; });
+
+	for (ProductType product : products)
+	{
+		for (int unit = 0; unit < mPlan.shortfall[product]; ++unit)
+		{
+			FactoryTimeline* best = nullptr;
+			for (FactoryTimeline& timeline : timelines)
+			{
+				const Factory::ProductionTypeList& list = timeline.factory->productList();
+				if (std::find(list.begin(), list.end(), product) == list.end()) { continue; }
+				if (!best || timeline.freeTurn < best->freeTurn) { best = &timeline; }
+			}
+
+			if (!best)
+			{
+				mPlan.unassigned[product] = mPlan.shortfall[product] - unit;
+				break;
+			}
+
+			best->units.push_back({ product, true });
+			best->freeTurn += unitTurns(product);
+		}
+	}
+
+	// Orders are the runs of planned units of the same product.
+	for (const FactoryTimeline& timeline : timelines)
+	{
+		Assignment assignment;
+		assignment.factory = timeline.factory;
+
+		for (const PlannedUnit& unit : timeline.units)
+		{
+			if (!unit.planned) { continue; }
+
+			if (assignment.orders.empty() || assignment.orders.back().product != unit.product)
+			{
+				Factory::ProductionOrder order;
+				order.product = unit.product;
+				assignment.orders.push_back(order);
+			}
+
+			++assignment.orders.back().count;
+		}
+
+		if (!assignment.orders.empty()) { mPlan.assignments.push_back(assignment); }
+	}
+
+	// Runs the factories turn by turn, paying for production from storage.
+	Resources pool = mResources;
+	int plannedLeft = 0;
+	for (ProductType product : PRODUCT_TYPES) { plannedLeft += mPlan.shortfall[product] - mPlan.unassigned[product]; }
+
+	for (int turn = 1; turn <= constants::PLANNER_TURNS && plannedLeft > 0; ++turn)
+	{
+		for (FactoryTimeline& timeline : timelines)
+		{
+			if (timeline.units.empty()) { continue; }
+
+			const PlannedUnit& unit = timeline.units.front();
+			const Resources& costs = productCost(unit.product).resources();
+
+			bool affordable = true;
+			for (size_t i = 0; i < costs.size(); ++i) { affordable &= pool[i] >= costs[i]; }
+			if (!affordable) { continue; }
+
+			for (size_t i = 0; i < costs.size(); ++i) { pool[i] -= costs[i]; }
+
+			if (++timeline.progress < unitTurns(unit.product)) { continue; }
+
+			if (unit.planned)
+			{
+				mPlan.completionTurn[unit.product] = turn;
+				--plannedLeft;
+			}
+
+			timeline.units.pop_front();
+			timeline.progress = 0;
+		}
+
+		for (size_t i = 0; i < pool.size(); ++i) { pool[i] += mIncome[i]; }
+	}
+
+	// Products that aren't all built within the planning horizon have no completion turn.
+	for (const FactoryTimeline& timeline : timelines)
+	{
+		for (const PlannedUnit& unit : timeline.units)
+		{
+			if (unit.planned) { mPlan.completionTurn[unit.product] = 0; }
+		}
+	}
+
+	bool complete = plannedLeft == 0;
+	for (ProductType product : PRODUCT_TYPES)
+	{
+		if (mPlan.unassigned[product] > 0)
+		{
+			mPlan.completionTurn[product] = 0;
+			complete = false;
+		}
+	}
+
+	if (!complete) { return; }
+
+	for (ProductType product : PRODUCT_TYPES) { mPlan.turns = std::max(mPlan.turns, mPlan.completionTurn[product]); }
+}
@@ -0,0 +1,100 @@
+#pragma once
+
+#include "ProductPool.h"
+#include "ProductionCost.h"
+
+#include "Things/Structures/Factory.h"
+
+#include <array>
+#include <vector>
+
+class SaveGameSnapshot;
+
+
+/**
+ * \brief	Plans the production needed to bring the colony up to target stocks.
+ *
+ * Given a target stock for each product the planner works out how many of
+ * each product are still missing, what they cost in refined resources and
+ * which factories should build them. Units are handed out one at a time to
+ * the capable factory that frees up first, products that fewer factories can
+ * build going first. Completion turns are then projected by running the
+ * factories turn by turn against the refined resources in storage and the
+ * refined resource income.
+ *
+ * Products that are waiting in factories count towards the stock, as do
+ * products being built or counted in production queues of factories that
+ * are working, so that a plan that's been applied doesn't plan the same
+ * products again.
+ *
+ * A plan is only solved again when its inputs change, i.e. when the targets,
+ * the colony stock, the refined resources or the state of a factory change.
+ *
+ * Targets are saved with the game. They aren't part of the state hash
+ * replays are checked against as setting them doesn't change the game.
+ *
+ * \note	Reads factories directly so it may only be used on the main thread.
+ */
+class ProductionPlanner
+{
+public:
+	typedef ProductionCost::ResourceCosts Resources;
+
+	/**
+	 * Orders a plan gives to a factory.
+	 */
+	struct Assignment
+	{
+		Factory*							factory = nullptr;
+		std::vector<Factory::ProductionOrder>	orders;
+	};
+
+	/**
+	 * Result of solving a plan.
+	 */
+	struct Plan
+	{
+		ProductPool::ProductTypeCount	stock = {{ 0 }};			/**< Products in the colony, including the ones in factories. */
+		ProductPool::ProductTypeCount	shortfall = {{ 0 }};		/**< Products missing from the targets. */
+		ProductPool::ProductTypeCount	unassigned = {{ 0 }};		/**< Missing products no factory can build. */
+		ProductPool::ProductTypeCount	completionTurn = {{ 0 }};	/**< Turns until the missing products are built. 0 if they won't be within constants::PLANNER_TURNS. */
+
+		Resources						bill = {{ 0 }};				/**< Refined resources needed to build the missing products. */
+		int								turns = 0;					/**< Turns until every missing product is built. 0 if it won't be within constants::PLANNER_TURNS. */
+
+		std::vector<Assignment>			assignments;
+	};
+
+public:
+	ProductionPlanner() = default;
+	~ProductionPlanner() = default;
+
+	void targets(const ProductPool::ProductTypeCount& targets) { mTargets = targets; }
+	const ProductPool::ProductTypeCount& targets() const { return mTargets; }
+
+	void colony(const ProductPool::ProductTypeCount& stock, const Resources& resources, const Resources& income);
+
+	const Plan& update();
+	const Plan& plan() const { return mPlan; }
+
+	void clear();
+
+	void serialize(SaveGameSnapshot& _w);
+	void deserialize(NAS2D::Xml::XmlElement* _ti);
+
+private:
+	ProductionPlanner(const ProductionPlanner&) = delete;
+	ProductionPlanner& operator=(const ProductionPlanner&) = delete;
+
+	void inputKey(std::vector<int>& key) const;
+	void solve();
+
+private:
+	ProductPool::ProductTypeCount	mTargets = {{ 0 }};		/**< Stock to reach of each product. */
+	ProductPool::ProductTypeCount	mStock = {{ 0 }};		/**< Products in warehouses and robots in the robot pool. */
+	Resources						mResources = {{ 0 }};	/**< Refined resources in storage. */
+	Resources						mIncome = {{ 0 }};		/**< Refined resources brought into storage per turn. */
+
+	std::vector<int>				mKey;					/**< Inputs of the last solved plan. */
+	Plan							mPlan;					/**< Last solved plan. */
+};
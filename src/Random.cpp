@@ -0,0 +1,271 @@
+// This is an open source non-commercial project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+
+#include "Random.h"
+
+#include "AttributeSchema.h"
+#include "SaveGameSnapshot.h"
+#include "StateHash.h"
+
+#include <cstdlib>
+#include <random>
+
+using namespace NAS2D::Xml;
+
+
+/**
+ * splitmix64, used to expand seeds into full generator states.
+ */
+static uint64_t splitmix64(uint64_t& x)
+{
+	uint64_t z = (x += 0x9e3779b97f4a7c15ull);
+	z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+	z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+	return z ^ (z >> 31);
+}
+
+
+static inline uint64_t rotl(uint64_t x, int k)
+{
+	return (x << k) | (x >> (64 - k));
+}
+
+
+// ==================================================================================
+// = Xoshiro256
+// ==================================================================================
+
+/**
+ * Seeds the generator.
+ */
+void Xoshiro256::seed(uint64_t seed)
+{
+	for (auto& word : mState) { word = splitmix64(seed); }
+}
+
+
+/**
+ * Gets the next 64 random bits.
+ */
+Xoshiro256::result_type Xoshiro256::operator()()
+{
+	const uint64_t result = rotl(mState[1] * 5, 7) * 9;
+	const uint64_t t = mState[1] << 17;
+
+	mState[2] ^= mState[0];
+	mState[3] ^= mState[1];
+	mState[1] ^= mState[2];
+	mState[0] ^= mState[3];
+
+	mState[2] ^= t;
+	mState[3] = rotl(mState[3], 45);
+
+	return result;
+}
+
+
+/**
+ * Gets a uniformly distributed number in the range [low, high].
+ *
+ * Uses Lemire's multiply and shift method which avoids a division in
+ * almost all cases and, unlike std::uniform_int_distribution, gives the
+ * same results on every platform.
+ */
+int Xoshiro256::range(int low, int high)
+{
+	const uint32_t span = static_cast<uint32_t>(high - low) + 1;
+
+	uint64_t m = ((*this)() >> 32) * span;
+	uint32_t l = static_cast<uint32_t>(m);
+	if (l < span)
+	{
+		const uint32_t threshold = (0u - span) % span;
+		while (l < threshold)
+		{
+			m = ((*this)() >> 32) * span;
+			l = static_cast<uint32_t>(m);
+		}
+	}
+
+	return low + static_cast<int>(m >> 32);
+}
+
+
+/**
+ * Gets the generator state as a hex string.
+ */
+std::string Xoshiro256::state() const
+{
+	static const char HEX[] = "0123456789abcdef";
+
+	std::string out;
+	for (uint64_t word : mState)
+	{
+		for (int shift = 60; shift >= 0; shift -= 4) { out += HEX[(word >> shift) & 0xf]; }
+	}
+
+	return out;
+}
+
+
+/**
+ * Sets the generator state from a string written by state().
+ *
+ * \return	False if the string isn't a valid state. The generator is
+ *			left unchanged in that case.
+ */
+bool Xoshiro256::state(const std::string& hex)
+{
+	if (hex.size() != mState.size() * 16) { return false; }
+	if (hex.find_first_not_of("0123456789abcdefABCDEF") != std::string::npos) { return false; }
+
+	std::array<uint64_t, 4> state;
+	for (size_t i = 0; i < state.size(); ++i)
+	{
+		state[i] = std::strtoull(hex.substr(i * 16, 16).c_str(), nullptr, 16);
+	}
+
+	if (state[0] == 0 && state[1] == 0 && state[2] == 0 && state[3] == 0) { return false; }
+
+	mState = state;
+	return true;
+}
+
+
+/**
+ * Adds the generator state to a state hash.
+ */
+void Xoshiro256::hash(StateHash& _h) const
+{
+	for (uint64_t word : mState) { _h.add(word); }
+}
+
+
+// ==================================================================================
+// = RandomService
+// ==================================================================================
+
+/**
+ * C'tor
+ *
+ * Seeds the service from std::random_device. Call seed() for a
+ * reproducible sequence.
+ */
+RandomService::RandomService()
+{
+	reseed();
+}
+
+
+/**
+ * Picks a new seed from std::random_device and resets all streams.
+ */
+void RandomService::reseed()
+{
+	std::random_device rd;
+	seed((static_cast<uint64_t>(rd()) << 32) | rd());
+}
+
+
+/**
+ * Sets the seed and resets all streams.
+ */
+void RandomService::seed(uint64_t seed)
+{
+	mSeed = seed;
+	for (auto& stream : mStreams)
+	{
+		stream.second.seed(streamSeed(stream.first));
+	}
+}
+
+
+/**
+ * Gets a named stream, creating it if needed.
+ */
+Xoshiro256& RandomService::stream(const std::string& name)
+{
+	auto it = mStreams.find(name);
+	if (it != mStreams.end()) { return it->second; }
+
+	return mStreams.emplace(name, Xoshiro256(streamSeed(name))).first->second;
+}
+
+
+/**
+ * Derives the seed of a stream by hashing its name (FNV-1a) and mixing
+ * it with the service seed.
+ */
+uint64_t RandomService::streamSeed(const std::string& name) const
+{
+	uint64_t hash = 0xcbf29ce484222325ull;
+	for (char c : name)
+	{
+		hash ^= static_cast<unsigned char>(c);
+		hash *= 0x100000001b3ull;
+	}
+
+	uint64_t x = mSeed ^ hash;
+	return splitmix64(x);
+}
+
+
+void RandomService::serialize(SaveGameSnapshot& _w)
+{
+	_w.openElement("random");
+	_w.attribute("seed", std::to_string(mSeed));
+
+	for (auto& stream : mStreams)
+	{
+		_w.openElement("stream");
+		_w.attribute("name", stream.first);
+		_w.attribute("state", stream.second.state());
+		_w.closeElement();
+	}
+
+	_w.closeElement();
+}
+
+
+/**
+ * Restores the seed and stream states from a savegame.
+ *
+ * \note	Savegames written before the seed was recorded don't have a
+ *			random element. The current state is left as is in that case.
+ */
+void RandomService::deserialize(XmlElement* _ti)
+{
+	if (!_ti) { return; }
+
+	struct SeedRecord { std::string seed; };
+	struct StreamRecord { std::string name, state; };
+
+	static const AttributeSchema<SeedRecord> SEED_SCHEMA("random", { { "seed", &SeedRecord::seed, true } });
+	static const AttributeSchema<StreamRecord> STREAM_SCHEMA("stream", { { "name", &StreamRecord::name, true }, { "state", &StreamRecord::state, true } });
+
+	SeedRecord record;
+	SEED_SCHEMA.read(_ti, record);
+	seed(std::strtoull(record.seed.c_str(), nullptr, 10));
+
+	for (XmlNode* node = _ti->firstChildElement("stream"); node; node = node->nextSibling())
+	{
+		StreamRecord streamRecord;
+		STREAM_SCHEMA.read(node->toElement(), streamRecord);
+		stream(streamRecord.name).state(streamRecord.state);
+	}
+}
+
+
+/**
+ * Adds the seed and the state of every stream to a state hash.
+ */
+void RandomService::hash(StateHash& _h) const
+{
+	_h.add(mSeed);
+
+	for (auto& stream : mStreams)
+	{
+		_h.add(stream.first);
+		stream.second.hash(_h);
+	}
+}
@@ -0,0 +1,90 @@
+#pragma once
+
+#include "NAS2D/NAS2D.h"
+
+#include <array>
+#include <cstdint>
+#include <map>
+#include <string>
+
+class SaveGameSnapshot;
+class StateHash;
+
+
+/**
+ * \brief	xoshiro256** pseudo random number generator.
+ *
+ * Small, fast and with well defined output on every platform so a given
+ * seed always produces the same sequence. Satisfies the standard
+ * UniformRandomBitGenerator requirements so it can be used with the
+ * distributions in \c <random> as well.
+ */
+class Xoshiro256
+{
+public:
+	using result_type = uint64_t;
+
+public:
+	explicit Xoshiro256(uint64_t seed = 0) { this->seed(seed); }
+
+	void seed(uint64_t seed);
+
+	static constexpr result_type min() { return 0; }
+	static constexpr result_type max() { return UINT64_MAX; }
+
+	result_type operator()();
+
+	int range(int low, int high);
+
+	std::string state() const;
+	bool state(const std::string& hex);
+
+	void hash(StateHash& _h) const;
+
+private:
+	std::array<uint64_t, 4>		mState;		/**< Generator state. */
+};
+
+
+/**
+ * \brief	Central source of random numbers.
+ *
+ * Each subsystem draws from its own named stream. Streams are derived from
+ * a single seed but are independent of each other so the sequence seen
+ * by one subsystem doesn't depend on how many numbers another has drawn,
+ * and subsystems running on different threads don't share any state.
+ *
+ * The seed and the state of every stream are stored in savegames so a
+ * loaded game continues with exactly the same sequence.
+ *
+ * \note	A stream must only be used by one thread at a time.
+ * \note	References returned by stream() remain valid for the lifetime
+ *			of the service, reseeding resets streams in place.
+ */
+class RandomService
+{
+public:
+	RandomService();
+
+	void seed(uint64_t seed);
+	void reseed();
+	uint64_t seed() const { return mSeed; }
+
+	Xoshiro256& stream(const std::string& name);
+
+	void serialize(SaveGameSnapshot& _w);
+	void deserialize(NAS2D::Xml::XmlElement* _ti);
+
+	void hash(StateHash& _h) const;
+
+private:
+	RandomService(const RandomService&) = delete;
+	RandomService& operator=(const RandomService&) = delete;
+
+private:
+	uint64_t streamSeed(const std::string& name) const;
+
+private:
+	uint64_t							mSeed = 0;		/**< Seed all streams are derived from. */
+	std::map<std::string, Xoshiro256>	mStreams;		/**< Named streams. */
+};
@@ -3,12 +3,18 @@
 
 #include "ResourcePool.h"
 
+#include "AttributeSchema.h"
 #include "Constants.h"
+#include "SaveGameSnapshot.h"
+#include "StateHash.h"
 
 #include <iostream>
 
 using namespace NAS2D::Xml;
 
+static_assert(ResourcePool::RESOURCE_RARE_MINERALS - ResourcePool::RESOURCE_COMMON_METALS + 1 == std::tuple_size<ProductionCost::ResourceCosts>::value,
+	"Production costs must line up with the refined resources of a ResourcePool.");
+
 
 ResourcePool::ResourcePool(int cmo, int cmno, int rmo, int rmno, int cm, int cmn, int rm, int rmn, int f, int e): _capacity(0)
 {
@@ -108,6 +114,47 @@ ResourcePool& ResourcePool::operator-=(const ResourcePool& rhs)
 }
 
 
+/**
+ * Determines if the refined resources in the pool cover a production cost.
+ */
+bool ResourcePool::canAfford(const ProductionCost& cost) const
+{
+	const ProductionCost::ResourceCosts& costs = cost.resources();
+	const int* refined = &_resourceTable[RESOURCE_COMMON_METALS];
+
+	// Every cost is checked so the loop has no early out and can be vectorized.
+	bool affordable = true;
+	for (size_t i = 0; i < costs.size(); ++i)
+	{
+		affordable &= refined[i] >= costs[i];
+	}
+
+	return affordable;
+}
+
+
+/**
+ * Takes a production cost out of the refined resources in the pool.
+ *
+ * \return	False if the pool can't cover the cost. Nothing is taken in that case.
+ */
+bool ResourcePool::spend(const ProductionCost& cost)
+{
+	if (!canAfford(cost)) { return false; }
+
+	const ProductionCost::ResourceCosts& costs = cost.resources();
+	int* refined = &_resourceTable[RESOURCE_COMMON_METALS];
+
+	for (size_t i = 0; i < costs.size(); ++i)
+	{
+		refined[i] -= costs[i];
+	}
+
+	_observerCallback();
+	return true;
+}
+
+
 int ResourcePool::resource(ResourceType _t) const
 {
 	return _resourceTable[_t];
@@ -333,20 +380,20 @@ void ResourcePool::capacity(int _i)
 }
 
 
-void ResourcePool::serialize(XmlElement* _ti)
+void ResourcePool::serialize(SaveGameSnapshot& _w)
 {
-	_ti->attribute(constants::SAVE_GAME_COMMON_METAL_ORE, commonMetalsOre());
-	_ti->attribute(constants::SAVE_GAME_COMMON_MINERAL_ORE, commonMineralsOre());
-	_ti->attribute(constants::SAVE_GAME_RARE_METAL_ORE, rareMetalsOre());
-	_ti->attribute(constants::SAVE_GAME_RARE_MINERAL_ORE, rareMineralsOre());
-
-	_ti->attribute(constants::SAVE_GAME_COMMON_METAL, commonMetals());
-	_ti->attribute(constants::SAVE_GAME_COMMON_MINERAL, commonMinerals());
-	_ti->attribute(constants::SAVE_GAME_RARE_METAL, rareMetals());
-	_ti->attribute(constants::SAVE_GAME_RARE_MINERAL, rareMinerals());
-
-	_ti->attribute(constants::SAVE_GAME_ENERGY, energy());
-	_ti->attribute(constants::SAVE_GAME_FOOD, food());
+	_w.attribute(constants::SAVE_GAME_COMMON_METAL_ORE, commonMetalsOre());
+	_w.attribute(constants::SAVE_GAME_COMMON_MINERAL_ORE, commonMineralsOre());
+	_w.attribute(constants::SAVE_GAME_RARE_METAL_ORE, rareMetalsOre());
+	_w.attribute(constants::SAVE_GAME_RARE_MINERAL_ORE, rareMineralsOre());
+
+	_w.attribute(constants::SAVE_GAME_COMMON_METAL, commonMetals());
+	_w.attribute(constants::SAVE_GAME_COMMON_MINERAL, commonMinerals());
+	_w.attribute(constants::SAVE_GAME_RARE_METAL, rareMetals());
+	_w.attribute(constants::SAVE_GAME_RARE_MINERAL, rareMinerals());
+
+	_w.attribute(constants::SAVE_GAME_ENERGY, energy());
+	_w.attribute(constants::SAVE_GAME_FOOD, food());
 }
 
 
@@ -355,24 +402,32 @@ void ResourcePool::deserialize(XmlElement* _ti)
 	/// \todo	This should probably trigger an exception.
 	if (_ti == nullptr) { return; }
 
-	XmlAttribute* attribute = _ti->firstAttribute();
-	while (attribute)
+	static const AttributeTable RESOURCE_ATTRIBUTES("resources",
 	{
-		if (attribute->name() == constants::SAVE_GAME_COMMON_METAL_ORE) { attribute->queryIntValue(_resourceTable[RESOURCE_COMMON_METALS_ORE]); }
-		else if (attribute->name() == constants::SAVE_GAME_COMMON_MINERAL_ORE){ attribute->queryIntValue(_resourceTable[RESOURCE_COMMON_MINERALS_ORE]); }
-		else if (attribute->name() == constants::SAVE_GAME_RARE_METAL_ORE) { attribute->queryIntValue(_resourceTable[RESOURCE_RARE_METALS_ORE]); }
-		else if (attribute->name() == constants::SAVE_GAME_RARE_MINERAL_ORE) { attribute->queryIntValue(_resourceTable[RESOURCE_RARE_MINERALS_ORE]); }
+		{ constants::SAVE_GAME_COMMON_METAL_ORE, RESOURCE_COMMON_METALS_ORE },
+		{ constants::SAVE_GAME_COMMON_MINERAL_ORE, RESOURCE_COMMON_MINERALS_ORE },
+		{ constants::SAVE_GAME_RARE_METAL_ORE, RESOURCE_RARE_METALS_ORE },
+		{ constants::SAVE_GAME_RARE_MINERAL_ORE, RESOURCE_RARE_MINERALS_ORE },
 
-		else if (attribute->name() == constants::SAVE_GAME_COMMON_METAL) { attribute->queryIntValue(_resourceTable[RESOURCE_COMMON_METALS]); }
-		else if (attribute->name() == constants::SAVE_GAME_COMMON_MINERAL) { attribute->queryIntValue(_resourceTable[RESOURCE_COMMON_MINERALS]); }
-		else if (attribute->name() == constants::SAVE_GAME_RARE_METAL) { attribute->queryIntValue(_resourceTable[RESOURCE_RARE_METALS]); }
-		else if (attribute->name() == constants::SAVE_GAME_RARE_MINERAL) { attribute->queryIntValue(_resourceTable[RESOURCE_RARE_MINERALS]); }
+		{ constants::SAVE_GAME_COMMON_METAL, RESOURCE_COMMON_METALS },
+		{ constants::SAVE_GAME_COMMON_MINERAL, RESOURCE_COMMON_MINERALS },
+		{ constants::SAVE_GAME_RARE_METAL, RESOURCE_RARE_METALS },
+		{ constants::SAVE_GAME_RARE_MINERAL, RESOURCE_RARE_MINERALS },
 
-		else if (attribute->name() == constants::SAVE_GAME_ENERGY) { attribute->queryIntValue(_resourceTable[RESOURCE_ENERGY]); }
-		else if (attribute->name() == constants::SAVE_GAME_FOOD) { attribute->queryIntValue(_resourceTable[RESOURCE_FOOD]); }
+		{ constants::SAVE_GAME_ENERGY, RESOURCE_ENERGY },
+		{ constants::SAVE_GAME_FOOD, RESOURCE_FOOD }
+	});
 
-		attribute = attribute->next();
-	}
+	RESOURCE_ATTRIBUTES.read(_ti, [this](int key, XmlAttribute* attribute) { attribute->queryIntValue(_resourceTable[key]); });
+}
+
+
+/**
+ * Adds the amount of every resource to a state hash.
+ */
+void ResourcePool::hash(StateHash& _h) const
+{
+	for (int amount : _resourceTable) { _h.add(amount); }
 }
 
 
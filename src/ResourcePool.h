@@ -4,6 +4,11 @@
 
 #include "NAS2D/NAS2D.h"
 
+#include "ProductionCost.h"
+
+class SaveGameSnapshot;
+class StateHash;
+
 
 /**
  * Pretty much just an easy container for keeping track of resources.
@@ -91,6 +96,9 @@ public:
 	void pushResources(ResourcePool& rp);
 	void pullResources(ResourcePool& rp);
 
+	bool canAfford(const ProductionCost& cost) const;
+	bool spend(const ProductionCost& cost);
+
 	int capacity() const { return _capacity; }
 	void capacity(int _i);
 
@@ -101,8 +109,9 @@ public:
 
 	bool empty() const;
 
-	void serialize(NAS2D::Xml::XmlElement* _ti);
+	void serialize(SaveGameSnapshot& _w);
 	void deserialize(NAS2D::Xml::XmlElement* _ti);
+	void hash(StateHash& _h) const;
 
 	Callback& resourceObserver() { return _observerCallback; }
 
@@ -0,0 +1,181 @@
+// This is an open source non-commercial project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+
+#include "RobotJobPlanner.h"
+
+#include "Constants.h"
+#include "StructureManager.h"
+
+#include "Map/TileMap.h"
+
+#include <algorithm>
+
+using namespace NAS2D;
+
+
+/**
+ * C'tor
+ *
+ * \param	tileMap		Map to plan tasks on.
+ * \param	ccLocation	Location of the Command Center.
+ */
+RobotJobPlanner::RobotJobPlanner(TileMap& tileMap, const Point_2d& ccLocation) : mTileMap(tileMap)
+{
+	CommSource cc;
+	cc.x = ccLocation.x();
+	cc.y = ccLocation.y();
+	cc.rangeSquared = constants::ROBOT_COM_RANGE * constants::ROBOT_COM_RANGE;
+	mCommSources.push_back(cc);
+
+	for (auto tower : Utility<StructureManager>::get().structureList(Structure::CLASS_COMM))
+	{
+		if (!tower->operational()) { continue; }
+
+		Tile* tile = Utility<StructureManager>::get().tileFromStructure(tower);
+
+		CommSource source;
+		source.x = tile->x();
+		source.y = tile->y();
+		source.rangeSquared = constants::COMM_TOWER_BASE_RANGE * constants::COMM_TOWER_BASE_RANGE;
+		mCommSources.push_back(source);
+	}
+}
+
+
+/**
+ * Plans bulldozing every tile in a rectangle.
+ *
+ * The corners can be given in any order and the rectangle is clipped to
+ * the map.
+ */
+RobotJobPlan RobotJobPlanner::rectangle(int x1, int y1, int x2, int y2, int depth, RobotJob::Priority priority)
+{
+	RobotJobPlan plan;
+
+	int left = std::max(std::min(x1, x2), 0);
+	int right = std::min(std::max(x1, x2), mTileMap.width() - 1);
+	int top = std::max(std::min(y1, y2), 0);
+	int bottom = std::min(std::max(y1, y2), mTileMap.height() - 1);
+
+	if (depth < 0 || depth > mTileMap.maxDepth() || left > right || top > bottom) { return plan; }
+
+	for (int y = top; y <= bottom; ++y)
+	{
+		const Tile* row = mTileMap.row(y, depth);
+		for (int x = left; x <= right; ++x)
+		{
+			const Tile& tile = row[x];
+			if (dozeable(tile) && inCommRange(x, y)) { addTask(plan, tile, priority); }
+			else { ++plan.skipped; }
+		}
+	}
+
+	order(plan);
+	return plan;
+}
+
+
+/**
+ * Plans bulldozing the tiles connected to a tile that need bulldozing.
+ *
+ * The fill spreads north, south, east and west and stops at tiles that
+ * can't be bulldozed, at the edge of communications range and after
+ * constants::ROBOT_AREA_ORDER_MAX_TILES tiles.
+ */
+RobotJobPlan RobotJobPlanner::floodFill(int x, int y, int depth, RobotJob::Priority priority)
+{
+	RobotJobPlan plan;
+
+	Tile* start = mTileMap.getTile(x, y, depth);
+	if (!start || !dozeable(*start) || !inCommRange(x, y)) { return plan; }
+
+	const int width = mTileMap.width();
+	const int height = mTileMap.height();
+
+	std::vector<char> visited(static_cast<size_t>(width * height), 0);
+	std::vector<Point_2d> open;
+
+	visited[static_cast<size_t>(y * width + x)] = 1;
+	open.push_back(Point_2d(x, y));
+
+	const int offsets[4][2] = { { 0, -1 }, { 0, 1 }, { 1, 0 }, { -1, 0 } };
+
+	while (!open.empty() && plan.jobs.size() < static_cast<size_t>(constants::ROBOT_AREA_ORDER_MAX_TILES))
+	{
+		Point_2d pt = open.back();
+		open.pop_back();
+
+		addTask(plan, mTileMap.row(pt.y(), depth)[pt.x()], priority);
+
+		for (const auto& offset : offsets)
+		{
+			int nx = pt.x() + offset[0], ny = pt.y() + offset[1];
+			if (nx < 0 || nx >= width || ny < 0 || ny >= height) { continue; }
+
+			char& seen = visited[static_cast<size_t>(ny * width + nx)];
+			if (seen) { continue; }
+			seen = 1;
+
+			if (dozeable(mTileMap.row(ny, depth)[nx]) && inCommRange(nx, ny)) { open.push_back(Point_2d(nx, ny)); }
+		}
+	}
+
+	order(plan);
+	return plan;
+}
+
+
+/**
+ * Determines if a point is within range of the Command Center or of an
+ * operational comm tower.
+ */
+bool RobotJobPlanner::inCommRange(int x, int y) const
+{
+	for (const auto& source : mCommSources)
+	{
+		float dx = static_cast<float>(x - source.x), dy = static_cast<float>(y - source.y);
+		if (dx * dx + dy * dy <= source.rangeSquared) { return true; }
+	}
+
+	return false;
+}
+
+
+/**
+ * Determines if a tile is terrain that a Robodozer can clear.
+ */
+bool RobotJobPlanner::dozeable(const Tile& tile) const
+{
+	return tile.excavated() && tile.empty() && !tile.hasMine() && tile.index() != TERRAIN_DOZED && tile.index() != TERRAIN_IMPASSABLE;
+}
+
+
+void RobotJobPlanner::addTask(RobotJobPlan& plan, const Tile& tile, RobotJob::Priority priority)
+{
+	RobotJob job;
+	job.type = ROBOT_DOZER;
+	job.x = tile.x();
+	job.y = tile.y();
+	job.depth = tile.depth();
+	job.priority = priority;
+	plan.jobs.push_back(job);
+
+	// A dozer works for as many turns as the terrain index.
+	plan.robotTurns += tile.index();
+}
+
+
+/**
+ * Orders the tasks of a plan from the longest to the shortest.
+ *
+ * Robots take the next task as soon as they're free so starting with the
+ * longest tasks leaves short tasks to even out the finishing times of
+ * the robots at the end of the order.
+ */
+void RobotJobPlanner::order(RobotJobPlan& plan)
+{
+	std::stable_sort(plan.jobs.begin(), plan.jobs.end(), [this](const RobotJob& a, const RobotJob& b)
+	{
+		return mTileMap.row(a.y, a.depth)[a.x].index() > mTileMap.row(b.y, b.depth)[b.x].index();
+	});
+}
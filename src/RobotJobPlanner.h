@@ -0,0 +1,63 @@
+#pragma once
+
+#include "RobotJobQueue.h"
+
+#include "NAS2D/NAS2D.h"
+
+#include <vector>
+
+class Tile;
+class TileMap;
+
+
+/**
+ * Tasks planned for an area order.
+ */
+struct RobotJobPlan
+{
+	std::vector<RobotJob>	jobs;				/**< Tasks in the order they should be queued in. */
+	int						robotTurns = 0;		/**< Number of turns a single robot needs for all of the tasks. */
+	int						skipped = 0;		/**< Tiles in the area that don't need a task or can't take one. */
+};
+
+
+/**
+ * \brief	Plans bulldozing tasks for an area of the map.
+ *
+ * An area is validated in a single pass over the rows of tiles it covers.
+ * Communications range is checked against the Command Center and comm
+ * towers collected once per plan instead of once per tile.
+ *
+ * Tiles that are already bulldozed, aren't excavated, are occupied, have
+ * a mine or are impassable are skipped.
+ */
+class RobotJobPlanner
+{
+public:
+	RobotJobPlanner(TileMap& tileMap, const NAS2D::Point_2d& ccLocation);
+
+	RobotJobPlan rectangle(int x1, int y1, int x2, int y2, int depth, RobotJob::Priority priority);
+	RobotJobPlan floodFill(int x, int y, int depth, RobotJob::Priority priority);
+
+private:
+	/**
+	 * A communications source and the squared distance it reaches.
+	 */
+	struct CommSource
+	{
+		int		x = 0;
+		int		y = 0;
+		float	rangeSquared = 0.0f;
+	};
+
+private:
+	bool inCommRange(int x, int y) const;
+	bool dozeable(const Tile& tile) const;
+
+	void addTask(RobotJobPlan& plan, const Tile& tile, RobotJob::Priority priority);
+	void order(RobotJobPlan& plan);
+
+private:
+	TileMap&				mTileMap;			/**< Map being planned on. */
+	std::vector<CommSource>	mCommSources;		/**< Command Center and operational comm towers. */
+};
@@ -0,0 +1,149 @@
+// This is an open source non-commercial project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+
+#include "RobotJobQueue.h"
+
+#include "AttributeSchema.h"
+#include "SaveGameSnapshot.h"
+#include "StateHash.h"
+
+#include <algorithm>
+#include <unordered_set>
+
+using namespace NAS2D::Xml;
+
+
+/**
+ * Queues a job behind all jobs of the same or a higher priority.
+ */
+void RobotJobQueue::enqueue(const RobotJob& job)
+{
+	remove(job.x, job.y, job.depth);
+
+	auto it = std::find_if(mJobs.begin(), mJobs.end(), [&job](const RobotJob& queued) { return queued.priority < job.priority; });
+	mJobs.insert(it, job);
+}
+
+
+/**
+ * Queues a batch of jobs of the same priority in order.
+ *
+ * Jobs already queued on the tiles of the batch are replaced. The queue
+ * is only walked once no matter the size of the batch.
+ */
+void RobotJobQueue::enqueue(const std::vector<RobotJob>& jobs)
+{
+	if (jobs.empty()) { return; }
+
+	auto key = [](const RobotJob& job) { return (static_cast<uint64_t>(job.depth) << 32) | (static_cast<uint64_t>(job.y) << 16) | static_cast<uint64_t>(job.x); };
+
+	std::unordered_set<uint64_t> tiles;
+	for (const auto& job : jobs) { tiles.insert(key(job)); }
+
+	mJobs.erase(std::remove_if(mJobs.begin(), mJobs.end(), [&](const RobotJob& queued) { return tiles.count(key(queued)) != 0; }), mJobs.end());
+
+	RobotJob::Priority priority = jobs.front().priority;
+	auto it = std::find_if(mJobs.begin(), mJobs.end(), [priority](const RobotJob& queued) { return queued.priority < priority; });
+	mJobs.insert(it, jobs.begin(), jobs.end());
+}
+
+
+/**
+ * Removes the job queued on a tile.
+ *
+ * \return	True if there was a job on the tile.
+ */
+bool RobotJobQueue::remove(int x, int y, int depth)
+{
+	auto it = std::find_if(mJobs.begin(), mJobs.end(), [x, y, depth](const RobotJob& job) { return job.x == x && job.y == y && job.depth == depth; });
+	if (it == mJobs.end()) { return false; }
+
+	mJobs.erase(it);
+	return true;
+}
+
+
+/**
+ * Gets the number of jobs queued for a robot type.
+ */
+int RobotJobQueue::count(RobotType type) const
+{
+	return static_cast<int>(std::count_if(mJobs.begin(), mJobs.end(), [type](const RobotJob& job) { return job.type == type; }));
+}
+
+
+void RobotJobQueue::serialize(SaveGameSnapshot& _w)
+{
+	_w.openElement("robot_jobs");
+
+	for (const auto& job : mJobs)
+	{
+		_w.openElement("job");
+		_w.attribute("type", job.type);
+		_w.attribute("x", job.x);
+		_w.attribute("y", job.y);
+		_w.attribute("depth", job.depth);
+		_w.attribute("priority", job.priority);
+		_w.closeElement();
+	}
+
+	_w.closeElement();
+}
+
+
+/**
+ * Reads the queued jobs from a savegame.
+ *
+ * \note	Savegames written before jobs could be queued don't have a
+ *			robot_jobs element and load with an empty queue.
+ */
+void RobotJobQueue::deserialize(XmlElement* _ti)
+{
+	mJobs.clear();
+	if (!_ti) { return; }
+
+	struct JobRecord { int type = 0, x = 0, y = 0, depth = 0, priority = 0; };
+
+	static const AttributeSchema<JobRecord> JOB_SCHEMA("job",
+	{
+		{ "type", &JobRecord::type, true },
+		{ "x", &JobRecord::x, true },
+		{ "y", &JobRecord::y, true },
+		{ "depth", &JobRecord::depth, true },
+		{ "priority", &JobRecord::priority }
+	});
+
+	for (XmlNode* node = _ti->firstChildElement("job"); node; node = node->nextSibling())
+	{
+		JobRecord record;
+		JOB_SCHEMA.read(node->toElement(), record);
+
+		RobotJob job;
+		job.type = static_cast<RobotType>(record.type);
+		job.x = record.x;
+		job.y = record.y;
+		job.depth = record.depth;
+		job.priority = static_cast<RobotJob::Priority>(record.priority);
+
+		// Jobs are saved in dispatch order.
+		mJobs.push_back(job);
+	}
+}
+
+
+/**
+ * Adds the queued jobs to a state hash.
+ */
+void RobotJobQueue::hash(StateHash& _h) const
+{
+	_h.add(static_cast<uint64_t>(mJobs.size()));
+
+	for (const auto& job : mJobs)
+	{
+		_h.add(job.type);
+		_h.add(job.x);
+		_h.add(job.y);
+		_h.add(job.depth);
+		_h.add(job.priority);
+	}
+}
@@ -0,0 +1,60 @@
+#pragma once
+
+#include "Common.h"
+
+#include "NAS2D/NAS2D.h"
+
+#include <vector>
+
+class SaveGameSnapshot;
+class StateHash;
+
+
+/**
+ * A task queued for the next available robot of a type.
+ */
+struct RobotJob
+{
+	enum Priority
+	{
+		PRIORITY_NORMAL,
+		PRIORITY_URGENT
+	};
+
+	RobotType	type = ROBOT_NONE;
+	int			x = 0;
+	int			y = 0;
+	int			depth = 0;
+	Priority	priority = PRIORITY_NORMAL;
+};
+
+
+/**
+ * \brief	Robot tasks waiting for a robot.
+ *
+ * Jobs are kept in the order they'll be dispatched in, urgent jobs first
+ * and otherwise in the order they were queued. A tile has at most one
+ * job, queuing another one on the same tile replaces it.
+ */
+class RobotJobQueue
+{
+public:
+	RobotJobQueue() = default;
+
+	void enqueue(const RobotJob& job);
+	void enqueue(const std::vector<RobotJob>& jobs);
+	bool remove(int x, int y, int depth);
+	void clear() { mJobs.clear(); }
+
+	std::vector<RobotJob>& jobs() { return mJobs; }
+
+	int count(RobotType type) const;
+	bool empty() const { return mJobs.empty(); }
+
+	void serialize(SaveGameSnapshot& _w);
+	void deserialize(NAS2D::Xml::XmlElement* _ti);
+	void hash(StateHash& _h) const;
+
+private:
+	std::vector<RobotJob>	mJobs;		/**< Jobs in dispatch order. */
+};
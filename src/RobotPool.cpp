@@ -4,6 +4,8 @@
 #include "RobotPool.h"
 #include "RobotPoolHelper.h"
 
+#include "Things/Structures/RobotCommand.h"
+
 #include <algorithm>
 
 extern int ROBOT_ID_COUNTER; /// \fixme	Kludge
@@ -39,18 +41,39 @@ void RobotPool::clear()
 	clearRobots(mMiners);
 	mRobots.clear();
 
+	mIdleDiggers.clear();
+	mIdleDozers.clear();
+	mIdleMiners.clear();
+
 	mRobotControlCount = 0;
 	mRobotControlMax = 0;
 }
 
 
+/**
+ * Removes a robot from the pool and from the command of its Robot
+ * Command Center.
+ *
+ * \note	Doesn't free the robot.
+ */
 void RobotPool::erase(Robot* _r)
 {
-	mRobots.erase(find(mRobots.begin(), mRobots.end(), _r));
+	if (_r->slot(Robot::SLOT_POOL) == Robot::NO_SLOT) { return; }
 
-	eraseRobot(mDiggers, _r);
-	eraseRobot(mDozers, _r);
-	eraseRobot(mMiners, _r);
+	// Robots that aren't on a free list are working.
+	if (_r->slot(Robot::SLOT_IDLE) == Robot::NO_SLOT && mRobotControlCount > 0) { --mRobotControlCount; }
+
+	if (_r->commander()) { _r->commander()->removeRobot(_r); }
+
+	eraseRobot(mRobots, _r, Robot::SLOT_POOL);
+
+	eraseRobot(mDiggers, _r, Robot::SLOT_TYPE);
+	eraseRobot(mDozers, _r, Robot::SLOT_TYPE);
+	eraseRobot(mMiners, _r, Robot::SLOT_TYPE);
+
+	eraseRobot(mIdleDiggers, _r, Robot::SLOT_IDLE);
+	eraseRobot(mIdleDozers, _r, Robot::SLOT_IDLE);
+	eraseRobot(mIdleMiners, _r, Robot::SLOT_IDLE);
 }
 
 
@@ -69,23 +92,26 @@ Robot* RobotPool::addRobot(RobotType _type, int id)
 	switch (_type)
 	{
 	case ROBOT_DOZER:
-		mDozers.push_back(new Robodozer());
+		pushRobot(mDozers, new Robodozer(), Robot::SLOT_TYPE);
 		mDozers.back()->id(_id);
-		mRobots.push_back(mDozers.back());
+		pushRobot(mRobots, mDozers.back(), Robot::SLOT_POOL);
+		pushRobot(mIdleDozers, mDozers.back(), Robot::SLOT_IDLE);
 		return mDozers.back();
 		break;
 
 	case ROBOT_DIGGER:
-		mDiggers.push_back(new Robodigger());
+		pushRobot(mDiggers, new Robodigger(), Robot::SLOT_TYPE);
 		mDiggers.back()->id(_id);
-		mRobots.push_back(mDiggers.back());
+		pushRobot(mRobots, mDiggers.back(), Robot::SLOT_POOL);
+		pushRobot(mIdleDiggers, mDiggers.back(), Robot::SLOT_IDLE);
 		return mDiggers.back();
 		break;
 
 	case ROBOT_MINER:
-		mMiners.push_back(new Robominer());
+		pushRobot(mMiners, new Robominer(), Robot::SLOT_TYPE);
 		mMiners.back()->id(_id);
-		mRobots.push_back(mMiners.back());
+		pushRobot(mRobots, mMiners.back(), Robot::SLOT_POOL);
+		pushRobot(mIdleMiners, mMiners.back(), Robot::SLOT_IDLE);
 		return mMiners.back();
 		break;
 
@@ -101,11 +127,12 @@ Robot* RobotPool::addRobot(RobotType _type, int id)
  * Gets a Robodigger from the pool.
  * 
  * \return	Returns a pointer to an available Robodigger. If no digger is available, returns nullptr.
+ *
+ * \note	The robot stays available until it's put to work with insertRobotIntoTable().
  */
 Robodigger* RobotPool::getDigger()
 {
-	Robodigger* _r = static_cast<Robodigger*>(getRobot(mDiggers));
-	return _r;
+	return mIdleDiggers.empty() ? nullptr : mIdleDiggers.back();
 }
 
 
@@ -116,8 +143,7 @@ Robodigger* RobotPool::getDigger()
  */
 Robodozer* RobotPool::getDozer()
 {
-	Robodozer* _r = static_cast<Robodozer*>(getRobot(mDozers));
-	return _r;
+	return mIdleDozers.empty() ? nullptr : mIdleDozers.back();
 }
 
 
@@ -128,8 +154,7 @@ Robodozer* RobotPool::getDozer()
  */
 Robominer* RobotPool::getMiner()
 {
-	Robominer* _r = static_cast<Robominer*>(getRobot(mMiners));
-	return _r;
+	return mIdleMiners.empty() ? nullptr : mIdleMiners.back();
 }
 
 
@@ -164,20 +189,20 @@ bool RobotPool::robotAvailable(RobotType _type)
 
 
 /**
- * 
+ * Gets the number of idle robots of a given type.
  */
 int RobotPool::getAvailableCount(RobotType _type)
 {
 	switch (_type)
 	{
 	case ROBOT_DIGGER:
-		return getIdleCount(mDiggers);
+		return static_cast<int>(mIdleDiggers.size());
 
 	case ROBOT_DOZER:
-		return getIdleCount(mDozers);
+		return static_cast<int>(mIdleDozers.size());
 
 	case ROBOT_MINER:
-		return getIdleCount(mMiners);
+		return static_cast<int>(mIdleMiners.size());
 
 	default:
 		return 0;
@@ -185,32 +210,6 @@ int RobotPool::getAvailableCount(RobotType _type)
 }
 
 
-/**
- * 
- */
-void RobotPool::InitRobotCtrl(uint32_t maxRobotCtrl)
-{
-	mRobotControlMax = maxRobotCtrl;
-	mRobotControlCount = 0;
-
-	updateRobotControlCount(mDiggers, mRobotControlCount);
-	updateRobotControlCount(mDozers, mRobotControlCount);
-	updateRobotControlCount(mMiners, mRobotControlCount);
-}
-
-
-/**
- * 
- */
-void RobotPool::AddRobotCtrl()
-{
-	if (mRobotControlMax > mRobotControlCount)
-	{
-		++mRobotControlCount;
-	}
-}
-
-
 /**
  * 
  */
@@ -224,7 +223,29 @@ bool RobotPool::insertRobotIntoTable(RobotTileTable& _rm, Robot* _r, Tile* _t)
 	_rm[_r] = _t;
 	_t->pushThing(_r);
 
-	AddRobotCtrl();
+	eraseRobot(mIdleDiggers, _r, Robot::SLOT_IDLE);
+	eraseRobot(mIdleDozers, _r, Robot::SLOT_IDLE);
+	eraseRobot(mIdleMiners, _r, Robot::SLOT_IDLE);
+
+	++mRobotControlCount;
 
 	return true;
 }
+
+
+/**
+ * Returns a robot that finished its task to the free list of its type.
+ *
+ * \note	Only robots that were put to work with insertRobotIntoTable()
+ *			should be released.
+ */
+void RobotPool::releaseRobot(Robot* _r)
+{
+	if (_r->slot(Robot::SLOT_IDLE) != Robot::NO_SLOT) { return; }
+
+	pushRobot(mIdleDiggers, _r, Robot::SLOT_IDLE);
+	pushRobot(mIdleDozers, _r, Robot::SLOT_IDLE);
+	pushRobot(mIdleMiners, _r, Robot::SLOT_IDLE);
+
+	if (mRobotControlCount > 0) { --mRobotControlCount; }
+}
@@ -26,10 +26,8 @@ public:
 	bool robotAvailable(RobotType _type);
 	int getAvailableCount(RobotType _type);
 
-	void InitRobotCtrl(uint32_t MaxRobotCtrl);
 	bool robotCtrlAvailable() { return mRobotControlCount < mRobotControlMax; }
 	bool commandCapacityAvailable() { return mRobots.size() < mRobotControlMax; }
-	void AddRobotCtrl();
 
 	DiggerList& diggers() { return mDiggers; }
 	DozerList& dozers() { return mDozers; }
@@ -38,8 +36,10 @@ public:
 	void clear();
 	void erase(Robot* _r);
 	bool insertRobotIntoTable(RobotTileTable& _rm, Robot* _r, Tile* _t);
+	void releaseRobot(Robot* _r);
 
 	uint32_t robotControlMax() { return mRobotControlMax; }
+	void robotControlMax(uint32_t _max) { mRobotControlMax = _max; }
 	uint32_t currentControlCount() { return mRobotControlCount; }
 	uint32_t availableControlCount() { return robotControlMax() - currentControlCount(); }
 
@@ -52,6 +52,10 @@ private:
 
 	RobotList		mRobots;	// List of all robots by pointer to base class
 
+	DiggerList		mIdleDiggers;	// Free lists of robots that aren't working on a task
+	DozerList		mIdleDozers;
+	MinerList		mIdleMiners;
+
 	uint32_t		mRobotControlMax = 0;
-	uint32_t		mRobotControlCount = 0;
+	uint32_t		mRobotControlCount = 0;	// Number of robots working on a task, kept up to date as robots are put to work and released
 };
@@ -19,46 +19,35 @@ void clearRobots(T& t)
 }
 
 
+/**
+ * Adds a robot to a list if it's of the list's type.
+ */
 template <class T>
-Robot* getRobot(const T& t)
+void pushRobot(T& list, Robot* _r, Robot::ListSlot slot)
 {
-	for (auto robot : t)
-	{
-		if (robot->idle()) { return robot; }
-	}
-	return nullptr;
-}
+	auto robot = dynamic_cast<typename T::value_type>(_r);
+	if (!robot) { return; }
 
-
-template <class T>
-int getIdleCount(const T& t)
-{
-	int count = 0;
-	for (auto robot : t)
-	{
-		if (robot->idle()) { ++count; }
-	}
-
-	return count;
+	robot->slot(slot, list.size());
+	list.push_back(robot);
 }
 
 
+/**
+ * Removes a robot from a list in constant time.
+ *
+ * The last robot of the list takes the place of the removed robot. Does
+ * nothing if the robot isn't in the list.
+ */
 template <class T>
-void updateRobotControlCount(const T& t, uint32_t& controlCounter)
+void eraseRobot(T& list, Robot* _r, Robot::ListSlot slot)
 {
-	for (auto robot : t)
-	{
-		if (!robot->idle() && !robot->dead()) { ++controlCounter; }
-	}
-}
+	size_t index = _r->slot(slot);
+	if (index >= list.size() || list[index] != _r) { return; }
 
+	list[index] = list.back();
+	list[index]->slot(slot, index);
+	list.pop_back();
 
-template <class T>
-void eraseRobot(T& t, Robot* _r)
-{
-	auto it = find(t.begin(), t.end(), _r);
-	if (it != t.end())
-	{
-		t.erase(it);
-	}
+	_r->slot(slot, Robot::NO_SLOT);
 }
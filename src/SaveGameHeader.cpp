@@ -0,0 +1,190 @@
+// This is an open source non-commercial project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+
+#include "SaveGameHeader.h"
+
+#include "CompressedFile.h"
+#include "Constants.h"
+#include "SaveGameSnapshot.h"
+
+#include <cstdlib>
+#include <map>
+
+using namespace NAS2D;
+
+
+/**
+ * Number of bytes read from the start of a savegame when looking for
+ * its header. Large enough for the root tag and a header with a full
+ * thumbnail.
+ */
+static const size_t HEADER_READ_SIZE = 4096;
+
+static const std::string HEADER_ELEMENT = "header";
+
+
+/**
+ * Encodes thumbnail colors as a string of hex RGB triplets.
+ */
+static std::string encodeThumbnail(const std::vector<Color_4ub>& thumbnail)
+{
+	static const char HEX[] = "0123456789abcdef";
+
+	std::string out;
+	out.reserve(thumbnail.size() * 6);
+	for (const auto& color : thumbnail)
+	{
+		for (uint8_t channel : { color.red(), color.green(), color.blue() })
+		{
+			out += HEX[channel >> 4];
+			out += HEX[channel & 0x0f];
+		}
+	}
+
+	return out;
+}
+
+
+/**
+ * Decodes a string written by encodeThumbnail(). Returns an empty list
+ * if the string isn't a complete thumbnail.
+ */
+static std::vector<Color_4ub> decodeThumbnail(const std::string& str)
+{
+	const size_t pixelCount = constants::SAVE_GAME_THUMBNAIL_SIZE * constants::SAVE_GAME_THUMBNAIL_SIZE;
+	if (str.size() != pixelCount * 6) { return {}; }
+
+	auto channel = [&str](size_t offset) { return static_cast<uint8_t>(std::strtoul(str.substr(offset, 2).c_str(), nullptr, 16)); };
+
+	std::vector<Color_4ub> thumbnail;
+	thumbnail.reserve(pixelCount);
+	for (size_t i = 0; i < pixelCount; ++i)
+	{
+		thumbnail.push_back(Color_4ub(channel(i * 6), channel(i * 6 + 2), channel(i * 6 + 4), 255));
+	}
+
+	return thumbnail;
+}
+
+
+/**
+ * Replaces the entity references written by XmlStreamWriter.
+ */
+static std::string unescape(const std::string& str)
+{
+	static const std::map<std::string, char> ENTITIES = { { "&amp;", '&' }, { "&lt;", '<' }, { "&gt;", '>' }, { "&quot;", '"' }, { "&apos;", '\'' } };
+
+	std::string out;
+	for (size_t i = 0; i < str.size(); ++i)
+	{
+		if (str[i] == '&')
+		{
+			size_t end = str.find(';', i);
+			if (end != std::string::npos)
+			{
+				auto it = ENTITIES.find(str.substr(i, end - i + 1));
+				if (it != ENTITIES.end())
+				{
+					out += it->second;
+					i = end;
+					continue;
+				}
+			}
+		}
+
+		out += str[i];
+	}
+
+	return out;
+}
+
+
+/**
+ * Parses the attributes of a start tag, e.g. ' a="1" b="2" />'.
+ */
+static std::map<std::string, std::string> parseAttributes(const std::string& tag)
+{
+	std::map<std::string, std::string> attributes;
+
+	size_t pos = 0;
+	while (true)
+	{
+		size_t equals = tag.find('=', pos);
+		if (equals == std::string::npos) { break; }
+
+		size_t open = tag.find('"', equals);
+		size_t close = open == std::string::npos ? std::string::npos : tag.find('"', open + 1);
+		if (close == std::string::npos) { break; }
+
+		size_t nameStart = tag.find_last_of(" \t\r\n", equals);
+		nameStart = (nameStart == std::string::npos) ? pos : nameStart + 1;
+
+		attributes[tag.substr(nameStart, equals - nameStart)] = unescape(tag.substr(open + 1, close - open - 1));
+		pos = close + 1;
+	}
+
+	return attributes;
+}
+
+
+/**
+ * Records a savegame header.
+ *
+ * \note	Must be called immediately after the root element has been
+ *			opened so the header can be found by readSaveGameHeader().
+ */
+void writeSaveGameHeader(SaveGameSnapshot& _w, const SaveGameHeader& header)
+{
+	_w.openElement(HEADER_ELEMENT);
+	_w.attribute("turn", header.turn);
+	_w.attribute("population", header.population);
+	_w.attribute("morale", header.morale);
+	_w.attribute("sitemap", header.sitemap);
+	_w.attribute("timestamp", std::to_string(static_cast<long long>(header.timestamp)));
+	_w.attribute("thumbnail", encodeThumbnail(header.thumbnail));
+	_w.closeElement();
+}
+
+
+/**
+ * Reads the header of a savegame.
+ *
+ * Only the start of the file is read, decompressing it if needed. If
+ * the file can't be read or doesn't have a header, e.g. it was written
+ * by an older version, the returned header is marked as not valid.
+ */
+SaveGameHeader readSaveGameHeader(const std::string& filename)
+{
+	SaveGameHeader header;
+
+	std::string buffer(HEADER_READ_SIZE, '\0');
+	try
+	{
+		// Compressed savegames are only decompressed as far as needed.
+		CompressedFileReader file(filename);
+		buffer.resize(file.read(&buffer[0], buffer.size()));
+	}
+	catch (const std::exception&)
+	{
+		return header;
+	}
+
+	size_t root = buffer.find("<" + constants::SAVE_GAME_ROOT_NODE);
+	size_t start = buffer.find("<" + HEADER_ELEMENT + " ");
+	if (root == std::string::npos || start == std::string::npos || start < root) { return header; }
+
+	size_t end = buffer.find("/>", start);
+	if (end == std::string::npos) { return header; }
+
+	auto attributes = parseAttributes(buffer.substr(start + HEADER_ELEMENT.size() + 1, end - start - HEADER_ELEMENT.size() - 1));
+
+	header.turn = std::atoi(attributes["turn"].c_str());
+	header.population = std::atoi(attributes["population"].c_str());
+	header.morale = std::atoi(attributes["morale"].c_str());
+	header.sitemap = attributes["sitemap"];
+	header.timestamp = static_cast<std::time_t>(std::atoll(attributes["timestamp"].c_str()));
+	header.thumbnail = decodeThumbnail(attributes["thumbnail"]);
+	header.valid = true;
+
+	return header;
+}
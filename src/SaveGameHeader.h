@@ -0,0 +1,35 @@
+#pragma once
+
+#include "NAS2D/NAS2D.h"
+
+#include <ctime>
+#include <string>
+#include <vector>
+
+class SaveGameSnapshot;
+
+
+/**
+ * \brief	Summary of a savegame used by the savegame browser.
+ *
+ * The header is written as the first child of the savegame's root
+ * element so that it can be read from the first few kilobytes of a file
+ * without parsing the whole document.
+ */
+struct SaveGameHeader
+{
+	int								turn = 0;				/**< Turn count. */
+	int								population = 0;			/**< Total population. */
+	int								morale = 0;				/**< Colony morale. */
+
+	std::string						sitemap;				/**< Site map the game is played on. */
+	std::time_t						timestamp = 0;			/**< Time the game was saved. */
+
+	std::vector<NAS2D::Color_4ub>	thumbnail;				/**< constants::SAVE_GAME_THUMBNAIL_SIZE squared colors in row order. Empty if not available. */
+
+	bool							valid = false;			/**< Header was found and read. */
+};
+
+
+void writeSaveGameHeader(SaveGameSnapshot& _w, const SaveGameHeader& header);
+SaveGameHeader readSaveGameHeader(const std::string& filename);
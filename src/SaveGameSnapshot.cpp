@@ -0,0 +1,166 @@
+// This is an open source non-commercial project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+
+#include "SaveGameSnapshot.h"
+
+#include "XmlStreamWriter.h"
+
+#include <limits>
+#include <stdexcept>
+
+
+/**
+ * Opens a new element as a child of the current element.
+ */
+void SaveGameSnapshot::openElement(const std::string& name)
+{
+	mEntries.push_back({ ENTRY_OPEN, nameIndex(name), 0 });
+}
+
+
+/**
+ * Closes the current element.
+ */
+void SaveGameSnapshot::closeElement()
+{
+	mEntries.push_back({ ENTRY_CLOSE, 0, 0 });
+}
+
+
+/**
+ * Records an attribute on the current element.
+ */
+void SaveGameSnapshot::attribute(const std::string& name, const std::string& value)
+{
+	mEntries.push_back({ ENTRY_ATTRIBUTE_STRING, nameIndex(name), static_cast<int>(mStrings.size()) });
+	mStrings.push_back(value);
+}
+
+
+/**
+ * Records an attribute on the current element.
+ */
+void SaveGameSnapshot::attribute(const std::string& name, int value)
+{
+	mEntries.push_back({ ENTRY_ATTRIBUTE_INT, nameIndex(name), value });
+}
+
+
+/**
+ * Writes the recorded document to a file as XML.
+ *
+ * \param	filename	File to write to. Any existing file is replaced only
+ *						once the new one has been written completely.
+ * \param	compression	Compression to apply to the file.
+ *
+ * \throws	std::runtime_error if the file can't be written.
+ */
+void SaveGameSnapshot::write(const std::string& filename, CompressionType compression) const
+{
+	XmlStreamWriter writer(filename, compression);
+
+	for (const auto& entry : mEntries)
+	{
+		switch (entry.type)
+		{
+		case ENTRY_OPEN:
+			writer.openElement(mNames[entry.name]);
+			break;
+		case ENTRY_CLOSE:
+			writer.closeElement();
+			break;
+		case ENTRY_ATTRIBUTE_INT:
+			writer.attribute(mNames[entry.name], entry.value);
+			break;
+		case ENTRY_ATTRIBUTE_STRING:
+			writer.attribute(mNames[entry.name], mStrings[entry.value]);
+			break;
+		}
+	}
+
+	writer.close();
+}
+
+
+/**
+ * Gets the index of a name in the name table, adding it if it's
+ * not already there.
+ */
+uint16_t SaveGameSnapshot::nameIndex(const std::string& name)
+{
+	auto it = mNameTable.find(name);
+	if (it != mNameTable.end()) { return it->second; }
+
+	if (mNames.size() > std::numeric_limits<uint16_t>::max())
+	{
+		throw std::runtime_error("SaveGameSnapshot::nameIndex(): Too many distinct names.");
+	}
+
+	uint16_t index = static_cast<uint16_t>(mNames.size());
+	mNames.push_back(name);
+	mNameTable[name] = index;
+	return index;
+}
+
+
+/**
+ * D'tor
+ *
+ * Blocks until any save in progress has been written.
+ */
+SaveGameWriter::~SaveGameWriter()
+{
+	wait();
+}
+
+
+/**
+ * Writes a snapshot to disk on the worker thread. Compression is done
+ * on the worker thread as well.
+ *
+ * \note	If a save is already in progress this waits for it to
+ *			finish first.
+ */
+void SaveGameWriter::write(std::unique_ptr<SaveGameSnapshot> snapshot, const std::string& filename, CompressionType compression)
+{
+	wait();
+
+	mBusy = true;
+	mThread = std::thread([this, filename, compression](std::unique_ptr<SaveGameSnapshot> _snapshot)
+	{
+		try
+		{
+			_snapshot->write(filename, compression);
+		}
+		catch (const std::exception& e)
+		{
+			std::lock_guard<std::mutex> lock(mErrorLock);
+			mError = e.what();
+		}
+
+		mBusy = false;
+	}, std::move(snapshot));
+}
+
+
+/**
+ * Blocks until the save in progress, if any, has been written.
+ */
+void SaveGameWriter::wait()
+{
+	if (mThread.joinable()) { mThread.join(); }
+}
+
+
+/**
+ * Gets and clears the error reported by the last failed save.
+ *
+ * \return	Error message or an empty string if there was no error.
+ */
+std::string SaveGameWriter::error()
+{
+	std::lock_guard<std::mutex> lock(mErrorLock);
+	std::string message;
+	message.swap(mError);
+	return message;
+}
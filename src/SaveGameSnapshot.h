@@ -0,0 +1,107 @@
+#pragma once
+
+#include "CompressedFile.h"
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+
+/**
+ * \brief	Compact, immutable record of a savegame.
+ *
+ * Serializers describe the savegame as a sequence of elements and
+ * attributes which are recorded as small fixed size entries. No text is
+ * formatted while recording so taking a snapshot on the main thread is
+ * quick. The recorded document is turned into XML by write() which may
+ * be called from any thread as the snapshot doesn't reference any game
+ * state.
+ *
+ * Attributes apply to the most recently opened element and must be
+ * recorded before any of its children are opened.
+ */
+class SaveGameSnapshot
+{
+public:
+	SaveGameSnapshot() = default;
+
+	void openElement(const std::string& name);
+	void closeElement();
+
+	void attribute(const std::string& name, const std::string& value);
+	void attribute(const std::string& name, int value);
+
+	void write(const std::string& filename, CompressionType compression = COMPRESSION_NONE) const;
+
+private:
+	SaveGameSnapshot(const SaveGameSnapshot&) = delete;
+	SaveGameSnapshot& operator=(const SaveGameSnapshot&) = delete;
+
+private:
+	enum EntryType : uint8_t
+	{
+		ENTRY_OPEN,
+		ENTRY_CLOSE,
+		ENTRY_ATTRIBUTE_INT,
+		ENTRY_ATTRIBUTE_STRING
+	};
+
+	struct Entry
+	{
+		EntryType	type;
+		uint16_t	name;			/**< Index into mNames. */
+		int			value;			/**< Attribute value or index into mStrings. */
+	};
+
+private:
+	uint16_t nameIndex(const std::string& name);
+
+private:
+	std::vector<Entry>							mEntries;		/**< Recorded document. */
+	std::vector<std::string>					mNames;			/**< Element and attribute names. */
+	std::vector<std::string>					mStrings;		/**< String attribute values. */
+	std::unordered_map<std::string, uint16_t>	mNameTable;		/**< Lookup table for mNames. */
+};
+
+
+/**
+ * \brief	Writes savegame snapshots to disk on a worker thread.
+ *
+ * Only one snapshot is written at a time. Queuing a snapshot while
+ * another is still being written waits for the earlier one to finish.
+ * Any save still in progress is completed before the writer is
+ * destroyed.
+ *
+ * Snapshots are written to a temporary file which is renamed over the
+ * target once complete (see XmlStreamWriter). A save that fails or is
+ * interrupted leaves the file it would have replaced as it was.
+ */
+class SaveGameWriter
+{
+public:
+	SaveGameWriter() = default;
+	~SaveGameWriter();
+
+	void write(std::unique_ptr<SaveGameSnapshot> snapshot, const std::string& filename, CompressionType compression);
+	void wait();
+
+	bool busy() const { return mBusy; }
+
+	std::string error();
+
+private:
+	SaveGameWriter(const SaveGameWriter&) = delete;
+	SaveGameWriter& operator=(const SaveGameWriter&) = delete;
+
+private:
+	std::thread			mThread;				/**< Worker thread. */
+	std::atomic<bool>	mBusy{ false };			/**< A snapshot is being written. */
+
+	std::mutex			mErrorLock;				/**< Guards mError. */
+	std::string			mError;					/**< Error from the last failed write, if any. */
+};
@@ -0,0 +1,31 @@
+// This is an open source non-commercial project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+
+#include "StateHash.h"
+
+
+/**
+ * Mixes raw bytes into the hash.
+ */
+void StateHash::add(const void* data, size_t length)
+{
+	const unsigned char* bytes = static_cast<const unsigned char*>(data);
+	for (size_t i = 0; i < length; ++i)
+	{
+		mHash ^= bytes[i];
+		mHash *= 0x100000001b3ull;
+	}
+}
+
+
+/**
+ * Mixes a string into the hash.
+ *
+ * The length goes in first so that neighbouring strings can't run into
+ * each other and hash the same.
+ */
+void StateHash::add(const std::string& str)
+{
+	add(static_cast<uint64_t>(str.size()));
+	add(str.data(), str.size());
+}
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+
+/**
+ * \brief	Running 64-bit FNV-1a hash of the state of the game.
+ *
+ * The parts of the simulation add their state with their hash() function.
+ * Values are mixed in as they're added so hashing the game doesn't record
+ * a savegame or format any text. Replays compare the hash at the end of
+ * every turn to check that they reproduce the recorded game.
+ *
+ * \note	Only state that changes through turns or through commands in the
+ *			command log may be added. The view and the UI are left out.
+ */
+class StateHash
+{
+public:
+	StateHash() = default;
+
+	void add(const void* data, size_t length);
+
+	void add(int value) { add(&value, sizeof(value)); }
+	void add(uint32_t value) { add(&value, sizeof(value)); }
+	void add(uint64_t value) { add(&value, sizeof(value)); }
+	void add(const std::string& str);
+
+	uint64_t value() const { return mHash; }
+
+private:
+	uint64_t	mHash = 0xcbf29ce484222325ull;		/**< FNV-1a offset basis until something is added. */
+};
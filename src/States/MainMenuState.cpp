@@ -7,11 +7,15 @@
 #include "PlanetSelectState.h"
 #include "Wrapper.h"
 
+#include "../AssetPreloader.h"
 #include "../Constants.h"
 #include "../FontManager.h"
+#include "../ImageManager.h"
 
 using namespace NAS2D;
 
+extern NAS2D::Image* IMG_LOADING;	/// \fixme Find a sane place for this.
+
 
 /**
  * C'tor
@@ -39,6 +43,10 @@ MainMenuState::~MainMenuState()
  */
 void MainMenuState::initialize()
 {
+	// The state this one replaced is gone by now so images only it used can go too.
+	Utility<ImageManager>::get().evict();
+	Utility<AssetPreloader>::get().requestManifest();
+
 	EventHandler& e = Utility<EventHandler>::get();
 	e.windowResized().connect(this, &MainMenuState::onWindowResized);
 	e.keyDown().connect(this, &MainMenuState::onKeyDown);
@@ -153,6 +161,9 @@ void MainMenuState::fileIoAction(const std::string& _file, FileIo::FileOperation
 	{
 		checkSavegameVersion(filename);
 
+		// The map view picks up its icons from the atlas, which is built once the manifest is uploaded.
+		Utility<AssetPreloader>::get().finish(*IMG_LOADING);
+
 		MapViewState* mapview = new MapViewState(filename);
 		mapview->_initialize();
 		mapview->activate();
@@ -273,6 +284,8 @@ NAS2D::State* MainMenuState::update()
 {
 	Renderer& r = Utility<Renderer>::get();
 
+	Utility<AssetPreloader>::get().upload(constants::PRELOAD_UPLOADS_PER_FRAME);
+
 	r.clearScreen(0, 0, 0);
 	r.drawImage(mBgImage, r.center_x() - mBgImage.width() / 2, r.center_y() - mBgImage.height() / 2);
 
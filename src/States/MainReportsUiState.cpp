@@ -5,6 +5,7 @@
 
 #include "../Constants.h"
 #include "../FontManager.h"
+#include "../ImageManager.h"
 
 #include "../UI/Reports/ReportInterface.h"
 
@@ -19,7 +20,7 @@ using namespace NAS2D;
 
 extern Point_2d		MOUSE_COORDS;
 
-static Image*		WINDOW_BACKGROUND = nullptr;
+static ImageManager::ImageHandle	WINDOW_BACKGROUND;
 
 Font*				BIG_FONT = nullptr;
 Font*				BIG_FONT_BOLD = nullptr;
@@ -58,7 +59,7 @@ public:
 public:
 	std::string			Name;
 
-	Image*				Img = nullptr;
+	ImageRegion					Img;
 
 	Point_2d			TextPosition;
 	Point_2d			IconPosition;
@@ -135,12 +136,12 @@ static void drawPanel(Renderer& _r, Panel& _p)
 		if (_p.UiPanel) { _p.UiPanel->update(); }
 
 		_r.drawText(*BIG_FONT_BOLD, _p.Name, _p.TextPosition.x(), _p.TextPosition.y(), 185, 185, 0);
-		_r.drawImage(*_p.Img, _p.IconPosition.x(), _p.IconPosition.y(), 1.0f, 185, 185, 0, 255);
+		_p.Img.draw(_r, _p.IconPosition.x(), _p.IconPosition.y(), 185, 185, 0, 255);
 	}
 	else
 	{
 		_r.drawText(*BIG_FONT_BOLD, _p.Name, _p.TextPosition.x(), _p.TextPosition.y(), 0, 185, 0);
-		_r.drawImage(*_p.Img, _p.IconPosition.x(), _p.IconPosition.y(), 1.0f, 0, 185, 0, 255);
+		_p.Img.draw(_r, _p.IconPosition.x(), _p.IconPosition.y(), 0, 185, 0, 255);
 	}
 }
 
@@ -165,11 +166,11 @@ MainReportsUiState::~MainReportsUiState()
 	Utility<EventHandler>::get().keyDown().disconnect(this, &MainReportsUiState::onKeyDown);
 	Utility<EventHandler>::get().mouseButtonDown().disconnect(this, &MainReportsUiState::onMouseDown);
 
-	delete WINDOW_BACKGROUND;
+	WINDOW_BACKGROUND.reset();
 
 	for (Panel& panel : Panels)
 	{
-		delete panel.Img;
+		panel.Img.reset();
 		delete panel.UiPanel;
 	}
 }
@@ -180,29 +181,29 @@ MainReportsUiState::~MainReportsUiState()
  */
 void MainReportsUiState::initialize()
 {
-	WINDOW_BACKGROUND = new Image("ui/skin/window_middle_middle.png");
+	WINDOW_BACKGROUND = Utility<ImageManager>::get().image("ui/skin/window_middle_middle.png");
 
 	BIG_FONT = Utility<FontManager>::get().font(constants::FONT_PRIMARY, 16);
 	BIG_FONT_BOLD = Utility<FontManager>::get().font(constants::FONT_PRIMARY_BOLD, 16);
 
-	Panels[PANEL_EXIT].Img = new Image("ui/icons/exit.png");
+	Panels[PANEL_EXIT].Img = Utility<ImageManager>::get().region("ui/icons/exit.png");
 
-	Panels[PANEL_RESEARCH].Img = new Image("ui/icons/research.png");
+	Panels[PANEL_RESEARCH].Img = Utility<ImageManager>::get().region("ui/icons/research.png");
 	Panels[PANEL_RESEARCH].Name = "Laboratories";
 
-	Panels[PANEL_PRODUCTION].Img = new Image("ui/icons/production.png");
+	Panels[PANEL_PRODUCTION].Img = Utility<ImageManager>::get().region("ui/icons/production.png");
 	Panels[PANEL_PRODUCTION].Name = "Factories";
 
-	Panels[PANEL_WAREHOUSE].Img = new Image("ui/icons/warehouse.png");
+	Panels[PANEL_WAREHOUSE].Img = Utility<ImageManager>::get().region("ui/icons/warehouse.png");
 	Panels[PANEL_WAREHOUSE].Name = "Warehouses";
 
-	Panels[PANEL_MINING].Img = new Image("ui/icons/mine.png");
+	Panels[PANEL_MINING].Img = Utility<ImageManager>::get().region("ui/icons/mine.png");
 	Panels[PANEL_MINING].Name = "Mines";
 
-	Panels[PANEL_SATELLITES].Img = new Image("ui/icons/satellite.png");
+	Panels[PANEL_SATELLITES].Img = Utility<ImageManager>::get().region("ui/icons/satellite.png");
 	Panels[PANEL_SATELLITES].Name = "Satellites";
 
-	Panels[PANEL_SPACEPORT].Img = new Image("ui/icons/spaceport.png");
+	Panels[PANEL_SPACEPORT].Img = Utility<ImageManager>::get().region("ui/icons/spaceport.png");
 	Panels[PANEL_SPACEPORT].Name = "Space Ports";
 
 	Renderer& r = Utility<Renderer>::get();
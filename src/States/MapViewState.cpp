@@ -6,7 +6,10 @@
 
 #include "../Constants.h"
 #include "../FontManager.h"
+#include "../FormattedText.h"
 #include "../GraphWalker.h"
+#include "../ProductionPlanner.h"
+#include "../Random.h"
 #include "../StructureCatalogue.h"
 #include "../StructureTranslator.h"
 
@@ -61,6 +64,9 @@ std::map <int, std::string>	LEVEL_STRING_TABLE =
 
 
 Font* MAIN_FONT = nullptr;
+static Font* MAIN_FONT_BOLD = nullptr;
+
+static FormattedText REPLAY_TEXT("Replaying turn %i");
 
 
 /**
@@ -69,8 +75,8 @@ Font* MAIN_FONT = nullptr;
  * \param	savegame	Save game filename to load.
  */
 MapViewState::MapViewState(const std::string& savegame) :
-	mBackground("sys/bg1.png"),
-	mUiIcons("ui/icons.png"),
+	mBackground(Utility<ImageManager>::get().image("sys/bg1.png")),
+	mUiIcons(Utility<ImageManager>::get().region("ui/icons.png")),
 	mLoadingExisting(true),
 	mExistingToLoad(savegame)
 {
@@ -88,12 +94,23 @@ MapViewState::MapViewState(const std::string& savegame) :
  */
 MapViewState::MapViewState(const std::string& sm, const std::string& t, int d, int mc) :
 	mTileMap(new TileMap(sm, t, d, mc)),
-	mBackground("sys/bg1.png"),
-	mMapDisplay(sm + MAP_DISPLAY_EXTENSION),
-	mHeightMap(sm + MAP_TERRAIN_EXTENSION),
-	mUiIcons("ui/icons.png")
+	mBackground(Utility<ImageManager>::get().image("sys/bg1.png")),
+	mMapDisplay(Utility<ImageManager>::get().image(sm + MAP_DISPLAY_EXTENSION)),
+	mHeightMap(Utility<ImageManager>::get().image(sm + MAP_TERRAIN_EXTENSION)),
+	mUiIcons(Utility<ImageManager>::get().region("ui/icons.png"))
 {
 	Utility<EventHandler>::get().windowResized().connect(this, &MapViewState::onWindowResized);
+
+	// Robot ids start over with every new game so a replay numbers robots the same way.
+	ROBOT_ID_COUNTER = 0;
+
+	CommandLogHeader header;
+	header.seed = Utility<RandomService>::get().seed();
+	header.map = sm;
+	header.tileset = t;
+	header.digDepth = d;
+	header.mineCount = mc;
+	Utility<CommandLog>::get().start(constants::SAVE_GAME_PATH + constants::SAVE_GAME_NEW_GAME_LOG, header);
 }
 
 
@@ -102,7 +119,16 @@ MapViewState::MapViewState(const std::string& sm, const std::string& t, int d, i
  */
 MapViewState::~MapViewState()
 {
+	// The turn being processed is dropped but it has to be stopped before
+	// anything it uses is torn down. What it failed with doesn't matter.
+	try { mTurnWorker.wait(); }
+	catch (...) {}
+
+	Utility<CommandLog>::get().stop();
+	Utility<CommandLog>::get().suspend(false);
+
 	scrubRobotList();
+	mPathFinder.reset();
 	delete mTileMap;
 
 	Utility<Renderer>::get().setCursor(POINTER_NORMAL);
@@ -151,6 +177,13 @@ void MapViewState::initialize()
 	mPopulationPool.population(&mPopulation);
 
 	if (mLoadingExisting) { load(mExistingToLoad); }
+	else
+	{
+		requestForecast();
+
+		Utility<ProductionPlanner>::get().clear();
+		updateProductionPlan();
+	}
 
 	//Utility<Mixer>::get().fadeInMusic(mBgMusic);
 	Utility<Renderer>::get().fadeIn(constants::FADE_SPEED);
@@ -168,6 +201,7 @@ void MapViewState::initialize()
 	e.textInputMode(true);
 
 	MAIN_FONT = Utility<FontManager>::get().font(constants::FONT_PRIMARY, constants::FONT_PRIMARY_NORMAL);
+	MAIN_FONT_BOLD = Utility<FontManager>::get().font(constants::FONT_PRIMARY_BOLD, constants::FONT_PRIMARY_MEDIUM);
 }
 
 
@@ -200,7 +234,10 @@ State* MapViewState::update()
 {
 	Renderer& r = Utility<Renderer>::get();
 
-	r.drawImageStretched(mBackground, 0, 0, r.width(), r.height());
+	r.drawImageStretched(*mBackground, 0, 0, r.width(), r.height());
+
+	if (mTurnWorker.update()) { completeTurn(); }
+	if (!mTurnWorker.busy()) { replayQueuedInput(); }
 
 	// FIXME: Ugly / hacky
 	if (mGameOverDialog.visible())
@@ -213,9 +250,28 @@ State* MapViewState::update()
 		return this;
 	}
 
+	if (mReplaying)
+	{
+		updateReplay();
+
+		if (mReplaying && mReplayHideUi)
+		{
+			const std::string& progress = REPLAY_TEXT(mTurnCount);
+			r.drawText(*MAIN_FONT_BOLD, progress, r.center_x() - REPLAY_TEXT.width(*MAIN_FONT_BOLD) / 2, r.center_y() - MAIN_FONT_BOLD->height() / 2, 255, 255, 255);
+			return this;
+		}
+	}
+
 	// explicit current level
-	Font* font = Utility<FontManager>::get().font(constants::FONT_PRIMARY_BOLD, constants::FONT_PRIMARY_MEDIUM);
-	r.drawText(*font, CURRENT_LEVEL_STRING, r.width() - font->width(CURRENT_LEVEL_STRING) - 5, mMiniMapBoundingBox.y() - font->height() - 12, 255, 255, 255);
+	int levelWidth = Utility<FontManager>::get().width(MAIN_FONT_BOLD, CURRENT_LEVEL_STRING);
+	r.drawText(*MAIN_FONT_BOLD, CURRENT_LEVEL_STRING, r.width() - levelWidth - 5, mMiniMapBoundingBox.y() - MAIN_FONT_BOLD->height() - 12, 255, 255, 255);
+
+	if (mTurnWorker.busy())
+	{
+		drawTurnInProgress();
+		return this;
+	}
+
 	if (mDebug) { drawDebug(); }
 	
 	if (!mGameOptionsDialog.visible() && !mGameOverDialog.visible() && !mFileIoDialog.visible())
@@ -231,6 +287,7 @@ State* MapViewState::update()
 		r.drawBoxFilled(0, 0, r.width(), r.height(), 0, 0, 0, 165);
 	}
 
+	updateHud();
 	drawUI();
 
 	if (r.isFading()) { return this; }
@@ -314,6 +371,9 @@ void MapViewState::onKeyDown(EventHandler::KeyCode key, EventHandler::KeyModifie
 {
 	if (!active()) { return; }
 
+	// Input is held while a turn is processed and handled once it's done.
+	if (mTurnWorker.busy()) { queueInput([=]() { onKeyDown(key, mod, repeat); }); return; }
+
 	// FIXME: Ugly / hacky
 	if (mGameOverDialog.visible() || mFileIoDialog.visible() || mGameOptionsDialog.visible())
 	{
@@ -433,7 +493,7 @@ void MapViewState::onKeyDown(EventHandler::KeyCode key, EventHandler::KeyModifie
 			break;
 
 		case EventHandler::KEY_ENTER:
-			if (mBtnTurns.enabled()) { nextTurn(); }
+			if (mBtnTurns.enabled()) { turnsRequested(); }
 			break;
 
 		default:
@@ -453,6 +513,10 @@ void MapViewState::onKeyDown(EventHandler::KeyCode key, EventHandler::KeyModifie
 void MapViewState::onMouseDown(EventHandler::MouseButton button, int x, int y)
 {
 	if (!active()) { return; }
+	if (mTurnWorker.busy()) { queueInput([=]() { onMouseDown(button, x, y); }); return; }
+
+	// Don't let the player change the game while it's being replayed.
+	if (mReplaying) { return; }
 
 	// FIXME: Ugly / hacky
 	if (mGameOverDialog.visible() || mFileIoDialog.visible() || mGameOptionsDialog.visible()) { return; }
@@ -574,17 +638,28 @@ void MapViewState::onMouseDown(EventHandler::MouseButton button, int x, int y)
 		// Click was within the bounds of the TileMap.
 		else if (isPointInRect(MOUSE_COORDS, mTileMap->boundingBox()))
 		{
+			Tile* tile = mTileMap->getVisibleTile();
+			if (!tile) { return; }
+
 			if (mInsertMode == INSERT_STRUCTURE)
 			{
-				placeStructure();
+				placeStructure(tile, mCurrentStructure);
 			}
 			else if (mInsertMode == INSERT_ROBOT)
 			{
-				placeRobot();
+				// Shift queues the task for the next free robot, Ctrl + Shift queues it ahead of other tasks.
+				// Dozer tasks are queued once the mouse is released as the player may be dragging out an area.
+				EventHandler& e = Utility<EventHandler>::get();
+				if (!e.query_shift()) { placeRobot(tile, mCurrentRobot); }
+				else if (mCurrentRobot == ROBOT_DOZER) { mRobotAreaAnchor = tile; }
+				else { queueRobotJob(tile, mCurrentRobot, e.query_control() ? RobotJob::PRIORITY_URGENT : RobotJob::PRIORITY_NORMAL); }
 			}
 			else if (mInsertMode == INSERT_TUBE)
 			{
-				placeTubes();
+				/** \fixme	This is a kludge that only works because all of the tube structures are listed alphabetically.
+				 *			Should instead take advantage of the updated meta data in the IconGridItem.
+				 */
+				placeTubes(tile, static_cast<ConnectorDir>(mConnections.selectionIndex() + 1));
 			}
 		}
 	}
@@ -594,12 +669,22 @@ void MapViewState::onMouseDown(EventHandler::MouseButton button, int x, int y)
 void MapViewState::onMouseDoubleClick(EventHandler::MouseButton button, int x, int y)
 {
 	if (!active()) { return; }
+	if (mTurnWorker.busy()) { queueInput([=]() { onMouseDoubleClick(button, x, y); }); return; }
 
 	if (button == EventHandler::BUTTON_LEFT)
 	{
 		if (mWindowStack.pointInWindow(MOUSE_COORDS)) { return; }
 		if (!mTileMap->tileHighlightVisible()) { return; }
 
+		// Shift + double click bulldozes all of the connected terrain.
+		EventHandler& e = Utility<EventHandler>::get();
+		if (mInsertMode == INSERT_ROBOT && mCurrentRobot == ROBOT_DOZER && e.query_shift())
+		{
+			Tile* tile = mTileMap->getVisibleTile();
+			if (tile) { queueRobotFill(tile, e.query_control() ? RobotJob::PRIORITY_URGENT : RobotJob::PRIORITY_NORMAL); }
+			return;
+		}
+
 		Tile* _t = mTileMap->getTile(mTileMap->tileHighlight().x() + mTileMap->mapViewLocation().x(), mTileMap->tileHighlight().y() + mTileMap->mapViewLocation().y());
 		if (_t && _t->thingIsStructure())
 		{
@@ -621,9 +706,25 @@ void MapViewState::onMouseDoubleClick(EventHandler::MouseButton button, int x, i
 */
 void MapViewState::onMouseUp(EventHandler::MouseButton button, int x, int y)
 {
+	if (mTurnWorker.busy()) { queueInput([=]() { onMouseUp(button, x, y); }); return; }
+
 	if (button == EventHandler::BUTTON_LEFT)
 	{
 		mLeftButtonDown = false;
+
+		if (mRobotAreaAnchor)
+		{
+			Tile* anchor = mRobotAreaAnchor;
+			mRobotAreaAnchor = nullptr;
+
+			if (mInsertMode != INSERT_ROBOT) { return; }
+
+			// Releasing outside of the map or on the same tile queues the anchor tile alone.
+			RobotJob::Priority priority = Utility<EventHandler>::get().query_control() ? RobotJob::PRIORITY_URGENT : RobotJob::PRIORITY_NORMAL;
+			Tile* tile = isPointInRect(MOUSE_COORDS, mTileMap->boundingBox()) ? mTileMap->getVisibleTile() : nullptr;
+			if (!tile || tile == anchor) { queueRobotJob(anchor, ROBOT_DOZER, priority); }
+			else { queueRobotArea(anchor, tile, priority); }
+		}
 	}
 }
 
@@ -636,7 +737,8 @@ void MapViewState::onMouseMove(int x, int y, int rX, int rY)
 	if (!active()) { return; }
 
 
-	if (mLeftButtonDown)
+	// The view doesn't move while a turn is processed.
+	if (mLeftButtonDown && !mTurnWorker.busy())
 	{
 		if (isPointInRect(MOUSE_COORDS, mMiniMapBoundingBox))
 		{
@@ -653,6 +755,8 @@ void MapViewState::onMouseMove(int x, int y, int rX, int rY)
  */
 void MapViewState::onMouseWheel(int x, int y)
 {
+	if (mTurnWorker.busy()) { queueInput([=]() { onMouseWheel(x, y); }); return; }
+
 	if (mInsertMode != INSERT_TUBE) { return; }
 
 	if (y > 0) { mConnections.decrementSelection(); }
@@ -660,6 +764,47 @@ void MapViewState::onMouseWheel(int x, int y)
 }
 
 
+/**
+ * Holds input received while a turn is processed.
+ */
+void MapViewState::queueInput(const std::function<void()>& handler)
+{
+	mQueuedInput.push_back({ MOUSE_COORDS, handler });
+}
+
+
+/**
+ * Handles the input received while the last turn was processed in the
+ * order it was received.
+ *
+ * The mouse is put back where it was for each input so clicks land on
+ * the tiles that were clicked. Input that starts another turn leaves the
+ * rest for after that turn.
+ */
+void MapViewState::replayQueuedInput()
+{
+	if (mQueuedInput.empty()) { return; }
+
+	Point_2d mouse = MOUSE_COORDS;
+
+	while (!mQueuedInput.empty() && !mTurnWorker.busy())
+	{
+		QueuedInput input = mQueuedInput.front();
+		mQueuedInput.pop_front();
+
+		MOUSE_COORDS = input.mouse;
+		mTileMap->injectMouse(input.mouse.x(), input.mouse.y());
+		mTileMap->updateTileHighlight();
+
+		input.handler();
+	}
+
+	MOUSE_COORDS = mouse;
+	mTileMap->injectMouse(mouse.x(), mouse.y());
+	mTileMap->updateTileHighlight();
+}
+
+
 /**
  * Changes the current view depth.
  */
@@ -695,6 +840,7 @@ void MapViewState::setMinimapView()
 void MapViewState::clearMode()
 {
 	mInsertMode = INSERT_NONE;
+	mRobotAreaAnchor = nullptr;
 	Utility<Renderer>::get().setCursor(POINTER_NORMAL);
 
 	mCurrentStructure = SID_NONE;
@@ -729,27 +875,20 @@ void MapViewState::insertTube(ConnectorDir _dir, int _depth, Tile* _t)
 
 
 /**
- * 
+ * Places a tube on a tile of the current level.
  */
-void MapViewState::placeTubes()
+void MapViewState::placeTubes(Tile* tile, ConnectorDir cd)
 {
-	int x = mTileMapMouseHover.x();
-	int y = mTileMapMouseHover.y();
-
-	Tile* tile = mTileMap->getVisibleTile(x, y, mTileMap->currentDepth());
-	if (!tile) { return; }
+	int x = tile->x();
+	int y = tile->y();
 
 	// Check the basics.
 	if (tile->thing() || tile->mine() || !tile->bulldozed() || !tile->excavated()) { return; }
 
-	/** \fixme	This is a kludge that only works because all of the tube structures are listed alphabetically.
-	 *			Should instead take advantage of the updated meta data in the IconGridItem.
-	 */
-	ConnectorDir cd = static_cast<ConnectorDir>(mConnections.selectionIndex() + 1);
-
 	if (validTubeConnection(mTileMap, x, y, cd))
 	{
-		insertTube(cd, mTileMap->currentDepth(), mTileMap->getTile(x, y));
+		insertTube(cd, mTileMap->currentDepth(), tile);
+		Utility<CommandLog>::get().record(COMMAND_PLACE_TUBE, x, y, tile->depth(), cd);
 
 		// FIXME: Naive approach -- will be slow with larger colonies.
 		Utility<StructureManager>::get().disconnectAll();
@@ -763,12 +902,13 @@ void MapViewState::placeTubes()
 
 
 /**
- * 
+ * Places a robot on a tile of the current level.
+ *
+ * \note	Diggers aren't placed until a direction has been picked in the
+ *			DiggerDirection dialog. See diggerSelectionDialog().
  */
-void MapViewState::placeRobot()
+void MapViewState::placeRobot(Tile* tile, RobotType robot)
 {
-	Tile* tile = mTileMap->getVisibleTile();
-	if (!tile) { return; }
 	if (!mRobotPool.robotCtrlAvailable()) { return; }
 	
 	// NOTE:	This function will never be called until the seed lander is deployed so there
@@ -779,8 +919,15 @@ void MapViewState::placeRobot()
 		return;
 	}
 
+	int travelTurns = robotTravelTurns(tile);
+	if (travelTurns == PathFinder::NO_PATH)
+	{
+		doAlertMessage(constants::ALERT_INVALID_ROBOT_PLACEMENT, constants::ALERT_ROBOT_UNREACHABLE);
+		return;
+	}
+
 	// Robodozer has been selected.
-	if(mCurrentRobot == ROBOT_DOZER)
+	if(robot == ROBOT_DOZER)
 	{
 		Robot* r = mRobotPool.getDozer();
 
@@ -797,11 +944,11 @@ void MapViewState::placeRobot()
 			}
 
 			mMineOperationsWindow.hide();
-			mTileMap->removeMineLocation(mTileMap->tileMouseHover());
+			mTileMap->removeMineLocation(Point_2d(tile->x(), tile->y()));
 			tile->pushMine(nullptr);
 			for (size_t i = 0; i <= static_cast<size_t>(mTileMap->maxDepth()); ++i)
 			{
-				Tile* _t = mTileMap->getTile(mTileMap->tileMouseHoverX(), mTileMap->tileMouseHoverY(), i);
+				Tile* _t = mTileMap->getTile(tile->x(), tile->y(), i);
 
 				// Probably overkill here but if this is ever true there is a serious logic error somewhere.
 				if (!_t->thing() || !_t->thingIsStructure())
@@ -835,7 +982,8 @@ void MapViewState::placeRobot()
 			if (_s->isFactory() && static_cast<Factory*>(_s) == mFactoryProduction.factory()) { mFactoryProduction.hide(); }
 			if (_s->isWarehouse())
 			{
-				if (simulateMoveProducts(static_cast<Warehouse*>(_s))) { moveProducts(static_cast<Warehouse*>(_s)); }
+				// The player already agreed to discard products when the log was recorded.
+				if (mReplaying || simulateMoveProducts(static_cast<Warehouse*>(_s))) { moveProducts(static_cast<Warehouse*>(_s)); }
 				else { return; } // Don't continue with the bulldoze if the user says no.
 			}
 
@@ -860,11 +1008,13 @@ void MapViewState::placeRobot()
 			return;
 		}
 
-		r->startTask(tile->index());
+		r->startTask(tile->index() + travelTurns);
 		mRobotPool.insertRobotIntoTable(mRobotList, r, tile);
 		static_cast<Robodozer*>(r)->tileIndex(static_cast<size_t>(tile->index()));
 		tile->index(TERRAIN_DOZED);
 
+		Utility<CommandLog>::get().record(COMMAND_PLACE_ROBOT, tile->x(), tile->y(), tile->depth(), ROBOT_DOZER);
+
 		if(!mRobotPool.robotAvailable(ROBOT_DOZER))
 		{
 			mRobots.removeItem(constants::ROBODOZER);
@@ -872,10 +1022,10 @@ void MapViewState::placeRobot()
 		}
 	}
 	// Robodigger has been selected.
-	else if(mCurrentRobot == ROBOT_DIGGER)
+	else if(robot == ROBOT_DIGGER)
 	{
 		// Keep digger within a safe margin of the map boundaries.
-		if (mTileMapMouseHover.x() < 3 || mTileMapMouseHover.x() > mTileMap->width() - 4 || mTileMapMouseHover.y() < 3 || mTileMapMouseHover.y() > mTileMap->height() - 4)
+		if (tile->x() < 3 || tile->x() > mTileMap->width() - 4 || tile->y() < 3 || tile->y() > mTileMap->height() - 4)
 		{
 			doAlertMessage(constants::ALERT_INVALID_ROBOT_PLACEMENT, constants::ALERT_DIGGER_EDGE_BUFFER);
 			return;
@@ -894,7 +1044,7 @@ void MapViewState::placeRobot()
 		{
 			if (!doYesNoMessage(constants::ALERT_DIGGER_MINE_TITLE, constants::ALERT_DIGGER_MINE)) { return; }
 
-			std::cout << "Digger destroyed a Mine at (" << mTileMap->tileMouseHoverX() << ", " << mTileMap->tileMouseHoverY() << ")." << std::endl;
+			std::cout << "Digger destroyed a Mine at (" << tile->x() << ", " << tile->y() << ")." << std::endl;
 			mTileMap->removeMineLocation(Point_2d(tile->x(), tile->y()));
 		}
 
@@ -950,17 +1100,19 @@ void MapViewState::placeRobot()
 		}
 	}
 	// Robominer has been selected.
-	else if(mCurrentRobot == ROBOT_MINER)
+	else if(robot == ROBOT_MINER)
 	{
 		if (tile->thing()) { doAlertMessage(constants::ALERT_INVALID_ROBOT_PLACEMENT, constants::ALERT_MINER_TILE_OBSTRUCTED); return; }
-		if (mTileMap->currentDepth() != constants::DEPTH_SURFACE) { doAlertMessage(constants::ALERT_INVALID_ROBOT_PLACEMENT, constants::ALERT_MINER_SURFACE_ONLY); return;  }
+		if (tile->depth() != constants::DEPTH_SURFACE) { doAlertMessage(constants::ALERT_INVALID_ROBOT_PLACEMENT, constants::ALERT_MINER_SURFACE_ONLY); return;  }
 		if (!tile->mine()) { doAlertMessage(constants::ALERT_INVALID_ROBOT_PLACEMENT, constants::ALERT_MINER_NOT_ON_MINE); return; }
 
 		Robot* r = mRobotPool.getMiner();
-		r->startTask(constants::MINER_TASK_TIME);
+		r->startTask(constants::MINER_TASK_TIME + travelTurns);
 		mRobotPool.insertRobotIntoTable(mRobotList, r, tile);
 		tile->index(TERRAIN_DOZED);
 
+		Utility<CommandLog>::get().record(COMMAND_PLACE_ROBOT, tile->x(), tile->y(), tile->depth(), ROBOT_MINER);
+
 		if (!mRobotPool.robotAvailable(ROBOT_MINER))
 		{
 			mRobots.removeItem(constants::ROBOMINER);
@@ -970,6 +1122,141 @@ void MapViewState::placeRobot()
 }
 
 
+/**
+ * Gets the number of turns a robot needs to travel to a tile.
+ *
+ * Robots leave from the Command Center or from an operational Robot
+ * Command Center, whichever is closest. Underground tiles are reached
+ * over the surface to the closest air shaft on their level, down the
+ * shaft and then through the level.
+ *
+ * \return	Number of turns or PathFinder::NO_PATH if the tile can't be
+ *			reached, i.e. it's walled in by impassable terrain or there's no
+ *			air shaft on its level.
+ */
+int MapViewState::robotTravelTurns(Tile* tile)
+{
+	if (!mPathFinder) { mPathFinder = std::make_unique<PathFinder>(*mTileMap); }
+	mPathFinder->sync(constants::DEPTH_SURFACE);
+
+	Point_2d destination(tile->x(), tile->y());
+	int underground = 0;
+
+	if (tile->depth() != constants::DEPTH_SURFACE)
+	{
+		mPathFinder->sync(tile->depth());
+
+		Tile* shaft = nullptr;
+		for (auto structure : Utility<StructureManager>::get().structureList(Structure::CLASS_TUBE))
+		{
+			if (structure->connectorDirection() != CONNECTOR_VERTICAL) { continue; }
+
+			Tile* _t = Utility<StructureManager>::get().tileFromStructure(structure);
+			if (_t->depth() != tile->depth()) { continue; }
+			if (!shaft || _t->distanceTo(tile) < shaft->distanceTo(tile)) { shaft = _t; }
+		}
+
+		if (!shaft) { return PathFinder::NO_PATH; }
+
+		underground = mPathFinder->findPath(Point_2d(shaft->x(), shaft->y()), destination, tile->depth());
+		if (underground == PathFinder::NO_PATH) { return PathFinder::NO_PATH; }
+
+		underground += tile->depth() * constants::ROBOT_SHAFT_TRAVEL_COST;
+		destination(shaft->x(), shaft->y());
+	}
+
+	int overland = mPathFinder->travelCost(ccLocation(), destination, constants::DEPTH_SURFACE);
+	for (auto rcc : Utility<StructureManager>::get().structureList(Structure::CLASS_ROBOT_COMMAND))
+	{
+		if (!rcc->operational()) { continue; }
+
+		Tile* _t = Utility<StructureManager>::get().tileFromStructure(rcc);
+		int cost = mPathFinder->travelCost(Point_2d(_t->x(), _t->y()), destination, constants::DEPTH_SURFACE);
+		if (cost != PathFinder::NO_PATH && (overland == PathFinder::NO_PATH || cost < overland)) { overland = cost; }
+	}
+
+	if (overland == PathFinder::NO_PATH) { return PathFinder::NO_PATH; }
+
+	return (overland + underground) / constants::ROBOT_TRAVEL_COST_PER_TURN;
+}
+
+
+/**
+ * Queues a robot task on a tile for the next free robot of its type.
+ *
+ * Queued tasks are handed out at the end of every turn once robots that
+ * finished their tasks are back in the pool. See dispatchRobotJobs().
+ */
+void MapViewState::queueRobotJob(Tile* tile, RobotType robot, RobotJob::Priority priority)
+{
+	if (!robotJobValid(tile, robot))
+	{
+		doAlertMessage(constants::ALERT_INVALID_ROBOT_PLACEMENT, constants::ALERT_ROBOT_JOB_INVALID);
+		return;
+	}
+
+	RobotJob job;
+	job.type = robot;
+	job.x = tile->x();
+	job.y = tile->y();
+	job.depth = tile->depth();
+	job.priority = priority;
+
+	mRobotJobs.enqueue(job);
+
+	Utility<CommandLog>::get().record(COMMAND_QUEUE_ROBOT_JOB, job.x, job.y, job.depth, robot | (priority << 8));
+}
+
+
+/**
+ * Queues bulldozing a rectangle of tiles on the level of the first corner.
+ */
+void MapViewState::queueRobotArea(Tile* corner1, Tile* corner2, RobotJob::Priority priority)
+{
+	RobotJobPlanner planner(*mTileMap, ccLocation());
+	if (!queueRobotPlan(planner.rectangle(corner1->x(), corner1->y(), corner2->x(), corner2->y(), corner1->depth(), priority))) { return; }
+
+	Utility<CommandLog>::get().record(COMMAND_QUEUE_ROBOT_AREA, corner1->x(), corner1->y(), corner1->depth(), static_cast<uint64_t>(corner2->x()) | (static_cast<uint64_t>(corner2->y()) << 16) | (static_cast<uint64_t>(priority) << 32));
+}
+
+
+/**
+ * Queues bulldozing the terrain connected to a tile.
+ */
+void MapViewState::queueRobotFill(Tile* tile, RobotJob::Priority priority)
+{
+	RobotJobPlanner planner(*mTileMap, ccLocation());
+	if (!queueRobotPlan(planner.floodFill(tile->x(), tile->y(), tile->depth(), priority))) { return; }
+
+	Utility<CommandLog>::get().record(COMMAND_QUEUE_ROBOT_FILL, tile->x(), tile->y(), tile->depth(), priority);
+}
+
+
+/**
+ * Queues the tasks of an area order and tells the player how long a
+ * single robot needs for them and how many tiles were skipped.
+ *
+ * \return	False if the plan has no tasks.
+ */
+bool MapViewState::queueRobotPlan(const RobotJobPlan& plan)
+{
+	if (plan.jobs.empty())
+	{
+		doAlertMessage(constants::ALERT_INVALID_ROBOT_PLACEMENT, constants::ALERT_ROBOT_AREA_EMPTY);
+		return false;
+	}
+
+	mRobotJobs.enqueue(plan.jobs);
+
+	if (!mReplaying)
+	{
+		doAlertMessage(constants::ALERT_ROBOT_AREA_QUEUED_TITLE, string_format(constants::ALERT_ROBOT_AREA_QUEUED_MESSAGE, static_cast<int>(plan.jobs.size()), plan.robotTurns, plan.skipped));
+	}
+
+	return true;
+}
+
+
 /**
  * Checks the robot selection interface and if the robot is not available in it, adds
  * it back in and reeneables the robots button if it's not enabled.
@@ -984,19 +1271,16 @@ void MapViewState::checkRobotSelectionInterface(const std::string& rType, int sh
 
 
 /**
- * Places a structure into the map.
+ * Places a structure on a tile of the current level.
  */
-void MapViewState::placeStructure()
+void MapViewState::placeStructure(Tile* tile, StructureID structure)
 {
 	// SID_NONE is a logic error and should fail as loudly as possible.
-	if (mCurrentStructure == SID_NONE) { throw std::runtime_error("MapViewState::placeStructure() called but mCurrentStructure == STRUCTURE_NONE"); }
-
-	Tile* tile = mTileMap->getVisibleTile();
-	if (!tile) { return; }
+	if (structure == SID_NONE) { throw std::runtime_error("MapViewState::placeStructure() called but structure == SID_NONE"); }
 
 	// NOTE:	This function will never be called until the seed lander is deployed so there
 	//			is no need to check that the CC Location is anything other than { 0, 0 }.
-	if (!structureIsLander(mCurrentStructure) && !selfSustained(mCurrentStructure) &&
+	if (!structureIsLander(structure) && !selfSustained(structure) &&
 		(tile->distanceTo(mTileMap->getTile(ccLocationX(), ccLocationY(), 0)) > constants::ROBOT_COM_RANGE))
 	{
 		doAlertMessage(constants::ALERT_INVALID_STRUCTURE_ACTION, constants::ALERT_STRUCTURE_OUT_OF_RANGE);
@@ -1022,7 +1306,7 @@ void MapViewState::placeStructure()
 		return;
 	}
 
-	if((!tile->bulldozed() && !structureIsLander(mCurrentStructure)))
+	if((!tile->bulldozed() && !structureIsLander(structure)))
 	{
 		doAlertMessage(constants::ALERT_INVALID_STRUCTURE_ACTION, constants::ALERT_STRUCTURE_TERRAIN);
 		return;
@@ -1034,14 +1318,14 @@ void MapViewState::placeStructure()
 		return;
 	}
 
-	int tile_x = mTileMapMouseHover.x(), tile_y = mTileMapMouseHover.y();
+	int tile_x = tile->x(), tile_y = tile->y();
 
 	// Seed lander is a special case and only one can ever be placed by the player ever.
-	if(mCurrentStructure == SID_SEED_LANDER)
+	if(structure == SID_SEED_LANDER)
 	{
 		insertSeedLander(tile_x, tile_y);
 	}
-	else if (mCurrentStructure == SID_COLONIST_LANDER)
+	else if (structure == SID_COLONIST_LANDER)
 	{
 		if (!validLanderSite(tile)) { return; }
 
@@ -1057,7 +1341,7 @@ void MapViewState::placeStructure()
 			populateStructureMenu();
 		}
 	}
-	else if (mCurrentStructure == SID_CARGO_LANDER)
+	else if (structure == SID_CARGO_LANDER)
 	{
 		if (!validLanderSite(tile)) { return; }
 
@@ -1075,20 +1359,20 @@ void MapViewState::placeStructure()
 	}
 	else
 	{
-		if (!validStructurePlacement(mTileMap, tile_x, tile_y) && !selfSustained(mCurrentStructure))
+		if (!validStructurePlacement(mTileMap, tile_x, tile_y) && !selfSustained(structure))
 		{
 			doAlertMessage(constants::ALERT_INVALID_STRUCTURE_ACTION, constants::ALERT_STRUCTURE_NO_TUBE);
 			return;
 		}
 
 		// Check build cost
-		if (!StructureCatalogue::canBuild(mPlayerResources, mCurrentStructure))
+		if (!StructureCatalogue::canBuild(mPlayerResources, structure))
 		{
-			resourceShortageMessage(mPlayerResources, mCurrentStructure);
+			resourceShortageMessage(mPlayerResources, structure);
 			return;
 		}
 
-		Structure* _s = StructureCatalogue::get(mCurrentStructure);
+		Structure* _s = StructureCatalogue::get(structure);
 		if (!_s) { throw std::runtime_error("MapViewState::placeStructure(): NULL Structure returned from StructureCatalog."); }
 
 		Utility<StructureManager>::get().addStructure(_s, tile);
@@ -1096,12 +1380,14 @@ void MapViewState::placeStructure()
 		// FIXME: Ugly
 		if (_s->isFactory())
 		{
-			static_cast<Factory*>(_s)->productionComplete().connect(this, &MapViewState::factoryProductionComplete);
 			static_cast<Factory*>(_s)->resourcePool(&mPlayerResources);
 		}
 
-		mPlayerResources -= StructureCatalogue::costToBuild(mCurrentStructure);
+		mPlayerResources -= StructureCatalogue::costToBuild(structure);
 	}
+
+	// The seed lander is recorded by insertSeedLander() as it checks the site itself.
+	if (structure != SID_SEED_LANDER) { Utility<CommandLog>::get().record(COMMAND_PLACE_STRUCTURE, tile_x, tile_y, tile->depth(), structure); }
 }
 
 
@@ -1123,6 +1409,7 @@ void MapViewState::insertSeedLander(int x, int y)
 		SeedLander* s = new SeedLander(x, y);
 		s->deployCallback().connect(this, &MapViewState::deploySeedLander);
 		Utility<StructureManager>::get().addStructure(s, mTileMap->getTile(x, y)); // Can only ever be placed on depth level 0
+		Utility<CommandLog>::get().record(COMMAND_PLACE_STRUCTURE, x, y, 0, SID_SEED_LANDER);
 
 		clearMode();
 		resetUi();
@@ -1164,12 +1451,7 @@ void MapViewState::updateRobots()
 				robot_it->second->removeThing();
 			}
 
-			/// \fixme	Brute force.
-			for (auto rcc : Utility<StructureManager>::get().structureList(Structure::CLASS_ROBOT_COMMAND))
-			{
-				static_cast<RobotCommand*>(rcc)->removeRobot(robot_it->first);
-			}
-
+			// Also removes the robot from the command of its RCC.
 			mRobotPool.erase(robot_it->first);
 			delete robot_it->first;
 			robot_it = mRobotList.erase(robot_it);
@@ -1181,6 +1463,7 @@ void MapViewState::updateRobots()
 				robot_it->second->removeThing();
 			}
 
+			mRobotPool.releaseRobot(robot_it->first);
 			robot_it = mRobotList.erase(robot_it);
 		}
 		else
@@ -1193,6 +1476,89 @@ void MapViewState::updateRobots()
 }
 
 
+/**
+ * Hands queued robot tasks out to free robots.
+ *
+ * Tasks that can no longer be done are dropped. Tasks that are out of
+ * communications range, whose tile is occupied by another robot or that
+ * robots can't reach yet stay queued until they can be done.
+ *
+ * \note	Dispatching isn't recorded to the command log. Replays queue
+ *			the same tasks and dispatch them the same way.
+ */
+void MapViewState::dispatchRobotJobs()
+{
+	if (mRobotJobs.empty()) { return; }
+
+	CommandLog& log = Utility<CommandLog>::get();
+	bool suspended = log.suspended();
+	log.suspend(true);
+
+	auto& jobs = mRobotJobs.jobs();
+	auto job_it = jobs.begin();
+	while (job_it != jobs.end())
+	{
+		Tile* tile = mTileMap->getTile(job_it->x, job_it->y, job_it->depth);
+		if (!tile || !robotJobValid(tile, job_it->type))
+		{
+			job_it = jobs.erase(job_it);
+			continue;
+		}
+
+		if (!mRobotPool.robotAvailable(job_it->type) || !mRobotPool.robotCtrlAvailable() || tile->robot() || outOfCommRange(ccLocation(), mTileMap, tile) || robotTravelTurns(tile) == PathFinder::NO_PATH)
+		{
+			++job_it;
+			continue;
+		}
+
+		if (job_it->type == ROBOT_DIGGER) { diggerSelectionDialog(DiggerDirection::SEL_DOWN, tile); }
+		else { placeRobot(tile, job_it->type); }
+
+		job_it = jobs.erase(job_it);
+	}
+
+	log.suspend(suspended);
+}
+
+
+/**
+ * Determines if a queued robot task can be done on a tile without asking
+ * the player anything.
+ *
+ * \note	Only terrain is bulldozed and diggers only ever dig down.
+ *			Bulldozing structures and digging sideways are left to the
+ *			player.
+ */
+bool MapViewState::robotJobValid(Tile* tile, RobotType robot)
+{
+	if (!tile->excavated() || (tile->thingIsStructure() && robot != ROBOT_DIGGER)) { return false; }
+
+	switch (robot)
+	{
+	case ROBOT_DOZER:
+		return !tile->hasMine() && tile->index() != TERRAIN_DOZED;
+
+	case ROBOT_MINER:
+		return tile->depth() == constants::DEPTH_SURFACE && tile->hasMine();
+
+	case ROBOT_DIGGER:
+	{
+		// Keep digger within a safe margin of the map boundaries.
+		if (tile->x() < 3 || tile->x() > mTileMap->width() - 4 || tile->y() < 3 || tile->y() > mTileMap->height() - 4) { return false; }
+		if (tile->depth() >= mTileMap->maxDepth() || tile->hasMine()) { return false; }
+		if (!mTileMap->getTile(tile->x(), tile->y(), tile->depth() + 1)->empty()) { return false; }
+
+		// Underground diggers go down through an air shaft.
+		if (tile->depth() == constants::DEPTH_SURFACE) { return !tile->thingIsStructure(); }
+		return tile->thingIsStructure() && tile->structure()->connectorDirection() == CONNECTOR_VERTICAL;
+	}
+
+	default:
+		return false;
+	}
+}
+
+
 /**
  * Checks and sets the current structure mode.
  */
@@ -6,9 +6,13 @@
 #include "MainReportsUiState.h"
 #include "Wrapper.h"
 
+#include "../CommandLog.h"
 #include "../Common.h"
 #include "../Constants.h"
+#include "../Forecast.h"
+#include "../ImageManager.h"
 
+#include "../Map/PathFinder.h"
 #include "../Map/Tile.h"
 #include "../Map/TileMap.h"
 
@@ -16,13 +20,22 @@
 #include "../Population/Population.h"
 
 #include "../ResourcePool.h"
+#include "../RobotJobPlanner.h"
+#include "../RobotJobQueue.h"
 #include "../RobotPool.h"
+#include "../SaveGameSnapshot.h"
+#include "../TurnWorker.h"
 
 #include "../Things/Structures/Structure.h"
 #include "../Things/Robots/Robots.h"
 
 #include "../UI/Gui.h"
 
+#include <deque>
+#include <functional>
+
+#include <chrono>
+
 using namespace NAS2D;
 
 /**
@@ -55,6 +68,43 @@ public:
 		POPULATION_LARGE = 2
 	};
 
+	/**
+	 * Events that end a fast-forward early. Alerts and announcements always do.
+	 */
+	enum FastForwardStop
+	{
+		STOP_NONE = 0,
+		STOP_FOOD_SHORTAGE = 1 << 0,		/**< Stored food won't last another turn at the current rate. */
+		STOP_STRUCTURE_COMPLETE = 1 << 1,	/**< A structure finished construction. */
+		STOP_ROBOT_IDLE = 1 << 2			/**< A robot finished its task and is waiting for a new one. */
+	};
+
+
+/**
+ * Values shown in the resource and robot bars.
+ *
+ * Taken every frame. While a turn is processed the values from before the
+ * turn are shown instead.
+ */
+struct HudSnapshot
+{
+	ResourcePool	resources;						/**< Player's resources. */
+	int				foodInStorage = 0;				/**< Food stored in the colony. */
+	int				foodTotalStorage = 0;			/**< Food that can be stored in the colony. */
+	int				energyProduced = 0;				/**< Energy produced in the last turn. */
+
+	int				population = 0;					/**< Number of colonists. */
+	int				morale = 0;						/**< Current morale. */
+	int				previousMorale = 0;				/**< Morale at the start of the last turn. */
+	int				turnCount = 0;					/**< Current turn. */
+
+	int				robotsAvailable[ROBOT_MINER + 1] = {};	/**< Idle robots by type. */
+	int				robotsTotal[ROBOT_MINER + 1] = {};		/**< Robots by type. */
+	int				robotsQueued[ROBOT_MINER + 1] = {};		/**< Queued jobs by type. */
+	uint32_t		robotControlCount = 0;			/**< Robots working. */
+	uint32_t		robotControlMax = 0;			/**< Robots that can work at once. */
+};
+
 public:
 	using QuitCallback = NAS2D::Signals::Signal0<void>;
 	using ReportsUiCallback = NAS2D::Signals::Signal0<void>;
@@ -73,6 +123,8 @@ public:
 
 	void focusOnStructure(Structure*);
 
+	void replay(const std::vector<Command>& commands, bool hideUi);
+
 protected:
 	void initialize();
 	State* update();
@@ -91,6 +143,9 @@ private:
 	void onMouseWheel(int x, int y);
 	void onWindowResized(int w, int h);
 
+	void queueInput(const std::function<void()>& handler);
+	void replayQueuedInput();
+
 	// ROBOT EVENT HANDLERS
 	void dozerTaskFinished(Robot* _r);
 	void diggerTaskFinished(Robot* _r);
@@ -103,6 +158,8 @@ private:
 	void drawNavInfo();
 	void drawResourceInfo();
 	void drawRobotInfo();
+	void drawTurnInProgress();
+	void updateHud();
 
 	// INSERT OBJECT HANDLING
 	void deployCargoLander();
@@ -111,9 +168,14 @@ private:
 	void insertSeedLander(int x, int y);
 	void insertTube(ConnectorDir _dir, int depth, Tile* t);
 
-	void placeRobot();
-	void placeStructure();
-	void placeTubes();
+	void placeRobot(Tile* tile, RobotType robot);
+	int robotTravelTurns(Tile* tile);
+	void queueRobotJob(Tile* tile, RobotType robot, RobotJob::Priority priority);
+	void queueRobotArea(Tile* corner1, Tile* corner2, RobotJob::Priority priority);
+	void queueRobotFill(Tile* tile, RobotJob::Priority priority);
+	bool queueRobotPlan(const RobotJobPlan& plan);
+	void placeStructure(Tile* tile, StructureID structure);
+	void placeTubes(Tile* tile, ConnectorDir connector);
 
 	void setStructureID(StructureID type, InsertMode mode);
 
@@ -126,19 +188,34 @@ private:
 	bool changeDepth(int _d);
 
 	void pullRobotFromFactory(ProductType pt, Factory& factory);
-	void factoryProductionComplete(Factory& factory);
+	void deliverFactoryProducts();
 
 	void mineFacilityExtended(MineFacility* mf);
 
 	// TURN LOGIC
 	void checkColonyShip();
 	void nextTurn();
+	void beginTurn();
+	void simulateTurn();
+	void finishTurn();
+	void completeTurn();
+	void processTurn();
+	void refreshTurnUi();
+	void requestForecast();
+	void fastForward(int turns, int stopEvents);
+	void drawFastForwardProgress(int turn, int turns);
+	void turnsRequested();
 	void updatePopulation();
 	void updateCommercial();
 	void updateMorale();
 	void updateResidentialCapacity();
 	void updateResources();
+	void updateFactoryQueues();
+	void updateProductionPlan();
+	ProductPool::ProductTypeCount productStock();
 	void updateRobots();
+	void dispatchRobotJobs();
+	bool robotJobValid(Tile* tile, RobotType robot);
 
 
 	// SAVE GAME MANAGEMENT FUNCTIONS
@@ -151,6 +228,17 @@ private:
 
 	void load(const std::string& _path);
 	void save(const std::string& _path);
+	void autosave();
+
+	std::unique_ptr<SaveGameSnapshot> snapshot();
+	void serializeState(SaveGameSnapshot& _w);
+
+	// COMMAND LOG AND REPLAY
+	void startCommandLog(const std::string& savegame);
+	void executeCommand(const Command& command);
+	void updateReplay();
+	void finishReplay(const std::string& message);
+	uint64_t stateHash();
 
 	// UI MANAGEMENT FUNCTIONS
 	void clearMode();
@@ -158,6 +246,8 @@ private:
 
 	void hideUi();
 	void unhideUi();
+	void suspendUi();
+	void resumeUi();
 	void initUi();
 	void resetUi();
 
@@ -193,28 +283,33 @@ private:
 	FpsCounter			mFps;							/**< Main FPS Counter. */
 
 	TileMap*			mTileMap = nullptr;				/**<  */
+	std::unique_ptr<PathFinder>	mPathFinder;			/**< Robot travel over mTileMap. Created when first needed. */
 
-	Image				mBackground;					/**< Background image drawn behind the tile map. */
-	Image				mMapDisplay;					/**< Satellite view of the Site Map. */
-	Image				mHeightMap;						/**< Height view of the Site Map. */
-	Image				mUiIcons;						/**< User interface icons. */
+	ImageManager::ImageHandle	mBackground;			/**< Background image drawn behind the tile map. */
+	ImageManager::ImageHandle	mMapDisplay;			/**< Satellite view of the Site Map. */
+	ImageManager::ImageHandle	mHeightMap;				/**< Height view of the Site Map. */
+	ImageRegion					mUiIcons;		/**< User interface icons. */
 
 	Point_2d			mTileMapMouseHover;				/**< Tile position the mouse is currently hovering over. */
+	Tile*				mRobotAreaAnchor = nullptr;		/**< Corner tile of a bulldozing area being dragged out. */
 
 	Rectangle_2d		mMiniMapBoundingBox;			/**< Area of the site map display. */
 
 	// POOL'S
 	ResourcePool		mPlayerResources;				/**< Player's current resources. */
+	ResourcePool		mRefinedIncome;					/**< Refined resources brought into storage last turn. */
 	RobotPool			mRobotPool;						/**< Robots that are currently available for use. */
 	PopulationPool		mPopulationPool;				/**<  */
 
 	RobotTileTable		mRobotList;						/**< List of active robots and their positions on the map. */
+	RobotJobQueue		mRobotJobs;						/**< Robot tasks waiting for a free robot. */
 
 	InsertMode			mInsertMode = INSERT_NONE;		/**< What's being inserted into the TileMap if anything. */
 	StructureID			mCurrentStructure = SID_NONE;	/**< Structure being placed. */
 	RobotType			mCurrentRobot = ROBOT_NONE;		/**< Robot being placed. */
 
 	Population			mPopulation;					/**<  */
+	Forecast			mForecast;						/**< Population and food forecast. */
 
 	//Music				mBgMusic;						/**<  */
 
@@ -266,5 +361,33 @@ private:
 
 	std::string			mExistingToLoad;				/**< Filename of the existing game to load. */
 
+	SaveGameWriter		mSaveGameWriter;				/**< Writes savegames in the background. */
+
+	// REPLAY
+	std::vector<Command>	mReplayCommands;			/**< Command log being replayed. */
+	size_t				mReplayPosition = 0;			/**< Next command to replay. */
+	bool				mReplaying = false;				/**< A command log is being replayed. */
+	bool				mReplayHideUi = false;			/**< Hide the map and the UI while replaying. */
+	int					mReplayTurns = 0;				/**< Number of turns replayed. */
+	std::chrono::steady_clock::duration	mReplayTurnTime{ 0 };		/**< Total time spent processing replayed turns. */
+	std::chrono::steady_clock::duration	mReplaySlowestTurn{ 0 };	/**< Longest time spent processing a single replayed turn. */
+
+	// TURN PROCESSING
+	/**
+	 * Input received while a turn was being processed.
+	 */
+	struct QueuedInput
+	{
+		Point_2d				mouse;					/**< Mouse position when the input was received. */
+		std::function<void()>	handler;				/**< Handler call for the input. */
+	};
+
+	TurnWorker			mTurnWorker;					/**< Processes turns off of the main thread. */
+	HudSnapshot			mHud;							/**< Values shown in the resource and robot bars. */
+	TileMap::ViewSnapshot	mMapSnapshot;				/**< Tiles in view before the turn being processed. */
+	std::deque<QueuedInput>	mQueuedInput;				/**< Input to handle once the turn being processed is done. */
+	std::vector<Window*>	mSuspendedWindows;			/**< Windows hidden while a turn is processed. */
+	bool				mUiSuspended = false;			/**< The UI is hidden while a turn is processed. */
+
 	//State*				mReturnState = this;			/**<  */
 };
@@ -9,6 +9,7 @@
 
 #include "../Constants.h"
 #include "../FontManager.h"
+#include "../FormattedText.h"
 
 extern Rectangle_2d MENU_ICON;
 
@@ -35,6 +36,31 @@ int GLOW_STEP_DIRECTION = 1;
 extern Font* MAIN_FONT; /// yuck
 
 
+// Labels of the resource and robot bars. Formatted again only when their values change.
+static FormattedText COMMON_METALS_TEXT("%i");
+static FormattedText RARE_METALS_TEXT("%i");
+static FormattedText COMMON_MINERALS_TEXT("%i");
+static FormattedText RARE_MINERALS_TEXT("%i");
+static FormattedText STORAGE_TEXT("%i/%i");
+static FormattedText FOOD_TEXT("%i/%i");
+static FormattedText ENERGY_TEXT("%i/%i");
+static FormattedText POPULATION_TEXT("%i");
+static FormattedText TURN_TEXT("%i");
+
+// Robot summaries by robot type, indexed like HudSnapshot::robotsTotal.
+static std::array<FormattedText, ROBOT_MINER + 1> ROBOT_TEXT =
+{{
+	FormattedText("%i/%i"), FormattedText("%i/%i"), FormattedText("%i/%i"), FormattedText("%i/%i")
+}};
+
+static std::array<FormattedText, ROBOT_MINER + 1> ROBOT_QUEUED_TEXT =
+{{
+	FormattedText("%i/%i (%i queued)"), FormattedText("%i/%i (%i queued)"), FormattedText("%i/%i (%i queued)"), FormattedText("%i/%i (%i queued)")
+}};
+
+static FormattedText ROBOT_CONTROL_TEXT("%i/%i");
+
+
 static void updateGlowTimer()
 {
 	if (GLOW_TIMER.accumulator() >= 10)
@@ -64,42 +90,46 @@ void MapViewState::drawMiniMap()
 	Renderer& r = Utility<Renderer>::get();
 	r.clipRect(mMiniMapBoundingBox.x(), mMiniMapBoundingBox.y(), mMiniMapBoundingBox.width(), mMiniMapBoundingBox.height());
 
-	if (mBtnToggleHeightmap.toggled()) { r.drawImage(mHeightMap, mMiniMapBoundingBox.x(), mMiniMapBoundingBox.y()); }
-	else { r.drawImage(mMapDisplay, mMiniMapBoundingBox.x(), mMiniMapBoundingBox.y()); }
+	if (mBtnToggleHeightmap.toggled()) { r.drawImage(*mHeightMap, mMiniMapBoundingBox.x(), mMiniMapBoundingBox.y()); }
+	else { r.drawImage(*mMapDisplay, mMiniMapBoundingBox.x(), mMiniMapBoundingBox.y()); }
 
 	if (ccLocationX() != 0 && ccLocationY() != 0)
 	{
-		r.drawSubImage(mUiIcons, ccLocationX() + mMiniMapBoundingBox.x() - 15, ccLocationY() + mMiniMapBoundingBox.y() - 15, 166, 226, 30, 30);
+		mUiIcons.drawSub(r, ccLocationX() + mMiniMapBoundingBox.x() - 15, ccLocationY() + mMiniMapBoundingBox.y() - 15, 166, 226, 30, 30);
 		r.drawBoxFilled(ccLocationX() + mMiniMapBoundingBox.x() - 1, ccLocationY() + mMiniMapBoundingBox.y() - 1, 3, 3, 255, 255, 255);
 	}
 
-	for (auto _tower : Utility<StructureManager>::get().structureList(Structure::CLASS_COMM))
+	// Comm towers and mines are changed by the turn being processed.
+	if (!mTurnWorker.busy())
 	{
-		if (_tower->operational())
+		for (auto _tower : Utility<StructureManager>::get().structureList(Structure::CLASS_COMM))
 		{
-			Tile* t = Utility<StructureManager>::get().tileFromStructure(_tower);
-			r.drawSubImage(mUiIcons, t->x() + mMiniMapBoundingBox.x() - 10, t->y() + mMiniMapBoundingBox.y() - 10, 146, 236, 20, 20);
+			if (_tower->operational())
+			{
+				Tile* t = Utility<StructureManager>::get().tileFromStructure(_tower);
+				mUiIcons.drawSub(r, t->x() + mMiniMapBoundingBox.x() - 10, t->y() + mMiniMapBoundingBox.y() - 10, 146, 236, 20, 20);
+			}
 		}
-	}
-
-	for (auto _mine : mTileMap->mineLocations())
-	{
-		Mine* mine = mTileMap->getTile(_mine.x(), _mine.y(), 0)->mine();
-		if (!mine) { break; } // avoids potential race condition where a mine is destroyed during an updated cycle.
 
-		if (!mine->active())
+		for (auto _mine : mTileMap->mineLocations())
 		{
-			r.drawSubImage(mUiIcons, _mine.x() + mMiniMapBoundingBox.x() - 2, _mine.y() + mMiniMapBoundingBox.y() - 2, 0.0f, 0.0f, 7.0f, 7.0f);
-		}
-		else if (mine->active() && !mine->exhausted())
-		{
-			r.drawSubImage(mUiIcons, _mine.x() + mMiniMapBoundingBox.x() - 2, _mine.y() + mMiniMapBoundingBox.y() - 2, 8.0f, 0.0f, 7.0f, 7.0f);
-		}
-		else if (mine->exhausted())
-		{
-			r.drawSubImage(mUiIcons, _mine.x() + mMiniMapBoundingBox.x() - 2, _mine.y() + mMiniMapBoundingBox.y() - 2, 16.0f, 0.0f, 7.0f, 7.0f);
-		}
+			Mine* mine = mTileMap->getTile(_mine.x(), _mine.y(), 0)->mine();
+			if (!mine) { break; } // avoids potential race condition where a mine is destroyed during an updated cycle.
+
+			if (!mine->active())
+			{
+				mUiIcons.drawSub(r, _mine.x() + mMiniMapBoundingBox.x() - 2, _mine.y() + mMiniMapBoundingBox.y() - 2, 0.0f, 0.0f, 7.0f, 7.0f);
+			}
+			else if (mine->active() && !mine->exhausted())
+			{
+				mUiIcons.drawSub(r, _mine.x() + mMiniMapBoundingBox.x() - 2, _mine.y() + mMiniMapBoundingBox.y() - 2, 8.0f, 0.0f, 7.0f, 7.0f);
+			}
+			else if (mine->exhausted())
+			{
+				mUiIcons.drawSub(r, _mine.x() + mMiniMapBoundingBox.x() - 2, _mine.y() + mMiniMapBoundingBox.y() - 2, 16.0f, 0.0f, 7.0f, 7.0f);
+			}
 
+		}
 	}
 
 	for (auto _robot : mRobotList)
@@ -135,63 +165,97 @@ void MapViewState::drawResourceInfo()
 	int offsetX = constants::RESOURCE_ICON_SIZE + 40;
 	int margin = constants::RESOURCE_ICON_SIZE + constants::MARGIN;
 
-	r.drawSubImage(mUiIcons, 2, 7, mPinResourcePanel ? 8 : 0, 72, 8, 8);
-	r.drawSubImage(mUiIcons, 675, 7, mPinPopulationPanel ? 8 : 0, 72, 8, 8);
+	mUiIcons.drawSub(r, 2, 7, mPinResourcePanel ? 8 : 0, 72, 8, 8);
+	mUiIcons.drawSub(r, 675, 7, mPinPopulationPanel ? 8 : 0, 72, 8, 8);
 
 	updateGlowTimer();
 
 	// Common Metals
-	r.drawSubImage(mUiIcons, x, y , 64, 16, constants::RESOURCE_ICON_SIZE, constants::RESOURCE_ICON_SIZE);
-	if (mPlayerResources.commonMetals() <= 10) { r.drawText(*MAIN_FONT, string_format("%i", mPlayerResources.commonMetals()), x + margin, textY, 255, GLOW_STEP, GLOW_STEP); }
-	else { r.drawText(*MAIN_FONT, string_format("%i", mPlayerResources.commonMetals()), x + margin, textY, 255, 255, 255); }
+	mUiIcons.drawSub(r, x, y , 64, 16, constants::RESOURCE_ICON_SIZE, constants::RESOURCE_ICON_SIZE);
+	if (mHud.resources.commonMetals() <= 10) { r.drawText(*MAIN_FONT, COMMON_METALS_TEXT(mHud.resources.commonMetals()), x + margin, textY, 255, GLOW_STEP, GLOW_STEP); }
+	else { r.drawText(*MAIN_FONT, COMMON_METALS_TEXT(mHud.resources.commonMetals()), x + margin, textY, 255, 255, 255); }
 
 	// Rare Metals
-	r.drawSubImage(mUiIcons, x + offsetX, y, 80, 16, constants::RESOURCE_ICON_SIZE, constants::RESOURCE_ICON_SIZE);
-	if (mPlayerResources.rareMetals() <= 10) { r.drawText(*MAIN_FONT, string_format("%i", mPlayerResources.rareMetals()), (x + offsetX) + margin, textY, 255, GLOW_STEP, GLOW_STEP); }
-	else { r.drawText(*MAIN_FONT, string_format("%i", mPlayerResources.rareMetals()), (x + offsetX) + margin, textY, 255, 255, 255); }
+	mUiIcons.drawSub(r, x + offsetX, y, 80, 16, constants::RESOURCE_ICON_SIZE, constants::RESOURCE_ICON_SIZE);
+	if (mHud.resources.rareMetals() <= 10) { r.drawText(*MAIN_FONT, RARE_METALS_TEXT(mHud.resources.rareMetals()), (x + offsetX) + margin, textY, 255, GLOW_STEP, GLOW_STEP); }
+	else { r.drawText(*MAIN_FONT, RARE_METALS_TEXT(mHud.resources.rareMetals()), (x + offsetX) + margin, textY, 255, 255, 255); }
 
 	// Common Minerals
-	r.drawSubImage(mUiIcons, (x + offsetX) * 2, y, 96, 16, constants::RESOURCE_ICON_SIZE, constants::RESOURCE_ICON_SIZE);
-	if (mPlayerResources.commonMinerals() <= 10) { r.drawText(*MAIN_FONT, string_format("%i", mPlayerResources.commonMinerals()), (x + offsetX) * 2 + margin, textY, 255, GLOW_STEP, GLOW_STEP); }
-	else { r.drawText(*MAIN_FONT, string_format("%i", mPlayerResources.commonMinerals()), (x + offsetX) * 2 + margin, textY, 255, 255, 255); }
+	mUiIcons.drawSub(r, (x + offsetX) * 2, y, 96, 16, constants::RESOURCE_ICON_SIZE, constants::RESOURCE_ICON_SIZE);
+	if (mHud.resources.commonMinerals() <= 10) { r.drawText(*MAIN_FONT, COMMON_MINERALS_TEXT(mHud.resources.commonMinerals()), (x + offsetX) * 2 + margin, textY, 255, GLOW_STEP, GLOW_STEP); }
+	else { r.drawText(*MAIN_FONT, COMMON_MINERALS_TEXT(mHud.resources.commonMinerals()), (x + offsetX) * 2 + margin, textY, 255, 255, 255); }
 
 	// Rare Minerals
-	r.drawSubImage(mUiIcons, (x + offsetX) * 3, y, 112, 16, constants::RESOURCE_ICON_SIZE, constants::RESOURCE_ICON_SIZE);
-	if (mPlayerResources.rareMinerals() <= 10) { r.drawText(*MAIN_FONT, string_format("%i", mPlayerResources.rareMinerals()), (x + offsetX) * 3 + margin, textY, 255, GLOW_STEP, GLOW_STEP); }
-	else { r.drawText(*MAIN_FONT, string_format("%i", mPlayerResources.rareMinerals()), (x + offsetX) * 3 + margin, textY, 255, 255, 255); }
+	mUiIcons.drawSub(r, (x + offsetX) * 3, y, 112, 16, constants::RESOURCE_ICON_SIZE, constants::RESOURCE_ICON_SIZE);
+	if (mHud.resources.rareMinerals() <= 10) { r.drawText(*MAIN_FONT, RARE_MINERALS_TEXT(mHud.resources.rareMinerals()), (x + offsetX) * 3 + margin, textY, 255, GLOW_STEP, GLOW_STEP); }
+	else { r.drawText(*MAIN_FONT, RARE_MINERALS_TEXT(mHud.resources.rareMinerals()), (x + offsetX) * 3 + margin, textY, 255, 255, 255); }
 
 	// Storage Capacity
-	r.drawSubImage(mUiIcons, (x + offsetX) * 4, y, 96, 32, constants::RESOURCE_ICON_SIZE, constants::RESOURCE_ICON_SIZE);
-	if (mPlayerResources.capacity() - mPlayerResources.currentLevel() <= 100) { r.drawText(*MAIN_FONT, string_format("%i/%i", mPlayerResources.currentLevel(), mPlayerResources.capacity()), (x + offsetX) * 4 + margin, textY, 255, GLOW_STEP, GLOW_STEP); }
-	else { r.drawText(*MAIN_FONT, string_format("%i/%i", mPlayerResources.currentLevel(), mPlayerResources.capacity()), (x + offsetX) * 4 + margin, textY, 255, 255, 255); }
+	mUiIcons.drawSub(r, (x + offsetX) * 4, y, 96, 32, constants::RESOURCE_ICON_SIZE, constants::RESOURCE_ICON_SIZE);
+	if (mHud.resources.capacity() - mHud.resources.currentLevel() <= 100) { r.drawText(*MAIN_FONT, STORAGE_TEXT(mHud.resources.currentLevel(), mHud.resources.capacity()), (x + offsetX) * 4 + margin, textY, 255, GLOW_STEP, GLOW_STEP); }
+	else { r.drawText(*MAIN_FONT, STORAGE_TEXT(mHud.resources.currentLevel(), mHud.resources.capacity()), (x + offsetX) * 4 + margin, textY, 255, 255, 255); }
 
 	// Food
-	r.drawSubImage(mUiIcons, (x + offsetX) * 6, y, 64, 32, constants::RESOURCE_ICON_SIZE, constants::RESOURCE_ICON_SIZE);
-	if (foodInStorage() <= 10) { r.drawText(*MAIN_FONT, string_format("%i/%i", foodInStorage(), foodTotalStorage()), (x + offsetX) * 6 + margin, textY, 255, GLOW_STEP, GLOW_STEP); }
-	else { r.drawText(*MAIN_FONT, string_format("%i/%i", foodInStorage(), foodTotalStorage()), (x + offsetX) * 6 + margin, textY, 255, 255, 255); }
+	mUiIcons.drawSub(r, (x + offsetX) * 6, y, 64, 32, constants::RESOURCE_ICON_SIZE, constants::RESOURCE_ICON_SIZE);
+	if (mHud.foodInStorage <= 10) { r.drawText(*MAIN_FONT, FOOD_TEXT(mHud.foodInStorage, mHud.foodTotalStorage), (x + offsetX) * 6 + margin, textY, 255, GLOW_STEP, GLOW_STEP); }
+	else { r.drawText(*MAIN_FONT, FOOD_TEXT(mHud.foodInStorage, mHud.foodTotalStorage), (x + offsetX) * 6 + margin, textY, 255, 255, 255); }
 
 	// Energy
-	r.drawSubImage(mUiIcons, (x + offsetX) * 8, y, 80, 32, constants::RESOURCE_ICON_SIZE, constants::RESOURCE_ICON_SIZE);
-	if (mPlayerResources.energy() <= 5) { r.drawText(*MAIN_FONT, string_format("%i/%i", mPlayerResources.energy(), Utility<StructureManager>::get().totalEnergyProduction()), (x + offsetX) * 8 + margin, textY, 255, GLOW_STEP, GLOW_STEP); }
-	else { r.drawText(*MAIN_FONT, string_format("%i/%i", mPlayerResources.energy(), Utility<StructureManager>::get().totalEnergyProduction()), (x + offsetX) * 8 + margin, textY, 255, 255, 255); }
+	mUiIcons.drawSub(r, (x + offsetX) * 8, y, 80, 32, constants::RESOURCE_ICON_SIZE, constants::RESOURCE_ICON_SIZE);
+	if (mHud.resources.energy() <= 5) { r.drawText(*MAIN_FONT, ENERGY_TEXT(mHud.resources.energy(), mHud.energyProduced), (x + offsetX) * 8 + margin, textY, 255, GLOW_STEP, GLOW_STEP); }
+	else { r.drawText(*MAIN_FONT, ENERGY_TEXT(mHud.resources.energy(), mHud.energyProduced), (x + offsetX) * 8 + margin, textY, 255, 255, 255); }
 
 	// Population / Morale
-	if (mCurrentMorale > mPreviousMorale) { r.drawSubImage(mUiIcons, (x + offsetX) * 10 - 17, y, 16, 48, constants::RESOURCE_ICON_SIZE, constants::RESOURCE_ICON_SIZE); }
-	else if (mCurrentMorale < mPreviousMorale) { r.drawSubImage(mUiIcons, (x + offsetX) * 10 - 17, y, 0, 48, constants::RESOURCE_ICON_SIZE, constants::RESOURCE_ICON_SIZE); }
-	else { r.drawSubImage(mUiIcons, (x + offsetX) * 10 - 17, y, 32, 48, constants::RESOURCE_ICON_SIZE, constants::RESOURCE_ICON_SIZE); }
+	if (mHud.morale > mHud.previousMorale) { mUiIcons.drawSub(r, (x + offsetX) * 10 - 17, y, 16, 48, constants::RESOURCE_ICON_SIZE, constants::RESOURCE_ICON_SIZE); }
+	else if (mHud.morale < mHud.previousMorale) { mUiIcons.drawSub(r, (x + offsetX) * 10 - 17, y, 0, 48, constants::RESOURCE_ICON_SIZE, constants::RESOURCE_ICON_SIZE); }
+	else { mUiIcons.drawSub(r, (x + offsetX) * 10 - 17, y, 32, 48, constants::RESOURCE_ICON_SIZE, constants::RESOURCE_ICON_SIZE); }
 
-	r.drawSubImage(mUiIcons, (x + offsetX) * 10, y, 176 + (clamp(mCurrentMorale, 1, 999) / 200) * constants::RESOURCE_ICON_SIZE, 0, constants::RESOURCE_ICON_SIZE, constants::RESOURCE_ICON_SIZE);
-	r.drawText(*MAIN_FONT, string_format("%i", mPopulation.size()), (x + offsetX) * 10 + margin, textY, 255, 255, 255);
+	mUiIcons.drawSub(r, (x + offsetX) * 10, y, 176 + (clamp(mHud.morale, 1, 999) / 200) * constants::RESOURCE_ICON_SIZE, 0, constants::RESOURCE_ICON_SIZE, constants::RESOURCE_ICON_SIZE);
+	r.drawText(*MAIN_FONT, POPULATION_TEXT(mHud.population), (x + offsetX) * 10 + margin, textY, 255, 255, 255);
 
-	if (mPinPopulationPanel	|| isPointInRect(MOUSE_COORDS.x(), MOUSE_COORDS.y(), 675, 1, 75, 19)) { mPopulationPanel.update(); }
-	if (mPinResourcePanel	|| isPointInRect(MOUSE_COORDS.x(), MOUSE_COORDS.y(), 0, 1, mResourceBreakdownPanel.width(), 19)) { mResourceBreakdownPanel.update(); }
+	// The panels read the colony which the turn being processed is changing.
+	if (!mTurnWorker.busy())
+	{
+		if (mPinPopulationPanel	|| isPointInRect(MOUSE_COORDS.x(), MOUSE_COORDS.y(), 675, 1, 75, 19)) { mPopulationPanel.update(); }
+		if (mPinResourcePanel	|| isPointInRect(MOUSE_COORDS.x(), MOUSE_COORDS.y(), 0, 1, mResourceBreakdownPanel.width(), 19)) { mResourceBreakdownPanel.update(); }
+	}
 
 	// Turns
-	r.drawSubImage(mUiIcons, r.width() - 80, y, 128, 0, constants::RESOURCE_ICON_SIZE, constants::RESOURCE_ICON_SIZE);
-	r.drawText(*MAIN_FONT, string_format("%i", mTurnCount), r.width() - 80 + margin, textY, 255, 255, 255);
+	mUiIcons.drawSub(r, r.width() - 80, y, 128, 0, constants::RESOURCE_ICON_SIZE, constants::RESOURCE_ICON_SIZE);
+	r.drawText(*MAIN_FONT, TURN_TEXT(mHud.turnCount), r.width() - 80 + margin, textY, 255, 255, 255);
 
-	if (isPointInRect(MOUSE_COORDS, MENU_ICON)) { r.drawSubImage(mUiIcons, MENU_ICON.x() + constants::MARGIN_TIGHT, MENU_ICON.y() + constants::MARGIN_TIGHT, 144, 32, constants::RESOURCE_ICON_SIZE, constants::RESOURCE_ICON_SIZE); }
-	else { r.drawSubImage(mUiIcons, MENU_ICON.x() + constants::MARGIN_TIGHT, MENU_ICON.y() + constants::MARGIN_TIGHT, 128, 32, constants::RESOURCE_ICON_SIZE, constants::RESOURCE_ICON_SIZE); }
+	if (isPointInRect(MOUSE_COORDS, MENU_ICON)) { mUiIcons.drawSub(r, MENU_ICON.x() + constants::MARGIN_TIGHT, MENU_ICON.y() + constants::MARGIN_TIGHT, 144, 32, constants::RESOURCE_ICON_SIZE, constants::RESOURCE_ICON_SIZE); }
+	else { mUiIcons.drawSub(r, MENU_ICON.x() + constants::MARGIN_TIGHT, MENU_ICON.y() + constants::MARGIN_TIGHT, 128, 32, constants::RESOURCE_ICON_SIZE, constants::RESOURCE_ICON_SIZE); }
+}
+
+
+/**
+ * Takes the values shown in the resource and robot bars.
+ */
+void MapViewState::updateHud()
+{
+	mHud.resources = mPlayerResources;
+	mHud.foodInStorage = foodInStorage();
+	mHud.foodTotalStorage = foodTotalStorage();
+	mHud.energyProduced = Utility<StructureManager>::get().totalEnergyProduction();
+
+	mHud.population = mPopulation.size();
+	mHud.morale = mCurrentMorale;
+	mHud.previousMorale = mPreviousMorale;
+	mHud.turnCount = mTurnCount;
+
+	for (RobotType type : { ROBOT_DIGGER, ROBOT_DOZER, ROBOT_MINER })
+	{
+		mHud.robotsAvailable[type] = mRobotPool.getAvailableCount(type);
+		mHud.robotsQueued[type] = mRobotJobs.count(type);
+	}
+
+	mHud.robotsTotal[ROBOT_DIGGER] = static_cast<int>(mRobotPool.diggers().size());
+	mHud.robotsTotal[ROBOT_DOZER] = static_cast<int>(mRobotPool.dozers().size());
+	mHud.robotsTotal[ROBOT_MINER] = static_cast<int>(mRobotPool.miners().size());
+
+	mHud.robotControlCount = mRobotPool.currentControlCount();
+	mHud.robotControlMax = mRobotPool.robotControlMax();
 }
 
 
@@ -212,21 +276,28 @@ void MapViewState::drawRobotInfo()
 	int margin = 30;	// Margin of 28 px from the graphics to the text
 	int x = 0, offsetX = 1;	// Start a the left side of the screen + an offset of 1 to detatch from the border
 	
+	// Available / total robots followed by the number of queued tasks if any.
+	auto robotSummary = [this](RobotType type) -> const std::string&
+	{
+		if (mHud.robotsQueued[type] == 0) { return ROBOT_TEXT[type](mHud.robotsAvailable[type], mHud.robotsTotal[type]); }
+		return ROBOT_QUEUED_TEXT[type](mHud.robotsAvailable[type], mHud.robotsTotal[type], mHud.robotsQueued[type]);
+	};
+
 	// Miner (last one)
-	r.drawSubImage(mUiIcons, (x + offsetX) * 8, y, 231, 18, 25, 25);
-	r.drawText(*MAIN_FONT, string_format("%i/%i", mRobotPool.getAvailableCount(ROBOT_MINER), mRobotPool.miners().size()), (x + offsetX) * 8 + margin, textY, 255, 255, 255);
+	mUiIcons.drawSub(r, (x + offsetX) * 8, y, 231, 18, 25, 25);
+	r.drawText(*MAIN_FONT, robotSummary(ROBOT_MINER), (x + offsetX) * 8 + margin, textY, 255, 255, 255);
 	// Dozer (Midle one)
 	textY -= 25; y -= 25;
-	r.drawSubImage(mUiIcons, (x + offsetX) * 8, y, 206, 18, 25, 25);
-	r.drawText(*MAIN_FONT, string_format("%i/%i", mRobotPool.getAvailableCount(ROBOT_DOZER), mRobotPool.dozers().size()), (x + offsetX) * 8 + margin, textY, 255, 255, 255);
+	mUiIcons.drawSub(r, (x + offsetX) * 8, y, 206, 18, 25, 25);
+	r.drawText(*MAIN_FONT, robotSummary(ROBOT_DOZER), (x + offsetX) * 8 + margin, textY, 255, 255, 255);
 	// Digger (First one)
 	textY -= 25; y -= 25;
-	r.drawSubImage(mUiIcons, (x + offsetX) * 8, y, 181, 18, 25, 25);
-	r.drawText(*MAIN_FONT, string_format("%i/%i", mRobotPool.getAvailableCount(ROBOT_DIGGER), mRobotPool.diggers().size()), (x + offsetX) * 8 + margin, textY, 255, 255, 255);
+	mUiIcons.drawSub(r, (x + offsetX) * 8, y, 181, 18, 25, 25);
+	r.drawText(*MAIN_FONT, robotSummary(ROBOT_DIGGER), (x + offsetX) * 8 + margin, textY, 255, 255, 255);
 	// robot control summary
 	textY -= 25; y -= 25;
-	r.drawSubImage(mUiIcons, (x + offsetX) * 8, y, 231, 43, 25, 25);
-	r.drawText(*MAIN_FONT, string_format("%i/%i", mRobotPool.currentControlCount(), mRobotPool.robotControlMax()), (x + offsetX) * 8 + margin, textY, 255, 255, 255);
+	mUiIcons.drawSub(r, (x + offsetX) * 8, y, 231, 43, 25, 25);
+	r.drawText(*MAIN_FONT, ROBOT_CONTROL_TEXT(static_cast<int>(mHud.robotControlCount), static_cast<int>(mHud.robotControlMax)), (x + offsetX) * 8 + margin, textY, 255, 255, 255);
 }
 
 
@@ -240,57 +311,57 @@ void MapViewState::drawNavInfo()
 	// Up / Down
 	if (isPointInRect(MOUSE_COORDS, MOVE_DOWN_ICON))
 	{
-		r.drawSubImage(mUiIcons, MOVE_DOWN_ICON.x(), MOVE_DOWN_ICON.y(), 64, 128, 32, 32, 255, 0, 0, 255);
+		mUiIcons.drawSub(r, MOVE_DOWN_ICON.x(), MOVE_DOWN_ICON.y(), 64, 128, 32, 32, 255, 0, 0, 255);
 	}
 	else
 	{
-		r.drawSubImage(mUiIcons, MOVE_DOWN_ICON.x(), MOVE_DOWN_ICON.y(), 64, 128, 32, 32);
+		mUiIcons.drawSub(r, MOVE_DOWN_ICON.x(), MOVE_DOWN_ICON.y(), 64, 128, 32, 32);
 	}
 
 	if (isPointInRect(MOUSE_COORDS, MOVE_UP_ICON))
 	{
-		r.drawSubImage(mUiIcons, MOVE_UP_ICON.x(), MOVE_UP_ICON.y(), 96, 128, 32, 32, 255, 0, 0, 255);
+		mUiIcons.drawSub(r, MOVE_UP_ICON.x(), MOVE_UP_ICON.y(), 96, 128, 32, 32, 255, 0, 0, 255);
 	}
 	else
 	{
-		r.drawSubImage(mUiIcons, MOVE_UP_ICON.x(), MOVE_UP_ICON.y(), 96, 128, 32, 32);
+		mUiIcons.drawSub(r, MOVE_UP_ICON.x(), MOVE_UP_ICON.y(), 96, 128, 32, 32);
 	}
 
 	// East / West / North / South
 	if (isPointInRect(MOUSE_COORDS, MOVE_EAST_ICON))
 	{
-		r.drawSubImage(mUiIcons, MOVE_EAST_ICON.x(), MOVE_EAST_ICON.y(), 32, 128, 32, 16, 255, 0, 0, 255);
+		mUiIcons.drawSub(r, MOVE_EAST_ICON.x(), MOVE_EAST_ICON.y(), 32, 128, 32, 16, 255, 0, 0, 255);
 	}
 	else
 	{
-		r.drawSubImage(mUiIcons, MOVE_EAST_ICON.x(), MOVE_EAST_ICON.y(), 32, 128, 32, 16);
+		mUiIcons.drawSub(r, MOVE_EAST_ICON.x(), MOVE_EAST_ICON.y(), 32, 128, 32, 16);
 	}
 
 	if (isPointInRect(MOUSE_COORDS, MOVE_WEST_ICON))
 	{
-		r.drawSubImage(mUiIcons, MOVE_WEST_ICON.x(), MOVE_WEST_ICON.y(), 32, 144, 32, 16, 255, 0, 0, 255);
+		mUiIcons.drawSub(r, MOVE_WEST_ICON.x(), MOVE_WEST_ICON.y(), 32, 144, 32, 16, 255, 0, 0, 255);
 	}
 	else
 	{
-		r.drawSubImage(mUiIcons, MOVE_WEST_ICON.x(), MOVE_WEST_ICON.y(), 32, 144, 32, 16);
+		mUiIcons.drawSub(r, MOVE_WEST_ICON.x(), MOVE_WEST_ICON.y(), 32, 144, 32, 16);
 	}
 
 	if (isPointInRect(MOUSE_COORDS, MOVE_NORTH_ICON))
 	{
-		r.drawSubImage(mUiIcons, MOVE_NORTH_ICON.x(), MOVE_NORTH_ICON.y(), 0, 128, 32, 16, 255, 0, 0, 255);
+		mUiIcons.drawSub(r, MOVE_NORTH_ICON.x(), MOVE_NORTH_ICON.y(), 0, 128, 32, 16, 255, 0, 0, 255);
 	}
 	else
 	{
-		r.drawSubImage(mUiIcons, MOVE_NORTH_ICON.x(), MOVE_NORTH_ICON.y(), 0, 128, 32, 16);
+		mUiIcons.drawSub(r, MOVE_NORTH_ICON.x(), MOVE_NORTH_ICON.y(), 0, 128, 32, 16);
 	}
 
 	if (isPointInRect(MOUSE_COORDS, MOVE_SOUTH_ICON))
 	{
-		r.drawSubImage(mUiIcons, MOVE_SOUTH_ICON.x(), MOVE_SOUTH_ICON.y(), 0, 144, 32, 16, 255, 0, 0, 255);
+		mUiIcons.drawSub(r, MOVE_SOUTH_ICON.x(), MOVE_SOUTH_ICON.y(), 0, 144, 32, 16, 255, 0, 0, 255);
 	}
 	else
 	{
-		r.drawSubImage(mUiIcons, MOVE_SOUTH_ICON.x(), MOVE_SOUTH_ICON.y(), 0, 144, 32, 16);
+		mUiIcons.drawSub(r, MOVE_SOUTH_ICON.x(), MOVE_SOUTH_ICON.y(), 0, 144, 32, 16);
 	}
 
 
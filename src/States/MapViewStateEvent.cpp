@@ -59,37 +59,60 @@ void MapViewState::pullRobotFromFactory(ProductType pt, Factory& factory)
 
 
 /**
- * Called whenever a Factory's production is complete.
+ * Delivers the products that factories finished this turn to the robot
+ * pool and to warehouses in one pass.
+ *
+ * \note	Robots load their sprites when they're made so this has to be
+ *			called on the main thread.
  */
-void MapViewState::factoryProductionComplete(Factory& factory)
-{	
-	switch (factory.productWaiting())
+void MapViewState::deliverFactoryProducts()
+{
+	StructureManager& sm = Utility<StructureManager>::get();
+	StructureList& warehouses = sm.structureList(Structure::CLASS_WAREHOUSE);
+
+	// Warehouses only fill up during delivery so the ones that couldn't take
+	// a product are skipped for the rest of the pass.
+	std::array<size_t, PRODUCT_COUNT> firstWarehouse = {{ 0 }};
+
+	for (auto structure : sm.structureList(Structure::CLASS_FACTORY))
 	{
-	case PRODUCT_DIGGER:
-		pullRobotFromFactory(PRODUCT_DIGGER, factory);
-		break;
+		Factory& factory = *static_cast<Factory*>(structure);
+		ProductType product = factory.productWaiting();
 
-	case PRODUCT_DOZER:
-		pullRobotFromFactory(PRODUCT_DOZER, factory);
-		break;
+		switch (product)
+		{
+		case PRODUCT_NONE:
+			break;
 
-	case PRODUCT_MINER:
-		pullRobotFromFactory(PRODUCT_MINER, factory);
-		break;
+		case PRODUCT_DIGGER:
+		case PRODUCT_DOZER:
+		case PRODUCT_MINER:
+			pullRobotFromFactory(product, factory);
+			break;
 
-	case PRODUCT_ROAD_MATERIALS:
-	case PRODUCT_CLOTHING:
-	case PRODUCT_MEDICINE:
+		case PRODUCT_ROAD_MATERIALS:
+		case PRODUCT_CLOTHING:
+		case PRODUCT_MEDICINE:
 		{
-			Warehouse* _wh = getAvailableWarehouse(factory.productWaiting(), 1);
-			if (_wh) { _wh->products().store(factory.productWaiting(), 1); factory.pullProduct(); }
-			else { factory.idle(IDLE_FACTORY_INSUFFICIENT_WAREHOUSE_SPACE); }
+			size_t& index = firstWarehouse[product];
+			while (index < warehouses.size() && !static_cast<Warehouse*>(warehouses[index])->products().canStore(product, 1)) { ++index; }
+
+			if (index < warehouses.size())
+			{
+				static_cast<Warehouse*>(warehouses[index])->products().store(product, 1);
+				factory.pullProduct();
+			}
+			else
+			{
+				factory.idle(IDLE_FACTORY_INSUFFICIENT_WAREHOUSE_SPACE);
+			}
 			break;
 		}
 
-	default:
-		std::cout << "Unknown Product." << std::endl;
-		break;
+		default:
+			std::cout << "Unknown Product." << std::endl;
+			break;
+		}
 	}
 }
 
@@ -129,6 +152,13 @@ void MapViewState::deployCargoLander()
  */
 void MapViewState::deploySeedLander(int x, int y)
 {
+	// The SEED structures and robots load their sprites when they're made.
+	if (mTurnWorker.onWorkerThread())
+	{
+		mTurnWorker.runOnMainThread([this, x, y]() { deploySeedLander(x, y); });
+		return;
+	}
+
 	mTileMap->getTile(x, y)->index(TERRAIN_DOZED);
 
 	// TOP ROW
@@ -154,7 +184,6 @@ void MapViewState::deploySeedLander(int x, int y)
 	// BOTTOM ROW
 	SeedFactory* sf = static_cast<SeedFactory*>(StructureCatalogue::get(SID_SEED_FACTORY));
 	sf->resourcePool(&mPlayerResources);
-	sf->productionComplete().connect(this, &MapViewState::factoryProductionComplete);
 	sf->sprite().skip(7);
 	Utility<StructureManager>::get().addStructure(sf, mTileMap->getTile(x - 1, y + 1));
 	mTileMap->getTile(x - 1, y + 1)->index(TERRAIN_DOZED);
@@ -294,6 +323,13 @@ void MapViewState::minerTaskFinished(Robot* _r)
 
 void MapViewState::mineFacilityExtended(MineFacility* mf)
 {
+	// Updates the mine operations window and makes a shaft with a sprite.
+	if (mTurnWorker.onWorkerThread())
+	{
+		mTurnWorker.runOnMainThread([this, mf]() { mineFacilityExtended(mf); });
+		return;
+	}
+
 	if (mMineOperationsWindow.mineFacility() == mf) { mMineOperationsWindow.mineFacility(mf); }
 	
 	Tile* mf_tile = Utility<StructureManager>::get().tileFromStructure(mf);
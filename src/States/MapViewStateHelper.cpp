@@ -14,6 +14,8 @@
 
 #include "../Constants.h"
 #include "../StructureCatalogue.h"
+#include "../SaveGameSnapshot.h"
+#include "../StateHash.h"
 
 
 #include "../Things/Structures/RobotCommand.h"
@@ -263,7 +265,8 @@ bool landingSiteSuitable(TileMap* tilemap, int x, int y)
 
 
 /**
- * Document me!
+ * Destroys the robots under the command of a Robot Command Center that's
+ * being bulldozed. Robots that are working die at the end of the turn.
  */
 void deleteRobotsInRCC(Robot* r, RobotCommand* rcc, RobotPool& rp, RobotTileTable& rtt, Tile* tile)
 {
@@ -273,7 +276,8 @@ void deleteRobotsInRCC(Robot* r, RobotCommand* rcc, RobotPool& rp, RobotTileTabl
 		return;
 	}
 
-	const RobotList& rl = rcc->robots();
+	// Erasing a robot removes it from the RCC's list.
+	const RobotList rl = rcc->robots();
 
 	for (auto robot : rl)
 	{
@@ -290,12 +294,15 @@ void deleteRobotsInRCC(Robot* r, RobotCommand* rcc, RobotPool& rp, RobotTileTabl
 
 
 /**
- * Document me!
+ * Updates the number of robots that can be controlled.
+ *
+ * \note	The number of robots under control is kept by the RobotPool as
+ *			robots are put to work and released.
  */
 void updateRobotControl(RobotPool& _rp)
 {
-	auto CommandCenter = Utility<StructureManager>::get().structureList(Structure::CLASS_COMMAND);
-	auto RobotCommand = Utility<StructureManager>::get().structureList(Structure::CLASS_ROBOT_COMMAND);
+	const auto& CommandCenter = Utility<StructureManager>::get().structureList(Structure::CLASS_COMMAND);
+	const auto& RobotCommand = Utility<StructureManager>::get().structureList(Structure::CLASS_ROBOT_COMMAND);
 
 	// 3 for the first command center
 	uint32_t _maxRobots = 0;
@@ -306,7 +313,7 @@ void updateRobotControl(RobotPool& _rp)
 		if (RobotCommand[s]->operational()) { _maxRobots += 10; }
 	}
 
-	_rp.InitRobotCtrl(_maxRobots);
+	_rp.robotControlMax(_maxRobots);
 }
 
 
@@ -337,9 +344,7 @@ bool selfSustained(StructureID id)
  */
 bool outOfCommRange(Point_2d& cc_location, TileMap* tile_map, Tile* current_tile)
 {
-	Tile* tile = tile_map->getVisibleTile();
-
-	if (tile->distanceTo(tile_map->getTile(cc_location.x(), cc_location.y(), 0)) <= constants::ROBOT_COM_RANGE)
+	if (current_tile->distanceTo(tile_map->getTile(cc_location.x(), cc_location.y(), 0)) <= constants::ROBOT_COM_RANGE)
 		return false;
 
 	Tile* _comm_t = nullptr;
@@ -527,20 +532,20 @@ void resourceShortageMessage(ResourcePool& _rp, StructureID sid)
 /** 
  * Document me!
  */
-void checkRobotDeployment(XmlElement* _ti, RobotTileTable& _rm, Robot* _r, RobotType _type)
+void checkRobotDeployment(SaveGameSnapshot& _w, RobotTileTable& _rm, Robot* _r, RobotType _type)
 {
-	_ti->attribute("id", _r->id());
-	_ti->attribute("type", _type);
-	_ti->attribute("age", _r->fuelCellAge());
-	_ti->attribute("production", _r->turnsToCompleteTask());
+	_w.attribute("id", _r->id());
+	_w.attribute("type", _type);
+	_w.attribute("age", _r->fuelCellAge());
+	_w.attribute("production", _r->turnsToCompleteTask());
 
 	for (auto it = _rm.begin(); it != _rm.end(); ++it)
 	{
 		if (it->first == _r)
 		{
-			_ti->attribute("x", it->second->x());
-			_ti->attribute("y", it->second->y());
-			_ti->attribute("depth", it->second->depth());
+			_w.attribute("x", it->second->x());
+			_w.attribute("y", it->second->y());
+			_w.attribute("depth", it->second->depth());
 		}
 	}
 
@@ -552,49 +557,82 @@ void checkRobotDeployment(XmlElement* _ti, RobotTileTable& _rm, Robot* _r, Robot
  * 
  * Convenience function
  */
-void writeRobots(XmlElement* _ti, RobotPool& _rp, RobotTileTable& _rm)
+void writeRobots(SaveGameSnapshot& _w, RobotPool& _rp, RobotTileTable& _rm)
 {
-	XmlElement* robots = new XmlElement("robots");
-	robots->attribute("id_counter", ROBOT_ID_COUNTER);
+	_w.openElement("robots");
+	_w.attribute("id_counter", ROBOT_ID_COUNTER);
 
 	RobotPool::DiggerList& diggers = _rp.diggers();
 
 	for (auto digger : diggers)
 	{
-		XmlElement* robot = new XmlElement("robot");
-		checkRobotDeployment(robot, _rm, digger, ROBOT_DIGGER);
-		robot->attribute("direction", digger->direction());
-		robots->linkEndChild(robot);
+		_w.openElement("robot");
+		checkRobotDeployment(_w, _rm, digger, ROBOT_DIGGER);
+		_w.attribute("direction", digger->direction());
+		_w.closeElement();
 	}
 
 	RobotPool::DozerList& dozers = _rp.dozers();
 	for (auto dozer : dozers)
 	{
-		XmlElement* robot = new XmlElement("robot");
-		checkRobotDeployment(robot, _rm, dozer, ROBOT_DOZER);
-		robots->linkEndChild(robot);
+		_w.openElement("robot");
+		checkRobotDeployment(_w, _rm, dozer, ROBOT_DOZER);
+		_w.closeElement();
 	}
 
 	RobotPool::MinerList& miners = _rp.miners();
 	for (auto miner : miners)
 	{
-		XmlElement* robot = new XmlElement("robot");
-		checkRobotDeployment(robot, _rm, miner, ROBOT_MINER);
-		robots->linkEndChild(robot);
+		_w.openElement("robot");
+		checkRobotDeployment(_w, _rm, miner, ROBOT_MINER);
+		_w.closeElement();
+	}
+
+	_w.closeElement();
+}
+
+
+/**
+ * Adds everything writeRobots() writes about the robots to a state hash.
+ */
+void hashRobots(StateHash& _h, RobotPool& _rp, RobotTileTable& _rm)
+{
+	_h.add(ROBOT_ID_COUNTER);
+
+	auto hashRobot = [&_h, &_rm](Robot* robot, RobotType type)
+	{
+		_h.add(robot->id());
+		_h.add(type);
+		_h.add(robot->fuelCellAge());
+		_h.add(robot->turnsToCompleteTask());
+
+		auto it = _rm.find(robot);
+		if (it == _rm.end()) { return; }
+
+		_h.add(it->second->x());
+		_h.add(it->second->y());
+		_h.add(it->second->depth());
+	};
+
+	for (auto digger : _rp.diggers())
+	{
+		hashRobot(digger, ROBOT_DIGGER);
+		_h.add(digger->direction());
 	}
 
-	_ti->linkEndChild(robots);
+	for (auto dozer : _rp.dozers()) { hashRobot(dozer, ROBOT_DOZER); }
+	for (auto miner : _rp.miners()) { hashRobot(miner, ROBOT_MINER); }
 }
 
 
 /** 
  * Document me!
  */
-void writeResources(XmlElement* _ti, ResourcePool& _rp, const std::string& tag_name)
+void writeResources(SaveGameSnapshot& _w, ResourcePool& _rp, const std::string& tag_name)
 {
-	XmlElement* resources = new XmlElement(tag_name);
-	_rp.serialize(resources);
-	_ti->linkEndChild(resources);
+	_w.openElement(tag_name);
+	_rp.serialize(_w);
+	_w.closeElement();
 }
 
 
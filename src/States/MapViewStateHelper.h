@@ -19,6 +19,8 @@ typedef std::map<Robot*, Tile*> RobotTileTable; /**<  */
 
 class Warehouse;	/**< Forward declaration for getAvailableWarehouse() function. */
 class RobotCommand;	/**< Forward declaration for getAvailableRobotCommand() function. */
+class SaveGameSnapshot;	/**< Forward declaration for serialization functions. */
+class StateHash;	/**< Forward declaration for hashRobots(). */
 
 NAS2D::Point_2d& ccLocation();
 int ccLocationX();
@@ -45,8 +47,9 @@ void moveProducts(Warehouse*);
 void resourceShortageMessage(ResourcePool&, StructureID);
 
 // Serialize / Deserialize
-void writeRobots(NAS2D::Xml::XmlElement* _ti, RobotPool& _rp, RobotTileTable& _rm);
-void writeResources(NAS2D::Xml::XmlElement* _ti, ResourcePool& _rp, const std::string& tag_name);
+void writeRobots(SaveGameSnapshot& _w, RobotPool& _rp, RobotTileTable& _rm);
+void writeResources(SaveGameSnapshot& _w, ResourcePool& _rp, const std::string& tag_name);
+void hashRobots(StateHash& _h, RobotPool& _rp, RobotTileTable& _rm);
 
 void readResources(NAS2D::Xml::XmlElement* _ti, ResourcePool& _rp);
 
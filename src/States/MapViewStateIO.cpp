@@ -10,9 +10,18 @@
 #include "MapViewState.h"
 
 
+#include "../AssetPreloader.h"
+#include "../AttributeSchema.h"
+#include "../CompressedFile.h"
 #include "../Constants.h"
+#include "../ProductionPlanner.h"
+#include "../Random.h"
 #include "../StructureCatalogue.h"
 #include "../StructureTranslator.h"
+#include "../SaveGameHeader.h"
+#include "../SaveGameSnapshot.h"
+
+#include <unordered_map>
 
 
 using namespace NAS2D;
@@ -34,6 +43,176 @@ extern NAS2D::Image* IMG_SAVING;
 extern int ROBOT_ID_COUNTER; /// \fixme Kludge
 
 
+/**
+ * Record types used to read savegame elements.
+ */
+struct PropertiesRecord
+{
+	int depth = 0;
+	std::string sitemap, tset;
+};
+
+struct RobotRecord
+{
+	int id = 0, type = 0, age = 0, production_time = 0, x = 0, y = 0, depth = 0, direction = 0;
+};
+
+struct StructureRecord
+{
+	std::string type;
+	int x = 0, y = 0, depth = 0, age = 0, state = 0, direction = 0, forced_idle = 0, disabled_reason = 0, idle_reason = 0, pop0 = 0, pop1 = 0;
+	int production_completed = 0, production_type = 0;
+};
+
+struct PopulationRecord
+{
+	int morale = 0, prev_morale = 0, colonist_landers = 0, cargo_landers = 0;
+	int children = 0, students = 0, workers = 0, scientists = 0, retired = 0;
+};
+
+struct CounterRecord { int count = 0; };
+
+
+static const AttributeSchema<PropertiesRecord> PROPERTIES_SCHEMA("properties",
+{
+	{ "diggingdepth", &PropertiesRecord::depth, true },
+	{ "sitemap", &PropertiesRecord::sitemap, true },
+	{ "tset", &PropertiesRecord::tset, true }
+});
+
+static const AttributeSchema<CounterRecord> ROBOTS_SCHEMA("robots", { { "id_counter", &CounterRecord::count, true } });
+
+static const AttributeSchema<RobotRecord> ROBOT_SCHEMA("robot",
+{
+	{ "id", &RobotRecord::id, true },
+	{ "type", &RobotRecord::type, true },
+	{ "age", &RobotRecord::age },
+	{ "production", &RobotRecord::production_time },
+	{ "x", &RobotRecord::x },
+	{ "y", &RobotRecord::y },
+	{ "depth", &RobotRecord::depth },
+	{ "direction", &RobotRecord::direction }
+});
+
+static const AttributeSchema<StructureRecord> STRUCTURE_SCHEMA("structure",
+{
+	{ "x", &StructureRecord::x, true },
+	{ "y", &StructureRecord::y, true },
+	{ "depth", &StructureRecord::depth, true },
+	{ "age", &StructureRecord::age },
+	{ "state", &StructureRecord::state },
+	{ "direction", &StructureRecord::direction },
+	{ "type", &StructureRecord::type, true },
+	{ "forced_idle", &StructureRecord::forced_idle },
+	{ "disabled_reason", &StructureRecord::disabled_reason },
+	{ "idle_reason", &StructureRecord::idle_reason },
+	{ "production_completed", &StructureRecord::production_completed },
+	{ "production_type", &StructureRecord::production_type },
+	{ "pop0", &StructureRecord::pop0 },
+	{ "pop1", &StructureRecord::pop1 }
+});
+
+static const AttributeSchema<CounterRecord> TURNS_SCHEMA("turns", { { "count", &CounterRecord::count, true } });
+
+static const AttributeSchema<PopulationRecord> POPULATION_SCHEMA("population",
+{
+	{ "morale", &PopulationRecord::morale },
+	{ "prev_morale", &PopulationRecord::prev_morale },
+	{ "colonist_landers", &PopulationRecord::colonist_landers },
+	{ "cargo_landers", &PopulationRecord::cargo_landers },
+	{ "children", &PopulationRecord::children },
+	{ "students", &PopulationRecord::students },
+	{ "workers", &PopulationRecord::workers },
+	{ "scientists", &PopulationRecord::scientists },
+	{ "retired", &PopulationRecord::retired }
+});
+
+
+/**
+ * Compression to use for savegames as set in the configuration file.
+ */
+static CompressionType saveGameCompression()
+{
+	return compressionFromString(Utility<Configuration>::get().option("save-compression"));
+}
+
+
+/**
+ * Records the current state of the game in a SaveGameSnapshot.
+ *
+ * \note	The snapshot doesn't refer back to any game state so it can
+ *			safely be written out on another thread.
+ */
+std::unique_ptr<SaveGameSnapshot> MapViewState::snapshot()
+{
+	auto snapshot = std::make_unique<SaveGameSnapshot>();
+
+	snapshot->openElement(constants::SAVE_GAME_ROOT_NODE);
+	snapshot->attribute("version", constants::SAVE_GAME_VERSION);
+
+	SaveGameHeader header;
+	header.turn = mTurnCount;
+	header.population = mPopulation.size();
+	header.morale = mCurrentMorale;
+	header.sitemap = mTileMap->mapPath();
+	header.timestamp = std::time(nullptr);
+
+	const int size = constants::SAVE_GAME_THUMBNAIL_SIZE;
+	for (int y = 0; y < size; ++y)
+	{
+		for (int x = 0; x < size; ++x)
+		{
+			header.thumbnail.push_back(mMapDisplay->pixelColor(x * mMapDisplay->width() / size, y * mMapDisplay->height() / size));
+		}
+	}
+
+	writeSaveGameHeader(*snapshot, header);
+	mTileMap->serializeView(*snapshot);
+	serializeState(*snapshot);
+
+	// Targets don't change the game so they're left out of the state hash.
+	Utility<ProductionPlanner>::get().serialize(*snapshot);
+
+	snapshot->closeElement();
+
+	return snapshot;
+}
+
+
+/**
+ * Records everything that makes up the state of the game, i.e. all of
+ * the savegame except its header, the view and the production targets.
+ */
+void MapViewState::serializeState(SaveGameSnapshot& _w)
+{
+	Utility<RandomService>::get().serialize(_w);
+
+	mTileMap->serialize(_w);
+	Utility<StructureManager>::get().serialize(_w);
+	writeRobots(_w, mRobotPool, mRobotList);
+	mRobotJobs.serialize(_w);
+	writeResources(_w, mPlayerResources, "resources");
+	writeResources(_w, mResourceBreakdownPanel.previousResources(), "prev_resources");
+
+	_w.openElement("turns");
+	_w.attribute("count", mTurnCount);
+	_w.closeElement();
+
+	_w.openElement("population");
+	_w.attribute("morale", mCurrentMorale);
+	_w.attribute("prev_morale", mPreviousMorale);
+	_w.attribute("colonist_landers", mLandersColonist);
+	_w.attribute("cargo_landers", mLandersCargo);
+	_w.attribute("children", mPopulation.size(Population::ROLE_CHILD));
+	_w.attribute("students", mPopulation.size(Population::ROLE_STUDENT));
+	_w.attribute("workers", mPopulation.size(Population::ROLE_WORKER));
+	_w.attribute("scientists", mPopulation.size(Population::ROLE_SCIENTIST));
+	_w.attribute("retired", mPopulation.size(Population::ROLE_RETIRED));
+	mPopulation.serialize(_w);
+	_w.closeElement();
+}
+
+
 /**
  * 
  */
@@ -44,39 +223,35 @@ void MapViewState::save(const std::string& _path)
 	r.drawImage(*IMG_SAVING, r.center_x() - (IMG_SAVING->width() / 2), r.center_y() - (IMG_SAVING->height() / 2));
 	r.update();
 
-	XmlDocument doc;
+	mSaveGameWriter.wait();
+	snapshot()->write(_path, saveGameCompression());
 
-	XmlElement* root = new XmlElement(constants::SAVE_GAME_ROOT_NODE);
-	root->attribute("version", constants::SAVE_GAME_VERSION);
-	doc.linkEndChild(root);
-
-	mTileMap->serialize(root);
-	Utility<StructureManager>::get().serialize(root);
-	writeRobots(root, mRobotPool, mRobotList);
-	writeResources(root, mPlayerResources, "resources");
-	writeResources(root, mResourceBreakdownPanel.previousResources(), "prev_resources");
-
-	XmlElement* turns = new XmlElement("turns");
-	turns->attribute("count", mTurnCount);
-	root->linkEndChild(turns);
-
-	XmlElement* population = new XmlElement("population");
-	population->attribute("morale", mCurrentMorale);
-	population->attribute("prev_morale", mPreviousMorale);
-	population->attribute("colonist_landers", mLandersColonist);
-	population->attribute("cargo_landers", mLandersCargo);
-	population->attribute("children", mPopulation.size(Population::ROLE_CHILD));
-	population->attribute("students", mPopulation.size(Population::ROLE_STUDENT));
-	population->attribute("workers", mPopulation.size(Population::ROLE_WORKER));
-	population->attribute("scientists", mPopulation.size(Population::ROLE_SCIENTIST));
-	population->attribute("retired", mPopulation.size(Population::ROLE_RETIRED));
-	root->linkEndChild(population);
-
-	// Write out the XML file.
-	XmlMemoryBuffer buff;
-	doc.accept(&buff);
-
-	Utility<Filesystem>::get().write(File(buff.buffer(), _path));
+	startCommandLog(_path);
+}
+
+
+/**
+ * Writes an autosave every constants::AUTOSAVE_INTERVAL turns. Autosaves
+ * are written in the background and rotate through a fixed number of
+ * slots so the oldest one is always the one replaced. A slot is only
+ * replaced once the new autosave has been written completely, so a
+ * failed autosave never costs the one it would have replaced.
+ *
+ * Errors from a previous autosave are reported here as they can't be
+ * shown from the worker thread.
+ */
+void MapViewState::autosave()
+{
+	std::string error = mSaveGameWriter.error();
+	if (!error.empty())
+	{
+		doNonFatalErrorMessage("Autosave Failed", error);
+	}
+
+	if (mTurnCount % constants::AUTOSAVE_INTERVAL != 0) { return; }
+
+	int slot = (mTurnCount / constants::AUTOSAVE_INTERVAL) % constants::AUTOSAVE_SLOT_COUNT;
+	mSaveGameWriter.write(snapshot(), constants::SAVE_GAME_PATH + constants::SAVE_GAME_AUTOSAVE + std::to_string(slot) + ".xml", saveGameCompression());
 }
 
 
@@ -85,6 +260,9 @@ void MapViewState::save(const std::string& _path)
  */
 void MapViewState::load(const std::string& _path)
 {
+	// Don't read a file that may still be being written.
+	mSaveGameWriter.wait();
+
 	resetUi();
 
 	Renderer& r = Utility<Renderer>::get();
@@ -101,12 +279,13 @@ void MapViewState::load(const std::string& _path)
 		throw std::runtime_error("File '" + _path + "' was not found.");
 	}
 
-	File xmlFile = Utility<Filesystem>::get().open(_path);
+	// Compressed savegames are decompressed as they're read.
+	std::string xml = readCompressedFile(_path);
 
 	XmlDocument doc;
 
 	// Load the XML document and handle any errors if occuring
-	doc.parse(xmlFile.raw_bytes());
+	doc.parse(xml.c_str());
 	if (doc.error())
 	{
 		throw std::runtime_error("Malformed savegame ('" + _path + "'). Error on Row " + std::to_string(doc.errorRow()) + ", Column " + std::to_string(doc.errorCol()) + ": " + doc.errorDesc());
@@ -129,23 +308,23 @@ void MapViewState::load(const std::string& _path)
 	Utility<StructureManager>::get().dropAllStructures();
 	ccLocation()(0, 0);	// Reset CC location
 
+	mPathFinder.reset();
 	delete mTileMap;
 	mTileMap = nullptr;
 
-	XmlElement* map = root->firstChildElement("properties");
-	int depth = 0;
-	std::string sitemap;
-	XmlAttribute* attribute = map->firstAttribute();
-	while (attribute)
-	{
-		if (attribute->name() == "diggingdepth") { attribute->queryIntValue(depth); }
-		else if (attribute->name() == "sitemap") { sitemap = attribute->value(); }
-		attribute = attribute->next();
-	}
+	PropertiesRecord properties;
+	PROPERTIES_SCHEMA.read(root->firstChildElement("properties"), properties);
+
+	Utility<RandomService>::get().deserialize(root->firstChildElement("random"));
+
+	// Decode the site on the worker thread while the plaque shows how far along it is.
+	AssetPreloader& preloader = Utility<AssetPreloader>::get();
+	preloader.requestSite(properties.sitemap, properties.tset);
+	preloader.finish(*IMG_LOADING);
 
-	mMapDisplay = Image(sitemap + MAP_DISPLAY_EXTENSION);
-	mHeightMap = Image(sitemap + MAP_TERRAIN_EXTENSION);
-	mTileMap = new TileMap(sitemap, map->attribute("tset"), depth, 0, false);
+	mMapDisplay = Utility<ImageManager>::get().image(properties.sitemap + MAP_DISPLAY_EXTENSION);
+	mHeightMap = Utility<ImageManager>::get().image(properties.sitemap + MAP_TERRAIN_EXTENSION);
+	mTileMap = new TileMap(properties.sitemap, properties.tset, properties.depth, 0, false);
 	mTileMap->deserialize(root);
 
 	/**
@@ -155,6 +334,7 @@ void MapViewState::load(const std::string& _path)
 	 */
 	readRobots(root->firstChildElement("robots"));	
 	readStructures(root->firstChildElement("structures"));
+	mRobotJobs.deserialize(root->firstChildElement("robot_jobs"));
 
 	readResources(root->firstChildElement("resources"), mPlayerResources);
 	readResources(root->firstChildElement("prev_resources"), mResourceBreakdownPanel.previousResources());
@@ -211,6 +391,16 @@ void MapViewState::load(const std::string& _path)
 	CURRENT_LEVEL_STRING = LEVEL_STRING_TABLE[mTileMap->currentDepth()];
 	mResourceBreakdownPanel.resourceCheck();
 
+	mForecast.clear();
+	requestForecast();
+
+	mRefinedIncome.clear();
+	Utility<ProductionPlanner>::get().clear();
+	Utility<ProductionPlanner>::get().deserialize(root->firstChildElement("production_targets"));
+	updateProductionPlan();
+
+	startCommandLog(_path);
+
 	mMapChangedCallback();
 }
 
@@ -224,30 +414,16 @@ void MapViewState::readRobots(XmlElement* _ti)
 	mRobotList.clear();
 	mRobots.dropAllItems();
 
-	/**
-	 * \fixme	This is fragile and prone to break if the savegame file is malformed.
-	 */
-	_ti->firstAttribute()->queryIntValue(ROBOT_ID_COUNTER);
+	CounterRecord counter;
+	ROBOTS_SCHEMA.read(_ti, counter);
+	ROBOT_ID_COUNTER = counter.count;
 
-	int id = 0, type = 0, age = 0, production_time = 0, x = 0, y = 0, depth = 0, direction = 0;
-	XmlAttribute* attribute = nullptr;
 	for (XmlNode* robot = _ti->firstChild(); robot; robot = robot->nextSibling())
 	{
-		id = type = age = production_time = x = y = depth = direction = 0;
-		attribute = robot->toElement()->firstAttribute();
-		while (attribute)
-		{
-			if (attribute->name() == "id")				{ attribute->queryIntValue(id); }
-			else if (attribute->name() == "type")		{ attribute->queryIntValue(type); }
-			else if (attribute->name() == "age")		{ attribute->queryIntValue(age); }
-			else if (attribute->name() == "production")	{ attribute->queryIntValue(production_time); }
-			else if (attribute->name() == "x")			{ attribute->queryIntValue(x); }
-			else if (attribute->name() == "y")			{ attribute->queryIntValue(y); }
-			else if (attribute->name() == "depth")		{ attribute->queryIntValue(depth); }
-			else if (attribute->name() == "direction")	{ attribute->queryIntValue(direction); }
-
-			attribute = attribute->next();
-		}
+		RobotRecord record;
+		ROBOT_SCHEMA.read(robot->toElement(), record);
+		int id = record.id, type = record.type, age = record.age, production_time = record.production_time;
+		int x = record.x, y = record.y, depth = record.depth, direction = record.direction;
 
 		Robot* r = nullptr;
 		switch (static_cast<RobotType>(type))
@@ -299,35 +475,20 @@ void MapViewState::readRobots(XmlElement* _ti)
 
 void MapViewState::readStructures(XmlElement* _ti)
 {
-	std::string type;
-	int x = 0, y = 0, depth = 0, age = 0, state = 0, direction = 0, forced_idle = 0, disabled_reason = 0, idle_reason = 0, pop0 = 0, pop1 = 0;
-	int production_completed = 0, production_type = 0;
-	XmlAttribute* attribute = nullptr;
+	// Robot Command Centers refer to the robots they command by ID.
+	std::unordered_map<int, Robot*> robotsById;
+	for (auto robot : mRobotPool.robots()) { robotsById[robot->id()] = robot; }
+
 	for (XmlNode* structure = _ti->firstChild(); structure != nullptr; structure = structure->nextSibling())
 	{
-		x = y = depth = age = state = direction = production_completed = production_type = disabled_reason = idle_reason = pop0 = pop1 = 0;
-		attribute = structure->toElement()->firstAttribute();
-		while (attribute)
-		{
-			if (attribute->name() == "x") { attribute->queryIntValue(x); }
-			else if (attribute->name() == "y") { attribute->queryIntValue(y); }
-			else if (attribute->name() == "depth") { attribute->queryIntValue(depth); }
-			else if (attribute->name() == "age") { attribute->queryIntValue(age); }
-			else if (attribute->name() == "state") { attribute->queryIntValue(state); }
-			else if (attribute->name() == "direction") { attribute->queryIntValue(direction); }
-			else if (attribute->name() == "type") { type = attribute->value(); }
-			else if (attribute->name() == "forced_idle") { attribute->queryIntValue(forced_idle); }
-			else if (attribute->name() == "disabled_reason") { attribute->queryIntValue(disabled_reason); }
-			else if (attribute->name() == "idle_reason") { attribute->queryIntValue(idle_reason); }
-
-			else if (attribute->name() == "production_completed") { attribute->queryIntValue(production_completed); }
-			else if (attribute->name() == "production_type") { attribute->queryIntValue(production_type); }
-
-			else if (attribute->name() == "pop0") { attribute->queryIntValue(pop0); }
-			else if (attribute->name() == "pop1") { attribute->queryIntValue(pop1); }
-
-			attribute = attribute->next();
-		}
+		StructureRecord record;
+		STRUCTURE_SCHEMA.read(structure->toElement(), record);
+
+		const std::string& type = record.type;
+		int x = record.x, y = record.y, depth = record.depth, age = record.age, state = record.state, direction = record.direction;
+		int forced_idle = record.forced_idle, disabled_reason = record.disabled_reason, idle_reason = record.idle_reason;
+		int production_completed = record.production_completed, production_type = record.production_type;
+		int pop0 = record.pop0, pop1 = record.pop1;
 
 		Tile* t = mTileMap->getTile(x, y, depth);
 		t->index(0);
@@ -394,8 +555,8 @@ void MapViewState::readStructures(XmlElement* _ti)
 			Factory* f = static_cast<Factory*>(st);
 			f->productType(static_cast<ProductType>(production_type));
 			f->productionTurnsCompleted(production_completed);
+			f->deserializeQueue(structure->firstChildElement("production_queue"));
 			f->resourcePool(&mPlayerResources);
-			f->productionComplete().connect(this, &MapViewState::factoryProductionComplete);
 		}
 
 		/**
@@ -412,19 +573,10 @@ void MapViewState::readStructures(XmlElement* _ti)
 			{
 				StringList rl_str = split_string(robots->value().c_str(), ',');
 
-				const RobotList& rl = mRobotPool.robots();
-
 				for (size_t i = 0; i < rl_str.size(); ++i)
 				{
-					int _rid = std::stoi(rl_str[i]);
-					for (size_t ri = 0; ri < rl.size(); ++ri)
-					{
-						if (rl[ri]->id() == _rid)
-						{
-							rcc->addRobot(rl[ri]);
-							break;
-						}
-					}
+					auto it = robotsById.find(std::stoi(rl_str[i]));
+					if (it != robotsById.end()) { rcc->addRobot(it->second); }
 				}
 			}
 		}
@@ -444,7 +596,9 @@ void MapViewState::readTurns(XmlElement* _ti)
 {
 	if (_ti)
 	{
-		_ti->firstAttribute()->queryIntValue(mTurnCount);
+		CounterRecord turns;
+		TURNS_SCHEMA.read(_ti, turns);
+		mTurnCount = turns.count;
 
 		if (mTurnCount > 0)
 		{
@@ -464,29 +618,26 @@ void MapViewState::readPopulation(XmlElement* _ti)
 	{
 		mPopulation.clear();
 
-		int children = 0, students = 0, workers = 0, scientists = 0, retired = 0;
+		PopulationRecord population;
+		population.morale = mCurrentMorale;
+		population.prev_morale = mPreviousMorale;
+		population.colonist_landers = mLandersColonist;
+		population.cargo_landers = mLandersCargo;
+
+		POPULATION_SCHEMA.read(_ti, population);
 
-		XmlAttribute* attribute = _ti->firstAttribute();
-		while (attribute)
+		mCurrentMorale = population.morale;
+		mPreviousMorale = population.prev_morale;
+		mLandersColonist = population.colonist_landers;
+		mLandersCargo = population.cargo_landers;
+
+		if (!mPopulation.deserialize(_ti))
 		{
-			if (attribute->name() == "morale") { attribute->queryIntValue(mCurrentMorale); }
-			else if (attribute->name() == "prev_morale") { attribute->queryIntValue(mPreviousMorale); }
-			else if (attribute->name() == "colonist_landers") { attribute->queryIntValue(mLandersColonist); }
-			else if (attribute->name() == "cargo_landers") { attribute->queryIntValue(mLandersCargo); }
-
-			else if (attribute->name() == "children") { attribute->queryIntValue(children); }
-			else if (attribute->name() == "students") { attribute->queryIntValue(students); }
-			else if (attribute->name() == "workers") { attribute->queryIntValue(workers); }
-			else if (attribute->name() == "scientists") { attribute->queryIntValue(scientists); }
-			else if (attribute->name() == "retired") { attribute->queryIntValue(retired); }
-
-			attribute = attribute->next();
+			mPopulation.addPopulation(Population::ROLE_CHILD, population.children);
+			mPopulation.addPopulation(Population::ROLE_STUDENT, population.students);
+			mPopulation.addPopulation(Population::ROLE_WORKER, population.workers);
+			mPopulation.addPopulation(Population::ROLE_SCIENTIST, population.scientists);
+			mPopulation.addPopulation(Population::ROLE_RETIRED, population.retired);
 		}
-
-		mPopulation.addPopulation(Population::ROLE_CHILD, children);
-		mPopulation.addPopulation(Population::ROLE_STUDENT, students);
-		mPopulation.addPopulation(Population::ROLE_WORKER, workers);
-		mPopulation.addPopulation(Population::ROLE_SCIENTIST, scientists);
-		mPopulation.addPopulation(Population::ROLE_RETIRED, retired);
 	}
 }
@@ -0,0 +1,253 @@
+// This is an open source non-commercial project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+
+// ==================================================================================
+// = This file implements recording player actions to the command log and
+// = replaying them.
+// ==================================================================================
+#include "MapViewState.h"
+
+#include "../Random.h"
+#include "../StateHash.h"
+
+#include "../Things/Structures/Structures.h"
+
+#include <algorithm>
+#include <iostream>
+
+
+/**
+ * Replays a command log once the state has been initialized.
+ *
+ * The state must have been constructed from the game the log starts
+ * from, with recording suspended so the log isn't overwritten.
+ *
+ * \param	commands	Commands to replay.
+ * \param	hideUi		Don't draw the map or the UI while replaying.
+ */
+void MapViewState::replay(const std::vector<Command>& commands, bool hideUi)
+{
+	mReplayCommands = commands;
+	mReplayPosition = 0;
+	mReplaying = true;
+	mReplayHideUi = hideUi;
+
+	mReplayTurns = 0;
+	mReplayTurnTime = std::chrono::steady_clock::duration::zero();
+	mReplaySlowestTurn = std::chrono::steady_clock::duration::zero();
+}
+
+
+/**
+ * Starts a new command log next to a savegame.
+ */
+void MapViewState::startCommandLog(const std::string& savegame)
+{
+	CommandLogHeader header;
+	header.seed = Utility<RandomService>::get().seed();
+	header.savegame = savegame;
+
+	Utility<CommandLog>::get().start(CommandLog::logFilename(savegame), header);
+}
+
+
+/**
+ * Gets a hash of the game state.
+ *
+ * Walks the same state serializeState() writes to a savegame, without
+ * recording a snapshot, so it's cheap enough to be done every turn.
+ * The view isn't covered as scrolling and changing levels aren't
+ * recorded.
+ */
+uint64_t MapViewState::stateHash()
+{
+	StateHash state;
+
+	Utility<RandomService>::get().hash(state);
+
+	mTileMap->hash(state);
+	Utility<StructureManager>::get().hash(state);
+	hashRobots(state, mRobotPool, mRobotList);
+	mRobotJobs.hash(state);
+	mPlayerResources.hash(state);
+	mResourceBreakdownPanel.previousResources().hash(state);
+
+	state.add(mTurnCount);
+
+	state.add(mCurrentMorale);
+	state.add(mPreviousMorale);
+	state.add(mLandersColonist);
+	state.add(mLandersCargo);
+	mPopulation.hash(state);
+
+	return state.value();
+}
+
+
+/**
+ * Replays the commands of the next turn.
+ *
+ * One turn is replayed per frame. The state hash recorded at the end of
+ * each turn is checked and the replay stops at the first turn that
+ * doesn't match.
+ */
+void MapViewState::updateReplay()
+{
+	if (mReplayHideUi && mReplayPosition == 0) { hideUi(); }
+
+	while (mReplayPosition < mReplayCommands.size())
+	{
+		const Command& command = mReplayCommands[mReplayPosition++];
+
+		if (command.type != COMMAND_END_TURN)
+		{
+			executeCommand(command);
+			if (!mReplaying) { return; }
+			continue;
+		}
+
+		auto start = std::chrono::steady_clock::now();
+		nextTurn();
+		auto elapsed = std::chrono::steady_clock::now() - start;
+
+		++mReplayTurns;
+		mReplayTurnTime += elapsed;
+		mReplaySlowestTurn = std::max(mReplaySlowestTurn, elapsed);
+
+		if (stateHash() != command.value)
+		{
+			finishReplay("Replay diverged from the recorded game on turn " + std::to_string(mTurnCount) + ".");
+		}
+
+		return;
+	}
+
+	finishReplay("Replay finished.");
+}
+
+
+/**
+ * Executes a recorded command.
+ */
+void MapViewState::executeCommand(const Command& command)
+{
+	Tile* tile = mTileMap->getTile(command.x, command.y, command.depth);
+	if (!tile)
+	{
+		finishReplay("Replay refers to tile (" + std::to_string(command.x) + ", " + std::to_string(command.y) + ", " + std::to_string(command.depth) + ") which is outside of the map.");
+		return;
+	}
+
+	// Placement rules are checked against the current level.
+	changeDepth(command.depth);
+
+	switch (command.type)
+	{
+	case COMMAND_PLACE_STRUCTURE:
+		placeStructure(tile, static_cast<StructureID>(command.value));
+		return;
+
+	case COMMAND_PLACE_TUBE:
+		placeTubes(tile, static_cast<ConnectorDir>(command.value));
+		return;
+
+	case COMMAND_PLACE_ROBOT:
+		placeRobot(tile, static_cast<RobotType>(command.value));
+		return;
+
+	case COMMAND_PLACE_DIGGER:
+		// Done by placeRobot() before the direction is picked.
+		if (tile->hasMine()) { mTileMap->removeMineLocation(Point_2d(tile->x(), tile->y())); }
+		diggerSelectionDialog(static_cast<DiggerDirection::DiggerSelection>(command.value), tile);
+		return;
+
+	case COMMAND_QUEUE_ROBOT_JOB:
+		queueRobotJob(tile, static_cast<RobotType>(command.value & 0xff), static_cast<RobotJob::Priority>(command.value >> 8));
+		return;
+
+	case COMMAND_QUEUE_ROBOT_AREA:
+	{
+		Tile* corner = mTileMap->getTile(static_cast<int>(command.value & 0xffff), static_cast<int>((command.value >> 16) & 0xffff), command.depth);
+		if (corner) { queueRobotArea(tile, corner, static_cast<RobotJob::Priority>(command.value >> 32)); }
+		return;
+	}
+
+	case COMMAND_QUEUE_ROBOT_FILL:
+		queueRobotFill(tile, static_cast<RobotJob::Priority>(command.value));
+		return;
+
+	default:
+		break;
+	}
+
+	if (!tile->thingIsStructure())
+	{
+		finishReplay("Replay refers to a structure at (" + std::to_string(command.x) + ", " + std::to_string(command.y) + ", " + std::to_string(command.depth) + ") which doesn't exist.");
+		return;
+	}
+
+	Structure* structure = tile->structure();
+
+	if (command.type == COMMAND_FORCE_IDLE)
+	{
+		structure->forceIdle(command.value != 0);
+	}
+	else if (command.type == COMMAND_PRODUCT_TYPE && structure->isFactory())
+	{
+		static_cast<Factory*>(structure)->productType(static_cast<ProductType>(command.value));
+	}
+	else if (command.type == COMMAND_QUEUE_PRODUCT && structure->isFactory())
+	{
+		Factory* factory = static_cast<Factory*>(structure);
+		ProductType product = static_cast<ProductType>(command.value & 0xff);
+		int amount = static_cast<int>(command.value >> 16);
+
+		if ((command.value >> 8) & 1) { factory->queueStock(product, amount); }
+		else { factory->queueProduct(product, amount); }
+	}
+	else if (command.type == COMMAND_CLEAR_PRODUCTION_QUEUE && structure->isFactory())
+	{
+		static_cast<Factory*>(structure)->clearQueue();
+	}
+	else if (command.type == COMMAND_EXTEND_MINE && structure->isMineFacility())
+	{
+		static_cast<MineFacility*>(structure)->extend();
+	}
+	else if (command.type == COMMAND_MINE_ORE && structure->isMineFacility())
+	{
+		Mine* mine = static_cast<MineFacility*>(structure)->mine();
+		bool enabled = (command.value & 1) != 0;
+
+		switch (command.value >> 1)
+		{
+		case Mine::ORE_COMMON_METALS: mine->miningCommonMetals(enabled); break;
+		case Mine::ORE_COMMON_MINERALS: mine->miningCommonMinerals(enabled); break;
+		case Mine::ORE_RARE_METALS: mine->miningRareMetals(enabled); break;
+		case Mine::ORE_RARE_MINERALS: mine->miningRareMinerals(enabled); break;
+		default: break;
+		}
+	}
+}
+
+
+/**
+ * Stops replaying and reports the result along with the time spent
+ * processing turns.
+ */
+void MapViewState::finishReplay(const std::string& message)
+{
+	mReplaying = false;
+	mReplayCommands.clear();
+
+	if (mReplayHideUi) { unhideUi(); }
+
+	std::cout << message << std::endl;
+
+	if (mReplayTurns == 0) { return; }
+
+	using Milliseconds = std::chrono::duration<double, std::milli>;
+	double total = std::chrono::duration_cast<Milliseconds>(mReplayTurnTime).count();
+	double slowest = std::chrono::duration_cast<Milliseconds>(mReplaySlowestTurn).count();
+
+	std::cout << "Replayed " << mReplayTurns << " turns in " << total << "ms (" << total / mReplayTurns << "ms per turn, slowest " << slowest << "ms)." << std::endl;
+}
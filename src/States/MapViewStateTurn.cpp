@@ -8,10 +8,31 @@
 #include "MapViewState.h"
 #include "MapViewStateHelper.h"
 
+#include "../ProductionPlanner.h"
+
 #include "../Things/Structures/Structures.h"
 
 
 extern NAS2D::Image* IMG_PROCESSING_TURN;	/// \fixme Find a sane place for this.
+extern NAS2D::Font* MAIN_FONT;
+
+
+/**
+ * Gets the refined resources in a pool in the order production costs use.
+ */
+static ProductionPlanner::Resources refinedResources(const ResourcePool& _rp)
+{
+	return {{ _rp.commonMetals(), _rp.commonMinerals(), _rp.rareMetals(), _rp.rareMinerals() }};
+}
+
+
+/**
+ * Gets the number of idle robots of every type.
+ */
+static int idleRobotCount(RobotPool& _rp)
+{
+	return _rp.getAvailableCount(ROBOT_DIGGER) + _rp.getAvailableCount(ROBOT_DOZER) + _rp.getAvailableCount(ROBOT_MINER);
+}
 
 
 /**
@@ -199,6 +220,7 @@ void MapViewState::updateResources()
 	}
 
 	// Move refined resources from smelters to storage tanks
+	mRefinedIncome.clear();
 	for (auto smelter : Utility<StructureManager>::get().structureList(Structure::CLASS_SMELTER))
 	{
 		if (!smelter->operational()) { continue; } // consider a different control path.
@@ -209,7 +231,10 @@ void MapViewState::updateResources()
 		truck.rareMetals(_rp.pullResource(ResourcePool::RESOURCE_RARE_METALS, 25));
 		truck.rareMinerals(_rp.pullResource(ResourcePool::RESOURCE_RARE_MINERALS, 25));
 
+		ResourcePool delivered = truck;
 		mPlayerResources.pushResources(truck);
+		delivered -= truck;
+		mRefinedIncome += delivered;
 
 		if (!truck.empty())
 		{
@@ -220,6 +245,67 @@ void MapViewState::updateResources()
 }
 
 
+/**
+ * Lets factories that work through a production queue pick what to build
+ * this turn.
+ *
+ * Stock orders are checked against the products in warehouses, the robots
+ * in the robot pool and the products factories are building or holding so
+ * that factories sharing an order don't overshoot it.
+ */
+void MapViewState::updateFactoryQueues()
+{
+	StructureList& factories = Utility<StructureManager>::get().structureList(Structure::CLASS_FACTORY);
+
+	ProductPool::ProductTypeCount stock = productStock();
+
+	for (auto structure : factories)
+	{
+		Factory* factory = static_cast<Factory*>(structure);
+		if (factory->productWaiting() != PRODUCT_NONE) { ++stock[factory->productWaiting()]; }
+		if (factory->productType() != PRODUCT_NONE) { ++stock[factory->productType()]; }
+	}
+
+	for (auto structure : factories)
+	{
+		static_cast<Factory*>(structure)->resolveQueue(stock);
+	}
+}
+
+
+/**
+ * Gets the number of each product in warehouses along with the robots in
+ * the robot pool.
+ */
+ProductPool::ProductTypeCount MapViewState::productStock()
+{
+	ProductPool::ProductTypeCount stock = {{ 0 }};
+
+	for (auto warehouse : Utility<StructureManager>::get().structureList(Structure::CLASS_WAREHOUSE))
+	{
+		ProductPool& products = static_cast<Warehouse*>(warehouse)->products();
+		for (ProductType product : PRODUCT_TYPES) { stock[product] += products.count(product); }
+	}
+
+	stock[PRODUCT_DIGGER] += static_cast<int>(mRobotPool.diggers().size());
+	stock[PRODUCT_DOZER] += static_cast<int>(mRobotPool.dozers().size());
+	stock[PRODUCT_MINER] += static_cast<int>(mRobotPool.miners().size());
+
+	return stock;
+}
+
+
+/**
+ * Brings the production plan up to date with the colony.
+ */
+void MapViewState::updateProductionPlan()
+{
+	ProductionPlanner& planner = Utility<ProductionPlanner>::get();
+	planner.colony(productStock(), refinedResources(mPlayerResources), refinedResources(mRefinedIncome));
+	planner.update();
+}
+
+
 /**
  * Check for colony ship deorbiting; if any colonists are remaining, kill
  * them and reduce morale by an appropriate amount.
@@ -271,22 +357,72 @@ void MapViewState::updateResidentialCapacity()
 
 
 /**
- * 
+ * Starts processing a turn on the worker thread.
+ *
+ * Turns that are done within constants::TURN_WORKER_WAIT milliseconds are
+ * finished right away. For longer turns the UI is put away and the map
+ * view is drawn as it was before the turn until the turn is done.
  */
 void MapViewState::nextTurn()
 {
-	Renderer& r = Utility<Renderer>::get();
-	r.drawImage(*IMG_PROCESSING_TURN, r.center_x() - (IMG_PROCESSING_TURN->width() / 2), r.center_y() - (IMG_PROCESSING_TURN->height() / 2));
-	r.update();
+	// Replays are timed so they're processed in place.
+	if (mReplaying)
+	{
+		processTurn();
+		refreshTurnUi();
+		return;
+	}
+
+	beginTurn();
+	updateHud();
+	mTileMap->snapshot(mMapSnapshot);
+
+	mTurnWorker.start([this]() { simulateTurn(); });
+
+	if (mTurnWorker.wait(constants::TURN_WORKER_WAIT)) { completeTurn(); }
+	else { suspendUi(); }
+}
+
+
+/**
+ * Processes a turn on the main thread without updating the UI that only
+ * shows its results.
+ */
+void MapViewState::processTurn()
+{
+	beginTurn();
+	simulateTurn();
+	finishTurn();
+}
+
 
+/**
+ * Gets the colony ready for a turn.
+ */
+void MapViewState::beginTurn()
+{
 	clearMode();
 
 	mPopulationPool.clear();
 
 	mResourceBreakdownPanel.previousResources() = mPlayerResources;
+}
+
 
+/**
+ * Updates the structures and the population.
+ *
+ * \note	May be run on the worker thread. Structures and robots that
+ *			load images can only be made or destroyed on the main thread
+ *			so the handlers that do that hand themselves over with
+ *			TurnWorker::runOnMainThread(). Nothing else in here may touch
+ *			the renderer or the UI.
+ */
+void MapViewState::simulateTurn()
+{
 	Utility<StructureManager>::get().disconnectAll();
 	checkConnectedness();
+	updateFactoryQueues();
 	Utility<StructureManager>::get().update(mPlayerResources, mPopulationPool);
 
 	mPreviousMorale = mCurrentMorale;
@@ -296,18 +432,22 @@ void MapViewState::nextTurn()
 	updatePopulation();
 	updateCommercial();
 	updateMorale();
-	updateRobots();
+}
 
-	updateResources();
 
-	mResourceBreakdownPanel.resourceCheck();
+/**
+ * Delivers finished products, moves the robots and ends the turn.
+ */
+void MapViewState::finishTurn()
+{
+	deliverFactoryProducts();
 
-	populateStructureMenu();
+	updateRobots();
+	dispatchRobotJobs();
 
-	checkColonyShip();
+	updateResources();
 
-	mMineOperationsWindow.updateCounts();
-	mStructureInspector.check();
+	checkColonyShip();
 
 	// Check for Game Over conditions
 	if (mPopulation.size() < 1 && mLandersColonist == 0)
@@ -317,4 +457,165 @@ void MapViewState::nextTurn()
 	}
 
 	mTurnCount++;
+
+	CommandLog& log = Utility<CommandLog>::get();
+	if (log.recording()) { log.record(COMMAND_END_TURN, 0, 0, 0, stateHash()); }
+
+	// Don't replace a good autosave with one of a colony that's been lost
+	// or with one of a replayed game.
+	if (!mGameOverDialog.visible() && !mReplaying) { autosave(); }
+}
+
+
+/**
+ * Finishes a turn that was processed on the worker thread.
+ */
+void MapViewState::completeTurn()
+{
+	// Put the UI back first so that the game over dialog and announcements
+	// made at the end of the turn aren't hidden again.
+	if (mUiSuspended) { resumeUi(); }
+
+	// Lets go of the sprites of things that the turn may remove.
+	mMapSnapshot.tiles.clear();
+
+	finishTurn();
+	refreshTurnUi();
+}
+
+
+/**
+ * Updates the UI that shows the results of a turn.
+ */
+void MapViewState::refreshTurnUi()
+{
+	mResourceBreakdownPanel.resourceCheck();
+
+	populateStructureMenu();
+
+	mMineOperationsWindow.updateCounts();
+	mStructureInspector.check();
+
+	requestForecast();
+	updateProductionPlan();
+}
+
+
+/**
+ * Requests a forecast of the population and food stores starting from
+ * the current state of the colony.
+ */
+void MapViewState::requestForecast()
+{
+	StructureManager& sm = Utility<StructureManager>::get();
+
+	Forecast::Inputs inputs;
+	inputs.population = mPopulation;
+	inputs.turn = mTurnCount;
+	inputs.food = foodInStorage();
+	inputs.foodCapacity = foodTotalStorage();
+	inputs.foodProduction = sm.getCountInState(Structure::CLASS_FOOD_PRODUCTION, Structure::OPERATIONAL) * AGRIDOME_BASE_PRODUCUCTION;
+	inputs.morale = mCurrentMorale;
+	inputs.residences = sm.getCountInState(Structure::CLASS_RESIDENCE, Structure::OPERATIONAL);
+	inputs.universities = sm.getCountInState(Structure::CLASS_UNIVERSITY, Structure::OPERATIONAL);
+	inputs.nurseries = sm.getCountInState(Structure::CLASS_NURSERY, Structure::OPERATIONAL);
+	inputs.hospitals = sm.getCountInState(Structure::CLASS_MEDICAL_CENTER, Structure::OPERATIONAL);
+
+	mForecast.request(inputs);
+}
+
+
+/**
+ * Processes several turns back to back.
+ *
+ * The UI is refreshed once after the last turn. Stops early when the
+ * player is alerted, when an announcement is made, when the game is over
+ * or when one of the stop events happens.
+ *
+ * \param	turns		Most turns to process.
+ * \param	stopEvents	FastForwardStop flags of the events to stop on.
+ */
+void MapViewState::fastForward(int turns, int stopEvents)
+{
+	StructureManager& sm = Utility<StructureManager>::get();
+
+	int alerts = alertMessageCount();
+	int food = foodInStorage();
+	int underConstruction = sm.underConstruction();
+	int idleRobots = idleRobotCount(mRobotPool);
+
+	NAS2D::Timer timer;
+
+	for (int turn = 0; turn < turns; ++turn)
+	{
+		// Redrawing every turn would take longer than the turns themselves.
+		if (turn == 0 || timer.accumulator() >= constants::FAST_FORWARD_REDRAW_INTERVAL)
+		{
+			drawFastForwardProgress(turn, turns);
+			timer.reset();
+		}
+
+		processTurn();
+
+		if (alertMessageCount() != alerts || mAnnouncement.visible() || mGameOverDialog.visible()) { break; }
+
+		int foodNow = foodInStorage();
+		if ((stopEvents & STOP_FOOD_SHORTAGE) && foodNow < food && foodNow < food - foodNow) { break; }
+		food = foodNow;
+
+		int underConstructionNow = sm.underConstruction();
+		if ((stopEvents & STOP_STRUCTURE_COMPLETE) && underConstructionNow < underConstruction) { break; }
+		underConstruction = underConstructionNow;
+
+		int idleRobotsNow = idleRobotCount(mRobotPool);
+		if ((stopEvents & STOP_ROBOT_IDLE) && idleRobotsNow > idleRobots) { break; }
+		idleRobots = idleRobotsNow;
+	}
+
+	refreshTurnUi();
+}
+
+
+/**
+ * Draws the processing turn plaque with a bar showing how many of the
+ * fast forwarded turns are done.
+ */
+void MapViewState::drawFastForwardProgress(int turn, int turns)
+{
+	Renderer& r = Utility<Renderer>::get();
+
+	float x = r.center_x() - (IMG_PROCESSING_TURN->width() / 2);
+	float y = r.center_y() - (IMG_PROCESSING_TURN->height() / 2);
+	float width = static_cast<float>(IMG_PROCESSING_TURN->width());
+
+	r.drawImage(*IMG_PROCESSING_TURN, x, y);
+
+	float barY = y + IMG_PROCESSING_TURN->height() + 4;
+	r.drawBoxFilled(x, barY, width, 8, 0, 0, 0, 200);
+	r.drawBoxFilled(x, barY, width * turn / turns, 8, 0, 185, 0);
+	r.drawBox(x, barY, width, 8, 255, 255, 255);
+
+	std::string text = string_format("%i / %i", turn, turns);
+	r.drawText(*MAIN_FONT, text, r.center_x() - MAIN_FONT->width(text) / 2, barY + 12, 255, 255, 255);
+
+	r.update();
+}
+
+
+/**
+ * Ends one or more turns depending on the modifier keys held down.
+ *
+ * Shift fast forwards a few turns, Control fast forwards until a
+ * structure completes and Control and Shift together fast forward until a
+ * robot is idle. Every fast forward stops if food runs short.
+ */
+void MapViewState::turnsRequested()
+{
+	EventHandler& e = Utility<EventHandler>::get();
+	bool shift = e.query_shift(), control = e.query_control();
+
+	if (mReplaying || (!shift && !control)) { nextTurn(); }
+	else if (!control) { fastForward(constants::FAST_FORWARD_TURNS, STOP_FOOD_SHORTAGE); }
+	else if (!shift) { fastForward(constants::FAST_FORWARD_MAX_TURNS, STOP_FOOD_SHORTAGE | STOP_STRUCTURE_COMPLETE); }
+	else { fastForward(constants::FAST_FORWARD_MAX_TURNS, STOP_FOOD_SHORTAGE | STOP_ROBOT_IDLE); }
 }
@@ -33,6 +33,8 @@ extern Rectangle_2d MOVE_WEST_ICON;
 extern Rectangle_2d MOVE_UP_ICON;
 extern Rectangle_2d MOVE_DOWN_ICON;
 
+extern Point_2d MOUSE_COORDS;
+
 
 extern NAS2D::Image* IMG_LOADING;	/// \fixme Find a sane place for this.
 extern NAS2D::Image* IMG_SAVING;	/// \fixme Find a sane place for this.
@@ -93,11 +95,13 @@ void MapViewState::initUi()
 
 	mPopulationPanel.position(675, constants::RESOURCE_ICON_SIZE + 4 + constants::MARGIN_TIGHT);
 	mPopulationPanel.population(&mPopulation);
+	mPopulationPanel.forecast(&mForecast);
 	mPopulationPanel.morale(&mCurrentMorale);
 	mPopulationPanel.old_morale(&mPreviousMorale);
 
 	mResourceBreakdownPanel.position(0, 22);
 	mResourceBreakdownPanel.playerResources(&mPlayerResources);
+	mResourceBreakdownPanel.forecast(&mForecast);
 
 	mGameOverDialog.returnToMainMenu().connect(this, &MapViewState::btnGameOverClicked);
 	mGameOverDialog.hide();
@@ -264,6 +268,33 @@ void MapViewState::unhideUi()
 }
 
 
+/**
+ * Puts the UI away while a turn is processed.
+ *
+ * The windows and menus show and change the colony so they can't be used
+ * until the turn is done. resumeUi() shows the windows that were open.
+ */
+void MapViewState::suspendUi()
+{
+	mSuspendedWindows = mWindowStack.visibleWindows();
+	hideUi();
+	mUiSuspended = true;
+}
+
+
+/**
+ * Brings back the UI put away by suspendUi().
+ */
+void MapViewState::resumeUi()
+{
+	unhideUi();
+	for (auto window : mSuspendedWindows) { window->show(); }
+
+	mSuspendedWindows.clear();
+	mUiSuspended = false;
+}
+
+
 /**
  * Hides all non-essential UI elements.
  */
@@ -385,6 +416,32 @@ void MapViewState::drawUI()
 }
 
 
+/**
+ * Draws the map view as it was before the turn that's being processed.
+ *
+ * Only what was copied before the turn started is drawn. The windows,
+ * menus and panels read the colony and stay away until the turn is done.
+ */
+void MapViewState::drawTurnInProgress()
+{
+	Renderer& r = Utility<Renderer>::get();
+
+	mTileMap->injectMouse(MOUSE_COORDS.x(), MOUSE_COORDS.y());
+	mTileMap->draw(mMapSnapshot);
+
+	r.drawBoxFilled(BOTTOM_UI_AREA, 39, 39, 39);
+	r.drawBox(BOTTOM_UI_AREA, 21, 21, 21);
+	r.drawLine(static_cast<float>(BOTTOM_UI_AREA.x() + 1), static_cast<float>(BOTTOM_UI_AREA.y()), static_cast<float>(BOTTOM_UI_AREA.x() + BOTTOM_UI_AREA.width() - 2), static_cast<float>(BOTTOM_UI_AREA.y()), 56, 56, 56);
+
+	drawMiniMap();
+	drawResourceInfo();
+	drawNavInfo();
+	drawRobotInfo();
+
+	r.drawImage(*IMG_PROCESSING_TURN, r.center_x() - (IMG_PROCESSING_TURN->width() / 2), r.center_y() - (IMG_PROCESSING_TURN->height() / 2));
+}
+
+
 /**
  * Handles clicks of the Connectedness Overlay button.
  */
@@ -455,6 +512,16 @@ void MapViewState::robotsSelectionChanged(const IconGrid::IconGridItem* _item)
  */
 void MapViewState::diggerSelectionDialog(DiggerDirection::DiggerSelection _sel, Tile* _t)
 {
+	// Worked out before an air shaft the digger goes down through is removed.
+	int travelTurns = robotTravelTurns(_t);
+	if (travelTurns == PathFinder::NO_PATH)
+	{
+		doAlertMessage(constants::ALERT_INVALID_ROBOT_PLACEMENT, constants::ALERT_ROBOT_UNREACHABLE);
+		return;
+	}
+
+	Utility<CommandLog>::get().record(COMMAND_PLACE_DIGGER, _t->x(), _t->y(), _t->depth(), _sel);
+
 	// Before doing anything, if we're going down and the depth is not the surface,
 	// the assumption is that we've already checked and determined that there's an air shaft
 	// so clear it from the tile, disconnect the tile and run a connectedness search.
@@ -469,7 +536,7 @@ void MapViewState::diggerSelectionDialog(DiggerDirection::DiggerSelection _sel,
 
 	// Assumes a digger is available.
 	Robodigger* r = mRobotPool.getDigger();
-	r->startTask(_t->index() + 5); // FIXME: Magic Number
+	r->startTask(_t->index() + 5 + travelTurns); // FIXME: Magic Number
 	mRobotPool.insertRobotIntoTable(mRobotList, r, _t);
 
 
@@ -586,7 +653,7 @@ void MapViewState::fileIoAction(const std::string& _file, FileIo::FileOperation
  */
 void MapViewState::btnTurnsClicked()
 {
-	nextTurn();
+	turnsRequested();
 }
 
 
@@ -599,6 +666,9 @@ void MapViewState::btnTurnsClicked()
  */
 void MapViewState::playerResourcePoolModified()
 {
+	// The menus are brought up to date once the turn being processed is done.
+	if (mTurnWorker.onWorkerThread()) { return; }
+
 	updateStructuresAvailability();
 }
 
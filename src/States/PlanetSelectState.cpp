@@ -7,11 +7,15 @@
 #include "MapViewState.h"
 #include "MainMenuState.h"
 
+#include "../AssetPreloader.h"
 #include "../Constants.h"
 #include "../FontManager.h"
+#include "../Random.h"
 
 using namespace NAS2D;
 
+extern NAS2D::Image* IMG_LOADING;	/// \fixme Find a sane place for this.
+
 Planet::PlanetType PLANET_TYPE_SELECTION = Planet::PLANET_TYPE_NONE;
 
 static Font* FONT = nullptr;
@@ -51,6 +55,34 @@ private:
 Explosion* EXPLODE = nullptr;
 
 
+/**
+ * Gets the site map and tileset of a planet type.
+ */
+static void planetSite(Planet::PlanetType type, std::string& map, std::string& tileset)
+{
+	switch (type)
+	{
+	case Planet::PLANET_TYPE_MERCURY:
+		map = "maps/merc_01";
+		tileset = "tsets/mercury.png";
+		break;
+
+	case Planet::PLANET_TYPE_MARS:
+		map = "maps/mars_04";
+		tileset = "tsets/mars.png";
+		break;
+
+	case Planet::PLANET_TYPE_GANYMEDE:
+		map = "maps/ganymede_01";
+		tileset = "tsets/ganymede.png";
+		break;
+
+	default:
+		break;
+	}
+}
+
+
 
 PlanetSelectState::PlanetSelectState():	mBg("sys/bg1.png"),
 										mStarFlare("sys/flare_1.png"),
@@ -141,6 +173,8 @@ State* PlanetSelectState::update()
 {
 	Renderer& r = Utility<Renderer>::get();
 
+	Utility<AssetPreloader>::get().upload(constants::PRELOAD_UPLOADS_PER_FRAME);
+
 	r.drawImageStretched(mBg, 0, 0, r.width(), r.height());
 
 	float _rotation = mTimer.tick() / 1200.0f;
@@ -176,25 +210,21 @@ State* PlanetSelectState::update()
 		std::string map, tileset;
 		int dig_depth = 0, max_mines = 0;
 
+		planetSite(PLANET_TYPE_SELECTION, map, tileset);
+
 		switch (PLANET_TYPE_SELECTION)
 		{
 		case Planet::PLANET_TYPE_MERCURY:
-			map = "maps/merc_01";
-			tileset = "tsets/mercury.png";
 			dig_depth = mPlanets[0]->digDepth();
 			max_mines = mPlanets[0]->maxMines();
 			break;
 
 		case Planet::PLANET_TYPE_MARS:
-			map = "maps/mars_04";
-			tileset = "tsets/mars.png";
 			dig_depth = mPlanets[1]->digDepth();
 			max_mines = mPlanets[1]->maxMines();
 			break;
 
 		case Planet::PLANET_TYPE_GANYMEDE:
-			map = "maps/ganymede_01";
-			tileset = "tsets/ganymede.png";
 			dig_depth = mPlanets[2]->digDepth();
 			max_mines = mPlanets[2]->maxMines();
 			break;
@@ -204,6 +234,11 @@ State* PlanetSelectState::update()
 			break;
 		}
 
+		// The site was requested when the planet was picked and is most likely decoded by now.
+		Utility<AssetPreloader>::get().finish(*IMG_LOADING);
+
+		Utility<RandomService>::get().reseed();
+
 		MapViewState* mapview = new MapViewState(map, tileset, dig_depth, max_mines);
 		mapview->setPopulationLevel(MapViewState::POPULATION_LARGE);
 		mapview->_initialize();
@@ -227,6 +262,12 @@ void PlanetSelectState::onMouseDown(EventHandler::MouseButton button, int x, int
 		{
 			Utility<Mixer>::get().playSound(mSelect);
 			PLANET_TYPE_SELECTION = mPlanets[i]->type();
+
+			// Decode the site while the screen fades out.
+			std::string map, tileset;
+			planetSite(PLANET_TYPE_SELECTION, map, tileset);
+			Utility<AssetPreloader>::get().requestSite(map, tileset);
+
 			Utility<Renderer>::get().fadeOut((float)constants::FADE_SPEED);
 			Utility<Mixer>::get().fadeOutMusic(constants::FADE_SPEED);
 			return;
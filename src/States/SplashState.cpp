@@ -5,6 +5,8 @@
 
 #include "MainMenuState.h"
 
+#include "../AssetPreloader.h"
+
 
 const int PAUSE_TIME = 5800;
 
@@ -53,6 +55,9 @@ void SplashState::initialize()
 	e.mouseButtonDown().connect(this, &SplashState::onMouseDown);
 
 	Utility<Renderer>::get().showSystemPointer(false);
+
+	// Images every game uses are decoded while the logos are shown.
+	Utility<AssetPreloader>::get().requestManifest();
 }
 
 
@@ -94,6 +99,8 @@ State* SplashState::update()
 {
 	Renderer& r = Utility<Renderer>::get();
 
+	Utility<AssetPreloader>::get().upload(constants::PRELOAD_UPLOADS_PER_FRAME);
+
 	if (r.isFaded() && !r.isFading() && mTimer.accumulator() > FADE_PAUSE_TIME)
 	{
 		if (mReturnState != this) { return mReturnState; }
@@ -6,6 +6,8 @@
 #include "Constants.h"
 #include "ProductPool.h"
 #include "StructureTranslator.h"
+#include "SaveGameSnapshot.h"
+#include "StateHash.h"
 
 #include "Things/Structures/Structures.h"
 
@@ -363,6 +365,21 @@ int StructureManager::destroyed()
 }
 
 
+/**
+ * Gets a count of the number of buildings under construction.
+ */
+int StructureManager::underConstruction()
+{
+	int count = 0;
+	for (auto it = mStructureLists.begin(); it != mStructureLists.end(); ++it)
+	{
+		count += getCountInState(it->first, Structure::UNDER_CONSTRUCTION);
+	}
+
+	return count;
+}
+
+
 /**
  *
  */
@@ -392,90 +409,156 @@ Tile* StructureManager::tileFromStructure(Structure* _st)
 /**
  * 
  */
-void serializeResourcePool(XmlElement* _ti, ResourcePool& _rp, const std::string& name)
+void serializeResourcePool(SaveGameSnapshot& _w, ResourcePool& _rp, const std::string& name)
 {
-	XmlElement* pool = new XmlElement(name);
-	_rp.serialize(pool);
-	_ti->linkEndChild(pool);
+	_w.openElement(name);
+	_rp.serialize(_w);
+	_w.closeElement();
 }
 
 
 /**
+ * Writes the attributes common to all structures.
+ */
+void serializeStructure(SaveGameSnapshot& _w, Structure* _s, Tile* _t)
+{
+	_w.attribute("x", _t->x());
+	_w.attribute("y", _t->y());
+	_w.attribute("depth", _t->depth());
+
+	_w.attribute("age", _s->age());
+	_w.attribute("state", _s->state());
+	_w.attribute("forced_idle", _s->forceIdle());
+	_w.attribute("disabled_reason", static_cast<int>(_s->disabledReason()));
+	_w.attribute("idle_reason", static_cast<int>(_s->idleReason()));
+	_w.attribute("type", _s->name());
+	_w.attribute("direction", _s->connectorDirection());
+
+	_w.attribute("pop0", _s->populationAvailable()[0]);
+	_w.attribute("pop1", _s->populationAvailable()[1]);
+}
+
+
+/**
+ * Records all structures.
  *
+ * Structures are written grouped by class in the order they were added
+ * so the same colony always produces the same document.
  */
-void serializeStructure(XmlElement* _ti, Structure* _s, Tile* _t)
+void StructureManager::serialize(SaveGameSnapshot& _w)
 {
-	_ti->attribute("x", _t->x());
-	_ti->attribute("y", _t->y());
-	_ti->attribute("depth", _t->depth());
-
-	_ti->attribute("age", _s->age());
-	_ti->attribute("state", _s->state());
-	_ti->attribute("forced_idle", _s->forceIdle());
-	_ti->attribute("disabled_reason", static_cast<int>(_s->disabledReason()));
-	_ti->attribute("idle_reason", static_cast<int>(_s->idleReason()));
-	_ti->attribute("type", _s->name());
-	_ti->attribute("direction", _s->connectorDirection());
-
-	if (!_s->production().empty())
-	{
-		serializeResourcePool(_ti, _s->production(), "production");
-	}
+	_w.openElement("structures");
 
-	if (!_s->storage().empty())
+	for (auto& structureClass : mStructureLists)
 	{
-		serializeResourcePool(_ti, _s->storage(), "storage");
+		for (Structure* structure : structureClass.second)
+		{
+			_w.openElement("structure");
+			serializeStructure(_w, structure, mStructureTileTable[structure]);
+
+			if (structure->isFactory())
+			{
+				_w.attribute("production_completed", static_cast<Factory*>(structure)->productionTurnsCompleted());
+				_w.attribute("production_type", static_cast<Factory*>(structure)->productType());
+			}
+
+			// Attributes have to be written before any child elements.
+			if (!structure->production().empty())
+			{
+				serializeResourcePool(_w, structure->production(), "production");
+			}
+
+			if (!structure->storage().empty())
+			{
+				serializeResourcePool(_w, structure->storage(), "storage");
+			}
+
+			if (structure->isFactory())
+			{
+				static_cast<Factory*>(structure)->serializeQueue(_w);
+			}
+
+			if (structure->isWarehouse())
+			{
+				_w.openElement("warehouse_products");
+				static_cast<Warehouse*>(structure)->products().serialize(_w);
+				_w.closeElement();
+			}
+
+			if (structure->isRobotCommand())
+			{
+				const RobotList& rl = static_cast<RobotCommand*>(structure)->robots();
+
+				std::stringstream str;
+				for (size_t i = 0; i < rl.size(); ++i)
+				{
+					str << rl[i]->id();
+					if (i != rl.size() - 1) { str << ","; }	// kind of a kludge
+				}
+
+				_w.openElement("robots");
+				_w.attribute("robots", str.str());
+				_w.closeElement();
+			}
+
+			_w.closeElement();
+		}
 	}
 
-	_ti->attribute("pop0", _s->populationAvailable()[0]);
-	_ti->attribute("pop1", _s->populationAvailable()[1]);
+	_w.closeElement();
 }
 
 
 /**
- * 
+ * Adds everything serialize() writes about the structures to a state hash.
  */
-void StructureManager::serialize(XmlElement* _ti)
+void StructureManager::hash(StateHash& _h)
 {
-	XmlElement* structures = new XmlElement("structures");
-
-	for (auto it = mStructureTileTable.begin(); it != mStructureTileTable.end(); ++it)
+	for (auto& structureClass : mStructureLists)
 	{
-		XmlElement* structure = new XmlElement("structure");
-		serializeStructure(structure, it->first, it->second);
+		_h.add(static_cast<uint64_t>(structureClass.second.size()));
 
-		if (it->first->isFactory())
+		for (Structure* structure : structureClass.second)
 		{
-			structure->attribute("production_completed", static_cast<Factory*>(it->first)->productionTurnsCompleted());
-			structure->attribute("production_type", static_cast<Factory*>(it->first)->productType());
-		}
-
-		if (it->first->isWarehouse())
-		{
-			XmlElement* warehouse_products = new XmlElement("warehouse_products");
-			static_cast<Warehouse*>(it->first)->products().serialize(warehouse_products);
-			structure->linkEndChild(warehouse_products);
-		}
-
-		if (it->first->isRobotCommand())
-		{
-			XmlElement* robots = new XmlElement("robots");
+			Tile* tile = mStructureTileTable[structure];
+			_h.add(tile->x());
+			_h.add(tile->y());
+			_h.add(tile->depth());
+
+			_h.add(structure->name());
+			_h.add(structure->age());
+			_h.add(structure->state());
+			_h.add(structure->forceIdle());
+			_h.add(static_cast<int>(structure->disabledReason()));
+			_h.add(static_cast<int>(structure->idleReason()));
+			_h.add(structure->connectorDirection());
+			_h.add(structure->populationAvailable()[0]);
+			_h.add(structure->populationAvailable()[1]);
+
+			structure->production().hash(_h);
+			structure->storage().hash(_h);
+
+			if (structure->isFactory())
+			{
+				Factory* factory = static_cast<Factory*>(structure);
+				_h.add(factory->productionTurnsCompleted());
+				_h.add(factory->productType());
+				_h.add(factory->queued());
+
+				for (const Factory::ProductionOrder& order : factory->productionQueue())
+				{
+					_h.add(order.product);
+					_h.add(order.count);
+					_h.add(order.stock);
+				}
+			}
 
-			const RobotList& rl = static_cast<RobotCommand*>(it->first)->robots();
+			if (structure->isWarehouse()) { static_cast<Warehouse*>(structure)->products().hash(_h); }
 
-			std::stringstream str;
-			for (size_t i = 0; i < rl.size(); ++i)
+			if (structure->isRobotCommand())
 			{
-				str << rl[i]->id();
-				if (i != rl.size() - 1) { str << ","; }	// kind of a kludge
+				for (Robot* robot : static_cast<RobotCommand*>(structure)->robots()) { _h.add(robot->id()); }
 			}
-
-			robots->attribute("robots", str.str());
-			structure->linkEndChild(robots);
 		}
-
-		structures->linkEndChild(structure);
 	}
-
-	_ti->linkEndChild(structures);
 }
@@ -5,6 +5,9 @@
 #include "ResourcePool.h"
 #include "Map/Tile.h"
 
+class SaveGameSnapshot;
+class StateHash;
+
 /**
  * Handles structure updating and resource management for structures.
  *
@@ -32,6 +35,7 @@ public:
 
 	int disabled();
 	int destroyed();
+	int underConstruction();
 
 	bool CHAPAvailable();
 
@@ -40,7 +44,8 @@ public:
 
 	void update(ResourcePool& _r, PopulationPool& _p);
 
-	void serialize(NAS2D::Xml::XmlElement* _ti);
+	void serialize(SaveGameSnapshot& _w);
+	void hash(StateHash& _h);
 
 protected:
 
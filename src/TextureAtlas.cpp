@@ -0,0 +1,190 @@
+// This is an open source non-commercial project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+
+#include "TextureAtlas.h"
+
+#include "Constants.h"
+#include "ImageManager.h"
+
+#include <algorithm>
+#include <numeric>
+
+using namespace NAS2D;
+
+
+/**
+ * C'tor
+ *
+ * \param	image	Atlas page or the image itself.
+ * \param	x		Left edge of the image in \c image.
+ * \param	y		Top edge of the image in \c image.
+ */
+ImageRegion::ImageRegion(std::shared_ptr<Image> image, float x, float y, float width, float height) :
+	mImage(image),
+	mX(x), mY(y),
+	mWidth(width), mHeight(height)
+{}
+
+
+/**
+ * Draws the whole image.
+ */
+void ImageRegion::draw(Renderer& r, float x, float y) const
+{
+	r.drawSubImage(*mImage, x, y, mX, mY, mWidth, mHeight);
+}
+
+
+/**
+ * Draws the whole image tinted with a color.
+ */
+void ImageRegion::draw(Renderer& r, float x, float y, uint8_t red, uint8_t green, uint8_t blue, uint8_t alpha) const
+{
+	r.drawSubImage(*mImage, x, y, mX, mY, mWidth, mHeight, red, green, blue, alpha);
+}
+
+
+/**
+ * Draws part of the image.
+ *
+ * \param	subX	Left edge of the part relative to the image.
+ * \param	subY	Top edge of the part relative to the image.
+ */
+void ImageRegion::drawSub(Renderer& r, float x, float y, float subX, float subY, float width, float height) const
+{
+	r.drawSubImage(*mImage, x, y, mX + subX, mY + subY, width, height);
+}
+
+
+/**
+ * Draws part of the image tinted with a color.
+ *
+ * \param	subX	Left edge of the part relative to the image.
+ * \param	subY	Top edge of the part relative to the image.
+ */
+void ImageRegion::drawSub(Renderer& r, float x, float y, float subX, float subY, float width, float height, uint8_t red, uint8_t green, uint8_t blue, uint8_t alpha) const
+{
+	r.drawSubImage(*mImage, x, y, mX + subX, mY + subY, width, height, red, green, blue, alpha);
+}
+
+
+/**
+ * Stages an image to be packed by the next build().
+ *
+ * \param	pixels	R, G, B, A bytes of every pixel, row by row.
+ */
+void TextureAtlas::stage(const std::string& name, std::vector<uint8_t>&& pixels, int width, int height)
+{
+	if (contains(name)) { return; }
+
+	StagedImage image;
+	image.name = name;
+	image.width = width;
+	image.height = height;
+	image.pixels = std::move(pixels);
+	mStaged.push_back(std::move(image));
+}
+
+
+/**
+ * Packs the staged images into new pages and uploads them.
+ *
+ * Images that don't fit on a page are dropped and are loaded on their own
+ * when they're asked for.
+ *
+ * \return	Number of pages built.
+ */
+size_t TextureAtlas::build()
+{
+	if (mStaged.empty()) { return 0; }
+
+	const int size = constants::ATLAS_PAGE_SIZE;
+	const int padding = constants::ATLAS_PADDING;
+
+	// Tallest first keeps the shelves from wasting much space.
+	std::vector<size_t> order(mStaged.size());
+	std::iota(order.begin(), order.end(), 0);
+	std::stable_sort(order.begin(), order.end(), [this](size_t a, size_t b) { return mStaged[a].height > mStaged[b].height; });
+
+	std::vector<std::vector<uint8_t>> pages;
+	std::vector<int> pageHeights;
+	int x = size, y = 0, shelfHeight = 0;
+
+	for (size_t index : order)
+	{
+		StagedImage& image = mStaged[index];
+		if (image.width > size || image.height > size) { continue; }
+
+		if (x + image.width > size)
+		{
+			x = 0;
+			y += shelfHeight;
+			shelfHeight = 0;
+		}
+
+		if (pages.empty() || y + image.height > size)
+		{
+			pages.emplace_back(static_cast<size_t>(size) * size * 4, 0);
+			pageHeights.push_back(0);
+			x = 0;
+			y = 0;
+			shelfHeight = 0;
+		}
+
+		std::vector<uint8_t>& page = pages.back();
+		for (int row = 0; row < image.height; ++row)
+		{
+			auto source = image.pixels.begin() + static_cast<size_t>(row) * image.width * 4;
+			std::copy(source, source + image.width * 4, page.begin() + (static_cast<size_t>(y + row) * size + x) * 4);
+		}
+
+		Region region;
+		region.page = mPages.size() + pages.size() - 1;
+		region.x = x;
+		region.y = y;
+		region.width = image.width;
+		region.height = image.height;
+		mRegions[image.name] = region;
+
+		x += image.width + padding;
+		shelfHeight = std::max(shelfHeight, image.height + padding);
+		pageHeights.back() = std::max(pageHeights.back(), y + image.height);
+	}
+
+	mStaged.clear();
+
+	// Rows below the last shelf are never drawn from so they aren't uploaded.
+	for (size_t i = 0; i < pages.size(); ++i)
+	{
+		pages[i].resize(static_cast<size_t>(size) * pageHeights[i] * 4);
+		mPages.push_back(ImageManager::fromPixels(std::move(pages[i]), size, pageHeights[i]));
+	}
+
+	return pages.size();
+}
+
+
+/**
+ * Determines if an image is packed or waiting to be packed.
+ */
+bool TextureAtlas::contains(const std::string& name) const
+{
+	if (mRegions.find(name) != mRegions.end()) { return true; }
+
+	return std::any_of(mStaged.begin(), mStaged.end(), [&name](const StagedImage& image) { return image.name == name; });
+}
+
+
+/**
+ * Gets the region of a packed image.
+ *
+ * \return	An empty region if the image isn't packed.
+ */
+ImageRegion TextureAtlas::region(const std::string& name) const
+{
+	auto it = mRegions.find(name);
+	if (it == mRegions.end()) { return ImageRegion(); }
+
+	const Region& region = it->second;
+	return ImageRegion(mPages[region.page], static_cast<float>(region.x), static_cast<float>(region.y), static_cast<float>(region.width), static_cast<float>(region.height));
+}
@@ -0,0 +1,105 @@
+#pragma once
+
+#include <NAS2D/NAS2D.h>
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+
+/**
+ * An image or the part of an atlas page an image was packed into.
+ *
+ * Draws are made relative to the image that was asked for so callers don't
+ * need to know whether it ended up in an atlas or not.
+ */
+class ImageRegion
+{
+public:
+	ImageRegion() = default;
+	ImageRegion(std::shared_ptr<NAS2D::Image> image, float x, float y, float width, float height);
+
+	void draw(NAS2D::Renderer& r, float x, float y) const;
+	void draw(NAS2D::Renderer& r, float x, float y, uint8_t red, uint8_t green, uint8_t blue, uint8_t alpha) const;
+
+	void drawSub(NAS2D::Renderer& r, float x, float y, float subX, float subY, float width, float height) const;
+	void drawSub(NAS2D::Renderer& r, float x, float y, float subX, float subY, float width, float height, uint8_t red, uint8_t green, uint8_t blue, uint8_t alpha) const;
+
+	float width() const { return mWidth; }
+	float height() const { return mHeight; }
+
+	void reset() { *this = ImageRegion(); }
+
+	explicit operator bool() const { return mImage != nullptr; }
+
+private:
+	std::shared_ptr<NAS2D::Image>	mImage;				/**< Atlas page or the image itself. */
+	float							mX = 0.0f;			/**< Left edge of the image in mImage. */
+	float							mY = 0.0f;			/**< Top edge of the image in mImage. */
+	float							mWidth = 0.0f;
+	float							mHeight = 0.0f;
+};
+
+
+/**
+ * Packs many small images into a few large pages so that drawing them
+ * doesn't switch textures between every draw.
+ *
+ * Images are staged as decoded pixels and packed into new pages by build().
+ * Pages are filled shelf by shelf, tallest images first, with a gap of
+ * constants::ATLAS_PADDING pixels around every image so filtering doesn't
+ * bleed neighbours into each other.
+ *
+ * \note	Pages are uploaded to the video card when they're built so the
+ *			atlas may only be built on the main thread.
+ */
+class TextureAtlas
+{
+public:
+	/**
+	 * Where an image was packed.
+	 */
+	struct Region
+	{
+		size_t	page = 0;
+		int		x = 0;
+		int		y = 0;
+		int		width = 0;
+		int		height = 0;
+	};
+
+public:
+	TextureAtlas() = default;
+	~TextureAtlas() = default;
+
+	void stage(const std::string& name, std::vector<uint8_t>&& pixels, int width, int height);
+	size_t build();
+
+	bool contains(const std::string& name) const;
+	ImageRegion region(const std::string& name) const;
+
+	size_t pages() const { return mPages.size(); }
+
+private:
+	TextureAtlas(const TextureAtlas&) = delete;
+	TextureAtlas& operator=(const TextureAtlas&) = delete;
+
+private:
+	/**
+	 * Pixels of an image waiting to be packed.
+	 */
+	struct StagedImage
+	{
+		std::string				name;
+		int						width = 0;
+		int						height = 0;
+		std::vector<uint8_t>	pixels;			/**< R, G, B, A bytes of every pixel, row by row. */
+	};
+
+private:
+	std::vector<StagedImage>						mStaged;		/**< Images waiting for the next build(). */
+	std::map<std::string, Region>					mRegions;		/**< Packed images by filename. */
+	std::vector<std::shared_ptr<NAS2D::Image>>		mPages;			/**< Built pages. */
+};
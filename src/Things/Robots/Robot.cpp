@@ -3,12 +3,16 @@
 
 #include "Robot.h"
 
+#include "../Structures/RobotCommand.h"
+
 Robot::Robot(const std::string& name, const std::string& sprite_path) :	Thing(name, sprite_path)
 {}
 
 
 Robot::~Robot()
-{}
+{
+	if (mCommander) { mCommander->removeRobot(this); }
+}
 
 
 void Robot::startTask(int turns)
@@ -2,6 +2,10 @@
 
 #include "../Thing.h"
 
+#include <cstddef>
+
+class RobotCommand;
+
 
 class Robot: public Thing
 {
@@ -9,6 +13,22 @@ public:
 	typedef NAS2D::Signals::Signal0<void> Callback;
 	typedef NAS2D::Signals::Signal1<Robot*> TaskCallback;
 
+	/**
+	 * Lists that keep track of where the robot is in them so it can be
+	 * removed without searching.
+	 */
+	enum ListSlot
+	{
+		SLOT_POOL,		/**< RobotPool's list of all robots. */
+		SLOT_TYPE,		/**< RobotPool's list of robots of the robot's type. */
+		SLOT_IDLE,		/**< RobotPool's free list of the robot's type. */
+		SLOT_COMMAND,	/**< Robot list of the commanding RobotCommand. */
+
+		SLOT_COUNT
+	};
+
+	static const size_t NO_SLOT = static_cast<size_t>(-1);
+
 public:
 	Robot(const std::string& name, const std::string& sprite_path);
 	virtual ~Robot();
@@ -30,6 +50,12 @@ public:
 	void id(int _id) { mId = _id; }
 	int id() const { return mId; }
 
+	RobotCommand* commander() const { return mCommander; }
+	void commander(RobotCommand* _rc) { mCommander = _rc; }
+
+	size_t slot(ListSlot list) const { return mSlots[list]; }
+	void slot(ListSlot list, size_t index) { mSlots[list] = index; }
+
 protected:
 	void incrementFuelCellAge() { mFuelCellAge++; }
 	void updateTask();
@@ -41,6 +67,9 @@ private:
 
 	bool			mSelfDestruct = false;
 
+	RobotCommand*	mCommander = nullptr;		/**< Robot Command Center the robot is under the command of. */
+	size_t			mSlots[SLOT_COUNT] = { NO_SLOT, NO_SLOT, NO_SLOT, NO_SLOT };	/**< Position of the robot in each ListSlot list. */
+
 	TaskCallback	mTaskCompleteCallback;
 	Callback		mSelfDestructCallback;
 };
@@ -5,17 +5,20 @@
 
 #include "Factory.h"
 
-typedef std::map<ProductType, ProductionCost> ProductionTypeTable;
+#include "../../AttributeSchema.h"
+#include "../../SaveGameSnapshot.h"
+
+using namespace NAS2D::Xml;
 
 
 /**
- * Table with production information for each product that factories can produce.
+ * Production information for each product that factories can produce.
  *
  * \note	This table defines parameters for -all- products that any factory can
  *			produce. It is up to the individual factory to determine what they are
  *			allowed to build.
  */
-ProductionTypeTable PRODUCTION_TYPE_TABLE = 
+constexpr ProductEntry<ProductionCost> PRODUCTION_COSTS[] =
 {
 	{ PRODUCT_DIGGER, ProductionCost(5, 10, 5, 5, 2) },
 	{ PRODUCT_DOZER, ProductionCost(5, 10, 5, 5, 2) },
@@ -30,11 +33,25 @@ ProductionTypeTable PRODUCTION_TYPE_TABLE =
 	{ PRODUCT_MEDICINE, ProductionCost(1, 0, 2, 0, 1) },
 };
 
+static_assert(coversEveryProduct(PRODUCTION_COSTS), "PRODUCTION_COSTS needs exactly one entry for every product in PRODUCT_TYPES.");
+
 
+/**
+ * Production costs indexed by ProductType.
+ */
+constexpr std::array<ProductionCost, PRODUCT_COUNT> PRODUCTION_TYPE_TABLE = makeProductTable(PRODUCTION_COSTS);
+
+
+/**
+ * Gets the production cost of a product.
+ *
+ * \note	PRODUCT_NONE costs nothing.
+ */
 const ProductionCost& productCost(ProductType _pt)
 {
-	// Sanity check
-	if (PRODUCTION_TYPE_TABLE.empty()) { throw std::runtime_error("Factory::productionCost() called before production table filled!"); }
+	static constexpr ProductionCost NO_COST;
+
+	if (_pt < 0 || _pt >= PRODUCT_COUNT) { return NO_COST; }
 
 	return PRODUCTION_TYPE_TABLE[_pt];
 }
@@ -49,7 +66,23 @@ Factory::~Factory()
 {}
 
 
+/**
+ * Sets the product to build over and over.
+ *
+ * \note	Replaces the production queue.
+ */
 void Factory::productType(ProductType _p)
+{
+	clearQueue();
+	mQueued = false;
+	product(_p);
+}
+
+
+/**
+ * Sets the product being built.
+ */
+void Factory::product(ProductType _p)
 {
 	if (_p == mProduct) { return; }
 
@@ -70,7 +103,7 @@ void Factory::productType(ProductType _p)
 
 	productionResetTurns();
 
-	mTurnsToComplete = PRODUCTION_TYPE_TABLE[mProduct].turnsToBuild();
+	mTurnsToComplete = productCost(mProduct).turnsToBuild();
 }
 
 
@@ -112,35 +145,27 @@ void Factory::updateProduction()
 		return;
 	}
 
-	if (mProduct == PRODUCT_NONE)
+	// Finished products are delivered at the end of the turn.
+	if (mProductWaiting != PRODUCT_NONE)
 	{
+		idle(IDLE_FACTORY_PRODUCTION_COMPLETE);
 		return;
 	}
 
-	if (mProductWaiting != PRODUCT_NONE)
+	if (mProduct == PRODUCT_NONE)
 	{
-		mProductionComplete(*this);
-		idle(IDLE_FACTORY_PRODUCTION_COMPLETE);
 		return;
 	}
 
-	if (!enoughResourcesAvailable())
+	#ifdef _DEBUG
+	if (mResourcesPool == nullptr) { throw std::runtime_error("Factory::updateProduction() called with a null Resource Pool set"); }
+	#endif
+
+	if (!mResourcesPool->spend(productCost(mProduct)))
 	{
 		idle(IDLE_FACTORY_INSUFFICIENT_RESOURCES);
 		return;
 	}
-	
-	/**
-	 * Using explicit calls here instead of ResourcePool::operator-=() because the production
-	 * table doesn't use ResourcePool objects.
-	 * 
-	 * \todo	Add an operator-=() to ResourcePool that takes type ProductionCost to improve
-	 *			readability of below code. Not thrilled with polluting the namespace but eh.
-	 */
-	mResourcesPool->commonMetals(mResourcesPool->commonMetals() - PRODUCTION_TYPE_TABLE[mProduct].commonMetals());
-	mResourcesPool->commonMinerals(mResourcesPool->commonMinerals() - PRODUCTION_TYPE_TABLE[mProduct].commonMinerals());
-	mResourcesPool->rareMetals(mResourcesPool->rareMetals() - PRODUCTION_TYPE_TABLE[mProduct].rareMetals());
-	mResourcesPool->rareMinerals(mResourcesPool->rareMinerals() - PRODUCTION_TYPE_TABLE[mProduct].rareMinerals());
 
 	++mTurnsCompleted;
 
@@ -148,7 +173,9 @@ void Factory::updateProduction()
 	{
 		productionResetTurns();
 		mProductWaiting = mProduct;
-		mProductionComplete(*this);
+
+		// The queue picks the next product at the start of the next turn.
+		if (mQueued) { clearProduction(); }
 	}
 }
 
@@ -159,15 +186,7 @@ bool Factory::enoughResourcesAvailable()
 	if (mResourcesPool == nullptr) { throw std::runtime_error("Factory::enoughResourcesAvailable() called with a null Resource Pool set"); }
 	#endif
 
-	if (mResourcesPool->commonMetals() >= PRODUCTION_TYPE_TABLE[mProduct].commonMetals() &&
-		mResourcesPool->commonMinerals() >= PRODUCTION_TYPE_TABLE[mProduct].commonMinerals() &&
-		mResourcesPool->rareMetals() >= PRODUCTION_TYPE_TABLE[mProduct].rareMetals() &&
-		mResourcesPool->rareMinerals() >= PRODUCTION_TYPE_TABLE[mProduct].rareMinerals())
-	{
-		return true;
-	}
-
-	return false;
+	return mResourcesPool->canAfford(productCost(mProduct));
 }
 
 
@@ -188,3 +207,156 @@ void Factory::clearProduction()
 	mTurnsToComplete = 0;
 	mProduct = PRODUCT_NONE;
 }
+
+
+/**
+ * Adds an order for a number of products to the end of the production queue.
+ *
+ * \note	The product being built, if any, is finished before the queue
+ *			takes over.
+ */
+void Factory::queueProduct(ProductType _p, int count)
+{
+	if (count < 1 || find(mAvailableProducts.begin(), mAvailableProducts.end(), _p) == mAvailableProducts.end()) { return; }
+
+	ProductionOrder order;
+	order.product = _p;
+	order.count = count;
+
+	mQueue.push_back(order);
+	mQueued = true;
+}
+
+
+/**
+ * Adds an order to keep the colony stocked with a number of products to the
+ * end of the production queue. Stock orders stay in the queue until they're
+ * cleared.
+ *
+ * \note	The product being built, if any, is finished before the queue
+ *			takes over.
+ */
+void Factory::queueStock(ProductType _p, int stock)
+{
+	if (stock < 1 || find(mAvailableProducts.begin(), mAvailableProducts.end(), _p) == mAvailableProducts.end()) { return; }
+
+	ProductionOrder order;
+	order.product = _p;
+	order.stock = stock;
+
+	mQueue.push_back(order);
+	mQueued = true;
+}
+
+
+/**
+ * Removes every order from the production queue.
+ *
+ * \note	The product being built is still finished.
+ */
+void Factory::clearQueue()
+{
+	mQueue.clear();
+}
+
+
+/**
+ * Determines if an order still needs products.
+ */
+bool Factory::orderDue(const ProductionOrder& order, const ProductPool::ProductTypeCount& stock) const
+{
+	if (order.stock > 0) { return stock[order.product] < order.stock; }
+	return order.count > 0;
+}
+
+
+/**
+ * Picks the next product to build from the production queue.
+ *
+ * Doesn't do anything while a product is being built or is waiting to be
+ * delivered or if the factory isn't working through a queue.
+ *
+ * \param	stock	Number of each product the colony has, including products
+ *					being built. Counts the product that's picked.
+ */
+void Factory::resolveQueue(ProductPool::ProductTypeCount& stock)
+{
+	if (!mQueued || mProduct != PRODUCT_NONE || mProductWaiting != PRODUCT_NONE) { return; }
+
+	for (auto it = mQueue.begin(); it != mQueue.end(); ++it)
+	{
+		if (!orderDue(*it, stock)) { continue; }
+
+		product(it->product);
+		++stock[it->product];
+
+		if (it->stock == 0 && --it->count == 0) { mQueue.erase(it); }
+		return;
+	}
+
+	// Nothing left to build. Stock orders keep the factory on the queue.
+	if (mQueue.empty()) { mQueued = false; }
+}
+
+
+/**
+ * Record type used to read production orders.
+ */
+struct OrderRecord
+{
+	int product = PRODUCT_NONE, count = 0, stock = 0;
+};
+
+static const AttributeSchema<OrderRecord> ORDER_SCHEMA("order",
+{
+	{ "product", &OrderRecord::product, true },
+	{ "count", &OrderRecord::count },
+	{ "stock", &OrderRecord::stock }
+});
+
+
+/**
+ * Writes the production queue as a child element of the current element.
+ * Nothing is written for a factory that isn't working through a queue.
+ */
+void Factory::serializeQueue(SaveGameSnapshot& _w)
+{
+	if (!mQueued) { return; }
+
+	_w.openElement("production_queue");
+
+	for (const ProductionOrder& order : mQueue)
+	{
+		_w.openElement("order");
+		_w.attribute("product", order.product);
+		_w.attribute("count", order.count);
+		_w.attribute("stock", order.stock);
+		_w.closeElement();
+	}
+
+	_w.closeElement();
+}
+
+
+/**
+ * Reads a production queue written by serializeQueue().
+ *
+ * \note	Expects to be called after the product being built has been set.
+ */
+void Factory::deserializeQueue(XmlElement* _ti)
+{
+	mQueue.clear();
+	mQueued = _ti != nullptr;
+
+	if (_ti == nullptr) { return; }
+
+	for (XmlNode* node = _ti->firstChild(); node != nullptr; node = node->nextSibling())
+	{
+		OrderRecord record;
+		ORDER_SCHEMA.read(node->toElement(), record);
+
+		ProductType _p = static_cast<ProductType>(record.product);
+		if (record.stock > 0) { queueStock(_p, record.stock); }
+		else { queueProduct(_p, record.count); }
+	}
+}
@@ -2,8 +2,11 @@
 
 #include "Structure.h"
 
+#include "../../ProductPool.h"
 #include "../../ProductionCost.h"
 
+class SaveGameSnapshot;
+
 /**
  * \brief	Defines the Factory interface.
  *
@@ -17,14 +20,29 @@
  *
  * \warning	There are no sanity checks in the underlying production code to check if resourcePool
  *			or robotPool have been properly set. It is assumed that they have been.
+ *
+ * A Factory either builds one product over and over or works through a production
+ * queue. Finished products wait in the factory until they're delivered at the end of
+ * the turn. The queue is resolved at the start of every turn with resolveQueue(): a
+ * factory that isn't building anything starts on the first order that still needs
+ * products.
  */
 class Factory : public Structure
 {
 public:
-	// Callback providing what was complete and a reference to the Factory.
-	typedef NAS2D::Signals::Signal1<Factory&> ProductionCallback;
+	/**
+	 * An entry in a production queue. Either builds a number of products or keeps
+	 * the colony stocked with a number of products.
+	 */
+	struct ProductionOrder
+	{
+		ProductType		product = PRODUCT_NONE;
+		int				count = 0;		/**< Number of products left to start. Unused by stock orders. */
+		int				stock = 0;		/**< Number of products to keep in the colony. 0 for a counted order. */
+	};
 
 	typedef std::vector<ProductType> ProductionTypeList;
+	typedef std::vector<ProductionOrder> ProductionQueue;
 
 public:
 	Factory(const std::string& name, const std::string& sprite_path);
@@ -49,9 +67,19 @@ public:
 
 	const ProductionTypeList& productList() const { return mAvailableProducts; }
 
-	virtual void initFactory() = 0;
+	void queueProduct(ProductType _p, int count);
+	void queueStock(ProductType _p, int stock);
+	void clearQueue();
+
+	const ProductionQueue& productionQueue() const { return mQueue; }
+	bool queued() const { return mQueued; }
+
+	void resolveQueue(ProductPool::ProductTypeCount& stock);
 
-	ProductionCallback& productionComplete() { return mProductionComplete; }
+	void serializeQueue(SaveGameSnapshot& _w);
+	void deserializeQueue(NAS2D::Xml::XmlElement* _ti);
+
+	virtual void initFactory() = 0;
 
 protected:
 	void clearProduction();
@@ -61,6 +89,10 @@ protected:
 
 	ResourcePool* resourcePool() { return mResourcesPool; }
 
+private:
+	void product(ProductType _p);
+	bool orderDue(const ProductionOrder& order, const ProductPool::ProductTypeCount& stock) const;
+
 private:
 	int								mTurnsCompleted = 0;
 	int								mTurnsToComplete = 0;
@@ -70,7 +102,8 @@ private:
 
 	ProductionTypeList				mAvailableProducts;			/**< List of products that the Factory can produce. */
 
-	ProductionCallback				mProductionComplete;		/**< Callback used when production is complete. */
+	ProductionQueue					mQueue;						/**< Orders still to be worked on. */
+	bool							mQueued = false;			/**< The product being built was picked by the production queue. */
 
 	ResourcePool*					mResourcesPool = nullptr;	/**< Pointer to the player's resource pool. UGLY. */
 };
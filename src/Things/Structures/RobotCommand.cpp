@@ -8,6 +8,21 @@
 
 extern int ROBOT_ID_COUNTER; /// \fixme Kludge
 
+/**
+ * D'tor
+ *
+ * Releases the robots under command of the facility.
+ */
+RobotCommand::~RobotCommand()
+{
+	for (auto robot : mRobotList)
+	{
+		robot->commander(nullptr);
+		robot->slot(Robot::SLOT_COMMAND, Robot::NO_SLOT);
+	}
+}
+
+
 /**
  * Gets whether the command facility has additional command capacity remaining.
  */
@@ -22,7 +37,7 @@ bool RobotCommand::commandCapacityAvailable() const
  */
 bool RobotCommand::commandedByThis(Robot* _r) const
 {
-	return find(mRobotList.begin(), mRobotList.end(), _r) != mRobotList.end();
+	return _r->commander() == this;
 }
 
 
@@ -50,6 +65,11 @@ void RobotCommand::addRobot(Robot* _r)
 		//throw std::runtime_error("RobotCommand::addRobot(): Adding a robot that is already under the command of this Robot Command Facility.");
 	}
 
+	// A robot is only ever under the command of one facility.
+	if (_r->commander()) { _r->commander()->removeRobot(_r); }
+
+	_r->commander(this);
+	_r->slot(Robot::SLOT_COMMAND, mRobotList.size());
 	mRobotList.push_back(_r);
 }
 
@@ -61,18 +81,18 @@ void RobotCommand::addRobot(Robot* _r)
  */
 void RobotCommand::removeRobot(Robot* _r)
 {
-	if (mRobotList.empty())
-	{
-		//throw std::runtime_error("RobotCommand::removeRobot(): Robot list empty.");
-		return;
-	}
-
-	auto _it = find(mRobotList.begin(), mRobotList.end(), _r);
-	if (_it == mRobotList.end())
+	if (!commandedByThis(_r))
 	{
 		//throw std::runtime_error("RobotCommand::removeRobot(): Removing a robot that is not under the command of this Robot Command Facility.");
 		return;
 	}
 
-	mRobotList.erase(_it);
+	// The last robot takes the place of the removed one.
+	size_t slot = _r->slot(Robot::SLOT_COMMAND);
+	mRobotList[slot] = mRobotList.back();
+	mRobotList[slot]->slot(Robot::SLOT_COMMAND, slot);
+	mRobotList.pop_back();
+
+	_r->commander(nullptr);
+	_r->slot(Robot::SLOT_COMMAND, Robot::NO_SLOT);
 }
@@ -24,7 +24,7 @@ public:
 		requiresCHAP(false);
 	}
 
-	virtual ~RobotCommand()	{}
+	virtual ~RobotCommand();
 
 	bool commandedByThis(Robot* _r) const;
 
@@ -33,6 +33,7 @@ public:
 	void removeRobot(Robot* _r);
 
 	const RobotList& robots() { return mRobotList; }
+	size_t robotCount() const { return mRobotList.size(); }
 
 protected:
 	virtual void think() final {}
@@ -44,5 +45,5 @@ protected:
 	}
 
 private:
-	RobotList	mRobotList;
+	RobotList	mRobotList;		/**< Robots under command. Each robot knows its position in the list. */
 };
@@ -0,0 +1,172 @@
+// This is an open source non-commercial project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+
+#include "TurnWorker.h"
+
+#include <chrono>
+#include <stdexcept>
+
+
+/**
+ * D'tor
+ *
+ * Waits for a job that's still running. Its exception, if any, is dropped.
+ */
+TurnWorker::~TurnWorker()
+{
+	try { wait(); }
+	catch (...) {}
+}
+
+
+/**
+ * Starts a job on the worker thread.
+ *
+ * \note	Only one job runs at a time.
+ */
+void TurnWorker::start(const std::function<void()>& job)
+{
+	if (busy()) { throw std::runtime_error("TurnWorker::start(): A job is already running."); }
+
+	mMainThread = std::this_thread::get_id();
+	mDone = false;
+	mBusy = true;
+
+	mThread = std::thread([this, job]()
+	{
+		std::exception_ptr error;
+		try { job(); }
+		catch (...) { error = std::current_exception(); }
+
+		std::lock_guard<std::mutex> lock(mMutex);
+		mError = error;
+		mDone = true;
+		mSignal.notify_all();
+	});
+}
+
+
+/**
+ * Determines if the caller is the job running on the worker thread.
+ */
+bool TurnWorker::onWorkerThread() const
+{
+	return busy() && std::this_thread::get_id() != mMainThread;
+}
+
+
+/**
+ * Runs the call the job is waiting on, if any, without waiting for the
+ * job and finishes the job if it's done.
+ *
+ * \return	True if a job was finished.
+ */
+bool TurnWorker::update()
+{
+	if (!busy()) { return false; }
+
+	std::unique_lock<std::mutex> lock(mMutex);
+	return service(lock);
+}
+
+
+/**
+ * Waits a while for the job to be done, running the calls it hands over
+ * in the meantime.
+ *
+ * \return	True if no job is running anymore.
+ */
+bool TurnWorker::wait(unsigned int milliseconds)
+{
+	if (!busy()) { return true; }
+
+	auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(milliseconds);
+
+	std::unique_lock<std::mutex> lock(mMutex);
+	while (!service(lock))
+	{
+		if (!mSignal.wait_until(lock, deadline, [this]() { return mDone || static_cast<bool>(mCall); })) { return false; }
+	}
+
+	return true;
+}
+
+
+/**
+ * Waits for the job to be done, running the calls it hands over in the
+ * meantime.
+ */
+void TurnWorker::wait()
+{
+	if (!busy()) { return; }
+
+	std::unique_lock<std::mutex> lock(mMutex);
+	while (!service(lock))
+	{
+		mSignal.wait(lock, [this]() { return mDone || static_cast<bool>(mCall); });
+	}
+}
+
+
+/**
+ * Runs a call on the main thread.
+ *
+ * From the job the call is handed to the main thread and the job waits
+ * until it's been run. Anywhere else the call is run right away.
+ */
+void TurnWorker::runOnMainThread(const std::function<void()>& call)
+{
+	if (!onWorkerThread())
+	{
+		call();
+		return;
+	}
+
+	std::unique_lock<std::mutex> lock(mMutex);
+	mCall = call;
+	mSignal.notify_all();
+	mSignal.wait(lock, [this]() { return !mCall; });
+}
+
+
+/**
+ * Runs the call handed over by the job and joins the worker thread once
+ * the job is done.
+ *
+ * \param	lock	Lock held on mMutex. Still held when false is returned.
+ *
+ * \return	True if the job was finished.
+ */
+bool TurnWorker::service(std::unique_lock<std::mutex>& lock)
+{
+	if (mCall)
+	{
+		std::function<void()> call = mCall;
+
+		lock.unlock();
+		std::exception_ptr error;
+		try { call(); }
+		catch (...) { error = std::current_exception(); }
+		lock.lock();
+
+		// The job can't go on until the call is cleared, even one that failed.
+		mCall = nullptr;
+		mSignal.notify_all();
+
+		if (error) { std::rethrow_exception(error); }
+	}
+
+	if (!mDone) { return false; }
+
+	std::exception_ptr error = mError;
+	mError = nullptr;
+
+	lock.unlock();
+	mThread.join();
+	mBusy = false;
+	lock.lock();
+
+	if (error) { std::rethrow_exception(error); }
+
+	return true;
+}
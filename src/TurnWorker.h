@@ -0,0 +1,55 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+
+/**
+ * \brief	Runs the processing of a turn on a worker thread.
+ *
+ * Anything a job can't do off of the main thread, like making things that
+ * load images, is handed back with runOnMainThread(). The job waits until
+ * the main thread has run the call the next time it calls update() or
+ * wait() so the job and the call never run at the same time.
+ *
+ * An exception thrown by the job is thrown again on the main thread when
+ * the job is finished.
+ */
+class TurnWorker
+{
+public:
+	TurnWorker() = default;
+	~TurnWorker();
+
+	void start(const std::function<void()>& job);
+
+	bool busy() const { return mBusy; }
+	bool onWorkerThread() const;
+
+	bool update();
+	bool wait(unsigned int milliseconds);
+	void wait();
+
+	void runOnMainThread(const std::function<void()>& call);
+
+private:
+	TurnWorker(const TurnWorker&) = delete;
+	TurnWorker& operator=(const TurnWorker&) = delete;
+
+	bool service(std::unique_lock<std::mutex>& lock);
+
+private:
+	std::thread					mThread;					/**< Thread the job runs on. */
+	std::thread::id				mMainThread;				/**< Thread that started the job. */
+	std::atomic<bool>			mBusy{ false };				/**< A job was started and hasn't been finished. */
+
+	std::mutex					mMutex;						/**< Guards everything below. */
+	std::condition_variable		mSignal;					/**< Signaled when a call is handed over, run or the job is done. */
+	std::function<void()>		mCall;						/**< Call the job is waiting on the main thread to run. */
+	bool						mDone = false;				/**< The job returned. */
+	std::exception_ptr			mError;						/**< Exception thrown by the job. */
+};
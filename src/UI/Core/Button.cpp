@@ -17,35 +17,11 @@ Button::Button()
 	Utility<EventHandler>::get().mouseMotion().connect(this, &Button::onMouseMotion);
 	hasFocus(true);
 
-	mSkinNormal.push_back(Image("ui/skin/button_top_left.png"));
-	mSkinNormal.push_back(Image("ui/skin/button_top_middle.png"));
-	mSkinNormal.push_back(Image("ui/skin/button_top_right.png"));
-	mSkinNormal.push_back(Image("ui/skin/button_middle_left.png"));
-	mSkinNormal.push_back(Image("ui/skin/button_middle_middle.png"));
-	mSkinNormal.push_back(Image("ui/skin/button_middle_right.png"));
-	mSkinNormal.push_back(Image("ui/skin/button_bottom_left.png"));
-	mSkinNormal.push_back(Image("ui/skin/button_bottom_middle.png"));
-	mSkinNormal.push_back(Image("ui/skin/button_bottom_right.png"));
-
-	mSkinHover.push_back(Image("ui/skin/button_hover_top_left.png"));
-	mSkinHover.push_back(Image("ui/skin/button_hover_top_middle.png"));
-	mSkinHover.push_back(Image("ui/skin/button_hover_top_right.png"));
-	mSkinHover.push_back(Image("ui/skin/button_hover_middle_left.png"));
-	mSkinHover.push_back(Image("ui/skin/button_hover_middle_middle.png"));
-	mSkinHover.push_back(Image("ui/skin/button_hover_middle_right.png"));
-	mSkinHover.push_back(Image("ui/skin/button_hover_bottom_left.png"));
-	mSkinHover.push_back(Image("ui/skin/button_hover_bottom_middle.png"));
-	mSkinHover.push_back(Image("ui/skin/button_hover_bottom_right.png"));
-
-	mSkinPressed.push_back(Image("ui/skin/button_pressed_top_left.png"));
-	mSkinPressed.push_back(Image("ui/skin/button_pressed_top_middle.png"));
-	mSkinPressed.push_back(Image("ui/skin/button_pressed_top_right.png"));
-	mSkinPressed.push_back(Image("ui/skin/button_pressed_middle_left.png"));
-	mSkinPressed.push_back(Image("ui/skin/button_pressed_middle_middle.png"));
-	mSkinPressed.push_back(Image("ui/skin/button_pressed_middle_right.png"));
-	mSkinPressed.push_back(Image("ui/skin/button_pressed_bottom_left.png"));
-	mSkinPressed.push_back(Image("ui/skin/button_pressed_bottom_middle.png"));
-	mSkinPressed.push_back(Image("ui/skin/button_pressed_bottom_right.png"));
+	mSkinNormal = Utility<ImageManager>::get().skin("ui/skin/button");
+
+	mSkinHover = Utility<ImageManager>::get().skin("ui/skin/button_hover");
+
+	mSkinPressed = Utility<ImageManager>::get().skin("ui/skin/button_pressed");
 
 	mFont = Utility<FontManager>::get().font(constants::FONT_PRIMARY, constants::FONT_PRIMARY_NORMAL);
 }
@@ -56,8 +32,6 @@ Button::~Button()
 	Utility<EventHandler>::get().mouseButtonDown().disconnect(this, &Button::onMouseDown);
 	Utility<EventHandler>::get().mouseButtonUp().disconnect(this, &Button::onMouseUp);
 	Utility<EventHandler>::get().mouseMotion().disconnect(this, &Button::onMouseMotion);
-
-	delete mImage;
 }
 
 
@@ -87,13 +61,13 @@ void Button::fontSize(size_t size)
 
 void Button::image(const std::string& path)
 {
-	mImage = new Image(path);
+	mImage = Utility<ImageManager>::get().image(path);
 }
 
 
 bool Button::hasImage() const
 {
-	return mImage->loaded();
+	return mImage && mImage->loaded();
 }
 
 
@@ -165,15 +139,15 @@ void Button::draw()
 
 	if (enabled() && mMouseHover && mState != STATE_PRESSED)
 	{
-		r.drawImageRect(rect().x(), rect().y(), rect().width(), rect().height(), mSkinHover);
+		r.drawImageRect(rect().x(), rect().y(), rect().width(), rect().height(), *mSkinHover);
 	}
 	else if (mState == STATE_NORMAL)
 	{
-		r.drawImageRect(rect().x(), rect().y(), rect().width(), rect().height(), mSkinNormal);
+		r.drawImageRect(rect().x(), rect().y(), rect().width(), rect().height(), *mSkinNormal);
 	}
 	else
 	{
-		r.drawImageRect(rect().x(), rect().y(), rect().width(), rect().height(), mSkinPressed);
+		r.drawImageRect(rect().x(), rect().y(), rect().width(), rect().height(), *mSkinPressed);
 	}
 
 	if (mImage)
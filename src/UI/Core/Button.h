@@ -4,6 +4,8 @@
 
 #include "Control.h"
 
+#include "../../ImageManager.h"
+
 #include <string>
 
 class Button: public Control
@@ -55,11 +57,11 @@ private:
 	State				mState = STATE_NORMAL;		/**< Current state of the Button. */
 	Type				mType = BUTTON_NORMAL;		/**< Modifies Button behavior. */
 
-	NAS2D::Image*		mImage = nullptr;			/**< Image to draw centered on the Button. */
+	ImageManager::ImageHandle	mImage;		/**< Image to draw centered on the Button. */
 
-	NAS2D::ImageList	mSkinNormal;
-	NAS2D::ImageList	mSkinHover;
-	NAS2D::ImageList	mSkinPressed;
+	ImageManager::ImageListHandle	mSkinNormal;
+	ImageManager::ImageListHandle	mSkinHover;
+	ImageManager::ImageListHandle	mSkinPressed;
 
 	NAS2D::Font*		mFont = nullptr;			/**< Buttons can have different font sizes. */
 
@@ -28,7 +28,7 @@ static Font* CBOX_FONT = nullptr;
 /**
  * C'tor
  */
-CheckBox::CheckBox() : mSkin("ui/skin/checkbox.png")
+CheckBox::CheckBox() : mSkin(Utility<ImageManager>::get().region("ui/skin/checkbox.png"))
 {
 	CBOX_FONT = Utility<FontManager>::get().font(constants::FONT_PRIMARY, constants::FONT_PRIMARY_NORMAL);
 	Utility<EventHandler>::get().mouseButtonDown().connect(this, &CheckBox::onMouseDown);
@@ -115,6 +115,6 @@ void CheckBox::update()
 {
 	Renderer& r = Utility<Renderer>::get();
 
-	r.drawSubImage(mSkin, positionX(), positionY(), mChecked ? 13.0f : 0.0f, 0.0f, 13.0f, 13.0f);
+	mSkin.drawSub(r, positionX(), positionY(), mChecked ? 13.0f : 0.0f, 0.0f, 13.0f, 13.0f);
 	r.drawText(*CBOX_FONT, text(), positionX() + 20.0f, positionY(), 255, 255, 255);
 }
@@ -4,6 +4,8 @@
 
 #include "Control.h"
 
+#include "../../ImageManager.h"
+
 #include <string>
 
 class CheckBox : public Control
@@ -29,7 +31,7 @@ protected:
 	virtual void onTextChanged() final;
 	
 private:
-	NAS2D::Image	mSkin;				/**<  */
+	ImageRegion					mSkin;				/**<  */
 
 	ClickCallback	mCallback;			/**< Object to notify when the Button is activated. */
 
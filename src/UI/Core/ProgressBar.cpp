@@ -25,25 +25,9 @@ ProgressBar::~ProgressBar()
 
 void ProgressBar::init()
 {
-	mSkinOut.push_back(Image("ui/skin/button_top_left.png"));
-	mSkinOut.push_back(Image("ui/skin/button_top_middle.png"));
-	mSkinOut.push_back(Image("ui/skin/button_top_right.png"));
-	mSkinOut.push_back(Image("ui/skin/button_middle_left.png"));
-	mSkinOut.push_back(Image("ui/skin/button_middle_middle.png"));
-	mSkinOut.push_back(Image("ui/skin/button_middle_right.png"));
-	mSkinOut.push_back(Image("ui/skin/button_bottom_left.png"));
-	mSkinOut.push_back(Image("ui/skin/button_bottom_middle.png"));
-	mSkinOut.push_back(Image("ui/skin/button_bottom_right.png"));
-
-	mSkinIn.push_back(Image("ui/skin/button_pressed_top_left.png"));
-	mSkinIn.push_back(Image("ui/skin/button_pressed_top_middle.png"));
-	mSkinIn.push_back(Image("ui/skin/button_pressed_top_right.png"));
-	mSkinIn.push_back(Image("ui/skin/button_pressed_middle_left.png"));
-	mSkinIn.push_back(Image("ui/skin/button_pressed_middle_middle.png"));
-	mSkinIn.push_back(Image("ui/skin/button_pressed_middle_right.png"));
-	mSkinIn.push_back(Image("ui/skin/button_pressed_bottom_left.png"));
-	mSkinIn.push_back(Image("ui/skin/button_pressed_bottom_middle.png"));
-	mSkinIn.push_back(Image("ui/skin/button_pressed_bottom_right.png"));
+	mSkinOut = Utility<ImageManager>::get().skin("ui/skin/button");
+
+	mSkinIn = Utility<ImageManager>::get().skin("ui/skin/button_pressed");
 
 	setColor(255, 0, 0);
 }
@@ -51,7 +35,7 @@ void ProgressBar::init()
 
 void ProgressBar::image(const std::string& _path, ImageMode _m)
 {
-	mImage = Image(_path);
+	mImage = Utility<ImageManager>::get().image(_path);
 	mImageMode = _m;
 	mUsesImage = true;
 }
@@ -59,7 +43,7 @@ void ProgressBar::image(const std::string& _path, ImageMode _m)
 
 bool ProgressBar::hasImage() const
 {
-	return mImage.loaded();
+	return mImage && mImage->loaded();
 }
 
 
@@ -81,8 +65,8 @@ void ProgressBar::draw()
 
 	Renderer& r = Utility<Renderer>::get();
 
-	r.drawImageRect(rect().x(), rect().y(), rect().width(), rect().height(), mSkinOut);
-	r.drawImageRect(rect().x()+2, rect().y()+2, rect().width()-4, rect().height()-4, mSkinIn);
+	r.drawImageRect(rect().x(), rect().y(), rect().width(), rect().height(), *mSkinOut);
+	r.drawImageRect(rect().x()+2, rect().y()+2, rect().width()-4, rect().height()-4, *mSkinIn);
 
 	iWidth = 0;
 	if (mEnd > 0)
@@ -92,11 +76,11 @@ void ProgressBar::draw()
 		return;
 
 	if (hasImage() && mImageMode == ImageMode::Repeating)
-		r.drawImageRepeated(mImage, rect().x() + 4, rect().y() + 4, static_cast<float>(iWidth), rect().height() - 8);
+		r.drawImageRepeated(*mImage, rect().x() + 4, rect().y() + 4, static_cast<float>(iWidth), rect().height() - 8);
 	else if (hasImage() && mImageMode == ImageMode::Stretching)
-		r.drawImageStretched(mImage, rect().x() + 4, rect().y() + 4, static_cast<float>(iWidth), rect().height() - 8);
+		r.drawImageStretched(*mImage, rect().x() + 4, rect().y() + 4, static_cast<float>(iWidth), rect().height() - 8);
 	else if (hasImage() && mImageMode == ImageMode::Straight)
-		r.drawSubImage(mImage, rect().x() + 4, rect().y() + 4, 0, 0, static_cast<float>(iWidth), rect().height() - 8);
+		r.drawSubImage(*mImage, rect().x() + 4, rect().y() + 4, 0, 0, static_cast<float>(iWidth), rect().height() - 8);
 	else
 		r.drawBoxFilled(rect().x() + 4, rect().y() + 4, static_cast<float>(iWidth), rect().height() - 8, mColorR, mColorG, mColorB, mColorAlpha);
 }
@@ -4,6 +4,8 @@
 
 #include "Control.h"
 
+#include "../../ImageManager.h"
+
 #include <string>
 
 class ProgressBar : public Control
@@ -52,11 +54,11 @@ private:
 	unsigned char		mColorB;
 	unsigned char		mColorAlpha;
 
-	NAS2D::Image		mImage;
+	ImageManager::ImageHandle		mImage;
 	ImageMode			mImageMode;
 
-	NAS2D::ImageList	mSkinOut;
-	NAS2D::ImageList	mSkinIn;
+	ImageManager::ImageListHandle	mSkinOut;
+	ImageManager::ImageListHandle	mSkinIn;
 
 	bool				mUsesImage;		/**< Internal flag indicating that the Button uses an image graphic. */
 };
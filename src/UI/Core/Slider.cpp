@@ -16,6 +16,17 @@ using namespace NAS2D;
 
 static Font* SLD_FONT = nullptr;
 
+
+/**
+ * Gets the filenames of the nine slices of a slider skin.
+ */
+static std::vector<std::string> sliderSkin(const std::string& name)
+{
+	std::vector<std::string> names;
+	for (const char* slice : { "_tl", "_tm", "_tr", "_ml", "_mm", "_mr", "_bl", "_bm", "_br" }) { names.push_back(name + slice + ".png"); }
+	return names;
+}
+
 /**
  * C'tor
  */
@@ -64,91 +75,21 @@ void Slider::size(float w, float h)
  */
 void Slider::setSkins()
 {
-	if (!mSkinButton1.empty()) { return; }
+	if (mSkinButton1) { return; }
 
 	if (mSliderType == SLIDER_VERTICAL)
 	{
-		mSkinButton1.push_back(Image("ui/skin/sv_bu_tl.png"));
-		mSkinButton1.push_back(Image("ui/skin/sv_bu_tm.png"));
-		mSkinButton1.push_back(Image("ui/skin/sv_bu_tr.png"));
-		mSkinButton1.push_back(Image("ui/skin/sv_bu_ml.png"));
-		mSkinButton1.push_back(Image("ui/skin/sv_bu_mm.png"));
-		mSkinButton1.push_back(Image("ui/skin/sv_bu_mr.png"));
-		mSkinButton1.push_back(Image("ui/skin/sv_bu_bl.png"));
-		mSkinButton1.push_back(Image("ui/skin/sv_bu_bm.png"));
-		mSkinButton1.push_back(Image("ui/skin/sv_bu_br.png"));
-
-		mSkinMiddle.push_back(Image("ui/skin/sv_sa_tl.png"));
-		mSkinMiddle.push_back(Image("ui/skin/sv_sa_tm.png"));
-		mSkinMiddle.push_back(Image("ui/skin/sv_sa_tr.png"));
-		mSkinMiddle.push_back(Image("ui/skin/sv_sa_ml.png"));
-		mSkinMiddle.push_back(Image("ui/skin/sv_sa_mm.png"));
-		mSkinMiddle.push_back(Image("ui/skin/sv_sa_mr.png"));
-		mSkinMiddle.push_back(Image("ui/skin/sv_sa_bl.png"));
-		mSkinMiddle.push_back(Image("ui/skin/sv_sa_bm.png"));
-		mSkinMiddle.push_back(Image("ui/skin/sv_sa_br.png"));
-
-		mSkinButton2.push_back(Image("ui/skin/sv_bd_tl.png"));
-		mSkinButton2.push_back(Image("ui/skin/sv_bd_tm.png"));
-		mSkinButton2.push_back(Image("ui/skin/sv_bd_tr.png"));
-		mSkinButton2.push_back(Image("ui/skin/sv_bd_ml.png"));
-		mSkinButton2.push_back(Image("ui/skin/sv_bd_mm.png"));
-		mSkinButton2.push_back(Image("ui/skin/sv_bd_mr.png"));
-		mSkinButton2.push_back(Image("ui/skin/sv_bd_bl.png"));
-		mSkinButton2.push_back(Image("ui/skin/sv_bd_bm.png"));
-		mSkinButton2.push_back(Image("ui/skin/sv_bd_br.png"));
-
-		mSkinSlider.push_back(Image("ui/skin/sv_sl_tl.png"));
-		mSkinSlider.push_back(Image("ui/skin/sv_sl_tm.png"));
-		mSkinSlider.push_back(Image("ui/skin/sv_sl_tr.png"));
-		mSkinSlider.push_back(Image("ui/skin/sv_sl_ml.png"));
-		mSkinSlider.push_back(Image("ui/skin/sv_sl_mm.png"));
-		mSkinSlider.push_back(Image("ui/skin/sv_sl_mr.png"));
-		mSkinSlider.push_back(Image("ui/skin/sv_sl_bl.png"));
-		mSkinSlider.push_back(Image("ui/skin/sv_sl_bm.png"));
-		mSkinSlider.push_back(Image("ui/skin/sv_sl_br.png"));
+		mSkinButton1 = Utility<ImageManager>::get().imageList(sliderSkin("ui/skin/sv_bu"));
+		mSkinMiddle = Utility<ImageManager>::get().imageList(sliderSkin("ui/skin/sv_sa"));
+		mSkinButton2 = Utility<ImageManager>::get().imageList(sliderSkin("ui/skin/sv_bd"));
+		mSkinSlider = Utility<ImageManager>::get().imageList(sliderSkin("ui/skin/sv_sl"));
 	}
 	else
 	{
-		mSkinButton1.push_back(Image("ui/skin/sh_bl_tl.png"));
-		mSkinButton1.push_back(Image("ui/skin/sh_bl_tm.png"));
-		mSkinButton1.push_back(Image("ui/skin/sh_bl_tr.png"));
-		mSkinButton1.push_back(Image("ui/skin/sh_bl_ml.png"));
-		mSkinButton1.push_back(Image("ui/skin/sh_bl_mm.png"));
-		mSkinButton1.push_back(Image("ui/skin/sh_bl_mr.png"));
-		mSkinButton1.push_back(Image("ui/skin/sh_bl_bl.png"));
-		mSkinButton1.push_back(Image("ui/skin/sh_bl_bm.png"));
-		mSkinButton1.push_back(Image("ui/skin/sh_bl_br.png"));
-
-		mSkinMiddle.push_back(Image("ui/skin/sh_sa_tl.png"));
-		mSkinMiddle.push_back(Image("ui/skin/sh_sa_tm.png"));
-		mSkinMiddle.push_back(Image("ui/skin/sh_sa_tr.png"));
-		mSkinMiddle.push_back(Image("ui/skin/sh_sa_ml.png"));
-		mSkinMiddle.push_back(Image("ui/skin/sh_sa_mm.png"));
-		mSkinMiddle.push_back(Image("ui/skin/sh_sa_mr.png"));
-		mSkinMiddle.push_back(Image("ui/skin/sh_sa_bl.png"));
-		mSkinMiddle.push_back(Image("ui/skin/sh_sa_bm.png"));
-		mSkinMiddle.push_back(Image("ui/skin/sh_sa_br.png"));
-
-		mSkinButton2.push_back(Image("ui/skin/sh_br_tl.png"));
-		mSkinButton2.push_back(Image("ui/skin/sh_br_tm.png"));
-		mSkinButton2.push_back(Image("ui/skin/sh_br_tr.png"));
-		mSkinButton2.push_back(Image("ui/skin/sh_br_ml.png"));
-		mSkinButton2.push_back(Image("ui/skin/sh_br_mm.png"));
-		mSkinButton2.push_back(Image("ui/skin/sh_br_mr.png"));
-		mSkinButton2.push_back(Image("ui/skin/sh_br_bl.png"));
-		mSkinButton2.push_back(Image("ui/skin/sh_br_bm.png"));
-		mSkinButton2.push_back(Image("ui/skin/sh_br_br.png"));
-
-		mSkinSlider.push_back(Image("ui/skin/sh_sl_tl.png"));
-		mSkinSlider.push_back(Image("ui/skin/sh_sl_tm.png"));
-		mSkinSlider.push_back(Image("ui/skin/sh_sl_tr.png"));
-		mSkinSlider.push_back(Image("ui/skin/sh_sl_ml.png"));
-		mSkinSlider.push_back(Image("ui/skin/sh_sl_mm.png"));
-		mSkinSlider.push_back(Image("ui/skin/sh_sl_mr.png"));
-		mSkinSlider.push_back(Image("ui/skin/sh_sl_bl.png"));
-		mSkinSlider.push_back(Image("ui/skin/sh_sl_bm.png"));
-		mSkinSlider.push_back(Image("ui/skin/sh_sl_br.png"));
+		mSkinButton1 = Utility<ImageManager>::get().imageList(sliderSkin("ui/skin/sh_bl"));
+		mSkinMiddle = Utility<ImageManager>::get().imageList(sliderSkin("ui/skin/sh_sa"));
+		mSkinButton2 = Utility<ImageManager>::get().imageList(sliderSkin("ui/skin/sh_br"));
+		mSkinSlider = Utility<ImageManager>::get().imageList(sliderSkin("ui/skin/sh_sl"));
 	}
 }
 
@@ -373,9 +314,9 @@ void Slider::draw()
 
 	if (mSliderType == SLIDER_VERTICAL)
 	{
-		r.drawImageRect(mSlideBar.x(), mSlideBar.y(), mSlideBar.width(), mSlideBar.height(), mSkinMiddle);// slide area
-		r.drawImageRect(mButton1.x(), mButton1.y(), mButton1.height(), mButton1.height(), mSkinButton1);// top button
-		r.drawImageRect(mButton2.x(), mButton2.y(), mButton2.height(), mButton2.height(), mSkinButton2);// bottom button
+		r.drawImageRect(mSlideBar.x(), mSlideBar.y(), mSlideBar.width(), mSlideBar.height(), *mSkinMiddle);// slide area
+		r.drawImageRect(mButton1.x(), mButton1.y(), mButton1.height(), mButton1.height(), *mSkinButton1);// top button
+		r.drawImageRect(mButton2.x(), mButton2.y(), mButton2.height(), mButton2.height(), *mSkinButton2);// bottom button
 		//r.drawImageRect(mButtonUp.x(), mButtonUp.y(), mButtonUp.height(), mButtonUp.height(), mSkinButtonLeft);// top button
 
 		// Slider
@@ -390,13 +331,13 @@ void Slider::draw()
 
 		mSlider.x(mSlideBar.x());
 		mSlider.y(mSlideBar.y() + _thumbPosition);
-		r.drawImageRect(mSlider.x(), mSlider.y(), mSlider.width(), mSlider.height(), mSkinSlider);
+		r.drawImageRect(mSlider.x(), mSlider.y(), mSlider.width(), mSlider.height(), *mSkinSlider);
 	}
 	else
 	{
-		r.drawImageRect(mSlideBar.x(), mSlideBar.y(), mSlideBar.width(), mSlideBar.height(), mSkinMiddle);	// slide area
-		r.drawImageRect(mButton1.x(), mButton1.y(), mButton1.height(), mButton1.height(), mSkinButton1);	// left button
-		r.drawImageRect(mButton2.x(), mButton2.y(), mButton2.height(), mButton2.height(), mSkinButton2);	// right button
+		r.drawImageRect(mSlideBar.x(), mSlideBar.y(), mSlideBar.width(), mSlideBar.height(), *mSkinMiddle);	// slide area
+		r.drawImageRect(mButton1.x(), mButton1.y(), mButton1.height(), mButton1.height(), *mSkinButton1);	// left button
+		r.drawImageRect(mButton2.x(), mButton2.y(), mButton2.height(), mButton2.height(), *mSkinButton2);	// right button
 
 		// Slider
 		mSlider.height(mSlideBar.height());	// height = slide bar height
@@ -410,7 +351,7 @@ void Slider::draw()
 
 		mSlider.x(mSlideBar.x() + _thumbPosition);
 		mSlider.y(mSlideBar.y());
-		r.drawImageRect(mSlider.x(), mSlider.y(), mSlider.width(), mSlider.height(), mSkinSlider);
+		r.drawImageRect(mSlider.x(), mSlider.y(), mSlider.width(), mSlider.height(), *mSkinSlider);
 	}
 
 	if (mDisplayPosition && mMouseHoverSlide)
@@ -96,11 +96,11 @@ private:
 
 
 	// drawing vars
-	NAS2D::ImageList		mSkinButton1;				/*!< Skin for button 1 (Up or Left). */
-	NAS2D::ImageList		mSkinButton2;				/*!< Skin for button 2 (Down or Right). */
-	NAS2D::ImageList		mSkinMiddle;				/*!< Skin for the slide area. */
+	ImageManager::ImageListHandle		mSkinButton1;				/*!< Skin for button 1 (Up or Left). */
+	ImageManager::ImageListHandle		mSkinButton2;				/*!< Skin for button 2 (Down or Right). */
+	ImageManager::ImageListHandle		mSkinMiddle;				/*!< Skin for the slide area. */
 	
-	NAS2D::ImageList		mSkinSlider;				/*!< Skin for the slider. */
+	ImageManager::ImageListHandle		mSkinSlider;				/*!< Skin for the slider. */
 	bool					mDisplayPosition = false;	/*!< Indicate if the slider display the value on mouse over. */
 	
 	NAS2D::Rectangle_2df	mButton1;					/*!< Area on screen where the second button is displayed. (Down/Left) */
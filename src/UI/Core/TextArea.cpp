@@ -26,6 +26,17 @@ void TextArea::font(const std::string& font, size_t size)
 
 void TextArea::processString()
 {
+	// Size changes come in several at a time, only lay out text that changed.
+	if (text() == mLayoutText && width() == mLayoutWidth && mFont == mLayoutFont)
+	{
+		if (mFont) { mNumLines = static_cast<size_t>(height() / mFont->height()); }
+		return;
+	}
+
+	mLayoutText = text();
+	mLayoutWidth = width();
+	mLayoutFont = mFont;
+
 	mFormattedList.clear();
 
 	if (width() < 10 || !mFont || text().empty()) { return; }
@@ -38,7 +49,7 @@ void TextArea::processString()
 		std::string line;
 		while (w < width() && i < tokenList.size())
 		{
-			int tokenWidth = mFont->width(tokenList[i] + " ");
+			int tokenWidth = Utility<FontManager>::get().width(mFont, tokenList[i] + " ");
 			w += tokenWidth;
 			if (w >= width())
 			{
@@ -38,4 +38,8 @@ private:
 	NAS2D::Color_4ub	mTextColor = NAS2D::COLOR_WHITE;
 
 	NAS2D::Font*		mFont = nullptr;
+
+	std::string			mLayoutText;				/**< Text mFormattedList was laid out from. */
+	float				mLayoutWidth = 0.0f;		/**< Width mFormattedList was laid out for. */
+	NAS2D::Font*		mLayoutFont = nullptr;		/**< Font mFormattedList was laid out with. */
 };
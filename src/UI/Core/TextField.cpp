@@ -36,25 +36,9 @@ TextField::TextField()
 	hasFocus(true);
 	Utility<EventHandler>::get().textInputMode(true);
 
-	mSkinNormal.push_back(Image("ui/skin/textbox_top_left.png"));
-	mSkinNormal.push_back(Image("ui/skin/textbox_top_middle.png"));
-	mSkinNormal.push_back(Image("ui/skin/textbox_top_right.png"));
-	mSkinNormal.push_back(Image("ui/skin/textbox_middle_left.png"));
-	mSkinNormal.push_back(Image("ui/skin/textbox_middle_middle.png"));
-	mSkinNormal.push_back(Image("ui/skin/textbox_middle_right.png"));
-	mSkinNormal.push_back(Image("ui/skin/textbox_bottom_left.png"));
-	mSkinNormal.push_back(Image("ui/skin/textbox_bottom_middle.png"));
-	mSkinNormal.push_back(Image("ui/skin/textbox_bottom_right.png"));
-
-	mSkinFocus.push_back(Image("ui/skin/textbox_top_left_highlight.png"));
-	mSkinFocus.push_back(Image("ui/skin/textbox_top_middle_highlight.png"));
-	mSkinFocus.push_back(Image("ui/skin/textbox_top_right_highlight.png"));
-	mSkinFocus.push_back(Image("ui/skin/textbox_middle_left_highlight.png"));
-	mSkinFocus.push_back(Image("ui/skin/textbox_middle_middle_highlight.png"));
-	mSkinFocus.push_back(Image("ui/skin/textbox_middle_right_highlight.png"));
-	mSkinFocus.push_back(Image("ui/skin/textbox_bottom_left_highlight.png"));
-	mSkinFocus.push_back(Image("ui/skin/textbox_bottom_middle_highlight.png"));
-	mSkinFocus.push_back(Image("ui/skin/textbox_bottom_right_highlight.png"));
+	mSkinNormal = Utility<ImageManager>::get().skin("ui/skin/textbox");
+
+	mSkinFocus = Utility<ImageManager>::get().skin("ui/skin/textbox", "_highlight");
 
 	TXT_FONT = Utility<FontManager>::get().font(constants::FONT_PRIMARY, constants::FONT_PRIMARY_NORMAL);
 	height(static_cast<float>(TXT_FONT->height() + FIELD_PADDING * 2));
@@ -314,8 +298,8 @@ void TextField::update()
 
 	Renderer& r = Utility<Renderer>::get();
 
-	if (hasFocus() && editable()) { r.drawImageRect(rect().x(), rect().y(), rect().width(), rect().height(), mSkinFocus); }
-	else { r.drawImageRect(rect().x(), rect().y(), rect().width(), rect().height(), mSkinNormal); }
+	if (hasFocus() && editable()) { r.drawImageRect(rect().x(), rect().y(), rect().width(), rect().height(), *mSkinFocus); }
+	else { r.drawImageRect(rect().x(), rect().y(), rect().width(), rect().height(), *mSkinNormal); }
 
 	if (highlight()) { r.drawBox(rect(), 255, 255, 0); }
 
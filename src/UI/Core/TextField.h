@@ -10,6 +10,8 @@
 #include "NAS2D/NAS2D.h"
 #include "Control.h"
 
+#include "../../ImageManager.h"
+
 
 /**
  * \class TextField
@@ -76,8 +78,8 @@ private:
 
 	BorderVisibility	mBorderVisibility = FOCUS_ONLY;	/**< Border visibility flag. */
 
-	NAS2D::ImageList	mSkinNormal;
-	NAS2D::ImageList	mSkinFocus;
+	ImageManager::ImageListHandle	mSkinNormal;
+	ImageManager::ImageListHandle	mSkinFocus;
 
 	bool				mEditable = true;				/**< Toggle editing of the field. */
 	bool				mShowCursor = true;				/**< Flag indicating whether or not to draw the cursor. */
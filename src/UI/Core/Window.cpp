@@ -32,20 +32,8 @@ void Window::_init()
 
 	WINDOW_TITLE_FONT = Utility<FontManager>::get().font(constants::FONT_PRIMARY_BOLD, constants::FONT_PRIMARY_NORMAL);
 
-	mBody.push_back(Image("ui/skin/window_top_left.png"));
-	mBody.push_back(Image("ui/skin/window_top_middle.png"));
-	mBody.push_back(Image("ui/skin/window_top_right.png"));
-	mBody.push_back(Image("ui/skin/window_middle_left.png"));
-	mBody.push_back(Image("ui/skin/window_middle_middle.png"));
-	mBody.push_back(Image("ui/skin/window_middle_right.png"));
-	mBody.push_back(Image("ui/skin/window_bottom_left.png"));
-	mBody.push_back(Image("ui/skin/window_bottom_middle.png"));
-	mBody.push_back(Image("ui/skin/window_bottom_right.png"));
-
-
-	mTitle.push_back(Image("ui/skin/window_title_left.png"));
-	mTitle.push_back(Image("ui/skin/window_title_middle.png"));
-	mTitle.push_back(Image("ui/skin/window_title_right.png"));
+	mBody = Utility<ImageManager>::get().skin("ui/skin/window");
+	mTitle = Utility<ImageManager>::get().imageList({ "ui/skin/window_title_left.png", "ui/skin/window_title_middle.png", "ui/skin/window_title_right.png" });
 }
 
 
@@ -95,11 +83,11 @@ void Window::update()
 
 	Renderer& r = Utility<Renderer>::get();
 
-	r.drawImage(mTitle[0], rect().x(), rect().y());
-	r.drawImageRepeated(mTitle[1], rect().x() + 4, rect().y(), rect().width() - 8, WINDOW_TITLE_BAR_HEIGHT);
-	r.drawImage(mTitle[2], rect().x() + rect().width() - 4, rect().y());
+	r.drawImage((*mTitle)[0], rect().x(), rect().y());
+	r.drawImageRepeated((*mTitle)[1], rect().x() + 4, rect().y(), rect().width() - 8, WINDOW_TITLE_BAR_HEIGHT);
+	r.drawImage((*mTitle)[2], rect().x() + rect().width() - 4, rect().y());
 
-	r.drawImageRect(rect().x(), rect().y() + 20, rect().width(), rect().height() - 20, mBody);
+	r.drawImageRect(rect().x(), rect().y() + 20, rect().width(), rect().height() - 20, *mBody);
 
 	r.drawText(*WINDOW_TITLE_FONT, text(), rect().x() + 5, rect().y() + 2, 255, 255, 255);
 
@@ -2,6 +2,8 @@
 
 #include "UIContainer.h"
 
+#include "../../ImageManager.h"
+
 class Window : public UIContainer
 {
 public:
@@ -25,6 +27,6 @@ private:
 	bool				mMouseDrag = false;
 	bool				mAnchored = false;
 
-	NAS2D::ImageList	mTitle;
-	NAS2D::ImageList	mBody;
+	ImageManager::ImageListHandle	mTitle;
+	ImageManager::ImageListHandle	mBody;
 };
@@ -108,6 +108,21 @@ void WindowStack::hide()
 }
 
 
+/**
+ * Gets the windows that are shown, front most first.
+ */
+std::vector<Window*> WindowStack::visibleWindows() const
+{
+	std::vector<Window*> windows;
+	for (auto window : mWindowList)
+	{
+		if (window->visible()) { windows.push_back(window); }
+	}
+
+	return windows;
+}
+
+
 void WindowStack::update()
 {
 	for (auto it = mWindowList.rbegin(); it != mWindowList.rend(); ++it)
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <list>
+#include <vector>
 
 #include "Window.h"
 
@@ -23,6 +24,8 @@ public:
 
 	void hide();
 
+	std::vector<Window*> visibleWindows() const;
+
 	void update();
 
 private:
@@ -5,13 +5,14 @@
 
 #include "../Constants.h"
 #include "../FontManager.h"
+#include "../ImageManager.h"
 
 
 using namespace NAS2D;
 
 
 const int LIST_ITEM_HEIGHT = 58;
-Image* STRUCTURE_ICONS = nullptr;
+ImageRegion STRUCTURE_ICONS;
 
 static Font* MAIN_FONT = nullptr;
 static Font* MAIN_FONT_BOLD = nullptr;
@@ -31,7 +32,7 @@ static void drawItem(Renderer& r, FactoryListBox::FactoryListBoxItem& item, int
 	if (highlight) { r.drawBoxFilled(x, y - offset, w, LIST_ITEM_HEIGHT, STRUCTURE_COLOR->red(), STRUCTURE_COLOR->green(), STRUCTURE_COLOR->blue(), 75); }
 
 	r.drawBox(x + 2, y + 2 - offset, w - 4, LIST_ITEM_HEIGHT - 4, STRUCTURE_COLOR->red(), STRUCTURE_COLOR->green(), STRUCTURE_COLOR->blue(), STRUCTURE_COLOR->alpha());
-	r.drawSubImage(*STRUCTURE_ICONS, x + 8, y + 8 - offset, item.icon_slice.x(), item.icon_slice.y(), 46, 46, 255, 255, 255, STRUCTURE_COLOR->alpha());
+	STRUCTURE_ICONS.drawSub(r, x + 8, y + 8 - offset, item.icon_slice.x(), item.icon_slice.y(), 46, 46, 255, 255, 255, STRUCTURE_COLOR->alpha());
 
 	r.drawText(*MAIN_FONT_BOLD, f->name(), x + 64, ((y + 29) - MAIN_FONT_BOLD->height() / 2) - offset,
 				STRUCTURE_TEXT_COLOR->red(), STRUCTURE_TEXT_COLOR->green(), STRUCTURE_TEXT_COLOR->blue(), STRUCTURE_TEXT_COLOR->alpha());
@@ -59,14 +60,14 @@ FactoryListBox::FactoryListBox()
  */
 FactoryListBox::~FactoryListBox()
 {
-	delete STRUCTURE_ICONS;
+	STRUCTURE_ICONS.reset();
 }
 
 
 void FactoryListBox::_init()
 {
 	item_height(LIST_ITEM_HEIGHT);
-	STRUCTURE_ICONS = new Image("ui/structures.png");
+	STRUCTURE_ICONS = Utility<ImageManager>::get().region("ui/structures.png");
 	MAIN_FONT = Utility<FontManager>::get().font(constants::FONT_PRIMARY, 12);
 	MAIN_FONT_BOLD = Utility<FontManager>::get().font(constants::FONT_PRIMARY_BOLD, 12);
 }
@@ -3,6 +3,7 @@
 
 #include "FactoryProduction.h"
 
+#include "../CommandLog.h"
 #include "../Constants.h"
 #include "../FontManager.h"
 
@@ -11,6 +12,9 @@ using namespace NAS2D;
 static Font* FONT = nullptr;
 static Font* FONT_BOLD = nullptr;
 
+/** Number of production orders shown in the dialog. */
+const size_t QUEUE_LINES = 4;
+
 /**
  * 
  */
@@ -33,7 +37,7 @@ FactoryProduction::~FactoryProduction()
  */
 void FactoryProduction::init()
 {
-	size(320, 162);
+	size(320, 252);
 
 	// Set up GUI Layout
 	add(&mProductGrid, static_cast<float>(constants::MARGIN), 25);
@@ -45,17 +49,38 @@ void FactoryProduction::init()
 	mProductGrid.hide();
 	mProductGrid.selectionChanged().connect(this, &FactoryProduction::productSelectionChanged);
 
-	add(&btnOkay, 233, 138);
+	add(&txtAmount, 5, 140);
+	txtAmount.size(40, 20);
+	txtAmount.numbers_only(true);
+	txtAmount.maxCharacters(3);
+	txtAmount.text("1");
+
+	add(&btnQueue, 48, 140);
+	btnQueue.text("Queue");
+	btnQueue.size(45, 20);
+	btnQueue.click().connect(this, &FactoryProduction::btnQueueClicked);
+
+	add(&btnKeepStock, 96, 140);
+	btnKeepStock.text("Keep");
+	btnKeepStock.size(49, 20);
+	btnKeepStock.click().connect(this, &FactoryProduction::btnKeepStockClicked);
+
+	add(&btnClearQueue, mProductGrid.width() + 12, 140);
+	btnClearQueue.text("Clear Queue");
+	btnClearQueue.size(70, 20);
+	btnClearQueue.click().connect(this, &FactoryProduction::btnClearQueueClicked);
+
+	add(&btnOkay, 233, 228);
 	btnOkay.text("Okay");
 	btnOkay.size(40, 20);
 	btnOkay.click().connect(this, &FactoryProduction::btnOkayClicked);
 
-	add(&btnCancel, 276, 138);
+	add(&btnCancel, 276, 228);
 	btnCancel.text("Cancel");
 	btnCancel.size(40, 20);
 	btnCancel.click().connect(this, &FactoryProduction::btnCancelClicked);
 
-	add(&btnClearSelection, 5, 138);
+	add(&btnClearSelection, 5, 228);
 	btnClearSelection.text("Clear Selection");
 	btnClearSelection.size(mProductGrid.width(), 20);
 	btnClearSelection.click().connect(this, &FactoryProduction::btnClearSelectionClicked);
@@ -121,17 +146,70 @@ void FactoryProduction::productSelectionChanged(const IconGrid::IconGridItem* _i
  */
 void FactoryProduction::btnOkayClicked()
 {
-	mFactory->productType(mProduct);
+	btnApplyClicked();
 	hide();
 }
 
 
 /**
- * 
+ * Sets the selected product as the one to build over and over.
+ *
+ * \note	A factory with orders in its production queue keeps them. Continuous
+ *			production can only be set once the queue is cleared or used up.
  */
 void FactoryProduction::btnApplyClicked()
 {
+	if (!mFactory || (mFactory->queued() && !mFactory->productionQueue().empty())) { return; }
+
 	mFactory->productType(mProduct);
+	Utility<CommandLog>::get().record(COMMAND_PRODUCT_TYPE, mFactory, mProduct);
+}
+
+
+/**
+ * Adds an order for the selected product to the factory's production queue.
+ */
+void FactoryProduction::btnQueueClicked()
+{
+	if (!mFactory || mProduct == PRODUCT_NONE) { return; }
+
+	mFactory->queueProduct(mProduct, amount());
+	Utility<CommandLog>::get().record(COMMAND_QUEUE_PRODUCT, mFactory, queueProductCommandValue(mProduct, false, amount()));
+}
+
+
+/**
+ * Adds an order to keep the colony stocked with the selected product to the
+ * factory's production queue.
+ */
+void FactoryProduction::btnKeepStockClicked()
+{
+	if (!mFactory || mProduct == PRODUCT_NONE) { return; }
+
+	mFactory->queueStock(mProduct, amount());
+	Utility<CommandLog>::get().record(COMMAND_QUEUE_PRODUCT, mFactory, queueProductCommandValue(mProduct, true, amount()));
+}
+
+
+/**
+ * 
+ */
+void FactoryProduction::btnClearQueueClicked()
+{
+	if (!mFactory) { return; }
+
+	mFactory->clearQueue();
+	Utility<CommandLog>::get().record(COMMAND_CLEAR_PRODUCTION_QUEUE, mFactory, 0);
+}
+
+
+/**
+ * Gets the amount entered for a production order. Defaults to 1.
+ */
+int FactoryProduction::amount() const
+{
+	if (txtAmount.empty()) { return 1; }
+	return std::max(std::stoi(txtAmount.text()), 1);
 }
 
 
@@ -162,6 +240,7 @@ void FactoryProduction::chkIdleClicked()
 	if (!mFactory) { return; }
 	
 	mFactory->forceIdle(chkIdle.checked());
+	Utility<CommandLog>::get().record(COMMAND_FORCE_IDLE, mFactory, chkIdle.checked());
 }
 
 
@@ -234,4 +313,41 @@ void FactoryProduction::update()
 
 	r.drawText(*FONT_BOLD, "Rare Minerals:", rect().x() + constants::MARGIN * 2 + mProductGrid.width(), rect().y() + 75.0f, 255, 255, 255);
 	r.drawText(*FONT, string_format("%i", mProductCost.rareMinerals() * mProductCost.turnsToBuild()), rect().x() + constants::MARGIN * 2 + mProductGrid.width() + 120, rect().y() + 75.0f, 255, 255, 255);
+
+	drawQueue();
+}
+
+
+/**
+ * Draws the first few orders of the factory's production queue.
+ */
+void FactoryProduction::drawQueue()
+{
+	Renderer& r = Utility<Renderer>::get();
+
+	float x = rect().x() + constants::MARGIN;
+	float y = rect().y() + 165.0f;
+
+	const Factory::ProductionQueue& queue = mFactory->productionQueue();
+
+	r.drawText(*FONT_BOLD, "Production Queue:", x, y, 255, 255, 255);
+	if (queue.empty())
+	{
+		r.drawText(*FONT, mFactory->queued() ? "Finishing last order" : "Empty", x + 120, y, 255, 255, 255);
+		return;
+	}
+
+	for (size_t i = 0; i < queue.size() && i < QUEUE_LINES; ++i)
+	{
+		const Factory::ProductionOrder& order = queue[i];
+		y += 12.0f;
+
+		if (order.stock > 0) { r.drawText(*FONT, string_format("Keep %i %s", order.stock, productDescription(order.product).c_str()), x, y, 255, 255, 255); }
+		else { r.drawText(*FONT, string_format("Build %i %s", order.count, productDescription(order.product).c_str()), x, y, 255, 255, 255); }
+	}
+
+	if (queue.size() > QUEUE_LINES)
+	{
+		r.drawText(*FONT, string_format("and %i more", static_cast<int>(queue.size() - QUEUE_LINES)), x + 180, y, 255, 255, 255);
+	}
 }
@@ -30,8 +30,14 @@ private:
 	void btnClearSelectionClicked();
 	void chkIdleClicked();
 	void btnApplyClicked();
+	void btnQueueClicked();
+	void btnKeepStockClicked();
+	void btnClearQueueClicked();
 
 	void clearProduct();
+	int amount() const;
+
+	void drawQueue();
 
 	void productSelectionChanged(const IconGrid::IconGridItem*);
 
@@ -51,6 +57,11 @@ private:
 	Button				btnCancel;
 	Button				btnClearSelection;
 	Button				btnApply;
+	Button				btnQueue;
+	Button				btnKeepStock;
+	Button				btnClearQueue;
+
+	TextField			txtAmount;
 
 	CheckBox			chkIdle;
 
@@ -116,21 +116,7 @@ void FileIo::setMode(FileOperation _m)
  */
 void FileIo::scanDirectory(const std::string& _dir)
 {
-	Filesystem& f = Utility<Filesystem>::get();
-	StringList dirList = f.directoryList(_dir);
-
-	mListBox.dropAllItems();
-
-	for (size_t i = 0; i < dirList.size(); ++i)
-	{
-		if (!f.isDirectory(_dir + dirList[i]))
-		{
-			dirList[i].resize(dirList[i].size() - 4);	// Assumes a file save extension of 3 characters.
-														// This is a naive approach.
-			mListBox.addItem(dirList[i]);
-		}
-	}
-	mListBox.sort();
+	mListBox.scanDirectory(_dir);
 }
 
 
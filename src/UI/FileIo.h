@@ -1,6 +1,7 @@
 #pragma once
 
 #include "UI.h"
+#include "SaveGameListBox.h"
 
 
 class FileIo : public Window
@@ -52,5 +53,5 @@ private:
 
 	TextField				txtFileName;
 
-	ListBox					mListBox;
+	SaveGameListBox			mListBox;
 };
@@ -19,15 +19,7 @@ IconGrid::IconGrid()
 	Utility<EventHandler>::get().mouseMotion().connect(this, &IconGrid::onMouseMotion);
 	hasFocus(true);
 
-	mSkin.push_back(Image("ui/skin/textbox_top_left.png"));
-	mSkin.push_back(Image("ui/skin/textbox_top_middle.png"));
-	mSkin.push_back(Image("ui/skin/textbox_top_right.png"));
-	mSkin.push_back(Image("ui/skin/textbox_middle_left.png"));
-	mSkin.push_back(Image("ui/skin/textbox_middle_middle.png"));
-	mSkin.push_back(Image("ui/skin/textbox_middle_right.png"));
-	mSkin.push_back(Image("ui/skin/textbox_bottom_left.png"));
-	mSkin.push_back(Image("ui/skin/textbox_bottom_middle.png"));
-	mSkin.push_back(Image("ui/skin/textbox_bottom_right.png"));
+	mSkin = Utility<ImageManager>::get().skin("ui/skin/textbox");
 
 	FONT = Utility<FontManager>::get().font(constants::FONT_PRIMARY, constants::FONT_PRIMARY_NORMAL);
 }
@@ -48,7 +40,7 @@ IconGrid::~IconGrid()
  */
 void IconGrid::sheetPath(const std::string& _path)
 {
-	mIconSheet = Image(_path);
+	mIconSheet = Utility<ImageManager>::get().region(_path);
 }
 
 
@@ -187,8 +179,9 @@ void IconGrid::addItemSorted(const std::string& name, int sheetIndex, int meta)
  */
 void IconGrid::addItem(const std::string& name, int sheetIndex, int meta)
 {
-	int x_pos = (sheetIndex % (mIconSheet.width() / mIconSize)) * mIconSize;
-	int y_pos = (sheetIndex / (mIconSheet.width() / mIconSize)) * mIconSize;
+	int columns = static_cast<int>(mIconSheet.width()) / mIconSize;
+	int x_pos = (sheetIndex % columns) * mIconSize;
+	int y_pos = (sheetIndex / columns) * mIconSize;
 
 	mIconItemList.push_back(IconGridItem());
 
@@ -407,7 +400,7 @@ void IconGrid::update()
 	Renderer& r = Utility<Renderer>::get();
 
 	//r.drawBoxFilled(rect(), 0, 0, 0);
-	r.drawImageRect(rect().x(), rect().y(), rect().width(), rect().height(), mSkin);
+	r.drawImageRect(rect().x(), rect().y(), rect().width(), rect().height(), *mSkin);
 
 	if (mIconItemList.empty()) { return; }
 
@@ -420,9 +413,9 @@ void IconGrid::update()
 		float y = static_cast<float>((rect().y() + mIconMargin) + (y_pos * mIconSize) + (mIconMargin * y_pos));
 
 		if (mIconItemList[i].available)
-			r.drawSubImage(mIconSheet, x, y, mIconItemList[i].pos.x(), mIconItemList[i].pos.y(), static_cast<float>(mIconSize), static_cast<float>(mIconSize));
+			mIconSheet.drawSub(r, x, y, mIconItemList[i].pos.x(), mIconItemList[i].pos.y(), static_cast<float>(mIconSize), static_cast<float>(mIconSize));
 		else
-			r.drawSubImage(mIconSheet, x, y, mIconItemList[i].pos.x(), mIconItemList[i].pos.y(), static_cast<float>(mIconSize), static_cast<float>(mIconSize), 255, 0, 0, 255);
+			mIconSheet.drawSub(r, x, y, mIconItemList[i].pos.x(), mIconItemList[i].pos.y(), static_cast<float>(mIconSize), static_cast<float>(mIconSize), 255, 0, 0, 255);
 	}
 
 	if (mCurrentSelection != constants::NO_SELECTION)
@@ -2,6 +2,8 @@
 
 #include "UI.h"
 
+#include "../ImageManager.h"
+
 #include <algorithm>
 
 /**
@@ -108,9 +110,9 @@ private:
 	bool				mShowTooltip = false;		/**< Flag indicating that we want a tooltip drawn near an icon when hovering over it. */
 	bool				mSorted = true;			/**< Flag indicating that the IconGrid should be sorted. */
 
-	NAS2D::Image		mIconSheet;					/**< Image containing the icons. */
+	ImageRegion						mIconSheet;					/**< Image containing the icons. */
 
-	NAS2D::ImageList	mSkin;
+	ImageManager::ImageListHandle	mSkin;
 
 	NAS2D::Point_2d		mGridSize;					/**< Dimensions of the grid that can be contained in the IconGrid with the current Icon Size and Icon Margin. */
 
@@ -3,6 +3,7 @@
 
 #include "MineOperationsWindow.h"
 
+#include "../CommandLog.h"
 #include "../Constants.h"
 #include "../FontManager.h"
 
@@ -54,7 +55,9 @@ const int				RARE_MINERALS_POS = 312;
 /**
  * 
  */
-MineOperationsWindow::MineOperationsWindow() : mUiIcon("ui/interface/mine.png"), mIcons("ui/icons.png")
+MineOperationsWindow::MineOperationsWindow() :
+	mUiIcon(Utility<ImageManager>::get().region("ui/interface/mine.png")),
+	mIcons(Utility<ImageManager>::get().region("ui/icons.png"))
 {
 	text(constants::WINDOW_MINE_OPERATIONS);
 	init();
@@ -109,15 +112,7 @@ void MineOperationsWindow::init()
 	chkRareMinerals.text("Rare Minerals");
 	chkRareMinerals.click().connect(this, &MineOperationsWindow::chkRareMineralsClicked);
 
-	mPanel.push_back(Image("ui/skin/textbox_top_left.png"));
-	mPanel.push_back(Image("ui/skin/textbox_top_middle.png"));
-	mPanel.push_back(Image("ui/skin/textbox_top_right.png"));
-	mPanel.push_back(Image("ui/skin/textbox_middle_left.png"));
-	mPanel.push_back(Image("ui/skin/textbox_middle_middle.png"));
-	mPanel.push_back(Image("ui/skin/textbox_middle_right.png"));
-	mPanel.push_back(Image("ui/skin/textbox_bottom_left.png"));
-	mPanel.push_back(Image("ui/skin/textbox_bottom_middle.png"));
-	mPanel.push_back(Image("ui/skin/textbox_bottom_right.png"));
+	mPanel = Utility<ImageManager>::get().skin("ui/skin/textbox");
 
 	FONT = Utility<FontManager>::get().font(constants::FONT_PRIMARY, constants::FONT_PRIMARY_NORMAL);
 	FONT_BOLD = Utility<FontManager>::get().font(constants::FONT_PRIMARY_BOLD, constants::FONT_PRIMARY_NORMAL);
@@ -206,6 +201,7 @@ void MineOperationsWindow::btnOkayClicked()
 void MineOperationsWindow::btnExtendShaftClicked()
 {
 	mFacility->extend();
+	Utility<CommandLog>::get().record(COMMAND_EXTEND_MINE, mFacility, 0);
 	btnExtendShaft.enabled(false);
 	updateCounts();
 }
@@ -217,6 +213,7 @@ void MineOperationsWindow::btnExtendShaftClicked()
 void MineOperationsWindow::btnIdleClicked()
 {
 	mFacility->forceIdle(btnIdle.toggled());
+	Utility<CommandLog>::get().record(COMMAND_FORCE_IDLE, mFacility, btnIdle.toggled());
 }
 
 
@@ -226,6 +223,7 @@ void MineOperationsWindow::btnIdleClicked()
 void MineOperationsWindow::chkCommonMetalsClicked()
 {
 	mFacility->mine()->miningCommonMetals(chkCommonMetals.checked());
+	Utility<CommandLog>::get().record(COMMAND_MINE_ORE, mFacility, (Mine::ORE_COMMON_METALS << 1) | (chkCommonMetals.checked() ? 1 : 0));
 }
 
 
@@ -235,6 +233,7 @@ void MineOperationsWindow::chkCommonMetalsClicked()
 void MineOperationsWindow::chkCommonMineralsClicked()
 {
 	mFacility->mine()->miningCommonMinerals(chkCommonMinerals.checked());
+	Utility<CommandLog>::get().record(COMMAND_MINE_ORE, mFacility, (Mine::ORE_COMMON_MINERALS << 1) | (chkCommonMinerals.checked() ? 1 : 0));
 }
 
 
@@ -244,6 +243,7 @@ void MineOperationsWindow::chkCommonMineralsClicked()
 void MineOperationsWindow::chkRareMetalsClicked()
 {
 	mFacility->mine()->miningRareMetals(chkRareMetals.checked());
+	Utility<CommandLog>::get().record(COMMAND_MINE_ORE, mFacility, (Mine::ORE_RARE_METALS << 1) | (chkRareMetals.checked() ? 1 : 0));
 }
 
 
@@ -253,6 +253,7 @@ void MineOperationsWindow::chkRareMetalsClicked()
 void MineOperationsWindow::chkRareMineralsClicked()
 {
 	mFacility->mine()->miningRareMinerals(chkRareMinerals.checked());
+	Utility<CommandLog>::get().record(COMMAND_MINE_ORE, mFacility, (Mine::ORE_RARE_MINERALS << 1) | (chkRareMinerals.checked() ? 1 : 0));
 }
 
 
@@ -267,7 +268,7 @@ void MineOperationsWindow::update()
 
 	Renderer& r = Utility<Renderer>::get();
 
-	r.drawImage(mUiIcon, rect().x() + 10, rect().y() + 30);
+	mUiIcon.draw(r, rect().x() + 10, rect().y() + 30);
 
 	r.drawText(*FONT_BOLD, "Mine Yield:", rect().x() + MINE_YIELD_POSITION, rect().y() + 30, 255, 255, 255);
 	r.drawText(*FONT, MINE_YIELD, rect().x() + MINE_YIELD_DESCRIPTION_POSITION, rect().y() + 30, 255, 255, 255);
@@ -292,7 +293,7 @@ void MineOperationsWindow::update()
 	// REMAINING ORE PANEL
 	r.drawText(*FONT_BOLD, "Remaining Resources", rect().x() + 10, rect().y() + 164, 255, 255, 255);
 
-	r.drawImageRect(rect().x() + 10, rect().y() + 180, rect().width() - 20, 40, mPanel);
+	r.drawImageRect(rect().x() + 10, rect().y() + 180, rect().width() - 20, 40, *mPanel);
 
 	r.drawLine(rect().x() + 98, rect().y() + 180, rect().x() + 98, rect().y() + 219, 22, 22, 22);
 	r.drawLine(rect().x() + 187, rect().y() + 180, rect().x() + 187, rect().y() + 219, 22, 22, 22);
@@ -300,10 +301,10 @@ void MineOperationsWindow::update()
 	
 	r.drawLine(rect().x() + 11, rect().y() + 200, rect().x() + rect().width() - 11, rect().y() + 200, 22, 22, 22);
 
-	r.drawSubImage(mIcons, rect().x() + COMMON_METALS_POS, rect().y() + 183, 64, 0, 16, 16);
-	r.drawSubImage(mIcons, rect().x() + COMMON_MINERALS_POS, rect().y() + 183, 96, 0, 16, 16);
-	r.drawSubImage(mIcons, rect().x() + RARE_METALS_POS, rect().y() + 183, 80, 0, 16, 16);
-	r.drawSubImage(mIcons, rect().x() + RARE_MINERALS_POS, rect().y() + 183, 112, 0, 16, 16);
+	mIcons.drawSub(r, rect().x() + COMMON_METALS_POS, rect().y() + 183, 64, 0, 16, 16);
+	mIcons.drawSub(r, rect().x() + COMMON_MINERALS_POS, rect().y() + 183, 96, 0, 16, 16);
+	mIcons.drawSub(r, rect().x() + RARE_METALS_POS, rect().y() + 183, 80, 0, 16, 16);
+	mIcons.drawSub(r, rect().x() + RARE_MINERALS_POS, rect().y() + 183, 112, 0, 16, 16);
 
 	r.drawText(*FONT, COMMON_METALS_COUNT, rect().x() + COMMON_METALS_ORE_POSITION, rect().y() + 202, 255, 255, 255);
 	r.drawText(*FONT, COMMON_MINERALS_COUNT, rect().x() + COMMON_MINERALS_ORE_POSITION, rect().y() + 202, 255, 255, 255);
@@ -2,6 +2,7 @@
 
 #include "UI.h"
 
+#include "../ImageManager.h"
 #include "../Mine.h"
 #include "../Things/Structures/MineFacility.h"
 
@@ -43,10 +44,10 @@ private:
 private:
 	MineFacility*		mFacility = nullptr;
 
-	NAS2D::Image		mUiIcon;
-	NAS2D::Image		mIcons;
+	ImageRegion						mUiIcon;
+	ImageRegion						mIcons;
 
-	NAS2D::ImageList	mPanel;
+	ImageManager::ImageListHandle	mPanel;
 
 	CheckBox			chkCommonMetals;
 	CheckBox			chkCommonMinerals;
@@ -3,6 +3,7 @@
 
 #include "PopulationPanel.h"
 
+#include "../Common.h"
 #include "../Constants.h"
 #include "../FontManager.h"
 
@@ -10,19 +11,17 @@ using namespace NAS2D;
 
 static Font* FONT = nullptr;
 
-PopulationPanel::PopulationPanel() : mIcons("ui/icons.png")
+PopulationPanel::PopulationPanel() :
+	mIcons(Utility<ImageManager>::get().region("ui/icons.png")),
+	mMoraleText("Morale: %i"),
+	mPreviousMoraleText("Previous: %i"),
+	mHousingText("Housing: %i / %i  (%i%%)"),
+	mForecastText("In %i turns: %i"),
+	mRoleText{{ FormattedText("%i"), FormattedText("%i"), FormattedText("%i"), FormattedText("%i"), FormattedText("%i") }}
 {
-	size(160, 220);
-
-	mSkin.push_back(Image("ui/skin/window_top_left.png"));
-	mSkin.push_back(Image("ui/skin/window_top_middle.png"));
-	mSkin.push_back(Image("ui/skin/window_top_right.png"));
-	mSkin.push_back(Image("ui/skin/window_middle_left.png"));
-	mSkin.push_back(Image("ui/skin/window_middle_middle.png"));
-	mSkin.push_back(Image("ui/skin/window_middle_right.png"));
-	mSkin.push_back(Image("ui/skin/window_bottom_left.png"));
-	mSkin.push_back(Image("ui/skin/window_bottom_middle.png"));
-	mSkin.push_back(Image("ui/skin/window_bottom_right.png"));
+	size(160, 270);
+
+	mSkin = Utility<ImageManager>::get().skin("ui/skin/window");
 
 	FONT = Utility<FontManager>::get().font(constants::FONT_PRIMARY, constants::FONT_PRIMARY_NORMAL);
 }
@@ -31,24 +30,37 @@ PopulationPanel::PopulationPanel() : mIcons("ui/icons.png")
 void PopulationPanel::update()
 {
 	Renderer& r = Utility<Renderer>::get();
-	r.drawImageRect(rect().x(), rect().y(), rect().width(), rect().height(), mSkin);
+	r.drawImageRect(rect().x(), rect().y(), rect().width(), rect().height(), *mSkin);
 
-	r.drawText(*FONT, string_format("Morale: %i", *mMorale), positionX() + 5, positionY() + 5, 255, 255, 255);
-	r.drawText(*FONT, string_format("Previous: %i", *mPreviousMorale), positionX() + 5, positionY() + 15, 255, 255, 255);
+	r.drawText(*FONT, mMoraleText(*mMorale), positionX() + 5, positionY() + 5, 255, 255, 255);
+	r.drawText(*FONT, mPreviousMoraleText(*mPreviousMorale), positionX() + 5, positionY() + 15, 255, 255, 255);
 
 	mCapacity = (mResidentialCapacity > 0) ? (static_cast<float>(mPopulation->size()) / static_cast<float>(mResidentialCapacity)) * 100.0f : 0.0f;
 	
-	r.drawText(*FONT, string_format("Housing: %i / %i  (%i%%)", mPopulation->size(), mResidentialCapacity, static_cast<int>(mCapacity)), positionX() + 5, positionY() + 30, 255, 255, 255);
-
-	r.drawSubImage(mIcons, positionX() + 5, positionY() + 45, 0, 96, 32, 32);		// Infant
-	r.drawSubImage(mIcons, positionX() + 5, positionY() + 79, 32, 96, 32, 32);		// Student
-	r.drawSubImage(mIcons, positionX() + 5, positionY() + 113, 64, 96, 32, 32);		// Worker
-	r.drawSubImage(mIcons, positionX() + 5, positionY() + 147, 96, 96, 32, 32);		// Scientist
-	r.drawSubImage(mIcons, positionX() + 5, positionY() + 181, 128, 96, 32, 32);	// Retired
-
-	r.drawText(*FONT, string_format("%i", mPopulation->size(Population::ROLE_CHILD)), positionX() + 42, positionY() + 65, 255, 255, 255);
-	r.drawText(*FONT, string_format("%i", mPopulation->size(Population::ROLE_STUDENT)), positionX() + 42, positionY() + 97, 255, 255, 255);
-	r.drawText(*FONT, string_format("%i", mPopulation->size(Population::ROLE_WORKER)), positionX() + 42, positionY() + 129, 255, 255, 255);
-	r.drawText(*FONT, string_format("%i", mPopulation->size(Population::ROLE_SCIENTIST)), positionX() + 42, positionY() + 160, 255, 255, 255);
-	r.drawText(*FONT, string_format("%i", mPopulation->size(Population::ROLE_RETIRED)), positionX() + 42, positionY() + 193, 255, 255, 255);
+	r.drawText(*FONT, mHousingText(mPopulation->size(), mResidentialCapacity, static_cast<int>(mCapacity)), positionX() + 5, positionY() + 30, 255, 255, 255);
+
+	mIcons.drawSub(r, positionX() + 5, positionY() + 45, 0, 96, 32, 32);		// Infant
+	mIcons.drawSub(r, positionX() + 5, positionY() + 79, 32, 96, 32, 32);		// Student
+	mIcons.drawSub(r, positionX() + 5, positionY() + 113, 64, 96, 32, 32);		// Worker
+	mIcons.drawSub(r, positionX() + 5, positionY() + 147, 96, 96, 32, 32);		// Scientist
+	mIcons.drawSub(r, positionX() + 5, positionY() + 181, 128, 96, 32, 32);	// Retired
+
+	r.drawText(*FONT, mRoleText[Population::ROLE_CHILD](mPopulation->size(Population::ROLE_CHILD)), positionX() + 42, positionY() + 65, 255, 255, 255);
+	r.drawText(*FONT, mRoleText[Population::ROLE_STUDENT](mPopulation->size(Population::ROLE_STUDENT)), positionX() + 42, positionY() + 97, 255, 255, 255);
+	r.drawText(*FONT, mRoleText[Population::ROLE_WORKER](mPopulation->size(Population::ROLE_WORKER)), positionX() + 42, positionY() + 129, 255, 255, 255);
+	r.drawText(*FONT, mRoleText[Population::ROLE_SCIENTIST](mPopulation->size(Population::ROLE_SCIENTIST)), positionX() + 42, positionY() + 160, 255, 255, 255);
+	r.drawText(*FONT, mRoleText[Population::ROLE_RETIRED](mPopulation->size(Population::ROLE_RETIRED)), positionX() + 42, positionY() + 193, 255, 255, 255);
+
+	if (!mForecast) { return; }
+
+	Forecast::Result forecast = mForecast->result();
+	if (forecast.population.empty())
+	{
+		r.drawText(*FONT, "Forecasting...", positionX() + 5, positionY() + 220, 150, 150, 150);
+		return;
+	}
+
+	Color_4ub color = forecast.population.back() < forecast.population.front() ? Color_4ub(255, 0, 0, 255) : Color_4ub(0, 185, 0, 255);
+	r.drawText(*FONT, mForecastText(constants::FORECAST_TURNS, forecast.population.back()), positionX() + 5, positionY() + 220, color.red(), color.green(), color.blue());
+	drawTrendLine(forecast.population, positionX() + 5.0f, positionY() + 234.0f, width() - 10.0f, 30.0f, color);
 }
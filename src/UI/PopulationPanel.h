@@ -2,6 +2,9 @@
 
 #include "UI.h"
 
+#include "../Forecast.h"
+#include "../FormattedText.h"
+#include "../ImageManager.h"
 #include "../Population/Population.h"
 
 class PopulationPanel: public Control
@@ -12,6 +15,7 @@ public:
 	virtual ~PopulationPanel() = default;
 
 	void population(Population* pop) { mPopulation = pop; }
+	void forecast(Forecast* forecast) { mForecast = forecast; }
 	void morale(int* m) { mMorale = m; }
 	void old_morale(int* m) { mPreviousMorale = m; }
 
@@ -28,10 +32,11 @@ public:
 protected:
 
 private:
-	NAS2D::Image		mIcons;
-	NAS2D::ImageList	mSkin;
+	ImageRegion						mIcons;
+	ImageManager::ImageListHandle	mSkin;
 
 	Population*			mPopulation = nullptr;
+	Forecast*			mForecast = nullptr;
 
 	int					mResidentialCapacity = 0;
 
@@ -39,4 +44,11 @@ private:
 	int*				mPreviousMorale = nullptr;
 
 	float				mCapacity = 0.0f;
+
+	// Labels, formatted again only when their values change.
+	FormattedText					mMoraleText;
+	FormattedText					mPreviousMoraleText;
+	FormattedText					mHousingText;
+	FormattedText					mForecastText;
+	std::array<FormattedText, 5>	mRoleText;				/**< Colonists by role, indexed by Population::PersonRole. */
 };
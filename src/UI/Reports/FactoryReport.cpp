@@ -3,14 +3,18 @@
 
 #include "FactoryReport.h"
 
+#include "../../CommandLog.h"
 #include "../../Constants.h"
 #include "../../FontManager.h"
+#include "../../ImageManager.h"
+#include "../../ProductionPlanner.h"
 #include "../../StructureManager.h"
 
 #include "../../Things/Structures/SurfaceFactory.h"
 #include "../../Things/Structures/SeedFactory.h"
 #include "../../Things/Structures/UndergroundFactory.h"
 
+#include <algorithm>
 #include <array>
 
 using namespace NAS2D;
@@ -31,13 +35,13 @@ static Font* FONT_BIG_BOLD = nullptr;
 
 static Factory* SELECTED_FACTORY = nullptr;
 
-static Image* FACTORY_SEED = nullptr;
-static Image* FACTORY_AG = nullptr;
-static Image* FACTORY_UG = nullptr;
-static Image* FACTORY_IMAGE = nullptr;
+static ImageRegion FACTORY_SEED;
+static ImageRegion FACTORY_AG;
+static ImageRegion FACTORY_UG;
+static ImageRegion FACTORY_IMAGE;
 
-std::array<Image*, PRODUCT_COUNT> PRODUCT_IMAGE_ARRAY;
-static Image* _PRODUCT_NONE = nullptr;
+std::array<ImageRegion, PRODUCT_COUNT> PRODUCT_IMAGE_ARRAY;
+static ImageRegion _PRODUCT_NONE;
 
 static std::string FACTORY_STATUS;
 static const std::string RESOURCES_REQUIRED = "Resources Required";
@@ -59,14 +63,15 @@ FactoryReport::FactoryReport()
  */
 FactoryReport::~FactoryReport()
 {
-	delete FACTORY_SEED;
-	delete FACTORY_AG;
-	delete FACTORY_UG;
-	delete _PRODUCT_NONE;
+	FACTORY_SEED.reset();
+	FACTORY_AG.reset();
+	FACTORY_UG.reset();
+	FACTORY_IMAGE.reset();
+	_PRODUCT_NONE.reset();
 
 	SELECTED_FACTORY = nullptr;
 
-	for (auto img : PRODUCT_IMAGE_ARRAY) { delete img; }
+	for (auto& img : PRODUCT_IMAGE_ARRAY) { img.reset(); }
 }
 
 
@@ -84,23 +89,23 @@ void FactoryReport::init()
 	FONT_BIG = Utility<FontManager>::get().font(constants::FONT_PRIMARY, constants::FONT_PRIMARY_HUGE);
 	FONT_BIG_BOLD = Utility<FontManager>::get().font(constants::FONT_PRIMARY_BOLD, constants::FONT_PRIMARY_HUGE);
 
-	FACTORY_SEED	= new Image("ui/interface/factory_seed.png");
-	FACTORY_AG		= new Image("ui/interface/factory_ag.png");
-	FACTORY_UG		= new Image("ui/interface/factory_ug.png");
+	FACTORY_SEED	= Utility<ImageManager>::get().region("ui/interface/factory_seed.png");
+	FACTORY_AG		= Utility<ImageManager>::get().region("ui/interface/factory_ag.png");
+	FACTORY_UG		= Utility<ImageManager>::get().region("ui/interface/factory_ug.png");
 
 	/// \todo Decide if this is the best place to have these images live or if it should be done at program start.
-	PRODUCT_IMAGE_ARRAY.fill(nullptr);
-	PRODUCT_IMAGE_ARRAY[PRODUCT_DIGGER]				= new Image("ui/interface/product_robodigger.png");
-	PRODUCT_IMAGE_ARRAY[PRODUCT_DOZER]				= new Image("ui/interface/product_robodozer.png");
-	PRODUCT_IMAGE_ARRAY[PRODUCT_MINER]				= new Image("ui/interface/product_robominer.png");
-	PRODUCT_IMAGE_ARRAY[PRODUCT_EXPLORER]			= new Image("ui/interface/product_roboexplorer.png");
-	PRODUCT_IMAGE_ARRAY[PRODUCT_TRUCK]				= new Image("ui/interface/product_truck.png");
-	PRODUCT_IMAGE_ARRAY[PRODUCT_ROAD_MATERIALS]		= new Image("ui/interface/product_road_materials.png");
-	PRODUCT_IMAGE_ARRAY[PRODUCT_MAINTENANCE_PARTS]	= new Image("ui/interface/product_maintenance_parts.png");
-	PRODUCT_IMAGE_ARRAY[PRODUCT_CLOTHING]			= new Image("ui/interface/product_clothing.png");
-	PRODUCT_IMAGE_ARRAY[PRODUCT_MEDICINE]			= new Image("ui/interface/product_medicine.png");
-
-	_PRODUCT_NONE = new Image("ui/interface/product_none.png");
+	PRODUCT_IMAGE_ARRAY.fill(ImageRegion());
+	PRODUCT_IMAGE_ARRAY[PRODUCT_DIGGER]				= Utility<ImageManager>::get().region("ui/interface/product_robodigger.png");
+	PRODUCT_IMAGE_ARRAY[PRODUCT_DOZER]				= Utility<ImageManager>::get().region("ui/interface/product_robodozer.png");
+	PRODUCT_IMAGE_ARRAY[PRODUCT_MINER]				= Utility<ImageManager>::get().region("ui/interface/product_robominer.png");
+	PRODUCT_IMAGE_ARRAY[PRODUCT_EXPLORER]			= Utility<ImageManager>::get().region("ui/interface/product_roboexplorer.png");
+	PRODUCT_IMAGE_ARRAY[PRODUCT_TRUCK]				= Utility<ImageManager>::get().region("ui/interface/product_truck.png");
+	PRODUCT_IMAGE_ARRAY[PRODUCT_ROAD_MATERIALS]		= Utility<ImageManager>::get().region("ui/interface/product_road_materials.png");
+	PRODUCT_IMAGE_ARRAY[PRODUCT_MAINTENANCE_PARTS]	= Utility<ImageManager>::get().region("ui/interface/product_maintenance_parts.png");
+	PRODUCT_IMAGE_ARRAY[PRODUCT_CLOTHING]			= Utility<ImageManager>::get().region("ui/interface/product_clothing.png");
+	PRODUCT_IMAGE_ARRAY[PRODUCT_MEDICINE]			= Utility<ImageManager>::get().region("ui/interface/product_medicine.png");
+
+	_PRODUCT_NONE = Utility<ImageManager>::get().region("ui/interface/product_none.png");
 
 	add(&lstFactoryList, 10, 63);
 	lstFactoryList.selectionChanged().connect(this, &FactoryReport::lstFactoryListSelectionChanged);
@@ -164,6 +169,28 @@ void FactoryReport::init()
 	btnApply.text("Apply");
 	btnApply.click().connect(this, &FactoryReport::btnApplyClicked);
 
+	add(&btnPlanner, position_x, 155);
+	btnPlanner.type(Button::BUTTON_TOGGLE);
+	btnPlanner.size(140, 30);
+	btnPlanner.text("Production Planner");
+	btnPlanner.click().connect(this, &FactoryReport::btnPlannerClicked);
+
+	add(&btnApplyPlan, 0, 0);
+	btnApplyPlan.size(140, 30);
+	btnApplyPlan.text("Apply Plan");
+	btnApplyPlan.click().connect(this, &FactoryReport::btnApplyPlanClicked);
+	btnApplyPlan.hide();
+
+	for (auto& txtTarget : txtTargets)
+	{
+		add(&txtTarget, 0, 0);
+		txtTarget.size(50, 18);
+		txtTarget.numbers_only(true);
+		txtTarget.maxCharacters(4);
+		txtTarget.textChanged().connect(this, &FactoryReport::txtTargetChanged);
+		txtTarget.hide();
+	}
+
 	add(&cboFilterByProduct, 250, 33);
 	cboFilterByProduct.size(200, 20);
 
@@ -306,7 +333,7 @@ void FactoryReport::fillFactoryList(Structure::StructureState state)
  */
 void FactoryReport::checkFactoryActionControls()
 {
-	bool actionControlVisible = !lstFactoryList.empty();
+	bool actionControlVisible = !lstFactoryList.empty() && !btnPlanner.toggled();
 
 	btnIdle.visible(actionControlVisible);
 	btnClearProduction.visible(actionControlVisible);
@@ -314,7 +341,28 @@ void FactoryReport::checkFactoryActionControls()
 	btnApply.visible(actionControlVisible);
 	lstProducts.visible(actionControlVisible);
 
-	if (actionControlVisible) { lstFactoryList.setSelection(0); }
+	if (!lstFactoryList.empty()) { lstFactoryList.setSelection(0); }
+}
+
+
+/**
+ * Sets visibility for the production planner controls and fills in the
+ * targets when the planner is shown.
+ */
+void FactoryReport::checkPlannerControls()
+{
+	bool plannerVisible = btnPlanner.toggled();
+
+	btnApplyPlan.visible(plannerVisible);
+
+	const ProductPool::ProductTypeCount& targets = Utility<ProductionPlanner>::get().targets();
+	for (size_t i = 0; i < txtTargets.size(); ++i)
+	{
+		txtTargets[i].visible(plannerVisible);
+
+		int target = targets[PRODUCT_TYPES[i]];
+		if (plannerVisible) { txtTargets[i].text(target > 0 ? std::to_string(target) : ""); }
+	}
 }
 
 
@@ -341,8 +389,15 @@ void FactoryReport::resized(Control* c)
 	btnIdle.position(position_x, btnIdle.positionY());
 	btnClearProduction.position(position_x, btnClearProduction.positionY());
 	btnTakeMeThere.position(position_x, btnTakeMeThere.positionY());
+	btnPlanner.position(position_x, btnPlanner.positionY());
 
 	btnApply.position(position_x, rect().height() + 8);
+	btnApplyPlan.position(position_x, rect().height() + 8);
+
+	for (size_t i = 0; i < txtTargets.size(); ++i)
+	{
+		txtTargets[i].position(DETAIL_PANEL.x() + 210, DETAIL_PANEL.y() + 190 + static_cast<int>(i) * 22);
+	}
 
 	lstProducts.size(DETAIL_PANEL.width() / 3, DETAIL_PANEL.height() - 219);
 	lstProducts.selectionChanged().connect(this, &FactoryReport::lstProductsSelectionChanged);
@@ -358,10 +413,12 @@ void FactoryReport::resized(Control* c)
  */
 void FactoryReport::visibilityChanged(bool visible)
 {
+	if (visible) { checkPlannerControls(); }
+
 	if (!SELECTED_FACTORY) { return; }
 
 	Structure::StructureState _state = SELECTED_FACTORY->state();
-	btnApply.visible(visible && (_state == Structure::OPERATIONAL || _state == Structure::IDLE));
+	btnApply.visible(visible && !btnPlanner.toggled() && (_state == Structure::OPERATIONAL || _state == Structure::IDLE));
 	checkFactoryActionControls();
 }
 
@@ -455,6 +512,7 @@ void FactoryReport::btnShowDisabledClicked()
 void FactoryReport::btnIdleClicked()
 {
 	SELECTED_FACTORY->forceIdle(btnIdle.toggled());
+	Utility<CommandLog>::get().record(COMMAND_FORCE_IDLE, SELECTED_FACTORY, btnIdle.toggled());
 	FACTORY_STATUS = structureStateDescription(SELECTED_FACTORY->state());
 }
 
@@ -465,6 +523,7 @@ void FactoryReport::btnIdleClicked()
 void FactoryReport::btnClearProductionClicked()
 {
 	SELECTED_FACTORY->productType(PRODUCT_NONE);
+	Utility<CommandLog>::get().record(COMMAND_PRODUCT_TYPE, SELECTED_FACTORY, PRODUCT_NONE);
 	lstProducts.clearSelection();
 	cboFilterByProductSelectionChanged();
 }
@@ -485,10 +544,66 @@ void FactoryReport::btnTakeMeThereClicked()
 void FactoryReport::btnApplyClicked()
 {
 	SELECTED_FACTORY->productType(SELECTED_PRODUCT_TYPE);
+	Utility<CommandLog>::get().record(COMMAND_PRODUCT_TYPE, SELECTED_FACTORY, SELECTED_PRODUCT_TYPE);
 	cboFilterByProductSelectionChanged();
 }
 
 
+/**
+ * Switches the detail pane between the selected factory and the production
+ * planner.
+ */
+void FactoryReport::btnPlannerClicked()
+{
+	checkPlannerControls();
+	checkFactoryActionControls();
+}
+
+
+/**
+ * Adds the orders of the production plan to the production queues of the
+ * factories.
+ */
+void FactoryReport::btnApplyPlanClicked()
+{
+	ProductionPlanner& planner = Utility<ProductionPlanner>::get();
+	const ProductionPlanner::Plan plan = planner.update();
+
+	StructureList& factories = Utility<StructureManager>::get().structureList(Structure::CLASS_FACTORY);
+
+	for (const ProductionPlanner::Assignment& assignment : plan.assignments)
+	{
+		if (std::find(factories.begin(), factories.end(), assignment.factory) == factories.end()) { continue; }
+
+		for (const Factory::ProductionOrder& order : assignment.orders)
+		{
+			assignment.factory->queueProduct(order.product, order.count);
+			Utility<CommandLog>::get().record(COMMAND_QUEUE_PRODUCT, assignment.factory, queueProductCommandValue(order.product, false, order.count));
+		}
+	}
+
+	planner.update();
+}
+
+
+/**
+ * Sets the target stock of a product from its text field.
+ */
+void FactoryReport::txtTargetChanged(Control* control)
+{
+	ProductionPlanner& planner = Utility<ProductionPlanner>::get();
+	ProductPool::ProductTypeCount targets = planner.targets();
+
+	for (size_t i = 0; i < txtTargets.size(); ++i)
+	{
+		if (&txtTargets[i] != control) { continue; }
+		targets[PRODUCT_TYPES[i]] = txtTargets[i].empty() ? 0 : std::stoi(txtTargets[i].text());
+	}
+
+	planner.targets(targets);
+}
+
+
 /**
  * 
  */
@@ -528,7 +643,7 @@ void FactoryReport::lstFactoryListSelectionChanged()
 	SELECTED_PRODUCT_TYPE = SELECTED_FACTORY->productType();
 
 	Structure::StructureState _state = SELECTED_FACTORY->state();
-	btnApply.visible(_state == Structure::OPERATIONAL || _state == Structure::IDLE);
+	btnApply.visible(!btnPlanner.toggled() && (_state == Structure::OPERATIONAL || _state == Structure::IDLE));
 }
 
 
@@ -559,7 +674,7 @@ void FactoryReport::drawDetailPane(Renderer& r)
 {
 	Color_4ub text_color(0, 185, 0, 255);
 
-	r.drawImage(*FACTORY_IMAGE, DETAIL_PANEL.x(), DETAIL_PANEL.y() + 25);
+	FACTORY_IMAGE.draw(r, DETAIL_PANEL.x(), DETAIL_PANEL.y() + 25);
 	r.drawText(*FONT_BIG_BOLD, SELECTED_FACTORY->name(), DETAIL_PANEL.x(), DETAIL_PANEL.y() - 8, text_color.red(), text_color.green(), text_color.blue());
 
 	r.drawText(*FONT_MED_BOLD, "Status", DETAIL_PANEL.x() + 138, DETAIL_PANEL.y() + 20, text_color.red(), text_color.green(), text_color.blue());
@@ -605,7 +720,7 @@ void FactoryReport::drawProductPane(Renderer& r)
 	if (SELECTED_PRODUCT_TYPE != PRODUCT_NONE)
 	{
 		r.drawText(*FONT_BIG_BOLD, productDescription(SELECTED_PRODUCT_TYPE), position_x, DETAIL_PANEL.y() + 180, 0, 185, 0);
-		r.drawImage(*PRODUCT_IMAGE_ARRAY[SELECTED_PRODUCT_TYPE], position_x, lstProducts.positionY());
+		PRODUCT_IMAGE_ARRAY[SELECTED_PRODUCT_TYPE].draw(r, position_x, lstProducts.positionY());
 		txtProductDescription.update();
 	}
 
@@ -624,6 +739,69 @@ void FactoryReport::drawProductPane(Renderer& r)
 }
 
 
+/**
+ * Draws the production plan: what's missing from the target stocks, what it
+ * costs and when it will be built.
+ */
+void FactoryReport::drawPlannerPane(Renderer& r)
+{
+	const ProductionPlanner::Plan& plan = Utility<ProductionPlanner>::get().update();
+
+	Color_4ub text_color(0, 185, 0, 255);
+	int x = DETAIL_PANEL.x();
+	int y = DETAIL_PANEL.y();
+
+	r.drawText(*FONT_BIG_BOLD, "Production Planner", x, y - 8, text_color.red(), text_color.green(), text_color.blue());
+
+	int missing = 0;
+	for (ProductType product : PRODUCT_TYPES) { missing += plan.shortfall[product]; }
+
+	std::string summary = "All targets are met.";
+	if (missing > 0 && plan.turns > 0) { summary = string_format("%i products missing, built in %i turns.", missing, plan.turns); }
+	else if (missing > 0) { summary = string_format("%i products missing, not all can be built within %i turns.", missing, constants::PLANNER_TURNS); }
+
+	r.drawText(*FONT_MED, summary, x, y + 35, text_color.red(), text_color.green(), text_color.blue());
+	r.drawText(*FONT_MED, string_format("%i factories assigned", static_cast<int>(plan.assignments.size())), x, y + 55, text_color.red(), text_color.green(), text_color.blue());
+
+	// RESOURCE BILL
+	r.drawText(*FONT_MED_BOLD, RESOURCES_REQUIRED, x, y + 80, text_color.red(), text_color.green(), text_color.blue());
+
+	const std::array<std::string, 4> RESOURCE_NAMES = {{ "Common Metals", "Common Minerals", "Rare Metals", "Rare Minerals" }};
+	for (size_t i = 0; i < RESOURCE_NAMES.size(); ++i)
+	{
+		int row = y + 100 + static_cast<int>(i) * 15;
+		std::string amount = std::to_string(plan.bill[i]);
+		r.drawText(*FONT_BOLD, RESOURCE_NAMES[i], x, row, text_color.red(), text_color.green(), text_color.blue());
+		r.drawText(*FONT, amount, x + WIDTH_RESOURCES_REQUIRED_LABEL - FONT->width(amount), row, text_color.red(), text_color.green(), text_color.blue());
+	}
+
+	// TARGETS
+	r.drawText(*FONT_BOLD, "Product", x, y + 172, text_color.red(), text_color.green(), text_color.blue());
+	r.drawText(*FONT_BOLD, "Stock", x + 150, y + 172, text_color.red(), text_color.green(), text_color.blue());
+	r.drawText(*FONT_BOLD, "Target", x + 210, y + 172, text_color.red(), text_color.green(), text_color.blue());
+	r.drawText(*FONT_BOLD, "Missing", x + 270, y + 172, text_color.red(), text_color.green(), text_color.blue());
+	r.drawText(*FONT_BOLD, "Turns", x + 330, y + 172, text_color.red(), text_color.green(), text_color.blue());
+
+	for (size_t i = 0; i < PRODUCT_TYPES.size(); ++i)
+	{
+		ProductType product = PRODUCT_TYPES[i];
+		int row = y + 192 + static_cast<int>(i) * 22;
+
+		std::string turns = "-";
+		if (plan.unassigned[product] > 0) { turns = "No factory"; }
+		else if (plan.shortfall[product] > 0 && plan.completionTurn[product] == 0) { turns = string_format(">%i", constants::PLANNER_TURNS); }
+		else if (plan.shortfall[product] > 0) { turns = std::to_string(plan.completionTurn[product]); }
+
+		plan.shortfall[product] > 0 && plan.completionTurn[product] == 0 ? text_color(255, 0, 0, 255) : text_color(0, 185, 0, 255);
+
+		r.drawText(*FONT, productDescription(product), x, row, text_color.red(), text_color.green(), text_color.blue());
+		r.drawText(*FONT, std::to_string(plan.stock[product]), x + 150, row, text_color.red(), text_color.green(), text_color.blue());
+		r.drawText(*FONT, std::to_string(plan.shortfall[product]), x + 270, row, text_color.red(), text_color.green(), text_color.blue());
+		r.drawText(*FONT, turns, x + 330, row, text_color.red(), text_color.green(), text_color.blue());
+	}
+}
+
+
 /**
  * 
  */
@@ -635,7 +813,11 @@ void FactoryReport::update()
 	r.drawLine(cboFilterByProduct.rect().x() + cboFilterByProduct.rect().width() + 10, rect().y() + 10, cboFilterByProduct.rect().x() + cboFilterByProduct.rect().width() + 10, rect().y() + rect().height() - 10, 0, 185, 0);
 	r.drawText(*FONT, "Filter by Product", SORT_BY_PRODUCT_POSITION, rect().y() + 10, 0, 185, 0);
 
-	if (SELECTED_FACTORY)
+	if (btnPlanner.toggled())
+	{
+		drawPlannerPane(r);
+	}
+	else if (SELECTED_FACTORY)
 	{
 		drawDetailPane(r);
 		drawProductPane(r);
@@ -6,8 +6,11 @@
 #include "../Core/ComboBox.h"
 #include "../Core/UIContainer.h"
 #include "../Core/TextArea.h"
+#include "../Core/TextField.h"
 #include "../FactoryListBox.h"
 
+#include <array>
+
 
 class FactoryReport : public ReportInterface
 {
@@ -43,6 +46,10 @@ private:
 
 	void btnApplyClicked();
 
+	void btnPlannerClicked();
+	void btnApplyPlanClicked();
+	void txtTargetChanged(Control*);
+
 	void filterButtonClicked(bool clearCbo);
 
 	void lstFactoryListSelectionChanged();
@@ -50,11 +57,13 @@ private:
 	void cboFilterByProductSelectionChanged();
 
 	void checkFactoryActionControls();
+	void checkPlannerControls();
 
 	void resized(Control*);
 
 	void drawDetailPane(NAS2D::Renderer&);
 	void drawProductPane(NAS2D::Renderer&);
+	void drawPlannerPane(NAS2D::Renderer&);
 
 	virtual void visibilityChanged(bool visible) final;
 
@@ -72,6 +81,11 @@ private:
 
 	Button			btnApply;
 
+	Button			btnPlanner;
+	Button			btnApplyPlan;
+
+	std::array<TextField, PRODUCT_TYPES.size()>	txtTargets;		/**< Target stock of each product in PRODUCT_TYPES. */
+
 	ComboBox		cboFilterByProduct;
 
 	FactoryListBox	lstFactoryList;
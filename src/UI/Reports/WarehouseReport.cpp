@@ -5,6 +5,7 @@
 
 #include "../../Constants.h"
 #include "../../FontManager.h"
+#include "../../ImageManager.h"
 #include "../../StructureManager.h"
 
 #include "../../Things/Structures/Warehouse.h"
@@ -18,7 +19,7 @@ static Font* FONT_MED = nullptr;
 static Font* FONT_MED_BOLD = nullptr;
 static Font* FONT_BIG_BOLD = nullptr;
 
-static Image* WAREHOUSE_IMG = nullptr;
+static ImageRegion WAREHOUSE_IMG;
 
 static int COUNT_WIDTH = 0;
 static int CAPACITY_WIDTH = 0;
@@ -89,7 +90,7 @@ WarehouseReport::WarehouseReport()
 WarehouseReport::~WarehouseReport()
 {
 	Control::resized().disconnect(this, &WarehouseReport::_resized);
-	delete WAREHOUSE_IMG;
+	WAREHOUSE_IMG.reset();
 }
 
 
@@ -103,7 +104,7 @@ void WarehouseReport::init()
 	FONT_MED_BOLD	= Utility<FontManager>::get().font(constants::FONT_PRIMARY_BOLD, constants::FONT_PRIMARY_MEDIUM);
 	FONT_BIG_BOLD	= Utility<FontManager>::get().font(constants::FONT_PRIMARY_BOLD, constants::FONT_PRIMARY_HUGE);
 
-	WAREHOUSE_IMG = new Image("ui/interface/warehouse.png");
+	WAREHOUSE_IMG = Utility<ImageManager>::get().region("ui/interface/warehouse.png");
 
 	add(&btnShowAll, 10, 10);
 	btnShowAll.size(75, 20);
@@ -470,7 +471,7 @@ void WarehouseReport::drawRightPanel(Renderer& r)
 	if (!SELECTED_WAREHOUSE) { return; }
 	
 	r.drawText(*FONT_BIG_BOLD, SELECTED_WAREHOUSE->name(), r.center_x() + 10, positionY() + 2, 0, 185, 0);
-	r.drawImage(*WAREHOUSE_IMG, r.center_x() + 10, positionY() + 35);
+	WAREHOUSE_IMG.draw(r, r.center_x() + 10, positionY() + 35);
 }
 
 
@@ -3,6 +3,7 @@
 
 #include "ResourceBreakdownPanel.h"
 
+#include "../Common.h"
 #include "../Constants.h"
 #include "../FontManager.h"
 
@@ -57,19 +58,11 @@ static ResourceTrend compareResources(int src, int dst)
 }
 
 
-ResourceBreakdownPanel::ResourceBreakdownPanel() : mIcons("ui/icons.png")
+ResourceBreakdownPanel::ResourceBreakdownPanel() : mIcons(Utility<ImageManager>::get().region("ui/icons.png"))
 {
-	size(270, 80);
-
-	mSkin.push_back(Image("ui/skin/window_top_left.png"));
-	mSkin.push_back(Image("ui/skin/window_top_middle.png"));
-	mSkin.push_back(Image("ui/skin/window_top_right.png"));
-	mSkin.push_back(Image("ui/skin/window_middle_left.png"));
-	mSkin.push_back(Image("ui/skin/window_middle_middle.png"));
-	mSkin.push_back(Image("ui/skin/window_middle_right.png"));
-	mSkin.push_back(Image("ui/skin/window_bottom_left.png"));
-	mSkin.push_back(Image("ui/skin/window_bottom_middle.png"));
-	mSkin.push_back(Image("ui/skin/window_bottom_right.png"));
+	size(270, 130);
+
+	mSkin = Utility<ImageManager>::get().skin("ui/skin/window");
 
 	FONT = Utility<FontManager>::get().font(constants::FONT_PRIMARY, constants::FONT_PRIMARY_NORMAL);
 }
@@ -96,12 +89,12 @@ void ResourceBreakdownPanel::resourceCheck()
 void ResourceBreakdownPanel::update()
 {
 	Renderer& r = Utility<Renderer>::get();
-	r.drawImageRect(rect().x(), rect().y(), rect().width(), rect().height(), mSkin);
+	r.drawImageRect(rect().x(), rect().y(), rect().width(), rect().height(), *mSkin);
 
-	r.drawSubImage(mIcons, 5.0f, rect().y() + 5.0f, 64.0f, 16.0f, 16.0f, 16.0f);
-	r.drawSubImage(mIcons, 5.0f, rect().y() + 23.0f, 80.0f, 16.0f, 16.0f, 16.0f);
-	r.drawSubImage(mIcons, 5.0f, rect().y() + 41.0f, 96.0f, 16.0f, 16.0f, 16.0f);
-	r.drawSubImage(mIcons, 5.0f, rect().y() + 59.0f, 112.0f, 16.0f, 16.0f, 16.0f);
+	mIcons.drawSub(r, 5.0f, rect().y() + 5.0f, 64.0f, 16.0f, 16.0f, 16.0f);
+	mIcons.drawSub(r, 5.0f, rect().y() + 23.0f, 80.0f, 16.0f, 16.0f, 16.0f);
+	mIcons.drawSub(r, 5.0f, rect().y() + 41.0f, 96.0f, 16.0f, 16.0f, 16.0f);
+	mIcons.drawSub(r, 5.0f, rect().y() + 59.0f, 112.0f, 16.0f, 16.0f, 16.0f);
 
 	r.drawText(*FONT, "Common Metals",		28.0f, rect().y() + 5.0f, 255, 255, 255);
 	r.drawText(*FONT, "Rare Metals",		28.0f, rect().y() + 23.0f, 255, 255, 255);
@@ -120,10 +113,10 @@ void ResourceBreakdownPanel::update()
 	fmt = string_format("%i", mPlayerResources->rareMinerals());
 	r.drawText(*FONT, fmt, 200.0f - FONT->width(fmt), rect().y() + 59.0f, 255, 255, 255);
 
-	r.drawSubImage(mIcons, 220.0f, rect().y() + 8.0f,	ICON_SLICE[COMMON_METALS].x(),		ICON_SLICE[COMMON_METALS].y(),		8.0f, 8.0f);
-	r.drawSubImage(mIcons, 220.0f, rect().y() + 26.0f,	ICON_SLICE[COMMON_MINERALS].x(),	ICON_SLICE[COMMON_MINERALS].y(),	8.0f, 8.0f);
-	r.drawSubImage(mIcons, 220.0f, rect().y() + 44.0f,	ICON_SLICE[RARE_METALS].x(),		ICON_SLICE[RARE_METALS].y(),		8.0f, 8.0f);
-	r.drawSubImage(mIcons, 220.0f, rect().y() + 62.0f,	ICON_SLICE[RARE_MINERALS].x(),		ICON_SLICE[RARE_MINERALS].y(),		8.0f, 8.0f);
+	mIcons.drawSub(r, 220.0f, rect().y() + 8.0f,	ICON_SLICE[COMMON_METALS].x(),		ICON_SLICE[COMMON_METALS].y(),		8.0f, 8.0f);
+	mIcons.drawSub(r, 220.0f, rect().y() + 26.0f,	ICON_SLICE[COMMON_MINERALS].x(),	ICON_SLICE[COMMON_MINERALS].y(),	8.0f, 8.0f);
+	mIcons.drawSub(r, 220.0f, rect().y() + 44.0f,	ICON_SLICE[RARE_METALS].x(),		ICON_SLICE[RARE_METALS].y(),		8.0f, 8.0f);
+	mIcons.drawSub(r, 220.0f, rect().y() + 62.0f,	ICON_SLICE[RARE_MINERALS].x(),		ICON_SLICE[RARE_MINERALS].y(),		8.0f, 8.0f);
 
 
 	fmt = string_format("%+i", mPlayerResources->commonMetals() - mPreviousResources.commonMetals());
@@ -137,4 +130,25 @@ void ResourceBreakdownPanel::update()
 
 	fmt = string_format("%+i", mPlayerResources->rareMinerals() - mPreviousResources.rareMinerals());
 	r.drawText(*FONT, fmt, 235.0f, rect().y() + 59.0f, RARE_MIN_COL.red(), RARE_MIN_COL.green(), RARE_MIN_COL.blue());
+
+	if (!mForecast) { return; }
+
+	Forecast::Result forecast = mForecast->result();
+	if (forecast.food.empty())
+	{
+		r.drawText(*FONT, "Forecasting food stores...", 5.0f, rect().y() + 80.0f, 150, 150, 150);
+		return;
+	}
+
+	if (forecast.starvationTurn > 0)
+	{
+		r.drawText(*FONT, string_format("Food runs out in %i turns", forecast.starvationTurn), 5.0f, rect().y() + 80.0f, 255, 0, 0);
+	}
+	else
+	{
+		r.drawText(*FONT, string_format("Food in %i turns: %i", constants::FORECAST_TURNS, forecast.food.back()), 5.0f, rect().y() + 80.0f, 255, 255, 255);
+	}
+
+	Color_4ub color = TEXT_COLOR[compareResources(forecast.food.back(), forecast.food.front())];
+	drawTrendLine(forecast.food, 5.0f, rect().y() + 95.0f, width() - 10.0f, 30.0f, color);
 }
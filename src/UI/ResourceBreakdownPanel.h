@@ -1,6 +1,8 @@
 #pragma once
 
 #include "Core/Control.h"
+#include "../Forecast.h"
+#include "../ImageManager.h"
 #include "../ResourcePool.h"
 
 class ResourceBreakdownPanel : public Control
@@ -10,6 +12,7 @@ public:
 	virtual ~ResourceBreakdownPanel() = default;
 
 	void playerResources(ResourcePool* rp) { mPlayerResources = rp; }
+	void forecast(Forecast* forecast) { mForecast = forecast; }
 	ResourcePool& previousResources() { return mPreviousResources; }
 
 	void resourceCheck();
@@ -17,9 +20,10 @@ public:
 	virtual void update() final;
 
 private:
-	NAS2D::Image		mIcons;
-	NAS2D::ImageList	mSkin;
+	ImageRegion						mIcons;
+	ImageManager::ImageListHandle	mSkin;
 
 	ResourcePool		mPreviousResources;
 	ResourcePool*		mPlayerResources = nullptr;
+	Forecast*			mForecast = nullptr;
 };
@@ -0,0 +1,207 @@
+// This is an open source non-commercial project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+
+#include "SaveGameListBox.h"
+
+#include "../Constants.h"
+#include "../FontManager.h"
+
+#include <physfs.h>
+
+#include <algorithm>
+#include <ctime>
+
+
+using namespace NAS2D;
+
+
+const int SAVE_GAME_ITEM_HEIGHT = 40;
+const int SAVE_GAME_THUMBNAIL_DRAW_SIZE = 32;
+
+/**
+ * Maximum number of headers read each frame. Keeps the list responsive
+ * when a directory with a lot of new or changed savegames is opened.
+ */
+const int HEADER_READS_PER_FRAME = 8;
+
+static Font* MAIN_FONT = nullptr;
+static Font* MAIN_FONT_BOLD = nullptr;
+
+
+/**
+ * Builds a displayable image from a header's thumbnail colors.
+ */
+static Image thumbnailImage(const SaveGameHeader& header)
+{
+	if (header.thumbnail.empty()) { return Image(); }
+
+	std::vector<uint8_t> pixels;
+	pixels.reserve(header.thumbnail.size() * 4);
+	for (const auto& color : header.thumbnail)
+	{
+		pixels.push_back(color.red());
+		pixels.push_back(color.green());
+		pixels.push_back(color.blue());
+		pixels.push_back(255);
+	}
+
+	return Image(pixels.data(), 4, constants::SAVE_GAME_THUMBNAIL_SIZE, constants::SAVE_GAME_THUMBNAIL_SIZE);
+}
+
+
+/**
+ * Gets a short summary line for a savegame.
+ */
+static std::string summary(const SaveGameListBox::HeaderCacheEntry& entry)
+{
+	if (entry.stale) { return "Reading..."; }
+	if (!entry.header.valid) { return "No summary available"; }
+
+	std::string sitemap = entry.header.sitemap.substr(entry.header.sitemap.find_last_of('/') + 1);
+
+	return "Turn " + std::to_string(entry.header.turn) +
+		"   Population " + std::to_string(entry.header.population) +
+		"   Morale " + std::to_string(entry.header.morale) +
+		"   " + sitemap;
+}
+
+
+static void drawItem(Renderer& r, SaveGameListBox::SaveGameListBoxItem& item, int x, int y, int w, int offset, bool highlight)
+{
+	const SaveGameListBox::HeaderCacheEntry& entry = *item.cache;
+
+	if (highlight) { r.drawBoxFilled(x, y - offset, w, SAVE_GAME_ITEM_HEIGHT, 0, 185, 0, 75); }
+
+	r.drawBox(x + 4, y + 4 - offset, SAVE_GAME_THUMBNAIL_DRAW_SIZE, SAVE_GAME_THUMBNAIL_DRAW_SIZE, 75, 75, 75, 255);
+	if (entry.thumbnail.loaded())
+	{
+		r.drawImageStretched(entry.thumbnail, x + 4, y + 4 - offset, SAVE_GAME_THUMBNAIL_DRAW_SIZE, SAVE_GAME_THUMBNAIL_DRAW_SIZE);
+	}
+
+	r.drawText(*MAIN_FONT_BOLD, item.Text, x + 44, y + 4 - offset, 255, 255, 255, 255);
+	r.drawText(*MAIN_FONT, summary(entry), x + 44, y + 22 - offset, 185, 185, 185, 255);
+
+	if (!entry.stale && entry.header.valid)
+	{
+		char date[32] = { 0 };
+		std::strftime(date, sizeof(date), "%Y-%m-%d %H:%M", std::localtime(&entry.header.timestamp));
+		r.drawText(*MAIN_FONT, date, x + w - MAIN_FONT->width(date) - 8, y + 4 - offset, 185, 185, 185, 255);
+	}
+}
+
+
+/**
+ * C'tor
+ */
+SaveGameListBox::SaveGameListBox()
+{
+	_init();
+}
+
+
+/**
+ * D'tor
+ */
+SaveGameListBox::~SaveGameListBox()
+{}
+
+
+void SaveGameListBox::_init()
+{
+	item_height(SAVE_GAME_ITEM_HEIGHT);
+	MAIN_FONT = Utility<FontManager>::get().font(constants::FONT_PRIMARY, 12);
+	MAIN_FONT_BOLD = Utility<FontManager>::get().font(constants::FONT_PRIMARY_BOLD, 12);
+}
+
+
+/**
+ * Fills the list with the savegames found in a directory, most recently
+ * saved first.
+ *
+ * Only file modification times are checked here. Headers of new or
+ * changed files are read later by update().
+ */
+void SaveGameListBox::scanDirectory(const std::string& _dir)
+{
+	Filesystem& f = Utility<Filesystem>::get();
+	StringList dirList = f.directoryList(_dir);
+
+	clearItems();
+
+	std::map<std::string, HeaderCacheEntry> cache;
+	for (auto& file : dirList)
+	{
+		std::string path = _dir + file;
+		if (f.isDirectory(path)) { continue; }
+
+		// Skip the command logs written next to savegames.
+		if (file.size() < 4 || file.compare(file.size() - 4, 4, ".xml") != 0) { continue; }
+
+		PHYSFS_Stat stat;
+		int64_t modtime = PHYSFS_stat(path.c_str(), &stat) ? stat.modtime : -1;
+
+		auto it = mHeaderCache.find(path);
+		HeaderCacheEntry& entry = cache[path];
+		if (it != mHeaderCache.end() && it->second.modtime == modtime && !it->second.stale)
+		{
+			entry = it->second;
+		}
+		entry.modtime = modtime;
+
+		file.resize(file.size() - 4);	// Assumes a file save extension of 3 characters.
+										// This is a naive approach.
+		mItems.push_back(new SaveGameListBoxItem(file, &entry));
+	}
+
+	mHeaderCache.swap(cache);
+
+	std::stable_sort(mItems.begin(), mItems.end(), [](ListBoxItem* a, ListBoxItem* b)
+	{
+		return static_cast<SaveGameListBoxItem*>(a)->cache->modtime > static_cast<SaveGameListBoxItem*>(b)->cache->modtime;
+	});
+
+	_update_item_display();
+}
+
+
+/**
+ * Reads a limited number of stale headers.
+ */
+void SaveGameListBox::refreshHeaders()
+{
+	int reads = 0;
+	for (auto& pair : mHeaderCache)
+	{
+		if (!pair.second.stale) { continue; }
+		if (reads++ >= HEADER_READS_PER_FRAME) { return; }
+
+		pair.second.header = readSaveGameHeader(pair.first);
+		pair.second.thumbnail = thumbnailImage(pair.second.header);
+		pair.second.stale = false;
+	}
+}
+
+
+/**
+ * Draws the SaveGameListBox
+ */
+void SaveGameListBox::update()
+{
+	if (!visible()) { return; }
+	ListBoxBase::update();
+
+	refreshHeaders();
+
+	Renderer& r = Utility<Renderer>::get();
+
+	r.clipRect(rect());
+
+	int first = draw_offset() / SAVE_GAME_ITEM_HEIGHT;
+	int last = std::min(static_cast<int>(mItems.size()), (draw_offset() + static_cast<int>(height())) / SAVE_GAME_ITEM_HEIGHT + 1);
+	for (int i = first; i < last; ++i)
+	{
+		drawItem(r, *static_cast<SaveGameListBoxItem*>(mItems[i]), positionX(), positionY() + (i * SAVE_GAME_ITEM_HEIGHT), item_width(), draw_offset(), i == ListBoxBase::currentSelection());
+	}
+
+	r.clipRectClear();
+}
@@ -0,0 +1,59 @@
+#pragma once
+
+#include "NAS2D/NAS2D.h"
+
+#include "Core/ListBoxBase.h"
+
+#include "../SaveGameHeader.h"
+
+#include <cstdint>
+#include <map>
+#include <string>
+
+
+/**
+ * Implements a ListBox that shows savegames along with a summary read
+ * from their headers.
+ *
+ * Headers are cached by file modification time so reopening the list
+ * only rereads files that have changed. Stale headers are read a few at a
+ * time as the list is drawn so it can be shown immediately.
+ */
+class SaveGameListBox : public ListBoxBase
+{
+public:
+	struct HeaderCacheEntry
+	{
+		int64_t			modtime = 0;			/**< Modification time of the file when the header was read. */
+		bool			stale = true;			/**< Header needs to be (re)read. */
+
+		SaveGameHeader	header;					/**< Cached header. */
+		NAS2D::Image	thumbnail;				/**< Thumbnail image built from the header. */
+	};
+
+	class SaveGameListBoxItem : public ListBoxItem
+	{
+	public:
+		SaveGameListBoxItem(const std::string& name, HeaderCacheEntry* entry) : ListBoxItem(name), cache(entry) {}
+		virtual ~SaveGameListBoxItem() {}
+
+	public:
+		HeaderCacheEntry* cache = nullptr;
+	};
+
+public:
+	SaveGameListBox();
+	virtual ~SaveGameListBox();
+
+	void scanDirectory(const std::string& _dir);
+
+	virtual void update() final;
+
+private:
+	void _init();
+
+	void refreshHeaders();
+
+private:
+	std::map<std::string, HeaderCacheEntry>	mHeaderCache;		/**< Savegame headers keyed by path. */
+};
@@ -16,7 +16,7 @@ static Font* FONT = nullptr;
 static Font* FONT_BOLD = nullptr;
 
 
-StructureInspector::StructureInspector() : mIcons("ui/icons.png")
+StructureInspector::StructureInspector() : mIcons(Utility<ImageManager>::get().image("ui/icons.png"))
 {
 	text(constants::WINDOW_STRUCTURE_INSPECTOR);
 	init();
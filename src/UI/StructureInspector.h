@@ -2,6 +2,7 @@
 
 #include "UI.h"
 
+#include "../ImageManager.h"
 #include "../Map/Tile.h"
 
 class StructureInspector : public Window
@@ -34,7 +35,7 @@ private:
 
 	TextArea		txtStateDescription;
 
-	NAS2D::Image	mIcons;
+	ImageManager::ImageHandle	mIcons;
 
 	std::string		mStructureClass;
 
@@ -0,0 +1,295 @@
+// This is an open source non-commercial project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+
+#include "XmlStreamWriter.h"
+
+#include <physfs.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+
+#if defined(WINDOWS) || defined(WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <Windows.h>
+#endif
+
+
+/**
+ * Size of the output buffer. Output is written to disk in chunks
+ * of this size.
+ */
+static const size_t WRITE_BUFFER_SIZE = 64 * 1024;
+
+
+/**
+ * Extension added to the name of the file while it's being written.
+ */
+static const std::string TEMP_FILE_EXTENSION = ".tmp";
+
+
+/**
+ * Gets the path of a file in the PhysFS write directory on the real
+ * filesystem.
+ */
+static std::string realWritePath(const std::string& filename)
+{
+	std::string path = PHYSFS_getWriteDir();
+	std::string separator = PHYSFS_getDirSeparator();
+	if (path.size() < separator.size() || path.compare(path.size() - separator.size(), separator.size(), separator) != 0) { path += separator; }
+
+	return path + filename;
+}
+
+
+/**
+ * Moves a file in the write directory over another, replacing it.
+ *
+ * PhysFS can't rename files so this is done on the real filesystem. The
+ * target is replaced in one step so it's never left missing or partly
+ * written.
+ *
+ * \throws	std::runtime_error if the file can't be moved.
+ */
+static void replaceFile(const std::string& from, const std::string& to)
+{
+	std::string source = realWritePath(from);
+	std::string target = realWritePath(to);
+
+#if defined(WINDOWS) || defined(WIN32)
+	bool moved = MoveFileExA(source.c_str(), target.c_str(), MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH) != 0;
+#else
+	bool moved = std::rename(source.c_str(), target.c_str()) == 0;
+#endif
+
+	if (!moved)
+	{
+		throw std::runtime_error("Unable to replace '" + to + "' with '" + from + "'.");
+	}
+}
+
+
+/**
+ * C'tor
+ *
+ * \param	filename	File to write to. Any existing file is replaced once
+ *						close() succeeds.
+ * \param	compression	Compression to apply to the file.
+ *
+ * \throws	std::runtime_error if the file can't be opened for writing.
+ */
+XmlStreamWriter::XmlStreamWriter(const std::string& filename, CompressionType compression) :
+	mFilename(filename),
+	mTempFilename(filename + TEMP_FILE_EXTENSION),
+	mFile(mTempFilename, compression),
+	mBuffer(WRITE_BUFFER_SIZE)
+{}
+
+
+/**
+ * D'tor
+ *
+ * If close() wasn't called or failed, the incomplete temporary file is
+ * deleted and any existing file is left as it was.
+ */
+XmlStreamWriter::~XmlStreamWriter()
+{
+	if (mReplaced) { return; }
+
+	try
+	{
+		mFile.close();
+	}
+	catch (const std::exception&)
+	{
+		// The file is deleted either way.
+	}
+
+	PHYSFS_delete(mTempFilename.c_str());
+}
+
+
+/**
+ * Opens a new element as a child of the current element.
+ */
+void XmlStreamWriter::openElement(const std::string& name)
+{
+	finishStartTag();
+
+	indent();
+	write("<", 1);
+	write(name);
+
+	mElementStack.push_back(name);
+	mStartTagOpen = true;
+}
+
+
+/**
+ * Closes the current element.
+ */
+void XmlStreamWriter::closeElement()
+{
+	if (mElementStack.empty())
+	{
+		throw std::runtime_error("XmlStreamWriter::closeElement(): No open element in '" + mFilename + "'.");
+	}
+
+	if (mStartTagOpen)
+	{
+		write(" />\n", 4);
+		mStartTagOpen = false;
+		mElementStack.pop_back();
+		return;
+	}
+
+	std::string name = mElementStack.back();
+	mElementStack.pop_back();
+
+	indent();
+	write("</", 2);
+	write(name);
+	write(">\n", 2);
+}
+
+
+/**
+ * Writes an attribute on the current element.
+ */
+void XmlStreamWriter::attribute(const std::string& name, const std::string& value)
+{
+	if (!mStartTagOpen)
+	{
+		throw std::runtime_error("XmlStreamWriter::attribute(): Attribute '" + name + "' written outside of a start tag in '" + mFilename + "'.");
+	}
+
+	write(" ", 1);
+	write(name);
+	write("=\"", 2);
+	writeEscaped(value);
+	write("\"", 1);
+}
+
+
+/**
+ * Writes an attribute on the current element.
+ */
+void XmlStreamWriter::attribute(const std::string& name, int value)
+{
+	attribute(name, std::to_string(value));
+}
+
+
+/**
+ * Closes any open elements, flushes pending output and closes the file.
+ *
+ * Output is written to a temporary file next to the target which only
+ * replaces the target once it has been written completely. A failed
+ * write never damages an existing file.
+ *
+ * \throws	std::runtime_error if pending output couldn't be written or
+ *			the file couldn't be replaced.
+ */
+void XmlStreamWriter::close()
+{
+	if (mClosed) { return; }
+	mClosed = true;
+
+	while (!mElementStack.empty())
+	{
+		closeElement();
+	}
+
+	flush();
+	mFile.close();
+
+	replaceFile(mTempFilename, mFilename);
+	mReplaced = true;
+}
+
+
+/**
+ * Ends the start tag of the current element if it's still open
+ * so that child content can follow it.
+ */
+void XmlStreamWriter::finishStartTag()
+{
+	if (!mStartTagOpen) { return; }
+
+	write(">\n", 2);
+	mStartTagOpen = false;
+}
+
+
+void XmlStreamWriter::indent()
+{
+	for (size_t i = 0; i < mElementStack.size(); ++i)
+	{
+		write("\t", 1);
+	}
+}
+
+
+/**
+ * Appends data to the output buffer, flushing to disk as needed.
+ */
+void XmlStreamWriter::write(const char* data, size_t length)
+{
+	while (length > 0)
+	{
+		if (mBufferLength == mBuffer.size()) { flush(); }
+
+		size_t count = std::min(length, mBuffer.size() - mBufferLength);
+		std::memcpy(mBuffer.data() + mBufferLength, data, count);
+
+		mBufferLength += count;
+		data += count;
+		length -= count;
+	}
+}
+
+
+/**
+ * Writes a string replacing characters that are not allowed in
+ * attribute values with their entity references.
+ */
+void XmlStreamWriter::writeEscaped(const std::string& str)
+{
+	size_t start = 0;
+	for (size_t i = 0; i < str.size(); ++i)
+	{
+		const char* entity = nullptr;
+		switch (str[i])
+		{
+		case '&': entity = "&amp;"; break;
+		case '<': entity = "&lt;"; break;
+		case '>': entity = "&gt;"; break;
+		case '"': entity = "&quot;"; break;
+		case '\'': entity = "&apos;"; break;
+		default: continue;
+		}
+
+		write(str.c_str() + start, i - start);
+		write(entity, std::strlen(entity));
+		start = i + 1;
+	}
+
+	write(str.c_str() + start, str.size() - start);
+}
+
+
+/**
+ * Writes any pending output to disk.
+ *
+ * \throws	std::runtime_error if the write fails.
+ */
+void XmlStreamWriter::flush()
+{
+	if (mBufferLength == 0) { return; }
+
+	mFile.write(mBuffer.data(), mBufferLength);
+	mBufferLength = 0;
+}
@@ -0,0 +1,69 @@
+#pragma once
+
+#include "CompressedFile.h"
+
+#include <string>
+#include <vector>
+
+
+/**
+ * \brief	Forward-only XML writer that streams directly to a file.
+ *
+ * XmlStreamWriter never builds a document tree. Markup is appended to a
+ * fixed size buffer which is flushed to disk whenever it fills up so
+ * memory use stays constant regardless of how much is written.
+ *
+ * Attributes apply to the most recently opened element and must be
+ * written before any of its children are opened.
+ *
+ * Output goes to a temporary file which replaces the target only when
+ * close() succeeds, so an existing file is never left partly written.
+ *
+ * \note	Files are opened through PhysFS so paths are relative to the
+ *			write directory set up by NAS2D::Filesystem. Output can be
+ *			compressed as it's written, see CompressedFileWriter.
+ */
+class XmlStreamWriter
+{
+public:
+	XmlStreamWriter(const std::string& filename, CompressionType compression = COMPRESSION_NONE);
+	~XmlStreamWriter();
+
+	void openElement(const std::string& name);
+	void closeElement();
+
+	void attribute(const std::string& name, const std::string& value);
+	void attribute(const std::string& name, int value);
+
+	void close();
+
+private:
+	XmlStreamWriter() = delete;
+	XmlStreamWriter(const XmlStreamWriter&) = delete;
+	XmlStreamWriter& operator=(const XmlStreamWriter&) = delete;
+
+private:
+	void finishStartTag();
+	void indent();
+
+	void write(const char* data, size_t length);
+	void write(const std::string& str) { write(str.c_str(), str.size()); }
+	void writeEscaped(const std::string& str);
+
+	void flush();
+
+private:
+	std::string					mFilename;						/**< Name of the file being written. */
+	std::string					mTempFilename;					/**< Name of the file output goes to until close(). */
+
+	CompressedFileWriter		mFile;							/**< Output file. */
+
+	std::vector<char>			mBuffer;						/**< Pending output. */
+	size_t						mBufferLength = 0;				/**< Number of bytes pending in the buffer. */
+
+	std::vector<std::string>	mElementStack;					/**< Names of elements that are still open. */
+
+	bool						mStartTagOpen = false;			/**< Start tag of the current element is still accepting attributes. */
+	bool						mClosed = false;				/**< close() has been called. */
+	bool						mReplaced = false;				/**< Output has replaced mFilename. */
+};
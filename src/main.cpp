@@ -7,14 +7,17 @@
 #include "NAS2D/Mixer/NullMixer.h"
 #include "NAS2D/Renderer/RendererOpenGL.h"
 
+#include "CommandLog.h"
 #include "Common.h"
 #include "Constants.h"
+#include "Random.h"
 #include "StructureCatalogue.h"
 #include "StructureTranslator.h"
 #include "WindowEventWrapper.h"
 
 #include "Things/Structures/Structure.h"
 
+#include "States/GameState.h"
 #include "States/MapViewState.h"
 #include "States/MainMenuState.h"
 #include "States/SplashState.h"
@@ -49,6 +52,46 @@ void validateVideoResolution()
 }
 
 
+/**
+ * Sets up a game that replays a command log.
+ *
+ * \param	filename	Command log to replay.
+ * \param	hideUi		Don't draw the map or the UI while replaying.
+ */
+State* replayState(const std::string& filename, bool hideUi)
+{
+	std::vector<Command> commands;
+	CommandLogHeader header = CommandLog::read(filename, commands);
+
+	std::cout << "Replaying " << commands.size() << " commands from '" << filename << "'." << std::endl;
+
+	// Don't overwrite the log being replayed or any other.
+	Utility<CommandLog>::get().suspend(true);
+	Utility<RandomService>::get().seed(header.seed);
+
+	MapViewState* mapview = nullptr;
+	if (header.savegame.empty())
+	{
+		mapview = new MapViewState(header.map, header.tileset, header.digDepth, header.mineCount);
+		mapview->setPopulationLevel(MapViewState::POPULATION_LARGE);
+	}
+	else
+	{
+		checkSavegameVersion(header.savegame);
+		mapview = new MapViewState(header.savegame);
+	}
+
+	mapview->replay(commands, hideUi);
+	mapview->_initialize();
+	mapview->activate();
+
+	GameState* gameState = new GameState();
+	gameState->mapviewstate(mapview);
+
+	return gameState;
+}
+
+
 int main(int argc, char *argv[])
 {
 	//Crude way of redirecting stream buffer when building in release (no console)
@@ -63,6 +106,16 @@ int main(int argc, char *argv[])
 
 	std::cout << "OutpostHD " << constants::VERSION << std::endl << std::endl;
 
+	// --replay <file> replays a command log, --no-ui skips drawing while it runs.
+	std::string replayLog;
+	bool replayHideUi = false;
+	for (int i = 1; i < argc; ++i)
+	{
+		std::string arg = argv[i];
+		if (arg == "--replay" && i + 1 < argc) { replayLog = argv[++i]; }
+		else if (arg == "--no-ui") { replayHideUi = true; }
+	}
+
 	StructureCatalogue::init();		// only needs to be done once at the start of the program.
 	StructureTranslator::init();	// only needs to be done once at the start of the program.
 
@@ -96,6 +149,10 @@ int main(int argc, char *argv[])
 		{
 			cf.option("maximized", "true");
 		}
+		if (cf.option("save-compression").empty())
+		{
+			cf.option("save-compression", "gzip");
+		}
 
 		validateVideoResolution();
 
@@ -147,7 +204,11 @@ int main(int argc, char *argv[])
 		StateManager stateManager;
 		stateManager.forceStopAudio(false);
 		
-		if (cf.option("skip-splash") == "false")
+		if (!replayLog.empty())
+		{
+			stateManager.setState(replayState(replayLog, replayHideUi));
+		}
+		else if (cf.option("skip-splash") == "false")
 		{
 			stateManager.setState(new SplashState());
 		}